@@ -3,8 +3,29 @@
 
 #include <stdint.h>
 
+#include "bat_xsum.h"
+
 #define dimension 2
 
+/*
+ * Storage type of positions and velocities. `make PRECISION=float`
+ * (-DBAT_REAL_FLOAT) stores them in single precision: the population takes
+ * less memory traffic and twice as many coordinates fit in a vector
+ * register. Fitness values, loudness, pulse rates and every comparison stay
+ * in double (mixed precision), and objectives are evaluated in double on
+ * the stored (rounded) coordinates.
+ */
+#ifdef BAT_REAL_FLOAT
+typedef float bat_real;
+#define BAT_REAL_NAME "float"
+#else
+typedef double bat_real;
+#define BAT_REAL_NAME "double"
+#endif
+
+/* Maximum number of objectives of the multi-objective mode (--mo-objective, see bat_mo.h). */
+#define BAT_MO_MAX 3
+
 /* Default values (can be overridden at runtime via CLI options). */
 #define N_BATS     40
 #define MAX_ITERS  10000
@@ -22,23 +43,90 @@
 #define Ub         5
 #define Lb         -5
 
+/* Parameter adaptation modes (--adapt), can be combined. */
+#define BAT_ADAPT_NONE     0
+#define BAT_ADAPT_HISTORY  1   /* per-bat success-history ALPHA/GAMMA */
+#define BAT_ADAPT_FREQ     2   /* per-bat self-adaptive frequency range */
+
+/*
+ * Runtime Bat Algorithm parameters.
+ * Defaults are the constants above; front-ends override them from the
+ * command line (--alpha, --gamma, --fmin, --fmax, --a0, --r0, --adapt).
+ */
+typedef struct {
+    double f_min;
+    double f_max;
+    double a0;
+    double r0;
+    double alpha;
+    double gamma;
+    int    adapt;   /* BAT_ADAPT_* bitmask */
+} BatParams;
+
+/* Parameters used by the core (set once, before the optimization starts). */
+extern BatParams bat_params;
+
 typedef struct {
-    double x_i[dimension];
-    double v_i[dimension];
+    bat_real x_i[dimension];
+    bat_real v_i[dimension];
     double f_i;
     double A_i;
     double r_i;
     double f_value;
 
+    /* Constraints (only maintained with --constraint, see bat_constraint.h). */
+    double f_obj;       /* objective at x_i (NaN if never needed); f_value is then its rank */
+    double viol;        /* total violation at x_i */
+
+    /* Objective vector at x_i (only with --mo-objective; f_value is then f_mo[0]). */
+    double f_mo[BAT_MO_MAX];
+
+    /* Self-adaptive state (only used with --adapt). */
+    double alpha_i;     /* loudness decay currently used by this bat */
+    double gamma_i;     /* pulse growth currently used by this bat */
+    double m_alpha;     /* success-history mean of alpha_i */
+    double m_gamma;     /* success-history mean of gamma_i */
+    double fmax_i;      /* upper end of this bat's frequency range */
+    uint32_t n_success; /* accepted moves (per-bat clock for r_i) */
+
     /* Per-bat RNG state (makes OpenMP/MPI runs deterministic and thread-safe). */
     uint32_t rng_state;
 } Bat;
 
+/*
+ * Algorithm-behavior counters, appended to the BENCH line. They tell how
+ * much work a run actually did, so run times of different back-ends can be
+ * compared per unit of work. Every field is a long, so threads / ranks can
+ * add their counters as an array of BAT_COUNTERS_N longs.
+ */
+typedef struct {
+    long local_search;   /* local random walks (second objective evaluation) */
+    long accepts;        /* accepted moves */
+    long clamps;         /* candidate coordinates clamped to [Lb, Ub] */
+    long amean_calls;    /* average-loudness computations (one per iteration and rank) */
+    long amean_scanned;  /* bats read by those computations */
+    long best_changes;   /* iterations that improved the best bat */
+    long con_evals;      /* candidates whose constraints were evaluated (--constraint) */
+    long obj_skipped;    /* objective evaluations saved by the feasibility screening */
+} BatCounters;
+
+#define BAT_COUNTERS_N ((int)(sizeof(BatCounters) / sizeof(long)))
+
+/* dst += src, field by field. */
+void bat_counters_merge(BatCounters *dst, const BatCounters *src);
+
+/* Appends the counters to the current BENCH line. */
+void bat_counters_print_bench(const BatCounters *cnt);
+
 /* Core Bat Algorithm functions (implemented in src/bat_core.c).
  * These are shared by sequential / OpenMP / MPI implementations.
  */
 void initialize_bats(Bat bats[], int n_bats, Bat *best_bat);
-void update_bat(Bat bats[], int n_bats, const Bat *best_bat, int i, int t);
+int update_bat(Bat *bat, const Bat *best_bat, double A_mean, int t, BatCounters *cnt);
+
+/* Average loudness (exact sum, independent of the summation order). */
+double bat_mean_loudness(const Bat bats[], int n_bats);
+void bat_loudness_sum(const Bat bats[], int n_bats, BatExactSum *sum);
 
 /* Deterministic initializer used by all front-ends. */
 void initialize_bats_seeded(Bat bats[], int n_bats, Bat *best_bat, uint32_t seed);
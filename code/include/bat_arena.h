@@ -0,0 +1,85 @@
+#ifndef BAT_ARENA_H
+#define BAT_ARENA_H
+
+#include <stddef.h>
+
+/*
+ * bat_arena.h
+ *
+ * Memory arena for the population and the scratch buffers (--hugepages).
+ *
+ * The front-ends reserve all the memory a run can need in one mapping
+ * before the first iteration: the population (with room for --restart ipop
+ * growth) and the scratch space of the MPI --shrink exchanges. Nothing is
+ * allocated inside the iteration loop; scratch buffers are taken with
+ * bat_arena_alloc() and returned with bat_arena_release(), like a stack.
+ *
+ * With large populations most TLB misses and page faults come from the
+ * population array. The mapping is backed by huge pages when possible:
+ *
+ * - hugetlb : explicit 2 MB pages (MAP_HUGETLB, needs vm.nr_hugepages)
+ * - thp     : transparent huge pages (2 MB-aligned mapping + MADV_HUGEPAGE)
+ * - off     : regular 4 KB pages
+ * - auto    : hugetlb if available, else thp (default)
+ *
+ * The --restart ipop room (up to 16x the initial population) is often never
+ * used, so bat_arena_create_hot() takes explicit huge pages in auto mode for
+ * the part used from the start only; the room behind it gets thp.
+ */
+
+enum {
+    BAT_PAGES_AUTO = 0,
+    BAT_PAGES_OFF,
+    BAT_PAGES_THP,
+    BAT_PAGES_HUGETLB
+};
+
+/* Alignment of every allocation (one cache line). */
+#define BAT_ARENA_ALIGN 64
+
+typedef struct {
+    unsigned char *base;   /* start of the mapping */
+    size_t size;           /* usable bytes */
+    size_t used;           /* bytes handed out so far */
+    size_t map_size;       /* bytes mapped (for munmap) */
+    void  *map_base;       /* address returned by mmap */
+    int    pages;          /* BAT_PAGES_* actually in use (OFF, THP or HUGETLB) */
+    size_t huge_size;      /* HUGETLB: bytes on explicit huge pages (the rest is thp) */
+} BatArena;
+
+/* Maps "auto" / "off" / "thp" / "hugetlb" to BAT_PAGES_*, or -1. */
+int bat_pages_from_name(const char *name);
+const char *bat_pages_name(int pages);
+
+/* Bytes taken from an arena by an allocation of `bytes` (alignment included). */
+size_t bat_arena_need(size_t bytes);
+
+/*
+ * Maps an arena of at least `size` bytes.
+ * Returns 0 on success, -1 on error (the reason is printed); `hugetlb`
+ * fails if no huge page is available, `auto` falls back to thp.
+ */
+int bat_arena_create(BatArena *a, size_t size, int pages);
+
+/*
+ * Same as bat_arena_create(), but in `auto` mode only the first `hot`
+ * bytes (rounded up to a huge page) are backed by explicit huge pages and
+ * the rest of the arena by transparent ones (thp for all of it if no
+ * huge page is free).
+ */
+int bat_arena_create_hot(BatArena *a, size_t size, size_t hot, int pages);
+
+/* Carves `bytes` (BAT_ARENA_ALIGN-aligned) out of the arena, or NULL if full. */
+void *bat_arena_alloc(BatArena *a, size_t bytes);
+
+/* Scratch scopes: everything allocated after `mark` is released at once. */
+size_t bat_arena_mark(const BatArena *a);
+void bat_arena_release(BatArena *a, size_t mark);
+
+/* Unmaps the arena. */
+void bat_arena_destroy(BatArena *a);
+
+/* Appends the arena size and page kind to the current BENCH line. */
+void bat_arena_print_bench(const BatArena *a);
+
+#endif
@@ -0,0 +1,91 @@
+#ifndef BAT_BIND_H
+#define BAT_BIND_H
+
+/*
+ * bat_bind.h
+ *
+ * Thread / rank placement (--bind compact|spread|numa) and its report.
+ *
+ * Without --bind, threads and ranks run wherever OMP_PROC_BIND,
+ * OMP_PLACES, the MPI launcher or the scheduler put them, and timings of
+ * runs with the same thread count can differ a lot (two threads sharing
+ * one physical core, ranks crossing sockets...). --bind pins every thread
+ * (OpenMP) or rank (MPI, per host) with sched_setaffinity, from the CPU
+ * topology in /sys/devices/system/cpu:
+ *
+ * - compact : consecutive slots on the same core / socket (SMT siblings
+ *             are filled before the next core)
+ * - spread  : slots evenly spaced over the physical cores (one hardware
+ *             thread per core before any SMT sibling is used)
+ * - numa    : slot k may run on any CPU of NUMA node k % n_nodes
+ *
+ * Only the CPUs the process may use (its affinity mask at startup) are
+ * considered; MPI ranks should be started with `mpiexec --bind-to none`
+ * so that every rank sees the CPUs of the whole host.
+ *
+ * Whatever the binding, the CPU each thread / rank runs on is recorded
+ * and appended to the BENCH line (cpu_map, physical cores, SMT sharing).
+ */
+
+enum {
+    BAT_BIND_NONE = 0,
+    BAT_BIND_COMPACT,
+    BAT_BIND_SPREAD,
+    BAT_BIND_NUMA
+};
+
+#define BAT_BIND_MAX_CPUS 1024
+
+typedef struct {
+    int id;        /* logical CPU number */
+    int node;      /* NUMA node */
+    int package;   /* socket */
+    int core;      /* core id within the socket */
+    int smt;       /* rank of this CPU among the hardware threads of its core */
+} BatCpu;
+
+typedef struct {
+    int    n;                         /* usable CPUs, sorted by (node, package, core, smt) */
+    int    n_nodes;                   /* NUMA nodes among them */
+    BatCpu cpu[BAT_BIND_MAX_CPUS];
+} BatTopology;
+
+/* Where one thread / rank runs (5 ints, gathered as MPI_INT by the MPI front-end). */
+typedef struct {
+    int host;      /* host id (MPI: world rank of the first rank on the host) */
+    int cpu;       /* CPU it was running on when sampled */
+    int node;
+    int package;
+    int core;
+} BatBindSlot;
+
+/* Maps "none" / "compact" / "spread" / "numa" to BAT_BIND_*, or -1. */
+int bat_bind_from_name(const char *name);
+const char *bat_bind_name(int kind);
+
+/*
+ * Reads the topology of the CPUs in the affinity mask of the calling
+ * thread. Must be called before any thread is pinned.
+ * Returns 0 on success, -1 on error (the reason is printed).
+ */
+int bat_topology_load(BatTopology *topo);
+
+/*
+ * Pins the calling thread for slot `slot` of `n_slots` (thread number or
+ * rank on the host). Returns 0 on success, -1 on error (printed).
+ */
+int bat_bind_self(const BatTopology *topo, int kind, int slot, int n_slots);
+
+/* Records where the calling thread runs now. */
+void bat_bind_where(const BatTopology *topo, int host, BatBindSlot *slot);
+
+/*
+ * Appends the placement to the current BENCH line:
+ * bind=<kind> cpu_map=<cpu of slot 0>,<cpu of slot 1>,... cores=<physical
+ * cores used> smt_shared=<slots sharing a core with another slot>
+ * nodes=<NUMA nodes used>. Hosts other than the first are prefixed
+ * with "h<host>:" in cpu_map.
+ */
+void bat_bind_print_bench(int kind, const BatBindSlot slots[], int n);
+
+#endif
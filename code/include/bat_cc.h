@@ -0,0 +1,146 @@
+#ifndef BAT_CC_H
+#define BAT_CC_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "bat.h"
+#include "bat_arena.h"
+#include "bat_hd.h"
+#include "bat_options.h"
+
+/*
+ * bat_cc.h
+ *
+ * Cooperative coevolution (--cc random|diff, with --dim).
+ *
+ * With thousands of coordinates a single swarm moving every coordinate at
+ * once improves slowly: a candidate that gets most coordinates better is
+ * rejected because of the few it gets worse. Cooperative coevolution
+ * splits the coordinates into groups and gives every group a sub-swarm of
+ * its own. A sub-swarm bat holds the group's coordinates only; it is
+ * evaluated on the context vector (the best full position found so far)
+ * with the group's coordinates replaced by its own.
+ *
+ * Decompositions:
+ *   random : the coordinates are shuffled into groups of --cc-size at
+ *            every round (random grouping, so interacting coordinates end
+ *            up together now and then)
+ *   diff   : recursive differential grouping at startup: coordinate sets
+ *            X1 and X2 interact if moving X2 changes the effect of moving
+ *            X1 on the objective. Interacting coordinates are kept in one
+ *            group; separable ones are packed into groups of --cc-size.
+ *            The probes are objective evaluations and are counted.
+ *
+ * A run is a sequence of rounds of --cc-iters iterations:
+ *   regroup : new decomposition (random), or the startup one (diff)
+ *   pack    : the population rows (BatHdPop) are copied into one block per
+ *             group, each a contiguous n_bats x group-size matrix
+ *   groups  : every sub-swarm re-evaluates its bats on the current
+ *             context, then runs the iterations; an iteration updates each
+ *             bat as update_bat() does, with the best of the sub-swarm as
+ *             guide and the mean loudness of the sub-swarm
+ *   unpack  : the blocks are copied back into the rows
+ *   merge   : in group order, the best of every sub-swarm replaces its
+ *             coordinates in the context if that improves the context
+ *             (one full evaluation per improved group)
+ * The sub-swarms of a round only read the context, and each draws from
+ * the RNG streams of its own bats: they run in any order or concurrently
+ * (threads, or ranks that exchange the blocks before unpacking) with the
+ * same result.
+ *
+ * A sub-swarm evaluation does not recompute the whole objective: the
+ * terms of the coordinates outside the group are summed once per round
+ * (rest), so a candidate only costs its group's terms. Rosenbrock terms
+ * join neighbouring coordinates: a group also owns the pairs it touches,
+ * the other coordinate coming from the context.
+ *
+ * Built-in objectives only (no --transform, no --objective-expr), and no
+ * --hd-slices: the MPI back-end distributes groups, not slices.
+ */
+
+/* Default coordinates per group (--cc-size) and iterations per round (--cc-iters). */
+#define BAT_CC_SIZE  10
+#define BAT_CC_ITERS 10
+
+enum {
+    BAT_CC_NONE = 0,
+    BAT_CC_RANDOM,   /* random grouping, new every round */
+    BAT_CC_DIFF      /* recursive differential grouping, once */
+};
+
+typedef struct {
+    int kind;          /* BAT_CC_RANDOM / BAT_CC_DIFF */
+    int dim;
+    int n_bats;        /* bats per sub-swarm */
+    int size;          /* --cc-size */
+    int n_groups;
+    int max_groups;    /* ceil(dim / size): room reserved for the groups */
+    uint32_t seed;
+    int *perm;         /* coordinate at position p; group g is positions [start[g], start[g + 1]) */
+    int *start;        /* max_groups + 1 */
+    int *group;        /* group of coordinate d */
+    bat_real *xb;      /* blocks: group g at n_bats * start[g], one row of its size per bat */
+    bat_real *vb;
+    BatHdBat *bat;     /* scalar state of the sub-swarms: bat i of group g at g * n_bats + i */
+    bat_real *guide;   /* best position of every sub-swarm, group g at start[g] */
+    double *guide_f;   /* its value */
+    double *base_f;    /* value of the context on each group at the start of the round */
+    long dg_evals;     /* evaluations spent by the differential grouping */
+    int dg_nonsep;     /* coordinates found in non-separable groups */
+} BatCc;
+
+/* Per-worker scratch of the sub-swarm rounds. */
+typedef struct {
+    double *work;      /* the context (double), with the evaluated group written in */
+    int *terms;        /* terms of the objective touched by the current group */
+    int n_terms;
+    double rest[2];    /* partial sums of the other terms */
+    bat_real *cand;    /* candidate and local walk of one bat */
+    bat_real *walk;
+    int *list;         /* differential grouping: coordinate sets */
+} BatCcScratch;
+
+/* Maps "none" / "random" / "diff" to BAT_CC_*, or -1. */
+int bat_cc_from_name(const char *name);
+const char *bat_cc_name(int kind);
+
+/* Rejects the options the mode does not implement (prints the reason). */
+int bat_cc_check(const BatOptions *opts);
+
+/* Arena bytes of the sub-swarms / of one scratch. */
+size_t bat_cc_bytes(int dim, int n_bats, int size);
+size_t bat_cc_scratch_bytes(int dim);
+
+/* Carves the sub-swarms / a scratch out of an arena sized with the functions above. */
+int bat_cc_create(BatCc *cc, BatArena *arena, int kind, int dim, int n_bats, int size, uint32_t seed);
+int bat_cc_scratch_create(BatCcScratch *s, BatArena *arena, const BatCc *cc);
+
+/*
+ * Decomposition of round `round` (see above). Returns the evaluations
+ * spent (differential grouping, first round only).
+ */
+long bat_cc_regroup(BatCc *cc, BatCcScratch *s, int round);
+
+/* Copies bats [first, first + count) between their rows and the group blocks. */
+void bat_cc_pack(BatCc *cc, const BatHdPop *pop, int first, int count);
+void bat_cc_unpack(const BatCc *cc, BatHdPop *pop, int first, int count);
+
+/*
+ * Round of sub-swarm g: iterations [t, t + iters) against the context
+ * pop->best_x (read-only). Only the block, bats and guide of group g are
+ * written. Returns the number of evaluations.
+ */
+long bat_cc_run_group(BatCc *cc, const BatHdPop *pop, BatCcScratch *s, int g, int t, int iters, BatCounters *cnt);
+
+/*
+ * Merges the guides into the context (pop->best_x / best_f), in group
+ * order. Returns the number of evaluations; cnt->best_changes counts the
+ * improved rounds.
+ */
+long bat_cc_merge(const BatCc *cc, BatHdPop *pop, BatCcScratch *s, BatCounters *cnt);
+
+/* Appends dim / hd_mode=cc / decomposition / groups to the current BENCH line. */
+void bat_cc_print_bench(const BatCc *cc, int iters);
+
+#endif
@@ -0,0 +1,60 @@
+#ifndef BAT_CLI_H
+#define BAT_CLI_H
+
+#include "bat_options.h"
+
+/*
+ * bat_cli.h
+ *
+ * Command line and entry points of the back-ends.
+ *
+ * The sequential, OpenMP and MPI programs share one parser for their
+ * basic options (bat_args_parse); everything else goes to
+ * bat_options_parse(). Each back-end is a function, called either by the
+ * main() of its own program (sequential, openmp_bat, mpi_bat) or by the
+ * unified `bat` driver, which selects it at runtime with --backend
+ * (see src/bat.c). The back-end sources are compiled a second time with
+ * -DBAT_NO_MAIN for the unified driver.
+ */
+
+enum {
+    BAT_BACKEND_AUTO = 0,
+    BAT_BACKEND_SEQ,
+    BAT_BACKEND_OMP,
+    BAT_BACKEND_MPI
+};
+
+typedef struct {
+    int          n_bats;      /* --n-bats <n> */
+    int          max_iters;   /* --iters <n> */
+    unsigned int seed;        /* --seed <s> (default: current time) */
+    int          do_snapshot; /* 0 with --no-snapshot (sequential back-end only) */
+    int          quiet;       /* --quiet */
+    int          autotune;    /* --autotune (OpenMP back-end only) */
+    const char  *tune_cache;  /* --tune-cache <file> */
+    int          backend;     /* --backend seq|omp|mpi|auto (BAT_BACKEND_*, -1 = invalid; `bat` only) */
+    BatOptions   opts;        /* shared options (bat_options.h) */
+    const char  *bench_extra; /* appended to the BENCH line as is (NULL = nothing; set by `bat`) */
+} BatArgs;
+
+/* Maps "auto" / "seq" / "omp" / "mpi" to BAT_BACKEND_*, or -1. */
+int bat_backend_from_name(const char *name);
+const char *bat_backend_name(int backend);
+
+/*
+ * Fills `args` from the command line (defaults first). Options that none
+ * of the parsers know are ignored, as before.
+ */
+void bat_args_parse(BatArgs *args, int argc, char **argv);
+
+/*
+ * Back-end entry points. Each one checks the options, runs the
+ * optimization and prints the BENCH line; it returns the process exit
+ * status. bat_run_mpi() expects MPI to be initialized (and leaves it
+ * initialized).
+ */
+int bat_run_sequential(const BatArgs *args);
+int bat_run_openmp(const BatArgs *args);
+int bat_run_mpi(const BatArgs *args);
+
+#endif
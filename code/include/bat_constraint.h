@@ -0,0 +1,171 @@
+#ifndef BAT_CONSTRAINT_H
+#define BAT_CONSTRAINT_H
+
+#include "bat.h"
+#include "bat_xsum.h"
+
+/*
+ * bat_constraint.h
+ *
+ * Inequality constraints g_k(x) <= 0 (--constraint "<expr>", repeatable;
+ * 2-D engine only).
+ *
+ * The core only knows the box [Lb, Ub]. Real problems often add
+ * constraints that are cheap to evaluate next to an expensive objective:
+ * the constraints of a candidate are evaluated first, and the objective
+ * only when the candidate can still be accepted.
+ *
+ * Constraints are batch functions: one call evaluates a constraint on
+ * several candidates (rows of doubles), like the interpreter of the
+ * objective expressions. --constraint compiles an expression of the
+ * bat_expr.h language (g_k is the value; x[1] + x[2] - 1 means
+ * x1 + x2 <= 1); C code can add any function with bat_con_add_batch().
+ *
+ * The violation of a point is v = sum_k max(0, g_k(x)). The value the
+ * swarm maximizes (Bat.f_value, called the rank below) depends on
+ * --con-mode:
+ *   deb     : Deb's feasibility rules. A feasible point beats an
+ *             infeasible one, two feasible points compare by objective,
+ *             two infeasible ones by violation. rank = f if v = 0, else
+ *             BAT_CON_INFEASIBLE * (1 + v).
+ *   eps     : epsilon-constraint method (Takahama & Sakai). As deb, with
+ *             points of violation <= eps counted as feasible. eps starts
+ *             from the mean violation of the initial population (or
+ *             --con-eps) and decreases as eps0 * (1 - t / Tc)^cp until
+ *             Tc = BAT_CON_EPS_FRAC * iters, then stays 0.
+ *   penalty : adaptive penalty (Hadj-Alouane & Bean). rank = f - lambda v;
+ *             lambda (--con-penalty at start) is divided by
+ *             BAT_CON_PEN_DOWN when the best bat was feasible for the last
+ *             BAT_CON_PEN_K iterations, and multiplied by BAT_CON_PEN_UP
+ *             when it was infeasible for all of them, within a factor
+ *             BAT_CON_PEN_RANGE of its initial value (a best bat that
+ *             only approaches the boundary from outside would otherwise
+ *             grow it without end).
+ * eps and lambda change between iterations only: the front-ends then
+ * re-rank the population and the archived best (bat_con_advance()).
+ *
+ * Screening (bat_con_screen()): a candidate is only worth an objective
+ * evaluation if it can beat the bat it would replace. Under deb/eps the
+ * rank of a candidate with v > eps does not depend on the objective at
+ * all; otherwise f <= f_bound (the known optimum of a built-in objective)
+ * bounds the rank, and the candidate is rejected when the bound does not
+ * beat the bat. The update then draws the same random numbers and accepts
+ * the same moves as with every objective evaluated: the saved evaluations
+ * are reported (obj_skipped=) next to the constraint evaluations
+ * (con_evals=).
+ */
+
+/* Maximum number of constraints. */
+#define BAT_CON_MAX 8
+
+/* Rank scale of infeasible points (deb / eps): below any objective value. */
+#define BAT_CON_INFEASIBLE (-1e100)
+
+/* Epsilon schedule: Tc = BAT_CON_EPS_FRAC * iters, exponent cp. */
+#define BAT_CON_EPS_FRAC 0.2
+#define BAT_CON_EPS_CP   5.0
+
+/* Penalty adaptation: window, decrease and increase factors. */
+#define BAT_CON_PEN_K     5
+#define BAT_CON_PEN_DOWN  2.0
+#define BAT_CON_PEN_UP    1.5
+#define BAT_CON_PEN_RANGE 1e6
+
+enum {
+    BAT_CON_DEB = 0,
+    BAT_CON_EPS,
+    BAT_CON_PENALTY
+};
+
+/* Command-line settings (part of BatOptions). */
+typedef struct {
+    int n;                           /* --constraint expressions (-1 = more than BAT_CON_MAX) */
+    const char *expr[BAT_CON_MAX];
+    int mode;                        /* --con-mode deb|eps|penalty (BAT_CON_*, -1 = invalid) */
+    double eps;                      /* --con-eps: initial epsilon level (< 0 = from the population) */
+    double penalty;                  /* --con-penalty: initial penalty weight */
+} BatConOptions;
+
+/*
+ * Batch constraint: out[c] = g(row c) for the `count` rows at rows + c * ld.
+ * ctx is the pointer given to bat_con_add_batch().
+ */
+typedef void (*BatConFn)(const void *ctx, const double *rows, int ld, int count, double out[]);
+
+/* Constraints of the run and state of the feasibility rule. */
+typedef struct {
+    int n;                           /* 0 = unconstrained run */
+    BatConFn fn[BAT_CON_MAX];
+    const void *ctx[BAT_CON_MAX];
+    int mode;                        /* BAT_CON_* */
+    double eps0;                     /* initial epsilon level (< 0 until bat_con_start()) */
+    double eps;                      /* current level (0 under deb and penalty) */
+    int eps_iters;                   /* Tc */
+    double lambda0;                  /* initial penalty weight */
+    double lambda;                   /* current penalty weight */
+    int feas_run;                    /* consecutive iterations with a feasible / infeasible best */
+    int infeas_run;
+    double f_bound;                  /* upper bound of the objective (+inf if unknown) */
+} BatConstraints;
+
+/* Constraints used by the core (set up before the optimization starts). */
+extern BatConstraints bat_con;
+
+/* Maps "deb" / "eps" / "penalty" to BAT_CON_*, or -1. */
+int bat_con_from_name(const char *name);
+const char *bat_con_name(int mode);
+
+/* Checks the settings and compiles the expressions (prints the problem, returns -1). */
+int bat_con_check(const BatConOptions *o);
+
+/*
+ * Installs the constraints of `o` and the feasibility rule (objective =
+ * BAT_OBJ_* in use, for the objective bound). Nothing is installed
+ * without --constraint.
+ */
+void bat_con_install(const BatConOptions *o, int objective);
+
+/* Adds a batch constraint. Returns -1 if BAT_CON_MAX are already installed. */
+int bat_con_add_batch(BatConFn fn, const void *ctx);
+
+/* Violations of `count` points (rows of dimension doubles, stride ld). */
+void bat_con_violation(const double *rows, int ld, int count, double v[]);
+
+/* Rank of a point of objective f and violation v under the current rule. */
+double bat_con_rank(double f, double v);
+
+/*
+ * Returns 1 if a candidate of violation v cannot beat a bat of rank
+ * `current` whatever its objective, or has a rank independent of it; the
+ * objective is then not needed and *rank receives the exact rank, or
+ * -INFINITY (rejected).
+ */
+int bat_con_screen(double v, double current, double *rank);
+
+/* Violation and rank of a stored point of objective f (initialization). */
+double bat_con_point(const bat_real x[], double f, double *viol);
+
+/* Exact sum of the violations of bats[0..n_bats). */
+void bat_con_violation_sum(const Bat bats[], int n_bats, BatExactSum *sum);
+
+/*
+ * Start of the run: the epsilon level from the summed violations of the
+ * n_bats initial bats (all ranks), and the schedule length.
+ */
+void bat_con_start(const BatExactSum *sum, int n_bats, int max_iters);
+
+/*
+ * Epsilon level / penalty weight of iteration t, given the best bat after
+ * iteration t - 1. Returns 1 if the ranks changed: the caller then calls
+ * bat_con_rerank() on its bats and archived best, and selects the best
+ * again.
+ */
+int bat_con_advance(int t, const Bat *best);
+
+/* Recomputes f_value from f_obj and viol. */
+void bat_con_rerank(Bat bats[], int n_bats);
+
+/* Appends the rule, its final state and the best bat's objective / violation to the current BENCH line. */
+void bat_con_print_bench(const Bat *best);
+
+#endif
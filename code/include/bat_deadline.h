@@ -0,0 +1,52 @@
+#ifndef BAT_DEADLINE_H
+#define BAT_DEADLINE_H
+
+/*
+ * bat_deadline.h
+ *
+ * Deadline-aware scheduling (--deadline <ms>).
+ *
+ * Instead of a fixed iteration count, the run gets a wall-clock budget.
+ * The scheduler measures the cost of each iteration online and only starts
+ * a new iteration if it is predicted to finish before the deadline, so the
+ * best bat found so far is always returned on time.
+ */
+
+typedef struct {
+    double budget_s;       /* total budget (seconds) */
+    double start_s;        /* clock value when the budget started */
+    double last_s;         /* clock value at the previous check */
+    double iter_cost_s;    /* smoothed per-iteration cost (EMA) */
+    double max_cost_s;     /* slowest iteration seen so far */
+    int    iters_done;     /* completed iterations */
+    int    pred_iters;     /* predicted total number of iterations that fit */
+    double elapsed_s;      /* total time used (set by bat_deadline_finish) */
+    int    missed;         /* 1 if the budget was exceeded */
+} BatDeadline;
+
+/* Monotonic clock in seconds (same clock for all front-ends). */
+double bat_deadline_now(void);
+
+/* Starts the budget; `budget_ms` is the allowed wall-clock time. */
+void bat_deadline_start(BatDeadline *d, double budget_ms);
+
+/*
+ * Marks the start of the first iteration: the time spent since
+ * bat_deadline_start() (initialization) counts against the budget but is
+ * not taken as the cost of an iteration.
+ */
+void bat_deadline_loop_start(BatDeadline *d);
+
+/*
+ * Records the end of one iteration and returns 1 if another iteration is
+ * predicted to fit in the remaining budget, 0 otherwise.
+ */
+int bat_deadline_next(BatDeadline *d);
+
+/* Stops the clock and computes the miss flag. */
+void bat_deadline_finish(BatDeadline *d);
+
+/* Remaining (positive) or overrun (negative) budget in milliseconds. */
+double bat_deadline_slack_ms(const BatDeadline *d);
+
+#endif
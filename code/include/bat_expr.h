@@ -0,0 +1,128 @@
+#ifndef BAT_EXPR_H
+#define BAT_EXPR_H
+
+/*
+ * bat_expr.h
+ *
+ * Objective expressions (--objective-expr "<expr>"): new objectives
+ * without editing the built-in functions and rebuilding.
+ *
+ * Language (the value is maximized, like the built-in functions; write
+ * -(...) for a minimization problem):
+ *   numbers, pi, e, n (number of coordinates)
+ *   + - * / ^ (power, right-associative), unary -, parentheses
+ *   sin cos tan exp log sqrt abs tanh, min(a, b), max(a, b)
+ *   x[k]        : coordinate k (1-based, constant k)
+ *   sum(e), prod(e) : e over every coordinate, where e may use
+ *       x  : the coordinate, i : its index (1-based)
+ *       xn : the next coordinate (the reduction then stops at n - 1)
+ *   Reductions cannot be nested.
+ *
+ * Examples:
+ *   rastrigin  : -(10*n + sum(x^2 - 10*cos(2*pi*x)))
+ *   griewank   : -(1 + sum(x^2)/4000 - prod(cos(x/sqrt(i))))
+ *   rosenbrock : -sum(100*(xn - x^2)^2 + (1 - x)^2)
+ *
+ * The text is parsed into a tree, constant-folded (n is known when the
+ * program is compiled, so n-only subexpressions fold too; small integer
+ * powers become multiplications) and compiled to a register bytecode.
+ * Constants live in a pool of their own; an instruction loads one into an
+ * ordinary register where it is first needed (before the loop for a
+ * reduction body), and the register is reused after its last use.
+ *
+ * The interpreter (bat_kernels.expr, one variant per ISA) runs a batch of
+ * candidates in BAT_EXPR_LANES lanes, and a reduction body on
+ * BAT_EXPR_CHUNK coordinates of every lane at once: every instruction is
+ * a vector loop over up to BAT_EXPR_LANES x BAT_EXPR_CHUNK values, so the
+ * cost of decoding it is shared by all of them. Lanes never interact and
+ * the terms of a reduction are accumulated in coordinate order: a
+ * candidate gets the same value in any batch. On the 2-D engine
+ * -sum(x^2) gives the built-in sphere bitwise; the --dim engine adds the
+ * built-in functions tile by tile (bat_hd.h), so there the two may differ
+ * in the last bits.
+ *
+ * Values outside the domain (sqrt(-1), log(0), overflow) would reach the
+ * best-bat comparisons as NaN, which no `>` ever replaces. The interpreter
+ * returns -INFINITY instead of any NaN or infinite value, the worst value
+ * of a maximized objective (prog.nonfinite; constraints use +INFINITY, a
+ * violated constraint).
+ */
+
+/* Candidates evaluated together by one pass over the bytecode. */
+#define BAT_EXPR_LANES 8
+/* Coordinates of every candidate processed together by a reduction body. */
+#define BAT_EXPR_CHUNK 8
+/* Limits of a compiled program. */
+#define BAT_EXPR_MAX_INS    256
+#define BAT_EXPR_MAX_REGS   64
+#define BAT_EXPR_MAX_RED    16
+#define BAT_EXPR_MAX_CONSTS 128
+#define BAT_EXPR_MAX_TEXT   1024
+
+/* Registers with a fixed meaning inside reductions. */
+enum {
+    BAT_EXPR_REG_X = 0,
+    BAT_EXPR_REG_XN,
+    BAT_EXPR_REG_I,
+    BAT_EXPR_REG_FIRST     /* first allocatable register */
+};
+
+enum {
+    BAT_EXPR_ADD = 0, BAT_EXPR_SUB, BAT_EXPR_MUL, BAT_EXPR_DIV, BAT_EXPR_POW,
+    BAT_EXPR_MIN, BAT_EXPR_MAX, BAT_EXPR_NEG,
+    BAT_EXPR_SIN, BAT_EXPR_COS, BAT_EXPR_TAN, BAT_EXPR_EXP, BAT_EXPR_LOG,
+    BAT_EXPR_SQRT, BAT_EXPR_ABS, BAT_EXPR_TANH,
+    BAT_EXPR_COORD,        /* dst = x[arg] */
+    BAT_EXPR_CONST,        /* dst = const_val[arg] */
+    BAT_EXPR_SUM,          /* dst = reduction arg (see BatExprRed) */
+    BAT_EXPR_PROD,
+    BAT_EXPR_OP_COUNT
+};
+
+typedef struct {
+    int op;
+    int dst;
+    int a, b;              /* operand registers */
+    int arg;               /* coordinate (BAT_EXPR_COORD), constant (BAT_EXPR_CONST) or reduction index */
+} BatExprIns;
+
+/* Body of a reduction: instructions [start, end), value in register `result`. */
+typedef struct {
+    int start, end;
+    int result;
+    int pairs;             /* 1 if the body reads xn */
+    int index;             /* 1 if the body reads i */
+} BatExprRed;
+
+typedef struct {
+    int n;                 /* coordinates the program was compiled for */
+    int n_ins;
+    int main_end;          /* the program is [0, main_end); reduction bodies follow */
+    int result;            /* register holding the value */
+    int n_regs;
+    int n_consts;
+    int n_red;
+    double nonfinite;      /* value returned instead of NaN / +-inf (-INFINITY unless changed) */
+    BatExprIns ins[BAT_EXPR_MAX_INS];
+    BatExprRed red[BAT_EXPR_MAX_RED];
+    double const_val[BAT_EXPR_MAX_CONSTS];
+} BatExprProg;
+
+/*
+ * Compiles `text` for points of n coordinates.
+ * Returns 0 on success, -1 on error (the reason and position are printed).
+ */
+int bat_expr_compile(BatExprProg *prog, const char *text, int n);
+
+/*
+ * Program used by --objective-expr (BAT_OBJ_EXPR): compiled once at
+ * startup, then read-only.
+ */
+int bat_expr_install(const char *text, int n);
+const BatExprProg *bat_expr_current(void);
+
+/* Value of one point / of `count` points stored as rows of `ld` doubles. */
+double bat_expr_eval(const double x[]);
+void bat_expr_eval_rows(const double *rows, int ld, int count, double out[]);
+
+#endif
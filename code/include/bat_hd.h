@@ -0,0 +1,208 @@
+#ifndef BAT_HD_H
+#define BAT_HD_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "bat.h"
+#include "bat_arena.h"
+#include "bat_options.h"
+#include "bat_transform.h"
+
+/*
+ * bat_hd.h
+ *
+ * High-dimensional engine (--dim <n>).
+ *
+ * Bat holds its `dimension` (2) coordinates inline. With 10^4-10^6
+ * coordinates a bat's x_i / v_i no longer fit in L1, and updating bats one
+ * at a time streams the whole best position from memory once per bat.
+ * This engine takes the dimension at runtime and stores positions and
+ * velocities as rows of `stride` coordinates (one row per bat); the
+ * scalar state of each bat lives in a separate array.
+ *
+ * One update is split in four phases:
+ *   begin  : per-bat draws (frequency, local-walk decision)
+ *   tile   : velocity of BAT_HD_TILE coordinates and the partial objective
+ *            sums of the candidate and local walk on that tile, in one pass
+ *   finish : partial sums combined in tile order, acceptance test
+ *   commit : rebuilds an accepted candidate tile by tile
+ * Candidates are never stored: the global move is recomputed from x and
+ * the updated v, the local walk from its per-tile stream. A tile pass
+ * reads x, v and best and writes v only.
+ *
+ * A group of bats is updated tile by tile, so each tile of the best
+ * position is loaded once and reused by the whole group from cache. With
+ * fewer bats than threads, the OpenMP back-end instead splits the tiles
+ * of one bat between the threads.
+ *
+ * Every per-coordinate random number (initial position, local walk) comes
+ * from one stream per (bat, tile) keyed by the bat's own RNG, and the
+ * objective is always combined from per-tile partials in tile order: the
+ * result does not depend on the group size, the thread count or on how
+ * tiles are distributed.
+ *
+ * A population may also be a block of the problem: bats [bat0, bat0 +
+ * n_bats) restricted to tiles [tile0, tile0 + n_tiles). The MPI back-end
+ * gives one block to every rank of a grid (bat groups x dimension slices)
+ * and combines the tile partials of a bat across its grid row.
+ *
+ * With --transform (bat_transform.h) the objective of a candidate needs
+ * all its coordinates at once: the tile pass writes the candidate rows of
+ * a batch instead of partials, and the candidates of all the bats of the
+ * batch are evaluated together (bat_hd_update_group() with the whole
+ * population as its group, or the steps it is made of). An
+ * --objective-expr has no tile partials either and uses the same batches
+ * (with transform none: a zero shift), which also give its interpreter
+ * full lane blocks.
+ *
+ * Options that work on Bat records (--adapt, --init, --obl, --refine,
+ * --restart, --shrink, --trace, --final-pop, --targets, --deadline) are
+ * rejected with --dim.
+ */
+
+/* Coordinates per tile (2 KB of doubles). Part of the RNG stream layout. */
+#define BAT_HD_TILE  256
+/* Default bats per group (--hd-group). */
+#define BAT_HD_GROUP 4
+/*
+ * Values kept per tile and candidate: the partial sum(s) of the objective
+ * and the first / last coordinate (Rosenbrock terms across tiles).
+ */
+#define BAT_HD_PARTS 4
+
+/* Scalar state of one bat (its coordinates are rows of BatHdPop). */
+typedef struct {
+    double f_i;
+    double A_i;
+    double r_i;
+    double f_value;
+    uint32_t rng_state;
+} BatHdBat;
+
+typedef struct {
+    int n_bats;
+    int bat0;          /* global index of the first bat */
+    int dim;           /* coordinates of the problem */
+    int tile0;         /* first tile held */
+    int n_tiles;       /* tiles held */
+    int d_lo;          /* first coordinate held (tile0 * BAT_HD_TILE) */
+    int stride;        /* coordinates per row (held coordinates rounded up to a cache line) */
+    bat_real *x;       /* n_bats rows */
+    bat_real *v;       /* n_bats rows */
+    BatHdBat *bat;
+    bat_real *best_x;  /* copy of the best bat's row */
+    double best_f;
+    int best_i;        /* global index of the best bat */
+    BatTransform *tf;  /* --transform: batch evaluation of the candidates (NULL = built-in objective) */
+} BatHdPop;
+
+/* State of one bat between the phases of its update. */
+typedef struct {
+    int bat;           /* index of the bat */
+    int walk;          /* 1 if the local walk is tried this update */
+    uint32_t key;      /* key of the per-tile local-walk streams */
+    int accept;        /* 0 = rejected, 1 = candidate, 2 = local walk */
+    double A_mean;     /* loudness scale of the local walk */
+    int walk_row;      /* batch row of the local walk (--transform; the candidate is row k) */
+} BatHdSlot;
+
+/* Per-worker scratch: room for `slots` bats updated together. */
+typedef struct {
+    int slots;
+    double *part;      /* slots x 2 candidates x n_tiles x BAT_HD_PARTS */
+    BatHdSlot *slot;
+} BatHdScratch;
+
+/* Rejects the options the engine does not implement (prints the reason). */
+int bat_hd_check(const BatOptions *opts);
+
+/* 1 if the candidates are evaluated in batches (--transform or --objective-expr, see below). */
+int bat_hd_batched(const BatOptions *opts);
+
+/* Tiles of a dim-coordinate problem, and the coordinates [lo, hi) of tiles [tile0, tile0 + n_tiles). */
+int bat_hd_tile_count(int dim);
+void bat_hd_tile_range(int dim, int tile0, int n_tiles, int *lo, int *hi);
+
+/* Arena bytes of a population (rows of `coords` coordinates) / of a scratch with `slots` slots. */
+size_t bat_hd_pop_bytes(int n_bats, int coords);
+size_t bat_hd_scratch_bytes(int n_tiles, int slots);
+
+/*
+ * Carve a population (whole problem, or a block, see above) / scratch out
+ * of an arena sized with the functions above. A transformed objective is
+ * attached afterwards by setting pop->tf.
+ */
+int bat_hd_pop_create(BatHdPop *pop, BatArena *arena, int n_bats, int dim);
+int bat_hd_pop_create_block(BatHdPop *pop, BatArena *arena, int bat0, int n_bats, int dim, int tile0, int n_tiles);
+int bat_hd_scratch_create(BatHdScratch *s, BatArena *arena, const BatHdPop *pop, int slots);
+
+/*
+ * Initial position (uniform in [Lb, Ub]) and parameters of local bat i.
+ * f_value is only set when the population holds every tile; a block
+ * combines bat_hd_row_parts() across its grid row instead, and a
+ * transformed objective evaluates every bat at once with
+ * bat_hd_eval_init() (the batch must have room for n_bats rows).
+ */
+void bat_hd_init_bat(BatHdPop *pop, int i, uint32_t seed);
+void bat_hd_row_parts(const BatHdPop *pop, int i, int id, double parts[]);
+void bat_hd_eval_init(BatHdPop *pop);
+
+/*
+ * Objective as per-tile partials: bat_hd_partial() for every tile, the
+ * first one copied to an accumulator and the others appended to it with
+ * bat_hd_combine() in tile order, then bat_hd_value(). bat_hd_objective()
+ * does the three on a whole row.
+ */
+void bat_hd_partial(int id, const bat_real x[], int d0, int d1, double part[BAT_HD_PARTS]);   /* x[0] = coordinate d0 */
+void bat_hd_combine(int id, double acc[BAT_HD_PARTS], const double part[BAT_HD_PARTS]);
+double bat_hd_value(int id, const double acc[BAT_HD_PARTS], int dim);
+double bat_hd_objective(int id, const bat_real x[], int dim);
+
+/*
+ * Update phases of local bat i in scratch slot k (see above); `tile` is a
+ * local tile index (0 .. n_tiles-1). bat_hd_finish() needs every tile: a
+ * block computes the candidate values from the gathered partials (see
+ * bat_hd_slot_parts()) and calls bat_hd_accept().
+ */
+void bat_hd_begin(BatHdPop *pop, BatHdScratch *s, int k, int i, double A_mean);
+void bat_hd_tile(BatHdPop *pop, BatHdScratch *s, int k, int tile, BatCounters *cnt);
+int  bat_hd_finish(BatHdPop *pop, BatHdScratch *s, int k, int t, BatCounters *cnt);
+int  bat_hd_accept(BatHdPop *pop, BatHdScratch *s, int k, int t, double F_move, double F_walk, BatCounters *cnt);
+void bat_hd_commit(BatHdPop *pop, const BatHdScratch *s, int k, int tile);
+
+/*
+ * Batch steps of a transformed objective, for slots [0, count):
+ * bat_hd_batch_rows() numbers the rows after bat_hd_begin() (candidate of
+ * slot k = row k, then the local walks) and returns the row count; after
+ * the tile passes and bat_transform_eval() (or its panel / value steps),
+ * bat_hd_accept_batch() runs the acceptance test of slot k from the
+ * values of its rows. bat_hd_finish() does not apply.
+ */
+int bat_hd_batch_rows(BatHdScratch *s, int count);
+int bat_hd_accept_batch(BatHdPop *pop, BatHdScratch *s, int k, int t, BatCounters *cnt);
+
+/* Partials of the held tiles of slot k, candidate c (0 = global move, 1 = local walk). */
+double *bat_hd_slot_parts(const BatHdPop *pop, const BatHdScratch *s, int k, int c);
+
+/*
+ * Updates bats [first, first + count) tile by tile (count <= s->slots).
+ * Returns the number of objective evaluations.
+ */
+int bat_hd_update_group(BatHdPop *pop, BatHdScratch *s, int first, int count, double A_mean, int t,
+                        BatCounters *cnt);
+
+/* Average loudness (exact sum, as bat_mean_loudness()). */
+double bat_hd_mean_loudness(const BatHdPop *pop);
+
+/*
+ * Finds the best bat (lowest index on ties) and copies its row to best_x
+ * if the best value improved; an equal value keeps the current guide.
+ * Returns 1 if the best value improved.
+ */
+int bat_hd_select_best(BatHdPop *pop);
+
+/* Appends dim / tile / group / mode to the current BENCH line (not the transform). */
+void bat_hd_print_bench(const BatHdPop *pop, int group, const char *mode);
+
+#endif
@@ -0,0 +1,64 @@
+#ifndef BAT_INIT_H
+#define BAT_INIT_H
+
+#include <stdint.h>
+
+#include "bat.h"
+
+/*
+ * bat_init.h
+ *
+ * Population initialization strategies (--init, --obl).
+ *
+ * - uniform : i.i.d. uniform positions (the historical default)
+ * - sobol   : Sobol sequence with a random digital shift (scrambled by seed)
+ * - halton  : Halton sequence with a random Cranley-Patterson rotation
+ * - lhs     : Latin hypercube sampling (one bat per stratum in every dimension)
+ *
+ * With opposition-based learning (--obl) each bat also evaluates the
+ * opposite point Lb + Ub - x and keeps the better of the two.
+ *
+ * Every strategy is index-addressable: bat i can be generated without
+ * generating bats 0..i-1, so the population can be built in parallel
+ * (OpenMP threads, or each MPI rank building its own slice), and the result
+ * only depends on (strategy, seed, n_bats).
+ */
+
+enum {
+    BAT_INIT_UNIFORM = 0,
+    BAT_INIT_SOBOL,
+    BAT_INIT_HALTON,
+    BAT_INIT_LHS
+};
+
+/* Quasi-random sequences are tabulated up to this dimension. */
+#define BAT_QMC_MAX_DIM 10
+
+typedef struct {
+    int      kind;                       /* BAT_INIT_* */
+    int      opposition;                 /* 1 = opposition-based learning */
+    int      n_bats;                     /* population size the plan was built for */
+    uint32_t seed;
+    uint32_t sobol_shift[dimension];     /* digital shift (XOR) per dimension */
+    double   halton_shift[dimension];    /* rotation in [0,1) per dimension */
+    int     *lhs_perm;                   /* dimension x n_bats stratum permutation */
+} BatInitPlan;
+
+/* Maps "uniform" / "sobol" / "halton" / "lhs" to BAT_INIT_*, or -1. */
+int bat_init_kind_from_name(const char *name);
+const char *bat_init_kind_name(int kind);
+
+/* Builds the per-seed tables of a strategy. Returns 0 on success, -1 on error. */
+int bat_init_plan_create(BatInitPlan *plan, int kind, int opposition, int n_bats, uint32_t seed);
+void bat_init_plan_free(BatInitPlan *plan);
+
+/* Fully initializes global bat `i` (RNG, position, parameters, fitness). */
+void bat_init_one(const BatInitPlan *plan, Bat *bat, int i);
+
+/* Serial initialization of the whole population + best selection. */
+void initialize_bats_plan(Bat bats[], int n_bats, Bat *best_bat, const BatInitPlan *plan);
+
+/* Copies the bat with the highest f_value into *best_bat. */
+void select_best_bat(const Bat bats[], int n_bats, Bat *best_bat);
+
+#endif
@@ -0,0 +1,93 @@
+#ifndef BAT_IO_H
+#define BAT_IO_H
+
+#include <stdio.h>
+#include <stdint.h>
+
+#include "bat.h"
+#include "bat_arena.h"
+
+/*
+ * bat_io.h
+ *
+ * Binary population format + a background writer thread.
+ *
+ * A population file is:
+ *   - one BatPopHeader
+ *   - one Bat record with the global best at dump time
+ *   - n_bats Bat records (the population, or the local slice for MPI ranks)
+ *
+ * Records are the raw in-memory Bat structs, so a file can only be read back
+ * by a build with the same `dimension` and struct layout. The header stores
+ * both values so a reader can reject incompatible files.
+ */
+
+#define BAT_POP_MAGIC   "BATPOP\0"
+#define BAT_POP_VERSION 1u
+
+typedef struct {
+    char     magic[8];     /* BAT_POP_MAGIC (including the trailing '\0') */
+    uint32_t version;      /* BAT_POP_VERSION */
+    uint32_t dim;          /* compile-time dimension of the writer */
+    uint32_t record_size;  /* sizeof(Bat) of the writer */
+    uint32_t n_bats;       /* number of population records that follow */
+    int32_t  iteration;    /* iteration index at which the state was captured */
+    uint32_t rank;         /* MPI rank of the writer (0 otherwise) */
+    uint32_t n_ranks;      /* number of MPI ranks (1 otherwise) */
+    uint32_t seed;         /* --seed of the run */
+} BatPopHeader;
+
+/* Synchronous write of a population file. Returns 0 on success, -1 on error. */
+int bat_write_population(const char *path, const Bat bats[], int n_bats, const Bat *best_bat,
+                         int iteration, uint32_t seed, int rank, int n_ranks);
+
+/*
+ * Trajectory file (--trace): one line per iteration with the iteration
+ * index, then f_value and x_i of the best bat in C99 hex-float notation
+ * ("%a"), so two traces are equal as text iff the values are bitwise equal.
+ * Used by tools/equiv_check.py to compare the back-ends.
+ */
+
+/* Opens a trace file for writing. Returns NULL (and prints why) on error. */
+FILE *bat_trace_open(const char *path);
+
+/* Appends the line of iteration t. */
+void bat_trace_write(FILE *fp, int t, const Bat *best_bat);
+
+/*
+ * Background writer: owns a spare population buffer and a thread that writes
+ * it to disk, so the optimizer only pays for one memcpy at dump time.
+ * The thread and buffer are set up before the first iteration.
+ */
+typedef struct BatDumpWriter BatDumpWriter;
+
+/*
+ * Starts an idle writer for dumps of up to `capacity` bats (the largest
+ * population of the run, see bat_options_max_bats()). The spare buffer is
+ * taken from `arena` (bat_dump_writer_bytes()), which must outlive the
+ * writer. Returns NULL on error (printed).
+ */
+BatDumpWriter *bat_dump_writer_create(BatArena *arena, int capacity);
+
+/* Arena bytes taken by bat_dump_writer_create() for `capacity` bats. */
+size_t bat_dump_writer_bytes(int capacity);
+
+/* bat_dump_writer_submit(): the previous dump is still being written. */
+#define BAT_DUMP_BUSY 1
+
+/*
+ * Queues an asynchronous dump. Returns 0 if the job was accepted, or
+ * BAT_DUMP_BUSY if the previous dump is still being written and `wait` is 0
+ * (the caller can retry at a later iteration). With `wait` set, the call
+ * waits for the previous dump instead (used by MPI so every rank captures
+ * the same iteration). Returns -1 on error (printed: no writer, more bats
+ * than the capacity); retrying does not help.
+ */
+int bat_dump_writer_submit(BatDumpWriter *w, const char *path, const Bat bats[], int n_bats,
+                           const Bat *best_bat, int iteration, uint32_t seed, int rank, int n_ranks,
+                           int wait);
+
+/* Waits for any pending dump, joins the writer thread and frees the writer (not its buffer). */
+void bat_dump_writer_destroy(BatDumpWriter *w);
+
+#endif
@@ -0,0 +1,108 @@
+#ifndef BAT_ISA_H
+#define BAT_ISA_H
+
+#include "bat.h"
+#include "bat_expr.h"
+
+/*
+ * bat_isa.h
+ *
+ * Runtime selection of the instruction-set variant of the hot kernels
+ * (--isa auto|generic|avx2|avx512).
+ *
+ * src/bat_kernels.c is compiled once per ISA (plain -O2, -mavx2 -mfma,
+ * -mavx512f ...), so one binary runs on every CPU of a mixed cluster and
+ * still uses the widest vectors the node supports. At startup the best
+ * variant supported by the CPU (cpuid) is installed in bat_kernels, unless
+ * --isa asks for a specific one. The chosen ISA is reported on the BENCH
+ * line (isa=...).
+ *
+ * The variants are only built on x86-64 (BAT_ISA_X86); elsewhere only the
+ * generic one exists.
+ */
+
+enum {
+    BAT_ISA_AUTO = -1,
+    BAT_ISA_GENERIC = 0,
+    BAT_ISA_AVX2,       /* AVX2 + FMA */
+    BAT_ISA_AVX512,     /* AVX-512 F/DQ */
+    BAT_ISA_COUNT
+};
+
+/* Engine id of the constrained update (--constraint, see bat_constraint.h). */
+#define BAT_ENGINE_CONSTRAINED (-2)
+/* Engine id of the multi-objective update (--mo-objective, see bat_mo.h). */
+#define BAT_ENGINE_MO (-3)
+
+/* Update of one bat (see update_bat() in bat.h). */
+typedef int (*BatUpdateFn)(Bat *bat, const Bat *best_bat, double A_mean, int t, BatCounters *cnt);
+
+/*
+ * Kernels currently in use (the generic ones until bat_isa_select()).
+ *
+ * `update` is the update engine of the objective in use: every built-in
+ * objective has an engine of its own with the function inlined, returned
+ * by engine(id); engine(-1) is the indirect one, which calls the objective
+ * through bat_objective_real() and works for any of them (see
+ * bat_isa_specialize()). engine(BAT_ENGINE_CONSTRAINED) screens the
+ * candidates with the constraints before calling the objective, and
+ * engine(BAT_ENGINE_MO) compares objective vectors.
+ */
+typedef struct {
+    BatUpdateFn update;
+    double (*objective)(int id, const double x[], int n);
+    void   (*gemm)(int m, int n, int k, const double *a, int lda, const double *b, int ldb, double *c, int ldc);
+    void   (*expr)(const BatExprProg *p, const double *rows, int ld, int count, double out[]);
+    BatUpdateFn (*engine)(int id);
+} BatKernels;
+
+extern BatKernels bat_kernels;
+
+/* Maps "auto" / "generic" / "avx2" / "avx512" to BAT_ISA_*, or -2. */
+int bat_isa_from_name(const char *name);
+const char *bat_isa_name(int isa);
+
+/* 1 if this binary has the variant and the CPU can run it. */
+int bat_isa_supported(int isa);
+
+/*
+ * Installs the kernels of `isa` (BAT_ISA_AUTO = best supported one).
+ * Returns the ISA in use, or -1 (nothing changed) if it is not supported.
+ */
+int bat_isa_select(int isa);
+
+/* ISA of the kernels in use. */
+int bat_isa_current(void);
+
+/*
+ * Selects the update engine of objective `id` (BAT_OBJ_*) for this and any
+ * later bat_isa_select(); -1 or BAT_OBJ_EXPR select the indirect engine
+ * (the default), BAT_ENGINE_CONSTRAINED / BAT_ENGINE_MO the constrained
+ * and multi-objective ones. `id` must be
+ * the objective installed with bat_set_objective().
+ */
+void bat_isa_specialize(int id);
+
+/* Objective of the update engine in use (-1 = indirect, BAT_ENGINE_*). */
+int bat_isa_engine(void);
+
+/* Variants compiled from bat_kernels.c (one set per ISA). */
+int    update_bat_generic(Bat *bat, const Bat *best_bat, double A_mean, int t, BatCounters *cnt);
+double bat_objective_eval_generic(int id, const double x[], int n);
+void   bat_gemm_generic(int m, int n, int k, const double *a, int lda, const double *b, int ldb, double *c, int ldc);
+void   bat_expr_run_generic(const BatExprProg *p, const double *rows, int ld, int count, double out[]);
+BatUpdateFn bat_update_engine_generic(int id);
+#ifdef BAT_ISA_X86
+int    update_bat_avx2(Bat *bat, const Bat *best_bat, double A_mean, int t, BatCounters *cnt);
+double bat_objective_eval_avx2(int id, const double x[], int n);
+void   bat_gemm_avx2(int m, int n, int k, const double *a, int lda, const double *b, int ldb, double *c, int ldc);
+void   bat_expr_run_avx2(const BatExprProg *p, const double *rows, int ld, int count, double out[]);
+BatUpdateFn bat_update_engine_avx2(int id);
+int    update_bat_avx512(Bat *bat, const Bat *best_bat, double A_mean, int t, BatCounters *cnt);
+double bat_objective_eval_avx512(int id, const double x[], int n);
+void   bat_gemm_avx512(int m, int n, int k, const double *a, int lda, const double *b, int ldb, double *c, int ldc);
+void   bat_expr_run_avx512(const BatExprProg *p, const double *rows, int ld, int count, double out[]);
+BatUpdateFn bat_update_engine_avx512(int id);
+#endif
+
+#endif
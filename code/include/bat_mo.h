@@ -0,0 +1,162 @@
+#ifndef BAT_MO_H
+#define BAT_MO_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "bat.h"
+#include "bat_arena.h"
+#include "bat_options.h"
+#include "bat_utils.h"
+
+/*
+ * bat_mo.h
+ *
+ * Multi-objective mode (--mo-objective "<expr>", 2 to BAT_MO_MAX times;
+ * 2-D engine only).
+ *
+ * Trade-off problems are usually solved by scalarizing the objectives
+ * with weights and running once per weight vector. This mode finds the
+ * whole Pareto front in one run: the objectives (all maximized) come from
+ * one vector-valued batch function, and a bounded external archive keeps
+ * the non-dominated points found so far.
+ *
+ * Iteration:
+ *   leaders : every bat draws its guide from the archive (binary
+ *             tournament on crowding distance, with the bat's own RNG):
+ *             the archive replaces best_bat, and guides spread along the
+ *             front instead of collapsing on one point
+ *   update  : the usual move and local walk; the walk replaces the
+ *             candidate if it dominates it, and the candidate is accepted
+ *             (loudness test as usual) unless the bat's point dominates it
+ *   merge   : every thread / rank filters the non-dominated points of its
+ *             own bats, the filtered sets are gathered after the archive
+ *             and the union is filtered again (bat_mo_merge()). If the
+ *             archive then exceeds its capacity (--mo-archive), the most
+ *             crowded points are dropped one at a time.
+ *
+ * Non-dominated filtering sorts the points in a canonical order (first
+ * objective descending, then the others, then the coordinates), in which
+ * a point can only be dominated by points before it. With two objectives a
+ * single sweep keeps the points whose second objective beats every
+ * earlier one (O(n log n) in all); with three, each point is compared
+ * with the kept ones only. The filtered union does not depend on how the
+ * points were split between threads or ranks, so every back-end ends with
+ * the same archive.
+ *
+ * The objective vector of a bat is Bat.f_mo; f_value holds its first
+ * objective. The BENCH line reports the archive size, the points offered
+ * to it (after the filtering of each thread / rank, so this count depends
+ * on the split) and dropped, and (two objectives) the hypervolume dominated by the
+ * archive above the worst initial value of each objective; --mo-front
+ * writes the archive as CSV.
+ */
+
+/* Default archive capacity (--mo-archive). */
+#define BAT_MO_ARCHIVE 100
+
+/*
+ * Vector-valued batch objective: out[c * BAT_MO_MAX + k] = objective k of
+ * the row c at rows + c * ld, for the `count` rows. ctx is the pointer
+ * given to bat_mo_set_batch().
+ */
+typedef void (*BatMoFn)(const void *ctx, const double *rows, int ld, int count, double out[]);
+
+/* Objectives of the run (n = 0: single-objective run). */
+typedef struct {
+    int n;
+    BatMoFn fn;
+    const void *ctx;
+} BatMoProblem;
+
+extern BatMoProblem bat_mo;
+
+/* An archive point. */
+typedef struct {
+    bat_real x[dimension];
+    double f[BAT_MO_MAX];
+    double crowd;          /* crowding distance (set by bat_mo_merge()) */
+    int fresh;             /* offered in the current merge (set by bat_mo_merge()) */
+} BatMoPoint;
+
+/*
+ * External archive. pt has room for cap + max_offers points: the offers
+ * of an iteration are written after the n archive points and merged in
+ * place.
+ */
+typedef struct {
+    int cap;
+    int max_offers;
+    int n;
+    BatMoPoint *pt;
+    BatKeyIndex *order;    /* scratch of the crowding distances */
+    double ref[BAT_MO_MAX]; /* hypervolume reference (worst initial values) */
+    long merged;           /* filtered points offered to the archive (depends on the split) */
+    long dropped;          /* points dropped by the crowding truncation */
+} BatMoArchive;
+
+/* Rejects the options the mode does not implement (prints the reason) and compiles the objectives. */
+int bat_mo_check(const BatOptions *opts);
+
+/* Installs the --mo-objective expressions (nothing without them). */
+void bat_mo_install(const BatOptions *opts);
+
+/* Installs a vector-valued objective of n_obj (2..BAT_MO_MAX) objectives. */
+int bat_mo_set_batch(BatMoFn fn, const void *ctx, int n_obj);
+
+/* Objective vectors of `count` rows (stride ld), BAT_MO_MAX doubles per row in out. */
+void bat_mo_eval(const double *rows, int ld, int count, double out[]);
+
+/* 1 if objective vector a dominates b (no worse everywhere, better somewhere). */
+int bat_mo_dominates(const double a[], const double b[]);
+
+/* Objective vector of a stored point (initialization); returns its first objective. */
+double bat_mo_point(const bat_real x[], double f[]);
+
+/* Arena bytes of an archive. */
+size_t bat_mo_bytes(int cap, int max_offers);
+
+/* Carves an archive out of an arena sized with bat_mo_bytes(). */
+int bat_mo_create(BatMoArchive *a, BatArena *arena, int cap, int max_offers);
+
+/*
+ * Non-dominated points of bats[0..n_bats), in canonical order, written to
+ * out (room for n_bats points). Returns their number.
+ */
+int bat_mo_collect(const Bat bats[], int n_bats, BatMoPoint out[]);
+
+/* Sets the hypervolume reference from the initial population (all ranks: call after the first merge). */
+void bat_mo_set_ref(BatMoArchive *a, const double worst[]);
+
+/* Worst value of every objective over bats[0..n_bats) (initial population). */
+void bat_mo_worst(const Bat bats[], int n_bats, double worst[]);
+
+/*
+ * Merges the n_new points stored at a->pt + a->n into the archive: the
+ * union is filtered, truncated to the capacity and its crowding distances
+ * recomputed. Returns the number of offered points the archive kept.
+ */
+int bat_mo_merge(BatMoArchive *a, int n_new);
+
+/*
+ * Guide of a bat: binary tournament on crowding distance between two
+ * archive points drawn with `rng`. Only the guide's x_i is set.
+ */
+void bat_mo_leader(const BatMoArchive *a, uint32_t *rng, Bat *leader);
+
+/*
+ * Best record of the archive for a dump: x_i and f_value (first
+ * objective) of pt[0], the rest zeroed.
+ */
+void bat_mo_best(const BatMoArchive *a, Bat *best);
+
+/* Hypervolume of the archive above a->ref (two objectives; -1 otherwise). */
+double bat_mo_hypervolume(const BatMoArchive *a);
+
+/* Writes the archive as CSV (f1..fm, x1..xd). Returns 0 on success. */
+int bat_mo_write_front(const BatMoArchive *a, const char *path);
+
+/* Appends mo= / mo_front= / mo_merged= / mo_dropped= / mo_hv= to the current BENCH line. */
+void bat_mo_print_bench(const BatMoArchive *a);
+
+#endif
@@ -0,0 +1,99 @@
+#ifndef BAT_MODE_H
+#define BAT_MODE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "bat.h"
+#include "bat_arena.h"
+#include "bat_bind.h"
+#include "bat_cli.h"
+#include "bat_options.h"
+
+/*
+ * bat_mode.h
+ *
+ * Driver support shared by the population modes (--mo-objective,
+ * --niche-radius), where no single best bat guides the swarm. Each
+ * front-end keeps its own update loop; the option check, the arena, the
+ * signals and the common part of the BENCH line go through the functions
+ * below.
+ *
+ * Signals are served at the end of every iteration, as in the main loop,
+ * but the files are written synchronously (the populations of these modes
+ * are small 2-D ones): SIGUSR1 writes dump_t<iter>.bin and the run goes
+ * on, SIGUSR2 writes checkpoint_t<iter>.bin and stops. The best record of
+ * the file is the first point of the Pareto archive (best first
+ * objective) or the seed of the best species. With MPI the caller agrees
+ * on the flags first; a split population is written as one file per rank
+ * (dump_t<iter>_r<rank>.bin), a replicated one by rank 0 alone.
+ */
+
+/* State of a mode run shared by the drivers. */
+typedef struct {
+    BatArena arena;
+    BatBindSlot *where;    /* placement of the threads / ranks (NULL on MPI ranks other than 0) */
+    int n_where;
+    int rank, n_ranks;     /* MPI rank and number of processes (0 and 1 otherwise) */
+    int slices;            /* files per dump: n_ranks for a split population, 1 if rank 0 has it all */
+    uint32_t seed;
+    int iters_done;        /* iterations completed (set by bat_mode_signals() on SIGUSR2) */
+} BatModeRun;
+
+/*
+ * Rejects the options that need a single best bat or a scalar objective
+ * (prints the reason, naming the mode by its option `flag`).
+ * Returns 0 if the options are compatible, -1 otherwise.
+ */
+int bat_mode_check(const BatOptions *opts, const char *flag);
+
+/*
+ * Starts a mode run: creates the arena and installs the signal handlers.
+ *
+ * Parameters:
+ *   - run         : state to set up
+ *   - args        : parsed command line (checked and applied options)
+ *   - arena_bytes : arena size (population and mode state)
+ *   - where       : placement slots from the driver's binding (malloc'ed; owned by run from now on)
+ *   - n_where     : number of slots
+ *   - rank        : MPI rank (0 otherwise)
+ *   - n_ranks     : number of MPI processes (1 otherwise)
+ *   - slices      : see BatModeRun
+ *
+ * Returns 0 on success, -1 on error (printed; `where` is freed).
+ */
+int bat_mode_begin(BatModeRun *run, const BatArgs *args, size_t arena_bytes, BatBindSlot *where, int n_where,
+                   int rank, int n_ranks, int slices);
+
+/*
+ * Serves the signal requests `sig` (BAT_SIG_*, the same on every rank) at
+ * the end of iteration t: writes bats[0..n_bats) of this rank with `best`
+ * as the best record. Returns 1 if the run must stop (run->iters_done is
+ * then t + 1), 0 otherwise.
+ */
+int bat_mode_signals(BatModeRun *run, int sig, int t, const Bat bats[], int n_bats, const Bat *best);
+
+/*
+ * Prints the BENCH line up to the fields of the mode, which the caller
+ * appends before bat_mode_end_bench().
+ *
+ * Parameters:
+ *   - run     : mode run
+ *   - args    : parsed command line
+ *   - version : back-end name of the line
+ *   - threads : OpenMP threads (1 otherwise)
+ *   - time_s  : time of the iterations
+ *   - evals   : objective evaluations (all threads / ranks)
+ *   - cnt     : work counters (all threads / ranks)
+ *   - best_f  : value reported as best_f
+ */
+void bat_mode_print_bench(const BatModeRun *run, const BatArgs *args, const char *version, int threads,
+                          double time_s, long evals, const BatCounters *cnt, double best_f);
+
+/* Ends the BENCH line (with the extra text of the unified driver, if any). */
+void bat_mode_end_bench(const BatArgs *args);
+
+/* Frees the arena and the placement slots. */
+void bat_mode_end(BatModeRun *run);
+
+#endif
@@ -0,0 +1,101 @@
+#ifndef BAT_NICHE_H
+#define BAT_NICHE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "bat.h"
+#include "bat_arena.h"
+#include "bat_options.h"
+#include "bat_utils.h"
+
+/*
+ * bat_niche.h
+ *
+ * Niching mode (--niche-radius r; 2-D engine only): finds several optima
+ * of a multimodal objective in one run instead of one per seed.
+ *
+ * Speciation (Li, 2004): the bats are visited from best to worst; a bat
+ * within distance r of an earlier species seed joins the best such
+ * species, otherwise it becomes the seed of a new one. Every bat then
+ * follows the seed of its species instead of the global best, so the
+ * species converge on different optima.
+ *
+ * Neighbour queries use a uniform hash grid of cell side r holding the
+ * seeds: a seed within r of a point lies in the 3^dimension cells around
+ * it. The grid is built incrementally during the sweep (a new seed is
+ * inserted as soon as it is created), and its slots carry the sweep
+ * number, so nothing is cleared between iterations. A speciation costs a
+ * sort plus a few distance checks per bat instead of one per seed.
+ *
+ * Niche bests: the best point of every species is matched against a list
+ * of at most --niche-max optima found so far (same niche = within r).
+ * Each entry records the iteration, evaluation count and time at which
+ * its current value was reached, and the iteration it was first seen.
+ * When the list is full a new niche replaces the worst entry if it is
+ * better, and two entries that drift into the same niche are merged. At
+ * the end the entries are printed as NICHE lines, best first, before the
+ * BENCH line.
+ *
+ * Speciation and the list only depend on the population, so every
+ * back-end reports the same niches (the times excepted).
+ */
+
+/* Default number of niche bests kept (--niche-max). */
+#define BAT_NICHE_MAX 10
+
+/* A niche best. */
+typedef struct {
+    bat_real x[dimension];
+    double f;
+    int iter_first;        /* iteration in which the niche was first seen */
+    int iter;              /* iteration / evaluations / seconds at which f was reached */
+    long evals;
+    double time_s;
+} BatNicheBest;
+
+/* Speciation state, hash grid and niche bests. */
+typedef struct {
+    double radius;
+    int n_bats;
+    int n_species;         /* species of the last speciation */
+    BatKeyIndex *order;    /* bats by decreasing f_value (key = -f_value) */
+    int *species;          /* species of every bat */
+    Bat *guide;            /* seed of every species (copy taken before the update) */
+    int *next;             /* next seed in the same cell */
+    int table_mask;        /* hash table: size - 1 (power of two) */
+    int64_t *cell;         /* cell coordinates of every slot (dimension per slot) */
+    int *head;             /* first seed of every slot */
+    int *stamp;            /* sweep that filled the slot (other values = empty) */
+    int sweep;
+    BatNicheBest *found;
+    int n_found, cap;
+    long queries;          /* speciation queries and distance checks (all sweeps) */
+    long checks;
+} BatNiche;
+
+/* Rejects the options the mode does not implement (prints the reason). */
+int bat_niche_check(const BatOptions *opts);
+
+/* Arena bytes of a niche state for n_bats bats and cap niche bests. */
+size_t bat_niche_bytes(int n_bats, int cap);
+
+/* Carves a niche state out of an arena sized with bat_niche_bytes(). */
+int bat_niche_create(BatNiche *nc, BatArena *arena, int n_bats, int cap, double radius);
+
+/*
+ * Splits bats[0..n_bats) into species and copies their seeds into
+ * nc->guide (bat i follows nc->guide[nc->species[i]]).
+ */
+void bat_niche_speciate(BatNiche *nc, const Bat bats[]);
+
+/* Matches the species seeds against the niche bests after `iter` iterations. */
+void bat_niche_record(BatNiche *nc, int iter, long evals, double time_s);
+
+/* Sorts the niche bests (best first) and prints them as NICHE lines. */
+void bat_niche_report(BatNiche *nc);
+
+/* Appends niche_r= / species= / niches= / niche_queries= / niche_checks= to the current BENCH line. */
+void bat_niche_print_bench(const BatNiche *nc);
+
+#endif
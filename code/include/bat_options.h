@@ -0,0 +1,89 @@
+#ifndef BAT_OPTIONS_H
+#define BAT_OPTIONS_H
+
+#include "bat.h"
+#include "bat_ttt.h"
+#include "bat_constraint.h"
+
+/*
+ * bat_options.h
+ *
+ * Command-line options shared by all front-ends.
+ *
+ * bat_args_parse() (bat_cli.h) handles the basic options (--n-bats,
+ * --iters, --seed, --quiet, ...) and forwards every other argument to
+ * bat_options_parse(), so new features only need to be declared once.
+ */
+
+typedef struct {
+    double deadline_ms;   /* --deadline <ms>: wall-clock budget (0 = disabled) */
+    int    init_kind;     /* --init uniform|sobol|halton|lhs (BAT_INIT_*, -1 = invalid) */
+    int    init_obl;      /* --obl: opposition-based initialization */
+    int    refine_method; /* --refine none|coord|nm (BAT_REFINE_*, -1 = invalid) */
+    int    refine_every;  /* --refine-every <iters>: refinement period */
+    int    refine_evals;  /* --refine-evals <n>: evaluation budget per refinement */
+    double refine_step;   /* --refine-step <s>: initial step / simplex size */
+    int    objective;     /* --objective <name> (BAT_OBJ_*, -1 = invalid) */
+    const char *objective_expr; /* --objective-expr <expr> (sets objective = BAT_OBJ_EXPR, see bat_expr.h) */
+    int    indirect_objective; /* --indirect-objective: generic update engine instead of the inlined one (bat_isa.h) */
+    BatParams params;     /* --alpha --gamma --fmin --fmax --a0 --r0 --adapt */
+    int    has_target;    /* --target <f> given */
+    double target;        /* stop once the best f_value reaches this value */
+    int    restart_kind;  /* --restart none|partial|full|ipop (BAT_RESTART_*, -1 = invalid) */
+    double restart_div;   /* --restart-div <d>: diversity threshold */
+    double restart_frac;  /* --restart-frac <f>: fraction re-sampled by partial restarts */
+    int    restart_grow;  /* --restart-grow <k>: ipop population growth factor */
+    int    restart_max_bats; /* --restart-max-bats <n>: ipop cap (0 = 16 x n_bats) */
+    int    restart_gap;   /* --restart-gap <iters>: minimum iterations between restarts */
+    double restart_stall; /* --restart-stall <r>: relative diversity change counted as frozen */
+    int    shrink_kind;   /* --shrink none|linear|nonlinear (BAT_SHRINK_*, -1 = invalid) */
+    int    shrink_min;    /* --shrink-min <n>: population size at the last iteration */
+    BatTimeToTarget ttt;  /* --targets <p1,p2,...>: precisions for time-to-target */
+    const char *trace_path;     /* --trace <file>: best bat of every iteration (NULL = off) */
+    const char *final_pop_path; /* --final-pop <file>: population file at the end (NULL = off) */
+    int    isa;           /* --isa auto|generic|avx2|avx512 (BAT_ISA_*, -2 = invalid) */
+    int    pages;         /* --hugepages auto|off|thp|hugetlb (BAT_PAGES_*, -1 = invalid) */
+    int    bind;          /* --bind none|compact|spread|numa (BAT_BIND_*, -1 = invalid) */
+    int    hd_dim;        /* --dim <n>: high-dimensional engine with n coordinates (0 = off, see bat_hd.h) */
+    int    hd_group;      /* --hd-group <n>: bats updated together per tile */
+    int    hd_slices;     /* --hd-slices <n>: dimension slices of the MPI process grid */
+    int    transform;     /* --transform none|shift|rotate (BAT_TRANSFORM_*, -1 = invalid; needs --dim) */
+    int    cc_kind;       /* --cc none|random|diff: cooperative coevolution (BAT_CC_*, -1 = invalid; needs --dim) */
+    int    cc_size;       /* --cc-size <n>: coordinates per group */
+    int    cc_iters;      /* --cc-iters <n>: sub-swarm iterations per round */
+    BatConOptions con;    /* --constraint <expr> (repeatable), --con-mode, --con-eps, --con-penalty */
+    int    n_mo;          /* --mo-objective <expr> given (repeatable, see bat_mo.h; -1 = more than BAT_MO_MAX) */
+    const char *mo_expr[BAT_MO_MAX];
+    int    mo_archive;    /* --mo-archive <n>: Pareto archive capacity */
+    const char *mo_front_path; /* --mo-front <file>: final archive as CSV (NULL = off) */
+    double niche_radius;  /* --niche-radius <r>: niching mode (0 = off, see bat_niche.h) */
+    int    niche_max;     /* --niche-max <n>: niche bests kept and reported */
+} BatOptions;
+
+/* Fills `opts` with the default values (all optional features disabled). */
+void bat_options_defaults(BatOptions *opts);
+
+/*
+ * Tries to consume argv[*i] (and its value, if any).
+ * Returns 1 if the option was recognized (and advances *i past its value),
+ * 0 otherwise.
+ */
+int bat_options_parse(BatOptions *opts, int argc, char **argv, int *i);
+
+/* Checks option values; prints the problem and returns -1 if one is invalid. */
+int bat_options_check(const BatOptions *opts);
+
+/* Installs the selected objective (compiling --objective-expr) and algorithm parameters in the core. */
+void bat_options_apply(const BatOptions *opts);
+
+/*
+ * Largest global population the run can reach from n_bats bats (the ipop
+ * cap with --restart ipop, n_bats otherwise): the front-ends size their
+ * arena with it.
+ */
+int bat_options_max_bats(const BatOptions *opts, int n_bats);
+
+/* Appends the non-default option values to the current BENCH line. */
+void bat_options_print_bench(const BatOptions *opts);
+
+#endif
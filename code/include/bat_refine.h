@@ -0,0 +1,43 @@
+#ifndef BAT_REFINE_H
+#define BAT_REFINE_H
+
+#include "bat.h"
+
+/*
+ * bat_refine.h
+ *
+ * Optional intensification stage (--refine coord|nm).
+ *
+ * Every --refine-every iterations the current global best is polished by a
+ * deterministic local optimizer, and the improved point is fed back into
+ * the swarm (it replaces the worst bat). The random walk of update_bat()
+ * is good at finding the basin but slow at resolving the last decimals;
+ * a local optimizer does that in a handful of evaluations.
+ */
+
+enum {
+    BAT_REFINE_NONE = 0,
+    BAT_REFINE_COORD,    /* compass / coordinate pattern search */
+    BAT_REFINE_NM        /* Nelder-Mead simplex */
+};
+
+/* Maps "none" / "coord" / "nm" to BAT_REFINE_*, or -1. */
+int bat_refine_from_name(const char *name);
+const char *bat_refine_name(int method);
+
+/*
+ * Polishes x (in place, kept inside [Lb, Ub]) with at most `max_evals`
+ * objective evaluations. `step` is the initial step / simplex size.
+ * On entry *f_x is the objective value at x (the f_value of the bat x
+ * comes from); on return it holds the value at the returned x.
+ * Returns the number of objective evaluations used.
+ */
+int bat_refine(int method, double x[], double *f_x, int max_evals, double step);
+
+/*
+ * Writes (x, f_x) into the worst bat of `bats` (velocity reset, RNG and
+ * loudness/pulse state kept). Returns the index of the replaced bat.
+ */
+int bat_inject(Bat bats[], int n_bats, const double x[], double f_x);
+
+#endif
@@ -0,0 +1,159 @@
+#ifndef BAT_RESTART_H
+#define BAT_RESTART_H
+
+#include <stdint.h>
+
+#include "bat.h"
+
+/*
+ * bat_restart.h
+ *
+ * Population diversity monitor + restart strategies (--restart).
+ *
+ * The swarm often collapses onto a single point long before --iters is
+ * reached; every later iteration only re-evaluates the same neighbourhood.
+ * The monitor measures the spread of the population, and the population
+ * is re-initialized when either
+ *
+ * - the spread drops below --restart-div (the swarm collapsed), or
+ * - the spread changed by less than --restart-stall (relative) over the
+ *   last --restart-gap iterations: the bats have stopped accepting moves
+ *   (their loudness decayed) and the swarm is frozen, even if it is not
+ *   concentrated on a single point.
+ *
+ * Strategies:
+ *
+ * - partial : the worst --restart-frac of the bats are re-sampled
+ * - full    : every bat is re-sampled
+ * - ipop    : full restart with a population --restart-grow times larger
+ *             (capped by --restart-max-bats), as in IPOP-CMA-ES
+ *
+ * The best bat found so far is kept in an archive, so restarts never lose
+ * the result.
+ *
+ * Diversity:
+ * D = sqrt(sum_d Var(x_d)) / (Ub - Lb), i.e. the RMS distance of the bats to
+ * their centroid, relative to the box size (about 0.41 for a uniform 2-D
+ * population). Var is computed from per-dimension sums of (x - ref) and
+ * (x - ref)^2 that are updated incrementally on every move, so checking the
+ * diversity costs O(dimension) per iteration instead of O(n_bats).
+ * Sums of disjoint sets of bats with the same `ref` can simply be added:
+ * this is how OpenMP threads and MPI ranks combine their contributions.
+ */
+
+enum {
+    BAT_RESTART_NONE = 0,
+    BAT_RESTART_PARTIAL,
+    BAT_RESTART_FULL,
+    BAT_RESTART_IPOP
+};
+
+/* The sums are recomputed from scratch this often (bounds rounding drift). */
+#define BAT_DIVERSITY_RESYNC 1000
+
+typedef struct {
+    bat_real ref[dimension];    /* reference point (shift for the sums) */
+    double sum[dimension];      /* sum of (x - ref) */
+    double sum_sq[dimension];   /* sum of (x - ref)^2 */
+    double n;                   /* number of bats in the sums */
+} BatDiversity;
+
+typedef struct {
+    int    kind;       /* BAT_RESTART_* */
+    double threshold;  /* restart when the diversity is below this value */
+    double frac;       /* partial: fraction of the (local) population re-sampled */
+    int    grow;       /* ipop: population growth factor */
+    int    max_bats;   /* ipop: maximum (global) population size */
+    int    gap;        /* minimum iterations between restarts, and stall window */
+    double stall;      /* relative diversity change below which the swarm is frozen */
+
+    int    count;      /* restarts performed so far */
+    int    t_last;     /* iteration of the last restart (clock of update_bat) */
+    double d_window;   /* diversity at the start of the stall window (-1 = none yet) */
+    int    t_window;   /* iteration at which the stall window started */
+    Bat    archive;    /* best bat over all restarts */
+} BatRestart;
+
+/* Maps "none" / "partial" / "full" / "ipop" to BAT_RESTART_*, or -1. */
+int bat_restart_from_name(const char *name);
+const char *bat_restart_name(int kind);
+
+/* Recomputes the sums of `bats` around `ref` (ref may alias div->ref). */
+void bat_diversity_reset(BatDiversity *div, const Bat bats[], int n_bats, const bat_real ref[]);
+
+/* Empty sums sharing the reference point of `div` (per-thread deltas). */
+void bat_diversity_delta(const BatDiversity *div, BatDiversity *delta);
+
+/* Accounts for one bat moving from old_x to new_x. */
+void bat_diversity_move(BatDiversity *div, const bat_real old_x[], const bat_real new_x[]);
+
+/* Adds the sums of `src` (same reference point) into `dst`. */
+void bat_diversity_merge(BatDiversity *dst, const BatDiversity *src);
+
+/* Normalized RMS distance to the centroid (see above). */
+double bat_diversity_value(const BatDiversity *div);
+
+/*
+ * update_bat() + diversity bookkeeping: the move of the bat is added to
+ * `delta` (if not NULL). Returns the number of objective evaluations.
+ */
+int update_bat_tracked(Bat *bat, const Bat *best_bat, double A_mean, int t, BatCounters *cnt,
+                       BatDiversity *delta);
+
+/*
+ * Sets up the restart state.
+ *
+ * Parameters:
+ *   - rs        : state to initialize
+ *   - kind      : BAT_RESTART_*
+ *   - threshold : diversity threshold
+ *   - frac      : partial restart fraction
+ *   - grow      : ipop growth factor
+ *   - max_bats  : ipop population cap
+ *   - gap       : minimum iterations between restarts (and stall window)
+ *   - stall     : relative diversity change that counts as frozen (0 = off)
+ *   - best      : initial best bat (seeds the archive)
+ */
+void bat_restart_init(BatRestart *rs, int kind, double threshold, double frac, int grow, int max_bats,
+                      int gap, double stall, const Bat *best);
+
+/* Keeps *best in the archive if it improves on it. */
+void bat_restart_archive(BatRestart *rs, const Bat *best);
+
+/*
+ * Returns 1 if a restart is due at iteration t with the given diversity.
+ * Must be called every iteration (it advances the stall window).
+ */
+int bat_restart_due(BatRestart *rs, double diversity, int t);
+
+/*
+ * Global population size after the next restart (ipop grows it, rounded
+ * down to a multiple of `multiple`; other strategies keep n_bats).
+ */
+int bat_restart_next_size(const BatRestart *rs, int n_bats, int multiple);
+
+/*
+ * Re-initializes (part of) a population slice and records the restart.
+ * Bats are re-sampled with the --init strategy, using a seed derived from
+ * (seed, restart count), so restarts are reproducible.
+ *
+ * Parameters:
+ *   - rs        : restart state (count / t_last are updated)
+ *   - bats      : slice to re-initialize
+ *   - local_n   : number of bats in the slice
+ *   - offset    : global index of bats[0]
+ *   - global_n  : global population size
+ *   - init_kind : BAT_INIT_* strategy
+ *   - obl       : opposition-based initialization
+ *   - seed      : run seed
+ *   - t         : current iteration
+ *
+ * Returns the number of objective evaluations used, or -1 on error.
+ */
+long bat_restart_apply(BatRestart *rs, Bat bats[], int local_n, int offset, int global_n,
+                       int init_kind, int obl, uint32_t seed, int t);
+
+/* Appends the restart statistics to the current BENCH line. */
+void bat_restart_print_bench(const BatRestart *rs, int n_bats_final, double diversity);
+
+#endif
@@ -0,0 +1,64 @@
+#ifndef BAT_SHRINK_H
+#define BAT_SHRINK_H
+
+#include <stddef.h>
+
+#include "bat.h"
+#include "bat_arena.h"
+
+/*
+ * bat_shrink.h
+ *
+ * Population-size reduction schedules (--shrink linear|nonlinear).
+ *
+ * Early iterations need many bats to explore; late iterations mostly
+ * refine the area around the best, where a few bats do the useful work.
+ * The schedule gives the population size after each iteration, from
+ * --n-bats at t = 0 down to --shrink-min at t = --iters, and the worst
+ * bats are dropped to follow it, so the cost of an iteration falls over
+ * the run.
+ *
+ * - linear    : N(t) = N0 + (N_min - N0) * t / T             (as in L-SHADE)
+ * - nonlinear : N(t) = N0 + (N_min - N0) * (t/T)^(1 - t/T)   (drops bats
+ *               faster in the first half, then levels off; as in NLPSR-SHADE)
+ */
+
+enum {
+    BAT_SHRINK_NONE = 0,
+    BAT_SHRINK_LINEAR,
+    BAT_SHRINK_NONLINEAR
+};
+
+/* Maps "none" / "linear" / "nonlinear" to BAT_SHRINK_*, or -1. */
+int bat_shrink_from_name(const char *name);
+const char *bat_shrink_name(int kind);
+
+/*
+ * Population size prescribed after iteration t.
+ *
+ * Parameters:
+ *   - kind  : BAT_SHRINK_*
+ *   - n0    : initial population size
+ *   - n_min : final population size
+ *   - t     : number of completed iterations
+ *   - t_max : total number of iterations (--iters)
+ */
+int bat_shrink_target(int kind, int n0, int n_min, int t, int t_max);
+
+/*
+ * Drops the worst bats so that `target` remain, compacting the array in
+ * place (survivors keep their relative order). The sort buffers are taken
+ * from `scratch` and released on return. Returns the new size.
+ */
+int bat_shrink_local(Bat bats[], int n_bats, int target, BatArena *scratch);
+
+/* Scratch bytes bat_shrink_local() needs for up to `n_bats` bats. */
+size_t bat_shrink_scratch_bytes(int n_bats);
+
+/*
+ * Same as bat_shrink_local(), but the bats to drop are given by a mask
+ * (drop[i] != 0). Used by MPI, where the worst bats are chosen globally.
+ */
+int bat_shrink_compact(Bat bats[], int n_bats, const unsigned char drop[]);
+
+#endif
@@ -0,0 +1,27 @@
+#ifndef BAT_SIGNAL_H
+#define BAT_SIGNAL_H
+
+/*
+ * bat_signal.h
+ *
+ * Signal-driven control of a running optimization:
+ * - SIGUSR1 : write a snapshot of the population at the next iteration
+ *             boundary (in the background, the loop keeps running)
+ * - SIGUSR2 : write a checkpoint at the next iteration boundary and exit
+ *
+ * The handlers only set flags; the front-ends poll them between iterations.
+ */
+
+#define BAT_SIG_DUMP 1   /* SIGUSR1 received */
+#define BAT_SIG_EXIT 2   /* SIGUSR2 received */
+
+/* MPI front-end: poll (and agree on) the flags every N iterations only. */
+#define BAT_SIGNAL_POLL_ITERS 16
+
+/* Installs the SIGUSR1/SIGUSR2 handlers. */
+void bat_signal_install(void);
+
+/* Returns the pending requests (BAT_SIG_* bitmask) and clears them. */
+int bat_signal_take(void);
+
+#endif
@@ -0,0 +1,108 @@
+#ifndef BAT_TRANSFORM_H
+#define BAT_TRANSFORM_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "bat_arena.h"
+
+/*
+ * bat_transform.h
+ *
+ * Shifted and rotated objectives (--transform shift|rotate, with --dim).
+ *
+ * The built-in functions have their optimum at the origin and, except
+ * Rosenbrock, are separable: a search that moves one coordinate at a time
+ * does unrealistically well on them. Like the CEC benchmark suites, the
+ * transformed variants evaluate
+ *
+ *     shift  : f(z)        z = x - o
+ *     rotate : f(M z)      M = a dense D x D rotation
+ *
+ * where o is a shift vector in [0.8 Lb, 0.8 Ub] (zero with transform
+ * none, which only batches an --objective-expr) and M the product of
+ * BAT_TF_REFLECTIONS random Householder reflections (an even number, so
+ * M is a proper rotation mixing every coordinate with every other one).
+ * o and M are drawn from a fixed seed: the problem instance only depends
+ * on the dimension, not on --seed.
+ *
+ * A rotated evaluation costs 2 D^2 flops. Instead of one matrix-vector
+ * product per candidate, the engine collects the candidates of an
+ * iteration as the rows of Z and computes Y = Z M^T with one cache-blocked
+ * matrix product (bat_kernels.gemm, one variant per ISA). The column
+ * panels of Y are independent: the OpenMP back-end splits them between
+ * threads. Every element of Y sums its products in the same order for any
+ * blocking, so results stay identical across back-ends.
+ */
+
+enum {
+    BAT_TRANSFORM_NONE = 0,
+    BAT_TRANSFORM_SHIFT,
+    BAT_TRANSFORM_ROTATE
+};
+
+/* Householder reflections multiplied into M (even: det M = +1). */
+#define BAT_TF_REFLECTIONS 16
+/*
+ * Cache blocking of Y = Z M^T: panels of BAT_TF_NC columns of Y; within a
+ * panel, BAT_TF_KC x BAT_TF_NC blocks of M^T (64 KB, kept in L2) are
+ * applied to BAT_TF_MC rows of Z at a time.
+ */
+#define BAT_TF_NC 64
+#define BAT_TF_KC 128
+#define BAT_TF_MC 64
+
+typedef struct {
+    int kind;          /* BAT_TRANSFORM_* */
+    int dim;
+    int ld;            /* row stride of the matrices (dim rounded up to a cache line) */
+    int max_rows;      /* candidates per batch */
+    double *shift;     /* o */
+    double *rot_p;     /* M^T packed by column panel (rotate only, see bat_transform.c) */
+    double *z;         /* batch rows, x - o: max_rows x ld */
+    double *y;         /* M z of every row (rotate only) */
+    double *f;         /* objective value of every row */
+    double gemm_flops; /* accumulated by bat_transform_account() */
+    double gemm_s;
+} BatTransform;
+
+/* Maps "none" / "shift" / "rotate" to BAT_TRANSFORM_*, or -1. */
+int bat_transform_from_name(const char *name);
+const char *bat_transform_name(int kind);
+
+/* Arena bytes of a transform of `dim` coordinates and `max_rows` rows per batch. */
+size_t bat_transform_bytes(int kind, int dim, int max_rows);
+
+/*
+ * Carves a transform out of an arena sized with bat_transform_bytes() and
+ * draws o and M. Returns 0 on success, -1 if the arena is too small.
+ */
+int bat_transform_create(BatTransform *tf, BatArena *arena, int kind, int dim, int max_rows);
+
+/* Row r of the batch (the caller stores x - o there). */
+double *bat_transform_row(const BatTransform *tf, int r);
+
+/*
+ * Batch evaluation of rows [0, rows), in two steps that can be split
+ * between threads: every column panel of Y (bat_transform_panels() of
+ * them, rotate only), then the values of blocks of rows [r0, r1) (into
+ * tf->f; an --objective-expr evaluates a block in the lanes of its
+ * interpreter, so blocks should be BAT_EXPR_LANES rows).
+ * bat_transform_eval() does both and accounts the product time.
+ */
+int  bat_transform_panels(const BatTransform *tf);
+void bat_transform_panel(BatTransform *tf, int rows, int panel);
+void bat_transform_values(BatTransform *tf, int id, int r0, int r1);
+void bat_transform_eval(BatTransform *tf, int id, int rows);
+
+/* Adds one product of `rows` rows that took `seconds` to the GEMM statistics. */
+void bat_transform_account(BatTransform *tf, int rows, double seconds);
+
+/*
+ * Appends transform= (and with rotate, the GEMM rate: total flops over
+ * `seconds` of product time, as gemm_gflops= / gemm_s=) to the current
+ * BENCH line.
+ */
+void bat_transform_print_bench(const BatTransform *tf, double flops, double seconds);
+
+#endif
@@ -0,0 +1,54 @@
+#ifndef BAT_TTT_H
+#define BAT_TTT_H
+
+/*
+ * bat_ttt.h
+ *
+ * Time-to-target recording (--targets), for COCO-style benchmarking.
+ *
+ * Fixed-iteration benchmarks reward a backend that iterates fast even if it
+ * converges worse. With --targets the run instead records, for a list of
+ * precisions Delta_f (e.g. 1e1,1e-1,1e-3,1e-5,1e-8), the number of objective
+ * evaluations and the seconds needed until the best value reaches
+ * f_opt - Delta_f, and stops as soon as the last target is reached
+ * (--iters remains the budget cap).
+ *
+ * Results go to the BENCH line as comma-separated lists (-1 = not reached):
+ *   ttt_prec=10,0.1 ttt_evals=120,2480 ttt_s=0.000012,0.000310
+ * and are turned into ERT tables and ECDFs by tools/bench_analyze.py.
+ */
+
+#define BAT_TTT_MAX 16
+
+typedef struct {
+    int    n;                      /* number of targets (0 = disabled) */
+    double prec[BAT_TTT_MAX];      /* precisions Delta_f, in the order given */
+    double f_target[BAT_TTT_MAX];  /* f_opt - prec[k] (we maximize) */
+    long   evals[BAT_TTT_MAX];     /* evaluations when reached, -1 = not yet */
+    double secs[BAT_TTT_MAX];      /* seconds when reached, -1 = not yet */
+    int    n_hit;                  /* number of targets reached */
+} BatTimeToTarget;
+
+/* Parses a comma-separated list of positive precisions. Returns 0 or -1. */
+int bat_ttt_parse(BatTimeToTarget *ttt, const char *list);
+
+/* Resets the records and sets the targets from the objective optimum. */
+void bat_ttt_start(BatTimeToTarget *ttt, double f_opt);
+
+/*
+ * Records the targets reached by `best_f`.
+ *
+ * Parameters:
+ *   - ttt    : recorder
+ *   - best_f : best value found so far
+ *   - evals  : evaluations used so far
+ *   - secs   : seconds elapsed so far
+ *
+ * Returns 1 once every target has been reached, 0 otherwise.
+ */
+int bat_ttt_update(BatTimeToTarget *ttt, double best_f, long evals, double secs);
+
+/* Appends ttt_prec / ttt_evals / ttt_s to the current BENCH line. */
+void bat_ttt_print_bench(const BatTimeToTarget *ttt);
+
+#endif
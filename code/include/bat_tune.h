@@ -0,0 +1,83 @@
+#ifndef BAT_TUNE_H
+#define BAT_TUNE_H
+
+#include "bat_options.h"
+
+/*
+ * bat_tune.h
+ *
+ * Persisted auto-tuning of the OpenMP loop (--autotune).
+ *
+ * The fastest thread count, loop schedule and chunk size depend on the
+ * population size, the dimension and the cost of the objective: with a
+ * cheap objective and a few thousand bats, 4 threads can be slower than 2.
+ * With --autotune the OpenMP program times a few candidate configurations
+ * on the real problem (on a copy of the initial population, so the run
+ * itself is unchanged), keeps the fastest and stores it in a plain-text
+ * cache. Later runs with the same key reuse the stored choice without
+ * tuning again.
+ *
+ * Cache key: (host name, n_bats bucket, dimension, precision, ISA,
+ * objective), where the bucket is n_bats rounded up to a power of two, the
+ * precision is sizeof(bat_real) (4 in the float build) and the ISA is the
+ * one of the kernels in use (--isa). The objective is its
+ * name, followed by a hash of the expression texts (--objective-expr,
+ * --constraint, --mo-objective) when there are any: "expr-9e3c0a1b4d2f6e87".
+ * One line per key:
+ *
+ *   <host> <bucket> <dim> <precision> <isa> <objective> <threads> <schedule> <chunk> <ns_per_update>
+ *
+ * Lines in an older format are ignored. Delete the file (or its line) to
+ * tune again, e.g. after a hardware or compiler change.
+ */
+
+#define BAT_TUNE_CACHE_DEFAULT "bat_tune.cache"
+#define BAT_TUNE_HOST_MAX 64
+
+enum {
+    BAT_SCHED_STATIC = 0,
+    BAT_SCHED_DYNAMIC,
+    BAT_SCHED_GUIDED
+};
+
+typedef struct {
+    char host[BAT_TUNE_HOST_MAX];
+    int  bucket;          /* n_bats rounded up to a power of two */
+    int  dim;
+    int  precision;       /* sizeof(bat_real) */
+    char isa[16];         /* bat_isa_name() of the kernels in use */
+    char objective[32];
+} BatTuneKey;
+
+typedef struct {
+    int    threads;
+    int    sched;         /* BAT_SCHED_* */
+    int    chunk;         /* 0 = schedule default */
+    double ns_per_update; /* measured time per bat update */
+} BatTuneChoice;
+
+/* Maps "static" / "dynamic" / "guided" to BAT_SCHED_*, or -1. */
+int bat_sched_from_name(const char *name);
+const char *bat_sched_name(int sched);
+
+/* Builds the cache key of a run (host name from gethostname(); call after bat_options_apply()). */
+void bat_tune_key(BatTuneKey *key, int n_bats, const BatOptions *opts);
+
+/*
+ * Candidate configurations for up to `max_threads` threads: thread counts
+ * 1, 2, 4, ... and max_threads, each with the schedules of the table in
+ * bat_tune.c. Writes at most `cap` entries and returns their number.
+ */
+int bat_tune_candidates(int max_threads, BatTuneChoice out[], int cap);
+
+/* Looks the key up in the cache. Returns 1 and fills *choice if found, 0 otherwise. */
+int bat_tune_lookup(const char *path, const BatTuneKey *key, BatTuneChoice *choice);
+
+/*
+ * Stores (or replaces) the choice for `key` in the cache. The file is
+ * rewritten through a temporary file, so a concurrent reader never sees a
+ * partial cache. Returns 0 on success, -1 on error (printed).
+ */
+int bat_tune_store(const char *path, const BatTuneKey *key, const BatTuneChoice *choice);
+
+#endif
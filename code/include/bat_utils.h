@@ -1,8 +1,59 @@
 #ifndef BAT_UTILS_H
 #define BAT_UTILS_H
 
+#include "bat.h"
+
 double uniform_random(double a, double b);
 double objective_function(const double point[]);
+
+/* objective_function() of a stored position (bat_real coordinates, see bat.h). */
+double bat_objective_real(const bat_real point[]);
 double normal_random(double mean, double stddev);
 
+/*
+ * Built-in objective functions (--objective).
+ *
+ * The Bat Algorithm here maximizes, so the classic minimization test
+ * functions are returned negated: their maximum is 0 at the optimum.
+ * "paraboloid" (10 - |x|^2, maximum 10) is the historical default.
+ */
+enum {
+    BAT_OBJ_PARABOLOID = 0,
+    BAT_OBJ_SPHERE,
+    BAT_OBJ_RASTRIGIN,
+    BAT_OBJ_ACKLEY,
+    BAT_OBJ_GRIEWANK,
+    BAT_OBJ_ROSENBROCK,
+    BAT_OBJ_COUNT
+};
+/* Compiled --objective-expr (see bat_expr.h): not selectable by name. */
+#define BAT_OBJ_EXPR BAT_OBJ_COUNT
+
+/* Maps an objective name to BAT_OBJ_*, or -1. */
+int bat_objective_from_name(const char *name);
+const char *bat_objective_name(int id);
+
+/* Selects the objective used by objective_function() (call before any thread starts). */
+void bat_set_objective(int id);
+int bat_get_objective(void);
+
+/* Evaluates a given objective on an n-dimensional point (BAT_OBJ_EXPR: n must be the compiled one). */
+double bat_objective_eval(int id, const double x[], int n);
+
+/* Maximum value of a built-in objective (used to define targets; unknown for BAT_OBJ_EXPR). */
+double bat_objective_optimum(int id);
+
+/* A sort key and the index (bat, point, ...) it belongs to. */
+typedef struct {
+    double key;
+    int index;
+} BatKeyIndex;
+
+/*
+ * Sorts by increasing key, equal keys by increasing index. The order is
+ * total, so every thread / rank sorting the same pairs gets the same
+ * result whatever the qsort implementation (sort by -f for best first).
+ */
+void bat_sort_by_key(BatKeyIndex pairs[], int n);
+
 #endif
@@ -0,0 +1,41 @@
+#ifndef BAT_XSUM_H
+#define BAT_XSUM_H
+
+#include <stdint.h>
+
+/*
+ * bat_xsum.h
+ *
+ * Exact, order-independent summation of doubles.
+ *
+ * Floating-point addition is not associative: the sequential program, the
+ * OpenMP threads and the MPI ranks add the same values in different orders
+ * and get results that differ in the last bits, which is enough to make
+ * the runs diverge after a few iterations. A BatExactSum is a fixed-point
+ * accumulator wide enough to hold any double exactly (Kulisch-style
+ * superaccumulator): additions are exact integer operations, so partial
+ * sums can be merged in any order (OpenMP critical sections, MPI_SUM on the
+ * int64 bins) and the final value is bitwise identical.
+ *
+ * Each bin holds 32 bits of the fixed-point number in an int64, so up to
+ * 2^31 values can be added before the bins must be normalized.
+ */
+
+#define BAT_XSUM_BINS 72
+
+typedef struct {
+    int64_t bin[BAT_XSUM_BINS];
+} BatExactSum;
+
+void bat_xsum_clear(BatExactSum *s);
+
+/* Adds a finite double (any sign) exactly. */
+void bat_xsum_add(BatExactSum *s, double v);
+
+/* dst += src (exact). */
+void bat_xsum_merge(BatExactSum *dst, const BatExactSum *src);
+
+/* The sum rounded to a double (depends only on the exact sum). */
+double bat_xsum_value(const BatExactSum *s);
+
+#endif
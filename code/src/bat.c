@@ -0,0 +1,271 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <omp.h>
+#include <mpi.h>
+
+#include "bat.h"
+#include "bat_cli.h"
+#include "bat_hd.h"
+#include "bat_init.h"
+#include "bat_options.h"
+#include "bat_transform.h"
+
+/*
+ * Unified driver: the sequential, OpenMP and MPI back-ends in one program.
+ *
+ * Idea:
+ * - The command line is the same as for the three separate programs, plus
+ *   --backend seq|omp|mpi|auto (default auto).
+ * - Under an MPI launcher with several ranks, only the MPI back-end makes
+ *   sense: auto selects it, seq/omp are rejected.
+ * - Otherwise auto picks between the sequential and the OpenMP back-end
+ *   (and the thread count) with a cost model calibrated on this machine
+ *   and on the real problem:
+ *
+ *       T(p) = n_bats * w / min(p, cores) + s(p)      (per iteration)
+ *
+ *   w    = time of one bat update (objective included), measured on a
+ *          sample of the initial population (one group of the
+ *          high-dimensional engine with --dim)
+ *   s(p) = synchronization cost of one OpenMP iteration with p threads
+ *          (fork/join, barrier, critical sections), measured with empty
+ *          iterations; s = 0 for the sequential back-end
+ *   cores = processors available to the program (omp_get_num_procs()):
+ *          threads beyond that only add synchronization cost
+ *
+ *   A thread count is only chosen if it is predicted to be faster than the
+ *   best smaller one by MODEL_MARGIN, so small problems run sequentially
+ *   instead of paying the parallel overhead.
+ *
+ * The BENCH line is the one of the selected back-end, with
+ * `backend=` (and the model values with auto) appended.
+ */
+
+/* Bats of the initial population used to measure w. */
+#define MODEL_SAMPLE_BATS 1024
+/* Sweeps over the sample (the fastest one is kept). */
+#define MODEL_SWEEPS      8
+/* Empty iterations timed per thread count (after MODEL_SYNC_WARMUP). */
+#define MODEL_SYNC_ITERS  200
+#define MODEL_SYNC_WARMUP 20
+/* Required relative gain to use more threads. */
+#define MODEL_MARGIN      0.10
+
+typedef struct {
+    double w_ns;      /* time of one bat update */
+    double sync_us;   /* s(p) of the chosen thread count (0 = sequential) */
+    double iter_us;   /* predicted time of one iteration */
+    double seq_us;    /* predicted time of one sequential iteration */
+    int    threads;   /* 1 = sequential back-end */
+    double calib_ms;  /* time spent calibrating */
+} BatCostModel;
+
+/* Number of ranks announced by the MPI launcher (1 if not started by one). */
+static int launcher_ranks(void) {
+    static const char *vars[] = {"OMPI_COMM_WORLD_SIZE", "PMI_SIZE", "MV2_COMM_WORLD_SIZE"};
+    for (size_t k = 0; k < sizeof(vars) / sizeof(vars[0]); k++) {
+        const char *v = getenv(vars[k]);
+        if (v && atoi(v) > 0) return atoi(v);
+    }
+    return 1;
+}
+
+/*
+ * Measures w: the time of one update_bat() call on a sample of the
+ * initial population (same --init strategy, objective and parameters).
+ * The options must already be applied.
+ *
+ * Returns the time per update in ns, or -1 on error.
+ */
+static double model_work_ns(const BatArgs *args) {
+    int k = args->n_bats < MODEL_SAMPLE_BATS ? args->n_bats : MODEL_SAMPLE_BATS;
+    Bat *sample = malloc((size_t)k * sizeof(Bat));
+    if (!sample) {
+        perror("malloc model sample");
+        return -1.0;
+    }
+    BatInitPlan plan;
+    if (bat_init_plan_create(&plan, args->opts.init_kind, args->opts.init_obl, args->n_bats, (uint32_t)args->seed) != 0) {
+        free(sample);
+        return -1.0;
+    }
+    for (int i = 0; i < k; i++) bat_init_one(&plan, &sample[i], i);
+    bat_init_plan_free(&plan);
+
+    Bat best;
+    select_best_bat(sample, k, &best);
+    double A_mean = bat_mean_loudness(sample, k);
+    BatCounters cnt = {0};
+
+    double best_ns = -1.0;
+    for (int s = 0; s < MODEL_SWEEPS; s++) {
+        double start = omp_get_wtime();
+        for (int i = 0; i < k; i++) update_bat(&sample[i], &best, A_mean, s, &cnt);
+        double ns = (omp_get_wtime() - start) * 1e9 / (double)k;
+        if (best_ns < 0.0 || ns < best_ns) best_ns = ns;
+    }
+    free(sample);
+    return best_ns;
+}
+
+/*
+ * w for --dim: the time of one bat update of the high-dimensional engine,
+ * measured on one group of the initial population (with --transform or
+ * --objective-expr, a batch of that group: the cost per bat barely
+ * depends on the batch size).
+ *
+ * Returns the time per update in ns, or -1 on error.
+ */
+static double model_work_hd_ns(const BatArgs *args) {
+    const BatOptions *opts = &args->opts;
+    int k = opts->hd_group < args->n_bats ? opts->hd_group : args->n_bats;
+    int batch = bat_hd_batched(opts);
+    BatArena arena;
+    size_t bytes = bat_hd_pop_bytes(k, opts->hd_dim) + bat_hd_scratch_bytes(bat_hd_tile_count(opts->hd_dim), k)
+                 + (batch ? bat_transform_bytes(opts->transform, opts->hd_dim, 2 * k) : 0);
+    if (bat_arena_create(&arena, bytes, opts->pages) != 0) {
+        return -1.0;
+    }
+    BatHdPop pop;
+    BatHdScratch scratch;
+    BatTransform tf;
+    if (bat_hd_pop_create(&pop, &arena, k, opts->hd_dim) != 0 || bat_hd_scratch_create(&scratch, &arena, &pop, k) != 0
+        || (batch && bat_transform_create(&tf, &arena, opts->transform, opts->hd_dim, 2 * k) != 0)) {
+        bat_arena_destroy(&arena);
+        return -1.0;
+    }
+    if (batch) pop.tf = &tf;
+    for (int i = 0; i < k; i++) bat_hd_init_bat(&pop, i, (uint32_t)args->seed);
+    if (batch) bat_hd_eval_init(&pop);
+    bat_hd_select_best(&pop);
+    double A_mean = bat_hd_mean_loudness(&pop);
+    BatCounters cnt = {0};
+
+    double best_ns = -1.0;
+    for (int s = 0; s < MODEL_SWEEPS; s++) {
+        double start = omp_get_wtime();
+        bat_hd_update_group(&pop, &scratch, 0, k, A_mean, s, &cnt);
+        double ns = (omp_get_wtime() - start) * 1e9 / (double)k;
+        if (best_ns < 0.0 || ns < best_ns) best_ns = ns;
+    }
+    bat_arena_destroy(&arena);
+    return best_ns;
+}
+
+/*
+ * Measures s(p): one empty iteration with the synchronization pattern of
+ * the OpenMP back-end (parallel region, two worksharing loops, two
+ * critical sections, one barrier).
+ *
+ * Returns the mean time per iteration in microseconds.
+ */
+static double model_sync_us(int threads) {
+    volatile long sink = 0;
+    double start = 0.0;
+
+    for (int r = 0; r < MODEL_SYNC_WARMUP + MODEL_SYNC_ITERS; r++) {
+        if (r == MODEL_SYNC_WARMUP) start = omp_get_wtime();
+        #pragma omp parallel num_threads(threads)
+        {
+            long local = 0;
+            #pragma omp for schedule(static)
+            for (int i = 0; i < threads; i++) local += i;
+            #pragma omp critical
+            sink += local;
+            #pragma omp barrier
+            #pragma omp for schedule(runtime)
+            for (int i = 0; i < threads; i++) local += i;
+            #pragma omp critical
+            sink += local;
+        }
+    }
+    return (omp_get_wtime() - start) * 1e6 / MODEL_SYNC_ITERS;
+}
+
+/*
+ * Calibrates the cost model and chooses the back-end and thread count
+ * for `args` on at most `max_threads` threads (1, 2, 4, ... and max) and
+ * `cores` processors.
+ * Returns 0 on success, -1 on error.
+ */
+static int model_choose(const BatArgs *args, int max_threads, int cores, BatCostModel *m) {
+    double start = omp_get_wtime();
+    memset(m, 0, sizeof(*m));
+
+    m->w_ns = args->opts.hd_dim > 0 ? model_work_hd_ns(args) : model_work_ns(args);
+    if (m->w_ns < 0.0) return -1;
+    m->seq_us = (double)args->n_bats * m->w_ns * 1e-3;
+    m->iter_us = m->seq_us;
+    m->threads = 1;
+
+    for (int p = 2; p <= max_threads; p = p * 2 < max_threads ? p * 2 : max_threads) {
+        double sync = model_sync_us(p);
+        double t = m->seq_us / (double)(p < cores ? p : cores) + sync;
+        if (t < m->iter_us * (1.0 - MODEL_MARGIN)) {
+            m->threads = p;
+            m->sync_us = sync;
+            m->iter_us = t;
+        }
+        if (p == max_threads) break;
+    }
+    m->calib_ms = (omp_get_wtime() - start) * 1e3;
+    return 0;
+}
+
+int main(int argc, char **argv) {
+    BatArgs args;
+    bat_args_parse(&args, argc, argv);
+
+    if (args.backend < 0) {
+        fprintf(stderr, "Invalid --backend (expected seq, omp, mpi or auto)\n");
+        return 1;
+    }
+
+    int ranks = launcher_ranks();
+    int backend = args.backend;
+    if (backend == BAT_BACKEND_AUTO && ranks > 1) backend = BAT_BACKEND_MPI;
+    if (ranks > 1 && backend != BAT_BACKEND_MPI) {
+        fprintf(stderr, "--backend %s cannot run under an MPI launcher with %d ranks (use --backend mpi or auto)\n",
+                bat_backend_name(backend), ranks);
+        return 1;
+    }
+
+    char extra[256];
+    if (backend == BAT_BACKEND_MPI) {
+        MPI_Init(&argc, &argv);
+        snprintf(extra, sizeof(extra), " backend=mpi");
+        args.bench_extra = extra;
+        int status = bat_run_mpi(&args);
+        MPI_Finalize();
+        return status;
+    }
+
+    if (backend == BAT_BACKEND_AUTO) {
+        if (args.n_bats <= 0) {
+            fprintf(stderr, "Invalid parameters: n_bats=%d\n", args.n_bats);
+            return 1;
+        }
+        if (bat_options_check(&args.opts) != 0) {
+            return 1;
+        }
+        bat_options_apply(&args.opts);
+
+        BatCostModel model;
+        if (model_choose(&args, omp_get_max_threads(), omp_get_num_procs(), &model) != 0) return 1;
+        backend = model.threads > 1 ? BAT_BACKEND_OMP : BAT_BACKEND_SEQ;
+        if (backend == BAT_BACKEND_OMP) omp_set_num_threads(model.threads);
+        if (!args.quiet) {
+            printf("Backend auto: %s with %d thread(s) (w=%.1f ns/bat, predicted %.2f us/iter vs %.2f sequential)\n",
+                   bat_backend_name(backend), model.threads, model.w_ns, model.iter_us, model.seq_us);
+        }
+        snprintf(extra, sizeof(extra),
+                 " backend=%s auto=1 model_w_ns=%.2f model_sync_us=%.3f model_iter_us=%.3f model_seq_us=%.3f model_ms=%.1f",
+                 bat_backend_name(backend), model.w_ns, model.sync_us, model.iter_us, model.seq_us, model.calib_ms);
+    } else {
+        snprintf(extra, sizeof(extra), " backend=%s", bat_backend_name(backend));
+    }
+    args.bench_extra = extra;
+
+    return backend == BAT_BACKEND_OMP ? bat_run_openmp(&args) : bat_run_sequential(&args);
+}
@@ -0,0 +1,151 @@
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <sys/mman.h>
+
+#include "bat_arena.h"
+
+/*
+ * bat_arena.c
+ *
+ * Purpose:
+ * Reserve the memory of a run in one (huge-page backed) mapping and hand it
+ * out with a bump pointer (see bat_arena.h).
+ */
+
+/* Huge page size used for rounding and alignment (x86-64 / arm64 default). */
+#define HUGE_PAGE_SIZE ((size_t)2 << 20)
+
+static size_t round_up(size_t v, size_t align) {
+    return (v + align - 1) / align * align;
+}
+
+int bat_pages_from_name(const char *name) {
+    if (strcmp(name, "auto") == 0)    return BAT_PAGES_AUTO;
+    if (strcmp(name, "off") == 0)     return BAT_PAGES_OFF;
+    if (strcmp(name, "thp") == 0)     return BAT_PAGES_THP;
+    if (strcmp(name, "hugetlb") == 0) return BAT_PAGES_HUGETLB;
+    return -1;
+}
+
+const char *bat_pages_name(int pages) {
+    switch (pages) {
+        case BAT_PAGES_OFF:     return "4k";
+        case BAT_PAGES_THP:     return "thp";
+        case BAT_PAGES_HUGETLB: return "hugetlb";
+        default:                return "auto";
+    }
+}
+
+size_t bat_arena_need(size_t bytes) {
+    return round_up(bytes, BAT_ARENA_ALIGN);
+}
+
+int bat_arena_create(BatArena *a, size_t size, int pages) {
+    memset(a, 0, sizeof(*a));
+    size_t len = round_up(size > 0 ? size : 1, HUGE_PAGE_SIZE);
+    void *p = MAP_FAILED;
+
+#ifdef MAP_HUGETLB
+    /* Explicit huge pages: the kernel aligns the mapping itself. */
+    if (pages == BAT_PAGES_AUTO || pages == BAT_PAGES_HUGETLB) {
+        p = mmap(NULL, len, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+        if (p != MAP_FAILED) {
+            a->map_base = p;
+            a->map_size = len;
+            a->base = p;
+            a->pages = BAT_PAGES_HUGETLB;
+            a->huge_size = len;
+        }
+    }
+#endif
+    if (p == MAP_FAILED && pages == BAT_PAGES_HUGETLB) {
+        fprintf(stderr, "--hugepages hugetlb: no huge pages available (see /proc/sys/vm/nr_hugepages)\n");
+        return -1;
+    }
+
+    if (p == MAP_FAILED) {
+        /* Over-map by one huge page so the arena can start on a 2 MB boundary. */
+        size_t map_len = len + HUGE_PAGE_SIZE;
+        p = mmap(NULL, map_len, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (p == MAP_FAILED) {
+            perror("mmap arena");
+            return -1;
+        }
+        a->map_base = p;
+        a->map_size = map_len;
+        a->base = (unsigned char *)round_up((size_t)(uintptr_t)p, HUGE_PAGE_SIZE);
+        a->pages = BAT_PAGES_OFF;
+#ifdef MADV_HUGEPAGE
+        if (pages != BAT_PAGES_OFF && madvise(a->base, len, MADV_HUGEPAGE) == 0) {
+            a->pages = BAT_PAGES_THP;
+        }
+#endif
+    }
+    a->size = len;
+    a->used = 0;
+    return 0;
+}
+
+int bat_arena_create_hot(BatArena *a, size_t size, size_t hot, int pages) {
+    size_t len = round_up(size > 0 ? size : 1, HUGE_PAGE_SIZE);
+    size_t hot_len = round_up(hot > 0 ? hot : 1, HUGE_PAGE_SIZE);
+    if (pages != BAT_PAGES_AUTO || hot_len >= len) return bat_arena_create(a, size, pages);
+
+    /* Reserve the whole arena with regular pages (2 MB-aligned, as for thp)... */
+    if (bat_arena_create(a, size, BAT_PAGES_THP) != 0) return -1;
+#ifdef MAP_HUGETLB
+    /*
+     * ...then map the hot part over its start with explicit huge pages.
+     * MAP_FIXED only replaces pages of our own reservation; if no huge page
+     * is free the regular ones are put back.
+     */
+    void *p = mmap(a->base, hot_len, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED | MAP_HUGETLB, -1, 0);
+    if (p == (void *)a->base) {
+        a->pages = BAT_PAGES_HUGETLB;
+        a->huge_size = hot_len;
+        return 0;
+    }
+    p = mmap(a->base, hot_len, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED, -1, 0);
+    if (p == MAP_FAILED) {
+        perror("mmap arena");
+        bat_arena_destroy(a);
+        return -1;
+    }
+#ifdef MADV_HUGEPAGE
+    if (a->pages == BAT_PAGES_THP) madvise(a->base, hot_len, MADV_HUGEPAGE);
+#endif
+#endif
+    return 0;
+}
+
+void *bat_arena_alloc(BatArena *a, size_t bytes) {
+    size_t need = bat_arena_need(bytes);
+    if (a->used + need > a->size) {
+        fprintf(stderr, "Arena exhausted: %zu bytes requested, %zu of %zu used\n", bytes, a->used, a->size);
+        return NULL;
+    }
+    void *p = a->base + a->used;
+    a->used += need;
+    return p;
+}
+
+size_t bat_arena_mark(const BatArena *a) {
+    return a->used;
+}
+
+void bat_arena_release(BatArena *a, size_t mark) {
+    if (mark <= a->used) a->used = mark;
+}
+
+void bat_arena_destroy(BatArena *a) {
+    if (a->map_base) munmap(a->map_base, a->map_size);
+    memset(a, 0, sizeof(*a));
+}
+
+void bat_arena_print_bench(const BatArena *a) {
+    printf(" arena_mb=%.1f pages=%s", (double)a->size / (1024.0 * 1024.0), bat_pages_name(a->pages));
+    if (a->pages == BAT_PAGES_HUGETLB && a->huge_size < a->size) {
+        printf(" hugetlb_mb=%.1f", (double)a->huge_size / (1024.0 * 1024.0));
+    }
+}
@@ -0,0 +1,227 @@
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <dirent.h>
+#include <sched.h>
+
+#include "bat_bind.h"
+
+/*
+ * bat_bind.c
+ *
+ * Purpose:
+ * Read the CPU topology from sysfs, pin threads / ranks with
+ * sched_setaffinity (--bind) and report where they ran.
+ */
+
+#define SYS_CPU  "/sys/devices/system/cpu"
+#define SYS_NODE "/sys/devices/system/node"
+
+int bat_bind_from_name(const char *name) {
+    if (strcmp(name, "none") == 0)    return BAT_BIND_NONE;
+    if (strcmp(name, "compact") == 0) return BAT_BIND_COMPACT;
+    if (strcmp(name, "spread") == 0)  return BAT_BIND_SPREAD;
+    if (strcmp(name, "numa") == 0)    return BAT_BIND_NUMA;
+    return -1;
+}
+
+const char *bat_bind_name(int kind) {
+    switch (kind) {
+        case BAT_BIND_COMPACT: return "compact";
+        case BAT_BIND_SPREAD:  return "spread";
+        case BAT_BIND_NUMA:    return "numa";
+        default:               return "none";
+    }
+}
+
+/* Reads the first line of a sysfs file into buf; returns 0 on success. */
+static int read_line(const char *path, char *buf, size_t len) {
+    FILE *fp = fopen(path, "r");
+    if (!fp) return -1;
+    int ok = fgets(buf, (int)len, fp) != NULL;
+    fclose(fp);
+    return ok ? 0 : -1;
+}
+
+static int read_int(const char *path, int fallback) {
+    char buf[32];
+    return read_line(path, buf, sizeof(buf)) == 0 ? atoi(buf) : fallback;
+}
+
+/*
+ * Looks for `cpu` in a sysfs CPU list ("0-3,8,10-11").
+ * Returns the number of listed CPUs below `cpu` if it is listed, -1 otherwise.
+ */
+static int cpulist_rank(const char *list, int cpu) {
+    int below = 0;
+    const char *p = list;
+    while (*p && *p != '\n') {
+        char *end;
+        long lo = strtol(p, &end, 10);
+        if (end == p) break;
+        long hi = lo;
+        if (*end == '-') {
+            p = end + 1;
+            hi = strtol(p, &end, 10);
+        }
+        if (cpu >= lo && cpu <= hi) return below + (int)(cpu - lo);
+        if (hi < cpu) below += (int)(hi - lo + 1);
+        p = (*end == ',') ? end + 1 : end;
+    }
+    return -1;
+}
+
+/* NUMA node of `cpu` (0 if the kernel exposes no node information). */
+static int cpu_node(int cpu) {
+    DIR *dir = opendir(SYS_NODE);
+    if (!dir) return 0;
+
+    int node = 0;
+    struct dirent *e;
+    while ((e = readdir(dir)) != NULL) {
+        int id;
+        char extra;
+        if (sscanf(e->d_name, "node%d%c", &id, &extra) != 1) continue;
+        char path[128], list[4096];
+        snprintf(path, sizeof(path), SYS_NODE "/node%d/cpulist", id);
+        if (read_line(path, list, sizeof(list)) == 0 && cpulist_rank(list, cpu) >= 0) {
+            node = id;
+            break;
+        }
+    }
+    closedir(dir);
+    return node;
+}
+
+static int cmp_cpu(const void *a, const void *b) {
+    const BatCpu *x = a, *y = b;
+    if (x->node != y->node) return x->node - y->node;
+    if (x->package != y->package) return x->package - y->package;
+    if (x->core != y->core) return x->core - y->core;
+    if (x->smt != y->smt) return x->smt - y->smt;
+    return x->id - y->id;
+}
+
+int bat_topology_load(BatTopology *topo) {
+    memset(topo, 0, sizeof(*topo));
+
+    cpu_set_t mask;
+    if (sched_getaffinity(0, sizeof(mask), &mask) != 0) {
+        perror("sched_getaffinity");
+        return -1;
+    }
+
+    for (int c = 0; c < CPU_SETSIZE && topo->n < BAT_BIND_MAX_CPUS; c++) {
+        if (!CPU_ISSET(c, &mask)) continue;
+
+        char path[128], list[256];
+        BatCpu *cpu = &topo->cpu[topo->n++];
+        cpu->id = c;
+        snprintf(path, sizeof(path), SYS_CPU "/cpu%d/topology/physical_package_id", c);
+        cpu->package = read_int(path, 0);
+        snprintf(path, sizeof(path), SYS_CPU "/cpu%d/topology/core_id", c);
+        cpu->core = read_int(path, c);
+        snprintf(path, sizeof(path), SYS_CPU "/cpu%d/topology/thread_siblings_list", c);
+        cpu->smt = read_line(path, list, sizeof(list)) == 0 ? cpulist_rank(list, c) : 0;
+        if (cpu->smt < 0) cpu->smt = 0;
+        cpu->node = cpu_node(c);
+    }
+    if (topo->n == 0) {
+        fprintf(stderr, "bind: no usable CPU found\n");
+        return -1;
+    }
+
+    qsort(topo->cpu, (size_t)topo->n, sizeof(BatCpu), cmp_cpu);
+    for (int i = 0; i < topo->n; i++) {
+        if (i == 0 || topo->cpu[i].node != topo->cpu[i - 1].node) topo->n_nodes++;
+    }
+    return 0;
+}
+
+/* Index in topo->cpu of the CPU for `slot` with --bind spread. */
+static int spread_index(const BatTopology *topo, int slot, int n_slots) {
+    /* First hardware thread of every core, in (node, package, core) order. */
+    int n_cores = 0;
+    for (int i = 0; i < topo->n; i++) {
+        if (topo->cpu[i].smt == 0) n_cores++;
+    }
+    if (n_cores == 0 || n_slots > n_cores) return slot % topo->n;
+
+    int k = (int)((long)slot * n_cores / n_slots);
+    for (int i = 0; i < topo->n; i++) {
+        if (topo->cpu[i].smt == 0 && k-- == 0) return i;
+    }
+    return slot % topo->n;
+}
+
+int bat_bind_self(const BatTopology *topo, int kind, int slot, int n_slots) {
+    if (kind == BAT_BIND_NONE || topo->n == 0) return 0;
+
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    if (kind == BAT_BIND_NUMA) {
+        /* Nodes are numbered in topo order (not by id: ids may have gaps). */
+        int want = slot % topo->n_nodes, k = -1;
+        for (int i = 0; i < topo->n; i++) {
+            if (i == 0 || topo->cpu[i].node != topo->cpu[i - 1].node) k++;
+            if (k == want) CPU_SET(topo->cpu[i].id, &set);
+        }
+    } else {
+        int i = kind == BAT_BIND_SPREAD ? spread_index(topo, slot, n_slots) : slot % topo->n;
+        CPU_SET(topo->cpu[i].id, &set);
+    }
+
+    if (sched_setaffinity(0, sizeof(set), &set) != 0) {
+        fprintf(stderr, "bind: sched_setaffinity for slot %d failed: %s\n", slot, strerror(errno));
+        return -1;
+    }
+    return 0;
+}
+
+void bat_bind_where(const BatTopology *topo, int host, BatBindSlot *slot) {
+    slot->host = host;
+    slot->cpu = sched_getcpu();
+    slot->node = slot->package = 0;
+    slot->core = slot->cpu;
+    for (int i = 0; i < topo->n; i++) {
+        if (topo->cpu[i].id == slot->cpu) {
+            slot->node = topo->cpu[i].node;
+            slot->package = topo->cpu[i].package;
+            slot->core = topo->cpu[i].core;
+            break;
+        }
+    }
+}
+
+static int same_core(const BatBindSlot *a, const BatBindSlot *b) {
+    return a->host == b->host && a->package == b->package && a->core == b->core;
+}
+
+void bat_bind_print_bench(int kind, const BatBindSlot slots[], int n) {
+    printf(" bind=%s cpu_map=", bat_bind_name(kind));
+    for (int i = 0; i < n; i++) {
+        printf(i == 0 ? "" : ",");
+        if (slots[i].host != slots[0].host) printf("h%d:", slots[i].host);
+        printf("%d", slots[i].cpu);
+    }
+
+    /* O(n^2) is fine: n is a thread or rank count. */
+    int cores = 0, shared = 0, nodes = 0;
+    for (int i = 0; i < n; i++) {
+        int first_core = 1, first_node = 1, sharing = 0;
+        for (int j = 0; j < n; j++) {
+            if (j == i) continue;
+            if (same_core(&slots[i], &slots[j])) {
+                sharing = 1;
+                if (j < i) first_core = 0;
+            }
+            if (j < i && slots[j].host == slots[i].host && slots[j].node == slots[i].node) first_node = 0;
+        }
+        cores += first_core;
+        nodes += first_node;
+        shared += sharing;
+    }
+    printf(" cores=%d smt_shared=%d nodes=%d", cores, shared, nodes);
+}
@@ -0,0 +1,506 @@
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+
+#include "bat.h"
+#include "bat_cc.h"
+#include "bat_rng.h"
+#include "bat_utils.h"
+#include "bat_xsum.h"
+
+/*
+ * bat_cc.c
+ *
+ * Purpose:
+ * Cooperative coevolution on the high-dimensional engine: decomposition
+ * of the coordinates, sub-swarm rounds against the context vector and
+ * merging of their results (see bat_cc.h).
+ */
+
+/* Seed mixes of the sub-swarm bats and of the random groupings. */
+#define CC_BAT_MIX   0x2545F491u
+#define CC_GROUP_MIX 0x9E3779B9u
+
+/*
+ * Differential grouping probes: every coordinate at Lb, the coordinates
+ * of X1 moved to CC_PROBE_X1 and those of X2 to CC_PROBE_X2 (fractions of
+ * [Lb, Ub]). The points are not symmetric around 0, so that terms in x^2
+ * also change. Two sets interact if the two differences of X1's effect
+ * differ by more than CC_DG_ALPHA times the largest probe value
+ * (rounding of an O(dim) sum stays far below).
+ */
+#define CC_PROBE_X1 0.8
+#define CC_PROBE_X2 0.5
+#define CC_DG_ALPHA 1e-10
+
+/* group_round() is specialized per objective (see bat_cc_run_group()). */
+#if defined(__GNUC__)
+#define CC_INLINE static inline __attribute__((always_inline))
+#else
+#define CC_INLINE static inline
+#endif
+
+static const char *cc_names[] = { "none", "random", "diff" };
+
+int bat_cc_from_name(const char *name) {
+    for (int k = BAT_CC_NONE; k <= BAT_CC_DIFF; k++) {
+        if (strcmp(name, cc_names[k]) == 0) return k;
+    }
+    return -1;
+}
+
+const char *bat_cc_name(int kind) {
+    return (kind >= BAT_CC_NONE && kind <= BAT_CC_DIFF) ? cc_names[kind] : "unknown";
+}
+
+int bat_cc_check(const BatOptions *opts) {
+    if (opts->hd_dim == 0) {
+        fprintf(stderr, "--cc needs --dim\n");
+        return -1;
+    }
+    if (bat_hd_batched(opts)) {
+        fprintf(stderr, "--cc needs a built-in --objective (no --transform or --objective-expr)\n");
+        return -1;
+    }
+    if (opts->hd_slices > 1) {
+        fprintf(stderr, "--cc cannot be combined with --hd-slices (the MPI back-end distributes the groups)\n");
+        return -1;
+    }
+    if (opts->cc_size < 1 || opts->cc_iters < 1) {
+        fprintf(stderr, "Invalid --cc-size %d / --cc-iters %d\n", opts->cc_size, opts->cc_iters);
+        return -1;
+    }
+    return 0;
+}
+
+static int group_count(int dim, int size) {
+    return (dim + size - 1) / size;
+}
+
+size_t bat_cc_bytes(int dim, int n_bats, int size) {
+    size_t groups = (size_t)group_count(dim, size);
+    return 3 * bat_arena_need((size_t)dim * sizeof(int)) + bat_arena_need((groups + 1) * sizeof(int))
+         + 2 * bat_arena_need((size_t)n_bats * (size_t)dim * sizeof(bat_real))
+         + bat_arena_need(groups * (size_t)n_bats * sizeof(BatHdBat)) + bat_arena_need((size_t)dim * sizeof(bat_real))
+         + 2 * bat_arena_need(groups * sizeof(double));
+}
+
+size_t bat_cc_scratch_bytes(int dim) {
+    return bat_arena_need((size_t)dim * sizeof(double)) + bat_arena_need((size_t)2 * dim * sizeof(int))
+         + 2 * bat_arena_need((size_t)dim * sizeof(bat_real)) + bat_arena_need((size_t)4 * dim * sizeof(int));
+}
+
+int bat_cc_create(BatCc *cc, BatArena *arena, int kind, int dim, int n_bats, int size, uint32_t seed) {
+    memset(cc, 0, sizeof(*cc));
+    cc->kind = kind;
+    cc->dim = dim;
+    cc->n_bats = n_bats;
+    cc->size = size < dim ? size : dim;
+    cc->max_groups = group_count(dim, cc->size);
+    cc->seed = seed;
+
+    size_t groups = (size_t)cc->max_groups;
+    cc->perm = bat_arena_alloc(arena, (size_t)dim * sizeof(int));
+    cc->group = bat_arena_alloc(arena, (size_t)dim * sizeof(int));
+    cc->start = bat_arena_alloc(arena, (groups + 1) * sizeof(int));
+    cc->xb = bat_arena_alloc(arena, (size_t)n_bats * (size_t)dim * sizeof(bat_real));
+    cc->vb = bat_arena_alloc(arena, (size_t)n_bats * (size_t)dim * sizeof(bat_real));
+    cc->bat = bat_arena_alloc(arena, groups * (size_t)n_bats * sizeof(BatHdBat));
+    cc->guide = bat_arena_alloc(arena, (size_t)dim * sizeof(bat_real));
+    cc->guide_f = bat_arena_alloc(arena, groups * sizeof(double));
+    cc->base_f = bat_arena_alloc(arena, groups * sizeof(double));
+    if (!cc->perm || !cc->group || !cc->start || !cc->xb || !cc->vb || !cc->bat || !cc->guide || !cc->guide_f
+        || !cc->base_f) {
+        return -1;
+    }
+
+    /* Sub-swarm slot g keeps its bats' state across regroupings. */
+    for (size_t k = 0; k < groups * (size_t)n_bats; k++) {
+        BatHdBat *b = &cc->bat[k];
+        b->rng_state = bat_rng_init(seed ^ CC_BAT_MIX, (uint32_t)k);
+        b->f_i = bat_params.f_min;
+        b->A_i = bat_params.a0;
+        b->r_i = bat_params.r0;
+        b->f_value = 0.0;
+    }
+    return 0;
+}
+
+int bat_cc_scratch_create(BatCcScratch *s, BatArena *arena, const BatCc *cc) {
+    s->work = bat_arena_alloc(arena, (size_t)cc->dim * sizeof(double));
+    s->terms = bat_arena_alloc(arena, (size_t)2 * cc->dim * sizeof(int));
+    s->cand = bat_arena_alloc(arena, (size_t)cc->dim * sizeof(bat_real));
+    s->walk = bat_arena_alloc(arena, (size_t)cc->dim * sizeof(bat_real));
+    s->list = bat_arena_alloc(arena, (size_t)4 * cc->dim * sizeof(int));
+    s->n_terms = 0;
+    return (s->work && s->terms && s->cand && s->walk && s->list) ? 0 : -1;
+}
+
+/* Equal groups of cc->size positions (the last one shorter). */
+static void equal_groups(BatCc *cc) {
+    cc->n_groups = cc->max_groups;
+    for (int g = 0; g <= cc->n_groups; g++) cc->start[g] = g * cc->size < cc->dim ? g * cc->size : cc->dim;
+}
+
+/* Random grouping of round `round`: a fresh shuffle of the coordinates. */
+static void random_groups(BatCc *cc, int round) {
+    uint32_t rng = bat_rng_init(cc->seed ^ CC_GROUP_MIX, (uint32_t)round);
+    for (int p = 0; p < cc->dim; p++) cc->perm[p] = p;
+    for (int p = cc->dim - 1; p > 0; p--) {
+        int q = (int)(bat_rng_uniform01(&rng) * (double)(p + 1));
+        if (q > p) q = p;
+        int tmp = cc->perm[p];
+        cc->perm[p] = cc->perm[q];
+        cc->perm[q] = tmp;
+    }
+    equal_groups(cc);
+}
+
+/*
+ * Appends to out[] the coordinates of x2[0, n2) that interact with X1:
+ * p1 has every coordinate at Lb, p2 the same with X1 moved (values f1,
+ * f2). X2 is tested as a whole and split in halves while it interacts,
+ * so finding k interacting coordinates costs O(k log n2) probes.
+ * Returns the evaluations.
+ */
+static long dg_interact(int id, int dim, bat_real *p1, bat_real *p2, double f1, double f2, const int *x2, int n2,
+                        int *out, int *n_out) {
+    const bat_real mid = (bat_real)(Lb + CC_PROBE_X2 * (Ub - Lb));
+    for (int k = 0; k < n2; k++) p1[x2[k]] = p2[x2[k]] = mid;
+    double f3 = bat_hd_objective(id, p1, dim);
+    double f4 = bat_hd_objective(id, p2, dim);
+    for (int k = 0; k < n2; k++) p1[x2[k]] = p2[x2[k]] = (bat_real)Lb;
+
+    double scale = fmax(fmax(fabs(f1), fabs(f2)), fmax(fabs(f3), fabs(f4)));
+    long evals = 2;
+    if (fabs((f1 - f2) - (f3 - f4)) <= CC_DG_ALPHA * scale) return evals;
+    if (n2 == 1) {
+        out[(*n_out)++] = x2[0];
+        return evals;
+    }
+    evals += dg_interact(id, dim, p1, p2, f1, f2, x2, n2 / 2, out, n_out);
+    evals += dg_interact(id, dim, p1, p2, f1, f2, x2 + n2 / 2, n2 - n2 / 2, out, n_out);
+    return evals;
+}
+
+/*
+ * Recursive differential grouping: X1 starts with the first remaining
+ * coordinate and absorbs the remaining coordinates it interacts with,
+ * until none is left; a single coordinate is separable. The non-separable
+ * sets come first in cc->perm (in the order they are found), then the
+ * separable coordinates; groups are then closed at the first set boundary
+ * after cc->size positions, so a set is never split.
+ * Returns the evaluations.
+ */
+static long diff_groups(BatCc *cc, BatCcScratch *s) {
+    const int id = bat_get_objective(), dim = cc->dim;
+    const bat_real hi = (bat_real)(Lb + CC_PROBE_X1 * (Ub - Lb));
+    int *x1 = s->list, *rem = s->list + dim, *out = s->list + 2 * dim, *sep = s->list + 3 * dim;
+    bat_real *p1 = s->cand, *p2 = s->walk;
+    int n_rem = dim, n_sep = 0, n_perm = 0, unit = 0;
+
+    for (int d = 0; d < dim; d++) {
+        rem[d] = d;
+        p1[d] = p2[d] = (bat_real)Lb;
+    }
+    double f1 = bat_hd_objective(id, p1, dim);
+    long evals = 1;
+
+    while (n_rem > 0) {
+        int n1 = 1;
+        x1[0] = rem[0];
+        memmove(rem, rem + 1, (size_t)(--n_rem) * sizeof(int));
+        p2[x1[0]] = hi;
+        for (;;) {
+            int n_out = 0;
+            double f2 = bat_hd_objective(id, p2, dim);
+            evals++;
+            if (n_rem > 0) evals += dg_interact(id, dim, p1, p2, f1, f2, rem, n_rem, out, &n_out);
+            if (n_out == 0) break;
+            /* X1 grows: drop the new members from the remaining set (order kept), test again. */
+            for (int k = 0, r = 0, w = 0; r < n_rem; r++) {
+                if (k < n_out && rem[r] == out[k]) {
+                    k++;
+                } else {
+                    rem[w++] = rem[r];
+                }
+            }
+            n_rem -= n_out;
+            for (int k = 0; k < n_out; k++) {
+                x1[n1++] = out[k];
+                p2[out[k]] = hi;
+            }
+        }
+        for (int k = 0; k < n1; k++) p2[x1[k]] = (bat_real)Lb;
+        if (n1 == 1) {
+            sep[n_sep++] = x1[0];
+        } else {
+            for (int k = 0; k < n1; k++) {
+                cc->perm[n_perm++] = x1[k];
+                cc->group[x1[k]] = unit;
+            }
+            unit++;
+            cc->dg_nonsep += n1;
+        }
+    }
+    for (int k = 0; k < n_sep; k++) {
+        cc->perm[n_perm++] = sep[k];
+        cc->group[sep[k]] = unit++;
+    }
+
+    cc->n_groups = 0;
+    cc->start[0] = 0;
+    for (int p = 1; p <= dim; p++) {
+        int boundary = p == dim || cc->group[cc->perm[p]] != cc->group[cc->perm[p - 1]];
+        if (boundary && (p - cc->start[cc->n_groups] >= cc->size || p == dim)) cc->start[++cc->n_groups] = p;
+    }
+    return evals;
+}
+
+long bat_cc_regroup(BatCc *cc, BatCcScratch *s, int round) {
+    long evals = 0;
+    if (cc->kind == BAT_CC_RANDOM) {
+        random_groups(cc, round);
+    } else if (round == 0) {
+        evals = diff_groups(cc, s);
+        cc->dg_evals = evals;
+    } else {
+        return 0;
+    }
+    for (int g = 0; g < cc->n_groups; g++) {
+        for (int p = cc->start[g]; p < cc->start[g + 1]; p++) cc->group[cc->perm[p]] = g;
+    }
+    return evals;
+}
+
+void bat_cc_pack(BatCc *cc, const BatHdPop *pop, int first, int count) {
+    for (int i = first; i < first + count; i++) {
+        const bat_real *x = pop->x + (size_t)i * (size_t)pop->stride;
+        const bat_real *v = pop->v + (size_t)i * (size_t)pop->stride;
+        for (int g = 0; g < cc->n_groups; g++) {
+            const int p0 = cc->start[g], n = cc->start[g + 1] - p0;
+            const size_t row = (size_t)cc->n_bats * (size_t)p0 + (size_t)i * (size_t)n;
+            for (int l = 0; l < n; l++) {
+                cc->xb[row + l] = x[cc->perm[p0 + l]];
+                cc->vb[row + l] = v[cc->perm[p0 + l]];
+            }
+        }
+    }
+}
+
+void bat_cc_unpack(const BatCc *cc, BatHdPop *pop, int first, int count) {
+    for (int i = first; i < first + count; i++) {
+        bat_real *x = pop->x + (size_t)i * (size_t)pop->stride;
+        bat_real *v = pop->v + (size_t)i * (size_t)pop->stride;
+        for (int g = 0; g < cc->n_groups; g++) {
+            const int p0 = cc->start[g], n = cc->start[g + 1] - p0;
+            const size_t row = (size_t)cc->n_bats * (size_t)p0 + (size_t)i * (size_t)n;
+            for (int l = 0; l < n; l++) {
+                x[cc->perm[p0 + l]] = cc->xb[row + l];
+                v[cc->perm[p0 + l]] = cc->vb[row + l];
+            }
+        }
+    }
+}
+
+/* Term of coordinate d (value xd) in the partial sums of a separable objective (formulas of bat_objective_eval()). */
+CC_INLINE void coord_term(int id, double xd, int d, double *p0, double *p1) {
+    switch (id) {
+        case BAT_OBJ_RASTRIGIN:
+            *p0 += xd * xd - 10.0 * cos(2.0 * M_PI * xd);
+            break;
+        case BAT_OBJ_ACKLEY:
+            *p0 += xd * xd;
+            *p1 += cos(2.0 * M_PI * xd);
+            break;
+        case BAT_OBJ_GRIEWANK:
+            *p0 += xd * xd;
+            *p1 *= cos(xd / sqrt((double)(d + 1)));
+            break;
+        default:   /* paraboloid, sphere */
+            *p0 += xd * xd;
+            break;
+    }
+}
+
+/* Rosenbrock term of the pair (d, d + 1). */
+CC_INLINE double pair_term(double x0, double x1) {
+    double a = x1 - x0 * x0;
+    double b = 1.0 - x0;
+    return 100.0 * a * a + b * b;
+}
+
+/*
+ * Terms of group g and partial sums of all the others, on the context:
+ * coordinates in increasing order, or Rosenbrock pairs touching the group
+ * (the context is then copied to s->work, where candidates are written).
+ */
+CC_INLINE void group_terms(int id, const BatCc *cc, const bat_real *ctx, BatCcScratch *s, int g) {
+    double p0 = 0.0, p1 = (id == BAT_OBJ_GRIEWANK) ? 1.0 : 0.0;
+    s->n_terms = 0;
+    if (id == BAT_OBJ_ROSENBROCK) {
+        for (int d = 0; d < cc->dim; d++) s->work[d] = (double)ctx[d];
+        for (int d = 0; d + 1 < cc->dim; d++) {
+            if (cc->group[d] == g || cc->group[d + 1] == g) s->terms[s->n_terms++] = d;
+            else p0 += pair_term(s->work[d], s->work[d + 1]);
+        }
+    } else {
+        for (int d = 0; d < cc->dim; d++) {
+            if (cc->group[d] != g) coord_term(id, (double)ctx[d], d, &p0, &p1);
+        }
+    }
+    s->rest[0] = p0;
+    s->rest[1] = p1;
+}
+
+/* Value of the context with the coordinates of group g (positions perm[0, n)) replaced by c. */
+CC_INLINE double group_value(int id, const BatCc *cc, BatCcScratch *s, const int *perm, int n, const bat_real *c) {
+    double acc[BAT_HD_PARTS] = { s->rest[0], s->rest[1], 0.0, 0.0 };
+    if (id == BAT_OBJ_ROSENBROCK) {
+        for (int l = 0; l < n; l++) s->work[perm[l]] = (double)c[l];
+        for (int k = 0; k < s->n_terms; k++) {
+            acc[0] += pair_term(s->work[s->terms[k]], s->work[s->terms[k] + 1]);
+        }
+    } else {
+        for (int l = 0; l < n; l++) coord_term(id, (double)c[l], perm[l], &acc[0], &acc[1]);
+    }
+    return bat_hd_value(id, acc, cc->dim);
+}
+
+static bat_real clamp_coord(bat_real c) {
+    return c < Lb ? (bat_real)Lb : (c > Ub ? (bat_real)Ub : c);
+}
+
+/* Guide <- best bat of the sub-swarm (lowest index on ties) if it is better. */
+static void group_best(BatCc *cc, int g, const bat_real *xb, int n) {
+    const BatHdBat *bats = cc->bat + (size_t)g * (size_t)cc->n_bats;
+    int best = 0;
+    for (int i = 1; i < cc->n_bats; i++) {
+        if (bats[i].f_value > bats[best].f_value) best = i;
+    }
+    if (bats[best].f_value <= cc->guide_f[g]) return;
+    cc->guide_f[g] = bats[best].f_value;
+    memcpy(cc->guide + cc->start[g], xb + (size_t)best * (size_t)n, (size_t)n * sizeof(bat_real));
+}
+
+/*
+ * Round of sub-swarm g (see bat_cc_run_group()). An iteration updates
+ * every bat as update_bat() does, on the group's coordinates: frequency,
+ * velocity towards the guide, candidate (clamped), local walk around the
+ * guide when the pulse test fails, acceptance by value and loudness.
+ */
+CC_INLINE long group_round(int id, BatCc *cc, const BatHdPop *pop, BatCcScratch *s, int g, int t, int iters,
+                           BatCounters *cnt) {
+    const BatParams *p = &bat_params;
+    const int p0 = cc->start[g], n = cc->start[g + 1] - p0;
+    const int *perm = cc->perm + p0;
+    bat_real *xb = cc->xb + (size_t)cc->n_bats * (size_t)p0;
+    bat_real *vb = cc->vb + (size_t)cc->n_bats * (size_t)p0;
+    bat_real *guide = cc->guide + p0;
+    BatHdBat *bats = cc->bat + (size_t)g * (size_t)cc->n_bats;
+    long evals = 1 + cc->n_bats;
+
+    /* The context on the group is the first guide; the bats are re-evaluated on the new context. */
+    group_terms(id, cc, pop->best_x, s, g);
+    for (int l = 0; l < n; l++) guide[l] = pop->best_x[perm[l]];
+    cc->base_f[g] = cc->guide_f[g] = group_value(id, cc, s, perm, n, guide);
+    for (int i = 0; i < cc->n_bats; i++) {
+        bats[i].f_value = group_value(id, cc, s, perm, n, xb + (size_t)i * (size_t)n);
+    }
+    group_best(cc, g, xb, n);
+
+    for (int it = t; it < t + iters; it++) {
+        BatExactSum loud;
+        bat_xsum_clear(&loud);
+        for (int i = 0; i < cc->n_bats; i++) bat_xsum_add(&loud, bats[i].A_i);
+        const double A_mean = bat_xsum_value(&loud) / (double)cc->n_bats;
+        cnt->amean_calls++;
+        cnt->amean_scanned += cc->n_bats;
+
+        for (int i = 0; i < cc->n_bats; i++) {
+            BatHdBat *b = &bats[i];
+            bat_real *x = xb + (size_t)i * (size_t)n;
+            bat_real *v = vb + (size_t)i * (size_t)n;
+
+            b->f_i = p->f_min + (p->f_max - p->f_min) * bat_rng_uniform01(&b->rng_state);
+            const bat_real f = (bat_real)b->f_i;
+            for (int l = 0; l < n; l++) {
+                v[l] += (guide[l] - x[l]) * f;
+                bat_real raw = x[l] + v[l];
+                s->cand[l] = clamp_coord(raw);
+                cnt->clamps += s->cand[l] != raw;
+            }
+            double Fnew = group_value(id, cc, s, perm, n, s->cand);
+            bat_real *chosen = s->cand;
+            evals++;
+
+            if (bat_rng_uniform01(&b->rng_state) > b->r_i) {
+                cnt->local_search++;
+                for (int l = 0; l < n; l++) {
+                    bat_real raw = (bat_real)(guide[l] + 0.1 * bat_rng_normal(&b->rng_state, 0.0, 1.0) * A_mean);
+                    s->walk[l] = clamp_coord(raw);
+                    cnt->clamps += s->walk[l] != raw;
+                }
+                double F_walk = group_value(id, cc, s, perm, n, s->walk);
+                evals++;
+                if (F_walk > Fnew) {   /* we maximize */
+                    Fnew = F_walk;
+                    chosen = s->walk;
+                }
+            }
+
+            double rand_loud = bat_rng_uniform01(&b->rng_state);
+            if (Fnew > b->f_value && rand_loud < b->A_i) {
+                memcpy(x, chosen, (size_t)n * sizeof(bat_real));
+                b->f_value = Fnew;
+                b->A_i *= p->alpha;
+                b->r_i = p->r0 * (1.0 - exp(-p->gamma * it));
+                cnt->accepts++;
+            }
+        }
+        group_best(cc, g, xb, n);
+    }
+    return evals;
+}
+
+long bat_cc_run_group(BatCc *cc, const BatHdPop *pop, BatCcScratch *s, int g, int t, int iters, BatCounters *cnt) {
+    /* One copy of the round per objective: the term functions fold to a few instructions. */
+    switch (bat_get_objective()) {
+        case BAT_OBJ_SPHERE:     return group_round(BAT_OBJ_SPHERE, cc, pop, s, g, t, iters, cnt);
+        case BAT_OBJ_RASTRIGIN:  return group_round(BAT_OBJ_RASTRIGIN, cc, pop, s, g, t, iters, cnt);
+        case BAT_OBJ_ACKLEY:     return group_round(BAT_OBJ_ACKLEY, cc, pop, s, g, t, iters, cnt);
+        case BAT_OBJ_GRIEWANK:   return group_round(BAT_OBJ_GRIEWANK, cc, pop, s, g, t, iters, cnt);
+        case BAT_OBJ_ROSENBROCK: return group_round(BAT_OBJ_ROSENBROCK, cc, pop, s, g, t, iters, cnt);
+        default:                 return group_round(BAT_OBJ_PARABOLOID, cc, pop, s, g, t, iters, cnt);
+    }
+}
+
+long bat_cc_merge(const BatCc *cc, BatHdPop *pop, BatCcScratch *s, BatCounters *cnt) {
+    const int id = bat_get_objective();
+    long evals = 0;
+    int improved = 0;
+    for (int g = 0; g < cc->n_groups; g++) {
+        if (cc->guide_f[g] <= cc->base_f[g]) continue;
+        const int p0 = cc->start[g], n = cc->start[g + 1] - p0;
+        for (int l = 0; l < n; l++) {
+            s->cand[l] = pop->best_x[cc->perm[p0 + l]];
+            pop->best_x[cc->perm[p0 + l]] = cc->guide[p0 + l];
+        }
+        double f = bat_hd_objective(id, pop->best_x, cc->dim);
+        evals++;
+        if (f > pop->best_f) {
+            pop->best_f = f;
+            improved = 1;
+        } else {
+            for (int l = 0; l < n; l++) pop->best_x[cc->perm[p0 + l]] = s->cand[l];
+        }
+    }
+    if (improved) cnt->best_changes++;
+    return evals;
+}
+
+void bat_cc_print_bench(const BatCc *cc, int iters) {
+    printf(" dim=%d hd_mode=cc cc=%s cc_groups=%d cc_size=%d cc_iters=%d", cc->dim, bat_cc_name(cc->kind),
+           cc->n_groups, cc->size, iters);
+    if (cc->kind == BAT_CC_DIFF) printf(" dg_evals=%ld dg_nonsep=%d", cc->dg_evals, cc->dg_nonsep);
+}
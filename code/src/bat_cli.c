@@ -0,0 +1,75 @@
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "bat.h"
+#include "bat_cli.h"
+#include "bat_tune.h"
+
+/*
+ * bat_cli.c
+ *
+ * Purpose:
+ * Parse the basic command-line options of all the programs (see
+ * bat_cli.h).
+ */
+
+int bat_backend_from_name(const char *name) {
+    if (strcmp(name, "auto") == 0) return BAT_BACKEND_AUTO;
+    if (strcmp(name, "seq") == 0)  return BAT_BACKEND_SEQ;
+    if (strcmp(name, "omp") == 0)  return BAT_BACKEND_OMP;
+    if (strcmp(name, "mpi") == 0)  return BAT_BACKEND_MPI;
+    return -1;
+}
+
+const char *bat_backend_name(int backend) {
+    switch (backend) {
+        case BAT_BACKEND_SEQ: return "seq";
+        case BAT_BACKEND_OMP: return "omp";
+        case BAT_BACKEND_MPI: return "mpi";
+        default:              return "auto";
+    }
+}
+
+/*
+ * Parses command-line arguments and sets execution parameters.
+ *
+ * Parameters:
+ *   - args : parsed arguments (see BatArgs)
+ *   - argc : number of command-line arguments
+ *   - argv : array of command-line arguments
+ */
+void bat_args_parse(BatArgs *args, int argc, char **argv) {
+    memset(args, 0, sizeof(*args));
+    args->n_bats = N_BATS;
+    args->max_iters = MAX_ITERS;
+    args->seed = (unsigned int)time(NULL);
+    args->do_snapshot = 1;
+    args->quiet = 0;
+    args->autotune = 0;
+    args->tune_cache = BAT_TUNE_CACHE_DEFAULT;
+    args->backend = BAT_BACKEND_AUTO;
+    bat_options_defaults(&args->opts);
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--n-bats") == 0 && i + 1 < argc) {
+            args->n_bats = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--iters") == 0 && i + 1 < argc) {
+            args->max_iters = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc) {
+            args->seed = (unsigned int)strtoul(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "--no-snapshot") == 0) {
+            args->do_snapshot = 0;
+        } else if (strcmp(argv[i], "--quiet") == 0) {
+            args->quiet = 1;
+        } else if (strcmp(argv[i], "--autotune") == 0) {
+            args->autotune = 1;
+        } else if (strcmp(argv[i], "--tune-cache") == 0 && i + 1 < argc) {
+            args->tune_cache = argv[++i];
+        } else if (strcmp(argv[i], "--backend") == 0 && i + 1 < argc) {
+            args->backend = bat_backend_from_name(argv[++i]);
+        } else {
+            bat_options_parse(&args->opts, argc, argv, &i);
+        }
+    }
+}
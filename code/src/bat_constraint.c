@@ -0,0 +1,205 @@
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "bat.h"
+#include "bat_constraint.h"
+#include "bat_expr.h"
+#include "bat_isa.h"
+#include "bat_utils.h"
+
+/*
+ * bat_constraint.c
+ *
+ * Purpose:
+ * Inequality constraints: batch evaluation of the violations, the
+ * feasibility rules (deb, eps, penalty) and their schedules, and the
+ * screening of candidates before the objective (see bat_constraint.h).
+ */
+
+BatConstraints bat_con = { 0 };
+
+/* Compiled --constraint expressions. */
+static BatExprProg con_progs[BAT_CON_MAX];
+
+static const char *con_names[] = { "deb", "eps", "penalty" };
+
+int bat_con_from_name(const char *name) {
+    for (int k = BAT_CON_DEB; k <= BAT_CON_PENALTY; k++) {
+        if (strcmp(name, con_names[k]) == 0) return k;
+    }
+    return -1;
+}
+
+const char *bat_con_name(int mode) {
+    return (mode >= BAT_CON_DEB && mode <= BAT_CON_PENALTY) ? con_names[mode] : "unknown";
+}
+
+int bat_con_check(const BatConOptions *o) {
+    static BatExprProg prog;
+
+    if (o->n < 0) {
+        fprintf(stderr, "Too many --constraint (at most %d)\n", BAT_CON_MAX);
+        return -1;
+    }
+    if (o->mode < 0) {
+        fprintf(stderr, "Invalid --con-mode (expected deb, eps or penalty)\n");
+        return -1;
+    }
+    if (o->penalty <= 0.0) {
+        fprintf(stderr, "Invalid --con-penalty %g\n", o->penalty);
+        return -1;
+    }
+    for (int k = 0; k < o->n; k++) {
+        if (bat_expr_compile(&prog, o->expr[k], dimension) != 0) return -1;
+    }
+    return 0;
+}
+
+/* Batch function of a compiled expression (ctx = its BatExprProg). */
+static void expr_constraint(const void *ctx, const double *rows, int ld, int count, double out[]) {
+    bat_kernels.expr((const BatExprProg *)ctx, rows, ld, count, out);
+}
+
+int bat_con_add_batch(BatConFn fn, const void *ctx) {
+    if (bat_con.n >= BAT_CON_MAX) return -1;
+    bat_con.fn[bat_con.n] = fn;
+    bat_con.ctx[bat_con.n] = ctx;
+    bat_con.n++;
+    return 0;
+}
+
+/*
+ * Installs the constraints and the rule.
+ *
+ * Parameters:
+ *   - o         : command-line settings (already checked)
+ *   - objective : BAT_OBJ_* in use
+ */
+void bat_con_install(const BatConOptions *o, int objective) {
+    memset(&bat_con, 0, sizeof(bat_con));
+    for (int k = 0; k < o->n; k++) {
+        /* Already compiled once by bat_con_check(). */
+        bat_expr_compile(&con_progs[k], o->expr[k], dimension);
+        con_progs[k].nonfinite = INFINITY;   /* an undefined constraint is violated */
+        bat_con_add_batch(expr_constraint, &con_progs[k]);
+    }
+    bat_con.mode = o->mode;
+    bat_con.eps0 = o->eps;
+    bat_con.eps = 0.0;
+    bat_con.lambda0 = bat_con.lambda = o->penalty;
+    bat_con.f_bound = objective == BAT_OBJ_EXPR ? INFINITY : bat_objective_optimum(objective);
+}
+
+/*
+ * Violations of `count` points, BAT_EXPR_LANES at a time.
+ *
+ * Parameters:
+ *   - rows  : first coordinate of the first point
+ *   - ld    : stride between points (doubles)
+ *   - count : number of points
+ *   - v     : output, one violation per point
+ */
+void bat_con_violation(const double *rows, int ld, int count, double v[]) {
+    double g[BAT_EXPR_LANES];
+    for (int c = 0; c < count; c++) v[c] = 0.0;
+    for (int c0 = 0; c0 < count; c0 += BAT_EXPR_LANES) {
+        const int w = count - c0 < BAT_EXPR_LANES ? count - c0 : BAT_EXPR_LANES;
+        for (int k = 0; k < bat_con.n; k++) {
+            bat_con.fn[k](bat_con.ctx[k], rows + (size_t)c0 * (size_t)ld, ld, w, g);
+            for (int c = 0; c < w; c++) {
+                if (g[c] > 0.0) v[c0 + c] += g[c];
+            }
+        }
+    }
+}
+
+double bat_con_rank(double f, double v) {
+    if (bat_con.mode == BAT_CON_PENALTY) return f - bat_con.lambda * v;
+    return v > bat_con.eps ? BAT_CON_INFEASIBLE * (1.0 + v) : f;
+}
+
+int bat_con_screen(double v, double current, double *rank) {
+    if (bat_con.mode != BAT_CON_PENALTY && v > bat_con.eps) {
+        *rank = BAT_CON_INFEASIBLE * (1.0 + v);
+        return 1;
+    }
+    /* f <= f_bound, and the rank is non-decreasing in f. */
+    double bound = bat_con.mode == BAT_CON_PENALTY ? bat_con.f_bound - bat_con.lambda * v : bat_con.f_bound;
+    if (bound <= current) {
+        *rank = -INFINITY;
+        return 1;
+    }
+    return 0;
+}
+
+double bat_con_point(const bat_real x[], double f, double *viol) {
+    double row[dimension];
+    for (int d = 0; d < dimension; d++) row[d] = (double)x[d];
+    bat_con_violation(row, dimension, 1, viol);
+    return bat_con_rank(f, *viol);
+}
+
+void bat_con_violation_sum(const Bat bats[], int n_bats, BatExactSum *sum) {
+    bat_xsum_clear(sum);
+    for (int i = 0; i < n_bats; i++) bat_xsum_add(sum, bats[i].viol);
+}
+
+/*
+ * Parameters:
+ *   - sum       : violations of the initial population (all ranks)
+ *   - n_bats    : global population size
+ *   - max_iters : iterations of the run
+ */
+void bat_con_start(const BatExactSum *sum, int n_bats, int max_iters) {
+    if (bat_con.eps0 < 0.0) bat_con.eps0 = bat_xsum_value(sum) / (double)n_bats;
+    bat_con.eps_iters = (int)(BAT_CON_EPS_FRAC * max_iters);
+    bat_con.eps = bat_con.mode == BAT_CON_EPS ? bat_con.eps0 : 0.0;
+    bat_con.feas_run = bat_con.infeas_run = 0;
+}
+
+int bat_con_advance(int t, const Bat *best) {
+    switch (bat_con.mode) {
+        case BAT_CON_EPS: {
+            double eps = 0.0;
+            if (t < bat_con.eps_iters) {
+                eps = bat_con.eps0 * pow(1.0 - (double)t / (double)bat_con.eps_iters, BAT_CON_EPS_CP);
+            }
+            if (eps == bat_con.eps) return 0;
+            bat_con.eps = eps;
+            return 1;
+        }
+        case BAT_CON_PENALTY:
+            if (best->viol > 0.0) {
+                bat_con.infeas_run++;
+                bat_con.feas_run = 0;
+            } else {
+                bat_con.feas_run++;
+                bat_con.infeas_run = 0;
+            }
+            double lambda = bat_con.lambda;
+            if (bat_con.feas_run >= BAT_CON_PEN_K) {
+                lambda = fmax(lambda / BAT_CON_PEN_DOWN, bat_con.lambda0 / BAT_CON_PEN_RANGE);
+                bat_con.feas_run = 0;
+            } else if (bat_con.infeas_run >= BAT_CON_PEN_K) {
+                lambda = fmin(lambda * BAT_CON_PEN_UP, bat_con.lambda0 * BAT_CON_PEN_RANGE);
+                bat_con.infeas_run = 0;
+            }
+            if (lambda == bat_con.lambda) return 0;
+            bat_con.lambda = lambda;
+            return 1;
+        default:
+            return 0;
+    }
+}
+
+void bat_con_rerank(Bat bats[], int n_bats) {
+    for (int i = 0; i < n_bats; i++) bats[i].f_value = bat_con_rank(bats[i].f_obj, bats[i].viol);
+}
+
+void bat_con_print_bench(const Bat *best) {
+    printf(" con=%s con_n=%d", bat_con_name(bat_con.mode), bat_con.n);
+    if (bat_con.mode == BAT_CON_EPS) printf(" con_eps0=%g", bat_con.eps0);
+    if (bat_con.mode == BAT_CON_PENALTY) printf(" con_lambda=%g", bat_con.lambda);
+    printf(" feasible=%d best_viol=%g best_obj=%.17g", best->viol <= 0.0, best->viol, best->f_obj);
+}
@@ -0,0 +1,84 @@
+#include <time.h>
+
+#include "bat_deadline.h"
+
+/*
+ * bat_deadline.c
+ *
+ * Purpose:
+ * Decide, after every iteration, whether the next one still fits in the
+ * caller's latency budget.
+ *
+ * Cost model:
+ * - The per-iteration cost depends on the machine, thread count and how
+ *   often the local search triggers, so it is measured while running.
+ * - We keep an exponential moving average of the iteration time, but we
+ *   also remember the slowest iteration: the prediction uses the larger of
+ *   the two plus a safety margin, because overrunning the deadline is worse
+ *   than giving up a couple of iterations.
+ */
+
+/* Weight of the newest sample in the moving average. */
+#define DEADLINE_EMA_WEIGHT 0.2
+/* Safety factor applied to the predicted cost of the next iteration. */
+#define DEADLINE_SAFETY     1.5
+
+double bat_deadline_now(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + 1e-9 * (double)ts.tv_nsec;
+}
+
+void bat_deadline_start(BatDeadline *d, double budget_ms) {
+    d->budget_s    = budget_ms * 1e-3;
+    d->start_s     = bat_deadline_now();
+    d->last_s      = d->start_s;
+    d->iter_cost_s = 0.0;
+    d->max_cost_s  = 0.0;
+    d->iters_done  = 0;
+    d->pred_iters  = 0;
+    d->elapsed_s   = 0.0;
+    d->missed      = 0;
+}
+
+void bat_deadline_loop_start(BatDeadline *d) {
+    d->last_s = bat_deadline_now();
+}
+
+int bat_deadline_next(BatDeadline *d) {
+    double now = bat_deadline_now();
+    double cost = now - d->last_s;
+    d->last_s = now;
+    d->iters_done++;
+
+    /* Online estimate of the iteration cost. */
+    if (d->iters_done == 1) {
+        d->iter_cost_s = cost;
+    } else {
+        d->iter_cost_s += DEADLINE_EMA_WEIGHT * (cost - d->iter_cost_s);
+    }
+    if (cost > d->max_cost_s) d->max_cost_s = cost;
+
+    double remaining = d->budget_s - (now - d->start_s);
+
+    /* Predicted total iteration count at the current average speed. */
+    if (d->iter_cost_s > 0.0) {
+        double more = remaining / d->iter_cost_s;
+        d->pred_iters = d->iters_done + (more > 0.0 ? (int)more : 0);
+    }
+
+    /* Conservative cost of the next iteration. */
+    double next_cost = d->iter_cost_s;
+    if (0.5 * d->max_cost_s > next_cost) next_cost = 0.5 * d->max_cost_s;
+
+    return remaining >= DEADLINE_SAFETY * next_cost;
+}
+
+void bat_deadline_finish(BatDeadline *d) {
+    d->elapsed_s = bat_deadline_now() - d->start_s;
+    d->missed = d->elapsed_s > d->budget_s;
+}
+
+double bat_deadline_slack_ms(const BatDeadline *d) {
+    return (d->budget_s - d->elapsed_s) * 1e3;
+}
@@ -0,0 +1,592 @@
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <ctype.h>
+
+#include "bat_expr.h"
+#include "bat_isa.h"
+
+/*
+ * bat_expr.c
+ *
+ * Purpose:
+ * Parser, constant folding and bytecode compiler of the objective
+ * expressions (see bat_expr.h). The interpreter is bat_expr_run() in
+ * bat_kernels.c.
+ */
+
+/* Tree nodes that are not instructions. */
+enum {
+    NODE_CONST = BAT_EXPR_OP_COUNT,
+    NODE_X,
+    NODE_XN,
+    NODE_I
+};
+
+#define MAX_NODES 512
+
+typedef struct {
+    int op;                /* BAT_EXPR_* or NODE_* */
+    int a, b;              /* children (-1 = none) */
+    int arg;               /* coordinate of BAT_EXPR_COORD */
+    double value;          /* NODE_CONST */
+    int varying;           /* depends on x, xn or i */
+    int pairs;             /* reads xn */
+    int index;             /* reads i */
+    int ctx;               /* 0 = main program, k = body of the k-th reduction */
+} ExprNode;
+
+typedef struct {
+    const char *text;
+    const char *pos;
+    int n;
+    int in_red;            /* parsing the body of a reduction */
+    int ctx, n_ctx;        /* current context (see ExprNode) */
+    int n_nodes;
+    ExprNode node[MAX_NODES];
+    int error;
+} ExprParser;
+
+static const struct {
+    const char *name;
+    int op;
+    int args;
+} expr_funcs[] = {
+    { "sin", BAT_EXPR_SIN, 1 },   { "cos", BAT_EXPR_COS, 1 },   { "tan", BAT_EXPR_TAN, 1 },
+    { "exp", BAT_EXPR_EXP, 1 },   { "log", BAT_EXPR_LOG, 1 },   { "sqrt", BAT_EXPR_SQRT, 1 },
+    { "abs", BAT_EXPR_ABS, 1 },   { "tanh", BAT_EXPR_TANH, 1 }, { "min", BAT_EXPR_MIN, 2 },
+    { "max", BAT_EXPR_MAX, 2 },   { "sum", BAT_EXPR_SUM, 1 },   { "prod", BAT_EXPR_PROD, 1 },
+};
+
+/* Reports a parse error at the current position (only the first one). */
+static void parse_error(ExprParser *ps, const char *msg) {
+    if (ps->error) return;
+    ps->error = 1;
+    fprintf(stderr, "--objective-expr: %s at column %d\n  %s\n  %*s^\n", msg, (int)(ps->pos - ps->text) + 1,
+            ps->text, (int)(ps->pos - ps->text), "");
+}
+
+static void skip_space(ExprParser *ps) {
+    while (isspace((unsigned char)*ps->pos)) ps->pos++;
+}
+
+static int accept_char(ExprParser *ps, char c) {
+    skip_space(ps);
+    if (*ps->pos != c) return 0;
+    ps->pos++;
+    return 1;
+}
+
+static int expect_char(ExprParser *ps, char c) {
+    if (accept_char(ps, c)) return 1;
+    char msg[32];
+    snprintf(msg, sizeof(msg), "expected '%c'", c);
+    parse_error(ps, msg);
+    return 0;
+}
+
+/*
+ * Node of the current context. An identical node of the same context is
+ * returned instead of a new one, so repeated subexpressions (the two
+ * (xn - x^2) of Rosenbrock) are computed once.
+ */
+static int new_node(ExprParser *ps, int op, int a, int b, int arg, double value) {
+    for (int k = 0; k < ps->n_nodes; k++) {
+        const ExprNode *nd = &ps->node[k];
+        if (nd->op == op && nd->a == a && nd->b == b && nd->arg == arg && nd->ctx == ps->ctx
+            && memcmp(&nd->value, &value, sizeof(value)) == 0) {
+            return k;
+        }
+    }
+    if (ps->n_nodes >= MAX_NODES) {
+        parse_error(ps, "expression too long");
+        return -1;
+    }
+    ExprNode *nd = &ps->node[ps->n_nodes];
+    memset(nd, 0, sizeof(*nd));
+    nd->op = op;
+    nd->a = a;
+    nd->b = b;
+    nd->arg = arg;
+    nd->value = value;
+    nd->ctx = ps->ctx;
+    nd->varying = op == NODE_X || op == NODE_XN || op == NODE_I;
+    nd->pairs = op == NODE_XN;
+    nd->index = op == NODE_I;
+    for (int c = 0; c < 2; c++) {
+        int child = c == 0 ? a : b;
+        if (child < 0) continue;
+        /* A reduction is a plain value for its parents; it keeps the flags of its body. */
+        if (op != BAT_EXPR_SUM && op != BAT_EXPR_PROD) nd->varying |= ps->node[child].varying;
+        nd->pairs |= ps->node[child].pairs;
+        nd->index |= ps->node[child].index;
+    }
+    return ps->n_nodes++;
+}
+
+static int const_node(ExprParser *ps, double value) {
+    return new_node(ps, NODE_CONST, -1, -1, 0, value);
+}
+
+static int is_const(const ExprParser *ps, int k, double value) {
+    return ps->node[k].op == NODE_CONST && ps->node[k].value == value;
+}
+
+/* Value of an operation on constants (the interpreter computes the same). */
+static double fold(int op, double a, double b) {
+    switch (op) {
+        case BAT_EXPR_ADD:  return a + b;
+        case BAT_EXPR_SUB:  return a - b;
+        case BAT_EXPR_MUL:  return a * b;
+        case BAT_EXPR_DIV:  return a / b;
+        case BAT_EXPR_POW:  return pow(a, b);
+        case BAT_EXPR_MIN:  return a < b ? a : b;
+        case BAT_EXPR_MAX:  return a > b ? a : b;
+        case BAT_EXPR_NEG:  return -a;
+        case BAT_EXPR_SIN:  return sin(a);
+        case BAT_EXPR_COS:  return cos(a);
+        case BAT_EXPR_TAN:  return tan(a);
+        case BAT_EXPR_EXP:  return exp(a);
+        case BAT_EXPR_LOG:  return log(a);
+        case BAT_EXPR_SQRT: return sqrt(a);
+        case BAT_EXPR_ABS:  return fabs(a);
+        default:            return tanh(a);
+    }
+}
+
+/*
+ * Operation node with constant folding and the identities that hold for
+ * every double (x + 0, x * 1, x / 1, x ^ 1, --x); x * 0 is kept, it is
+ * not 0 for an infinite x.
+ */
+static int op_node(ExprParser *ps, int op, int a, int b) {
+    if (a < 0 || (b < 0 && op <= BAT_EXPR_MAX)) return -1;
+    int ca = ps->node[a].op == NODE_CONST, cb = b < 0 || ps->node[b].op == NODE_CONST;
+    if (ca && cb) return const_node(ps, fold(op, ps->node[a].value, b < 0 ? 0.0 : ps->node[b].value));
+
+    switch (op) {
+        case BAT_EXPR_ADD:
+            if (is_const(ps, a, 0.0)) return b;
+            if (is_const(ps, b, 0.0)) return a;
+            break;
+        case BAT_EXPR_SUB:
+            if (is_const(ps, b, 0.0)) return a;
+            if (is_const(ps, a, 0.0)) return op_node(ps, BAT_EXPR_NEG, b, -1);
+            break;
+        case BAT_EXPR_MUL:
+            if (is_const(ps, a, 1.0)) return b;
+            if (is_const(ps, b, 1.0)) return a;
+            break;
+        case BAT_EXPR_DIV:
+        case BAT_EXPR_POW:
+            if (is_const(ps, b, 1.0)) return a;
+            break;
+        case BAT_EXPR_NEG:
+            if (ps->node[a].op == BAT_EXPR_NEG) return ps->node[a].a;
+            break;
+        default:
+            break;
+    }
+    return new_node(ps, op, a, b, 0, 0.0);
+}
+
+static int parse_expr(ExprParser *ps);
+static int parse_unary(ExprParser *ps);
+
+/* Constant subexpression (the index of x[k]). */
+static int parse_index(ExprParser *ps) {
+    int k = parse_expr(ps);
+    if (k < 0) return -1;
+    double v = ps->node[k].value;
+    if (ps->node[k].op != NODE_CONST || v != floor(v)) {
+        parse_error(ps, "the index of x[] must be a constant integer");
+        return -1;
+    }
+    if (v < 1.0 || v > (double)ps->n) {
+        parse_error(ps, "coordinate index out of range");
+        return -1;
+    }
+    return expect_char(ps, ']') ? new_node(ps, BAT_EXPR_COORD, -1, -1, (int)v - 1, 0.0) : -1;
+}
+
+/* Function call; `name` points to the function name (for error messages). */
+static int parse_call(ExprParser *ps, int f, const char *name) {
+    int op = expr_funcs[f].op, red = op == BAT_EXPR_SUM || op == BAT_EXPR_PROD;
+    if (red && ps->in_red) {
+        ps->pos = name;
+        parse_error(ps, "sum() and prod() cannot be nested");
+        return -1;
+    }
+    if (!expect_char(ps, '(')) return -1;
+    if (red) {
+        ps->in_red = 1;
+        ps->ctx = ++ps->n_ctx;
+    }
+    int a = parse_expr(ps), b = -1;
+    if (red) ps->in_red = ps->ctx = 0;
+    if (a < 0) return -1;
+    if (expr_funcs[f].args == 2) {
+        if (!expect_char(ps, ',')) return -1;
+        if ((b = parse_expr(ps)) < 0) return -1;
+    }
+    if (!expect_char(ps, ')')) return -1;
+    return red ? new_node(ps, op, a, -1, 0, 0.0) : op_node(ps, op, a, b);
+}
+
+static int parse_primary(ExprParser *ps) {
+    skip_space(ps);
+    const char *start = ps->pos;
+
+    if (isdigit((unsigned char)*start) || *start == '.') {
+        char *end;
+        double v = strtod(start, &end);
+        if (end == start) {
+            parse_error(ps, "invalid number");
+            return -1;
+        }
+        ps->pos = end;
+        return const_node(ps, v);
+    }
+    if (accept_char(ps, '(')) {
+        int k = parse_expr(ps);
+        return k >= 0 && expect_char(ps, ')') ? k : -1;
+    }
+    if (!isalpha((unsigned char)*start)) {
+        parse_error(ps, *start ? "unexpected character" : "unexpected end of expression");
+        return -1;
+    }
+
+    while (isalnum((unsigned char)*ps->pos) || *ps->pos == '_') ps->pos++;
+    char name[16];
+    size_t len = (size_t)(ps->pos - start);
+    if (len >= sizeof(name)) len = sizeof(name) - 1;
+    memcpy(name, start, len);
+    name[len] = '\0';
+
+    for (size_t f = 0; f < sizeof(expr_funcs) / sizeof(expr_funcs[0]); f++) {
+        if (strcmp(name, expr_funcs[f].name) == 0) return parse_call(ps, (int)f, start);
+    }
+    if (strcmp(name, "pi") == 0) return const_node(ps, M_PI);
+    if (strcmp(name, "e") == 0) return const_node(ps, M_E);
+    if (strcmp(name, "n") == 0) return const_node(ps, (double)ps->n);
+    if (strcmp(name, "x") == 0 && accept_char(ps, '[')) return parse_index(ps);
+
+    int op = strcmp(name, "x") == 0 ? NODE_X : strcmp(name, "xn") == 0 ? NODE_XN
+           : strcmp(name, "i") == 0 ? NODE_I : -1;
+    if (op < 0) {
+        ps->pos = start;
+        parse_error(ps, "unknown name");
+        return -1;
+    }
+    if (!ps->in_red) {
+        ps->pos = start;
+        parse_error(ps, "x, xn and i are only defined inside sum() or prod() (use x[k] outside)");
+        return -1;
+    }
+    return new_node(ps, op, -1, -1, 0, 0.0);
+}
+
+/* power := primary ['^' unary] (right-associative, binds tighter than unary minus on its left) */
+static int parse_power(ExprParser *ps) {
+    int base = parse_primary(ps);
+    if (base < 0 || !accept_char(ps, '^')) return base;
+    int exponent = parse_unary(ps);
+    return exponent < 0 ? -1 : op_node(ps, BAT_EXPR_POW, base, exponent);
+}
+
+static int parse_unary(ExprParser *ps) {
+    if (accept_char(ps, '-')) {
+        int a = parse_unary(ps);
+        return a < 0 ? -1 : op_node(ps, BAT_EXPR_NEG, a, -1);
+    }
+    if (accept_char(ps, '+')) return parse_unary(ps);
+    return parse_power(ps);
+}
+
+static int parse_term(ExprParser *ps) {
+    int a = parse_unary(ps);
+    while (a >= 0) {
+        int op = accept_char(ps, '*') ? BAT_EXPR_MUL : accept_char(ps, '/') ? BAT_EXPR_DIV : -1;
+        if (op < 0) break;
+        int b = parse_unary(ps);
+        a = b < 0 ? -1 : op_node(ps, op, a, b);
+    }
+    return a;
+}
+
+static int parse_expr(ExprParser *ps) {
+    int a = parse_term(ps);
+    while (a >= 0) {
+        int op = accept_char(ps, '+') ? BAT_EXPR_ADD : accept_char(ps, '-') ? BAT_EXPR_SUB : -1;
+        if (op < 0) break;
+        int b = parse_term(ps);
+        a = b < 0 ? -1 : op_node(ps, op, a, b);
+    }
+    return a;
+}
+
+/*
+ * Code generation.
+ *
+ * Registers are allocated when a value is produced and released once its
+ * last parent has consumed it (a shared node is generated once). Reduction bodies are emitted to a second stream; values of
+ * a body that do not depend on x, xn or i are emitted to the main stream
+ * instead (computed once, before the loop), in registers the body never
+ * writes and that stay reserved until the reduction is done.
+ */
+typedef struct {
+    BatExprProg *prog;
+    const ExprParser *ps;
+    uint64_t used;         /* allocated registers */
+    uint64_t fixed;        /* registers never released (x, xn, i) */
+    uint64_t pinned;       /* loop invariants of the current body */
+    uint64_t body_regs;    /* registers written by the current body */
+    int in_body;
+    BatExprIns body[BAT_EXPR_MAX_INS];
+    int n_body;
+    int reg[MAX_NODES];    /* register of every generated node (-1 = not yet) */
+    int left[MAX_NODES];   /* parents of every node that have not consumed it yet */
+    int error;
+} ExprGen;
+
+static void gen_error(ExprGen *g, const char *msg) {
+    if (!g->error) fprintf(stderr, "--objective-expr: %s\n", msg);
+    g->error = 1;
+}
+
+static int alloc_reg(ExprGen *g, uint64_t avoid) {
+    for (int r = BAT_EXPR_REG_FIRST; r < BAT_EXPR_MAX_REGS; r++) {
+        uint64_t bit = (uint64_t)1 << r;
+        if ((g->used | avoid) & bit) continue;
+        g->used |= bit;
+        if (r + 1 > g->prog->n_regs) g->prog->n_regs = r + 1;
+        return r;
+    }
+    gen_error(g, "expression needs too many registers");
+    return -1;
+}
+
+static void release_reg(ExprGen *g, int r) {
+    if (r < 0) return;
+    uint64_t bit = (uint64_t)1 << r;
+    if ((g->fixed | g->pinned) & bit) return;
+    g->used &= ~bit;
+}
+
+static void emit(ExprGen *g, int body, int op, int dst, int a, int b, int arg) {
+    BatExprProg *p = g->prog;
+    if (p->n_ins + g->n_body >= BAT_EXPR_MAX_INS) {
+        gen_error(g, "expression too long");
+        return;
+    }
+    BatExprIns ins = { op, dst, a, b, arg };
+    if (body) g->body[g->n_body++] = ins;
+    else p->ins[p->n_ins++] = ins;
+}
+
+/* Index of a value in the constant pool (equal values share an entry). */
+static int const_index(ExprGen *g, double value) {
+    BatExprProg *p = g->prog;
+    for (int c = 0; c < p->n_consts; c++) {
+        if (memcmp(&p->const_val[c], &value, sizeof(value)) == 0) return c;
+    }
+    if (p->n_consts >= BAT_EXPR_MAX_CONSTS) {
+        gen_error(g, "too many constants");
+        return -1;
+    }
+    p->const_val[p->n_consts] = value;
+    return p->n_consts++;
+}
+
+static int gen(ExprGen *g, int k);
+
+/* Parent edges of the tree below node k (each shared node is visited once). */
+static void count_uses(ExprGen *g, int k) {
+    const ExprNode *nd = &g->ps->node[k];
+    if (nd->a >= 0 && g->left[nd->a]++ == 0) count_uses(g, nd->a);
+    if (nd->b >= 0 && g->left[nd->b]++ == 0) count_uses(g, nd->b);
+}
+
+/* A parent has consumed node k. */
+static void drop(ExprGen *g, int k) {
+    if (k >= 0 && --g->left[k] == 0) release_reg(g, g->reg[k]);
+}
+
+/* Destination of an instruction (emitted in the body or the main stream). */
+static int gen_dst(ExprGen *g, int body) {
+    int r = alloc_reg(g, body ? 0 : g->body_regs);
+    if (r < 0) return -1;
+    if (body) g->body_regs |= (uint64_t)1 << r;
+    else if (g->in_body) g->pinned |= (uint64_t)1 << r;
+    return r;
+}
+
+/* base^k for k = 2, 3, 4, as multiplications. */
+static int gen_powi(ExprGen *g, int body, int base_node, int k) {
+    int base = gen(g, base_node);
+    int sq = gen_dst(g, body);
+    emit(g, body, BAT_EXPR_MUL, sq, base, base, 0);
+    if (k == 2) {
+        drop(g, base_node);
+        return sq;
+    }
+    int r = gen_dst(g, body);
+    emit(g, body, BAT_EXPR_MUL, r, sq, k == 3 ? base : sq, 0);
+    release_reg(g, sq);
+    drop(g, base_node);
+    return r;
+}
+
+static int gen_reduction(ExprGen *g, int k) {
+    const ExprNode *nd = &g->ps->node[k];
+    BatExprProg *p = g->prog;
+    if (p->n_red >= BAT_EXPR_MAX_RED) {
+        gen_error(g, "too many sum()/prod()");
+        return -1;
+    }
+    int red = p->n_red++;
+    g->in_body = 1;
+    g->body_regs = 0;
+    p->red[red].start = g->n_body;
+    p->red[red].result = gen(g, nd->a);
+    p->red[red].end = g->n_body;
+    p->red[red].pairs = nd->pairs;
+    p->red[red].index = nd->index;
+    g->in_body = 0;
+
+    /* The body result and the invariants are dead once the loop is done. */
+    uint64_t pinned = g->pinned;
+    g->pinned = 0;
+    drop(g, nd->a);
+    for (int r = 0; r < BAT_EXPR_MAX_REGS; r++) {
+        if (pinned & ((uint64_t)1 << r)) release_reg(g, r);
+    }
+    g->body_regs = 0;
+
+    int dst = gen_dst(g, 0);
+    emit(g, 0, nd->op, dst, -1, -1, red);
+    return dst;
+}
+
+static int gen_node(ExprGen *g, int k) {
+    const ExprNode *nd = &g->ps->node[k];
+    switch (nd->op) {
+        case NODE_CONST: {
+            /*
+             * Loaded where it is used, into an ordinary register released
+             * after its last use (never inside a body: it is invariant).
+             */
+            int c = const_index(g, nd->value);
+            int dst = c < 0 ? -1 : gen_dst(g, 0);
+            if (dst >= 0) emit(g, 0, BAT_EXPR_CONST, dst, -1, -1, c);
+            return dst;
+        }
+        case NODE_X:     return BAT_EXPR_REG_X;
+        case NODE_XN:    return BAT_EXPR_REG_XN;
+        case NODE_I:     return BAT_EXPR_REG_I;
+        case BAT_EXPR_SUM:
+        case BAT_EXPR_PROD:
+            return gen_reduction(g, k);
+        default:
+            break;
+    }
+
+    int body = g->in_body && nd->varying;
+    if (nd->op == BAT_EXPR_COORD) {
+        int dst = gen_dst(g, 0);
+        emit(g, 0, BAT_EXPR_COORD, dst, -1, -1, nd->arg);
+        return dst;
+    }
+    if (nd->op == BAT_EXPR_POW && g->ps->node[nd->b].op == NODE_CONST) {
+        double e = g->ps->node[nd->b].value;
+        if (e == 2.0 || e == 3.0 || e == 4.0) {
+            drop(g, nd->b);
+            return gen_powi(g, body, nd->a, (int)e);
+        }
+        if (e == 0.5) {
+            drop(g, nd->b);
+            int a = gen(g, nd->a);
+            int dst = gen_dst(g, body);
+            drop(g, nd->a);
+            emit(g, body, BAT_EXPR_SQRT, dst, a, -1, 0);
+            return dst;
+        }
+    }
+    int a = gen(g, nd->a);
+    int b = nd->b >= 0 ? gen(g, nd->b) : -1;
+    /* The destination is allocated first: it never aliases an operand (see expr_ops()). */
+    int dst = gen_dst(g, body);
+    drop(g, nd->a);
+    drop(g, nd->b);
+    emit(g, body, nd->op, dst, a, b, 0);
+    return dst;
+}
+
+static int gen(ExprGen *g, int k) {
+    if (g->error) return -1;
+    if (g->reg[k] < 0) g->reg[k] = gen_node(g, k);
+    return g->reg[k];
+}
+
+int bat_expr_compile(BatExprProg *prog, const char *text, int n) {
+    static ExprParser ps;
+    static ExprGen g;
+
+    memset(prog, 0, sizeof(*prog));
+    memset(&ps, 0, sizeof(ps));
+    if (strlen(text) > BAT_EXPR_MAX_TEXT) {
+        fprintf(stderr, "--objective-expr: expression longer than %d characters\n", BAT_EXPR_MAX_TEXT);
+        return -1;
+    }
+    ps.text = ps.pos = text;
+    ps.n = n;
+    int root = parse_expr(&ps);
+    skip_space(&ps);
+    if (root >= 0 && *ps.pos) parse_error(&ps, "unexpected text after the expression");
+    if (root < 0 || ps.error) return -1;
+
+    memset(&g, 0, sizeof(g));
+    g.prog = prog;
+    g.ps = &ps;
+    g.fixed = g.used = ((uint64_t)1 << BAT_EXPR_REG_FIRST) - 1;
+    for (int k = 0; k < ps.n_nodes; k++) g.reg[k] = -1;
+    g.left[root] = 1;
+    count_uses(&g, root);
+    prog->n = n;
+    prog->n_regs = BAT_EXPR_REG_FIRST;
+    prog->nonfinite = -INFINITY;
+    prog->result = gen(&g, root);
+    if (g.error) return -1;
+
+    /* Bodies follow the main program. */
+    prog->main_end = prog->n_ins;
+    memcpy(prog->ins + prog->n_ins, g.body, (size_t)g.n_body * sizeof(BatExprIns));
+    prog->n_ins += g.n_body;
+    for (int r = 0; r < prog->n_red; r++) {
+        prog->red[r].start += prog->main_end;
+        prog->red[r].end += prog->main_end;
+    }
+    return 0;
+}
+
+static BatExprProg current_prog;
+
+int bat_expr_install(const char *text, int n) {
+    return bat_expr_compile(&current_prog, text, n);
+}
+
+const BatExprProg *bat_expr_current(void) {
+    return &current_prog;
+}
+
+double bat_expr_eval(const double x[]) {
+    double f;
+    bat_kernels.expr(&current_prog, x, 0, 1, &f);
+    return f;
+}
+
+void bat_expr_eval_rows(const double *rows, int ld, int count, double out[]) {
+    bat_kernels.expr(&current_prog, rows, ld, count, out);
+}
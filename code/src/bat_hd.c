@@ -0,0 +1,544 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include "bat.h"
+#include "bat_hd.h"
+#include "bat_rng.h"
+#include "bat_utils.h"
+#include "bat_xsum.h"
+#include "bat_init.h"
+#include "bat_refine.h"
+#include "bat_restart.h"
+#include "bat_shrink.h"
+
+/*
+ * bat_hd.c
+ *
+ * Purpose:
+ * High-dimensional engine: runtime dimension, one row of coordinates per
+ * bat, updates tiled over the dimension (see bat_hd.h).
+ */
+
+/* Seed mix of the per-(bat, tile) initialization streams. */
+#define HD_INIT_MIX 0x3C6EF372u
+
+/* tile_pass() must be specialized per objective (see bat_hd_tile()). */
+#if defined(__GNUC__)
+#define HD_INLINE static inline __attribute__((always_inline))
+#else
+#define HD_INLINE static inline
+#endif
+
+int bat_hd_check(const BatOptions *opts) {
+    const char *bad = NULL;
+    if (opts->params.adapt != BAT_ADAPT_NONE)             bad = "--adapt";
+    else if (opts->init_kind != BAT_INIT_UNIFORM)         bad = "--init";
+    else if (opts->init_obl)                              bad = "--obl";
+    else if (opts->refine_method != BAT_REFINE_NONE)      bad = "--refine";
+    else if (opts->restart_kind != BAT_RESTART_NONE)      bad = "--restart";
+    else if (opts->shrink_kind != BAT_SHRINK_NONE)        bad = "--shrink";
+    else if (opts->trace_path)                            bad = "--trace";
+    else if (opts->final_pop_path)                        bad = "--final-pop";
+    else if (opts->ttt.n > 0)                             bad = "--targets";
+    else if (opts->deadline_ms > 0.0)                     bad = "--deadline";
+    if (bad) {
+        fprintf(stderr, "%s is not supported with --dim\n", bad);
+        return -1;
+    }
+    if (opts->hd_group < 1) {
+        fprintf(stderr, "Invalid --hd-group %d\n", opts->hd_group);
+        return -1;
+    }
+    if (opts->hd_slices < 1 || opts->hd_slices > bat_hd_tile_count(opts->hd_dim)) {
+        fprintf(stderr, "Invalid --hd-slices %d (1 to %d for --dim %d)\n", opts->hd_slices,
+                bat_hd_tile_count(opts->hd_dim), opts->hd_dim);
+        return -1;
+    }
+    /* A batch needs every coordinate of a candidate on one rank. */
+    if (bat_hd_batched(opts) && opts->hd_slices > 1) {
+        fprintf(stderr, "%s cannot be combined with --hd-slices\n",
+                opts->transform != BAT_TRANSFORM_NONE ? "--transform" : "--objective-expr");
+        return -1;
+    }
+    return 0;
+}
+
+int bat_hd_batched(const BatOptions *opts) {
+    return opts->transform != BAT_TRANSFORM_NONE || opts->objective == BAT_OBJ_EXPR;
+}
+
+/* Row length: coords rounded up to a whole number of cache lines. */
+static int row_stride(int coords) {
+    int per_line = BAT_ARENA_ALIGN / (int)sizeof(bat_real);
+    return (coords + per_line - 1) / per_line * per_line;
+}
+
+int bat_hd_tile_count(int dim) {
+    return (dim + BAT_HD_TILE - 1) / BAT_HD_TILE;
+}
+
+void bat_hd_tile_range(int dim, int tile0, int n_tiles, int *lo, int *hi) {
+    long end = (long)(tile0 + n_tiles) * BAT_HD_TILE;
+    *lo = tile0 * BAT_HD_TILE;
+    *hi = end < dim ? (int)end : dim;
+}
+
+size_t bat_hd_pop_bytes(int n_bats, int coords) {
+    size_t row = (size_t)row_stride(coords) * sizeof(bat_real);
+    return 2 * bat_arena_need((size_t)n_bats * row) + bat_arena_need(row)
+         + bat_arena_need((size_t)n_bats * sizeof(BatHdBat));
+}
+
+size_t bat_hd_scratch_bytes(int n_tiles, int slots) {
+    return bat_arena_need((size_t)slots * 2 * (size_t)n_tiles * BAT_HD_PARTS * sizeof(double))
+         + bat_arena_need((size_t)slots * sizeof(BatHdSlot));
+}
+
+int bat_hd_pop_create(BatHdPop *pop, BatArena *arena, int n_bats, int dim) {
+    return bat_hd_pop_create_block(pop, arena, 0, n_bats, dim, 0, bat_hd_tile_count(dim));
+}
+
+int bat_hd_pop_create_block(BatHdPop *pop, BatArena *arena, int bat0, int n_bats, int dim, int tile0, int n_tiles) {
+    int d_hi;
+    memset(pop, 0, sizeof(*pop));
+    pop->n_bats = n_bats;
+    pop->bat0 = bat0;
+    pop->dim = dim;
+    pop->tile0 = tile0;
+    pop->n_tiles = n_tiles;
+    bat_hd_tile_range(dim, tile0, n_tiles, &pop->d_lo, &d_hi);
+    pop->stride = row_stride(d_hi - pop->d_lo);
+    pop->best_i = -1;
+
+    size_t row = (size_t)pop->stride * sizeof(bat_real);
+    pop->x = bat_arena_alloc(arena, (size_t)n_bats * row);
+    pop->v = bat_arena_alloc(arena, (size_t)n_bats * row);
+    pop->best_x = bat_arena_alloc(arena, row);
+    pop->bat = bat_arena_alloc(arena, (size_t)n_bats * sizeof(BatHdBat));
+    return (pop->x && pop->v && pop->best_x && pop->bat) ? 0 : -1;
+}
+
+int bat_hd_scratch_create(BatHdScratch *s, BatArena *arena, const BatHdPop *pop, int slots) {
+    s->slots = slots;
+    s->part = bat_arena_alloc(arena, (size_t)slots * 2 * (size_t)pop->n_tiles * BAT_HD_PARTS * sizeof(double));
+    s->slot = bat_arena_alloc(arena, (size_t)slots * sizeof(BatHdSlot));
+    return (s->part && s->slot) ? 0 : -1;
+}
+
+double *bat_hd_slot_parts(const BatHdPop *pop, const BatHdScratch *s, int k, int c) {
+    return s->part + ((size_t)k * 2 + (size_t)c) * (size_t)pop->n_tiles * BAT_HD_PARTS;
+}
+
+/* Partials of slot k, candidate c, local tile j. */
+static double *slot_part(const BatHdPop *pop, const BatHdScratch *s, int k, int c, int j) {
+    return bat_hd_slot_parts(pop, s, k, c) + (size_t)j * BAT_HD_PARTS;
+}
+
+/* Coordinates [d0, d1) of local tile j. */
+static void local_tile(const BatHdPop *pop, int j, int *d0, int *d1) {
+    bat_hd_tile_range(pop->dim, pop->tile0 + j, 1, d0, d1);
+}
+
+void bat_hd_init_bat(BatHdPop *pop, int i, uint32_t seed) {
+    BatHdBat *b = &pop->bat[i];
+    bat_real *x = pop->x + (size_t)i * (size_t)pop->stride;
+    bat_real *v = pop->v + (size_t)i * (size_t)pop->stride;
+    uint32_t g = (uint32_t)(pop->bat0 + i);
+    int d0, d1;
+
+    b->rng_state = bat_rng_init(seed, g);
+    uint32_t key = bat_rng_init(seed ^ HD_INIT_MIX, g);
+    for (int j = 0; j < pop->n_tiles; j++) {
+        local_tile(pop, j, &d0, &d1);
+        uint32_t rng = bat_rng_init(key, (uint32_t)(pop->tile0 + j));
+        for (int d = d0; d < d1; d++) {
+            x[d - pop->d_lo] = (bat_real)bat_rng_uniform(&rng, (double)Lb, (double)Ub);
+            v[d - pop->d_lo] = V0;
+        }
+    }
+    /* Padding of the row stays zero (never read by the objective). */
+    bat_hd_tile_range(pop->dim, pop->tile0, pop->n_tiles, &d0, &d1);
+    for (int l = d1 - d0; l < pop->stride; l++) x[l] = v[l] = 0;
+
+    b->f_i = bat_params.f_min;
+    b->A_i = bat_params.a0;
+    b->r_i = bat_params.r0;
+    b->f_value = 0.0;
+    if (!pop->tf && pop->tile0 == 0 && pop->n_tiles == bat_hd_tile_count(pop->dim)) {
+        b->f_value = bat_hd_objective(bat_get_objective(), x, pop->dim);
+    }
+}
+
+void bat_hd_row_parts(const BatHdPop *pop, int i, int id, double parts[]) {
+    const bat_real *x = pop->x + (size_t)i * (size_t)pop->stride;
+    int d0, d1;
+    for (int j = 0; j < pop->n_tiles; j++) {
+        local_tile(pop, j, &d0, &d1);
+        bat_hd_partial(id, x + (d0 - pop->d_lo), d0, d1, parts + (size_t)j * BAT_HD_PARTS);
+    }
+}
+
+void bat_hd_eval_init(BatHdPop *pop) {
+    BatTransform *tf = pop->tf;
+    for (int i = 0; i < pop->n_bats; i++) {
+        const bat_real *x = pop->x + (size_t)i * (size_t)pop->stride;
+        double *z = bat_transform_row(tf, i);
+        for (int d = 0; d < pop->dim; d++) z[d] = (double)x[d] - tf->shift[d];
+    }
+    bat_transform_eval(tf, bat_get_objective(), pop->n_bats);
+    for (int i = 0; i < pop->n_bats; i++) pop->bat[i].f_value = tf->f[i];
+}
+
+/*
+ * Adds coordinate d (value xd; xp = coordinate d - 1) to the partial sums
+ * of a built-in objective (see bat_objective_eval() for the formulas).
+ * Rosenbrock adds the term of the pair (d - 1, d), skipped on the first
+ * coordinate of a tile; bat_hd_combine() adds the pairs across tiles.
+ */
+HD_INLINE void add_term(int id, double xd, double xp, int d, int first, double *p0, double *p1) {
+    switch (id) {
+        case BAT_OBJ_RASTRIGIN:
+            *p0 += xd * xd - 10.0 * cos(2.0 * M_PI * xd);
+            break;
+        case BAT_OBJ_ACKLEY:
+            *p0 += xd * xd;
+            *p1 += cos(2.0 * M_PI * xd);
+            break;
+        case BAT_OBJ_GRIEWANK:
+            *p0 += xd * xd;
+            *p1 *= cos(xd / sqrt((double)(d + 1)));
+            break;
+        case BAT_OBJ_ROSENBROCK:
+            if (!first) {
+                double a = xd - xp * xp;
+                double b = 1.0 - xp;
+                *p0 += 100.0 * a * a + b * b;
+            }
+            break;
+        default:   /* paraboloid, sphere */
+            *p0 += xd * xd;
+            break;
+    }
+}
+
+/*
+ * Clamps to [Lb, Ub]. Written as two selects so that GCC emits maxsd /
+ * minsd (with the flags of bat_hd.o, see the Makefile): in high dimension
+ * the bound hits follow no pattern and a branch mispredicts constantly.
+ * Callers count hits as `clamped != raw`, which shares no comparison with
+ * the selects.
+ */
+static inline bat_real clamp_coord(bat_real c) {
+    c = c > Lb ? c : Lb;
+    return c < Ub ? c : Ub;
+}
+
+/* Coordinate of the local walk around best[d] (eps from the tile stream). */
+static inline bat_real walk_coord(bat_real best, double eps, double A_mean) {
+    return (bat_real)(best + 0.1 * eps * A_mean);
+}
+
+void bat_hd_partial(int id, const bat_real x[], int d0, int d1, double part[BAT_HD_PARTS]) {
+    double p0 = 0.0, p1 = (id == BAT_OBJ_GRIEWANK) ? 1.0 : 0.0;
+    for (int l = 0; l < d1 - d0; l++) add_term(id, (double)x[l], l ? (double)x[l - 1] : 0.0, d0 + l, l == 0, &p0, &p1);
+    part[0] = p0;
+    part[1] = p1;
+    part[2] = (double)x[0];
+    part[3] = (double)x[d1 - d0 - 1];
+}
+
+void bat_hd_combine(int id, double acc[BAT_HD_PARTS], const double part[BAT_HD_PARTS]) {
+    if (id == BAT_OBJ_ROSENBROCK) {
+        double a = part[2] - acc[3] * acc[3];
+        double b = 1.0 - acc[3];
+        acc[0] += 100.0 * a * a + b * b;
+    }
+    acc[0] += part[0];
+    if (id == BAT_OBJ_GRIEWANK) acc[1] *= part[1];
+    else acc[1] += part[1];
+    acc[3] = part[3];
+}
+
+double bat_hd_value(int id, const double acc[BAT_HD_PARTS], int dim) {
+    double n = (double)dim;
+    switch (id) {
+        case BAT_OBJ_SPHERE:
+        case BAT_OBJ_ROSENBROCK:
+            return -acc[0];
+        case BAT_OBJ_RASTRIGIN:
+            return -(10.0 * n + acc[0]);
+        case BAT_OBJ_ACKLEY:
+            return -(-20.0 * exp(-0.2 * sqrt(acc[0] / n)) - exp(acc[1] / n) + 20.0 + M_E);
+        case BAT_OBJ_GRIEWANK:
+            return -(1.0 + acc[0] / 4000.0 - acc[1]);
+        default:
+            return 10.0 - acc[0];
+    }
+}
+
+double bat_hd_objective(int id, const bat_real x[], int dim) {
+    double acc[BAT_HD_PARTS], part[BAT_HD_PARTS];
+    bat_hd_partial(id, x, 0, dim < BAT_HD_TILE ? dim : BAT_HD_TILE, acc);
+    for (int d0 = BAT_HD_TILE; d0 < dim; d0 += BAT_HD_TILE) {
+        bat_hd_partial(id, x + d0, d0, d0 + BAT_HD_TILE < dim ? d0 + BAT_HD_TILE : dim, part);
+        bat_hd_combine(id, acc, part);
+    }
+    return bat_hd_value(id, acc, dim);
+}
+
+/* Objective value of candidate c of slot k (its tile partials combined in order). */
+static double slot_value(const BatHdPop *pop, const BatHdScratch *s, int k, int c, int id) {
+    double acc[BAT_HD_PARTS];
+    memcpy(acc, slot_part(pop, s, k, c, 0), sizeof(acc));
+    for (int j = 1; j < pop->n_tiles; j++) bat_hd_combine(id, acc, slot_part(pop, s, k, c, j));
+    return bat_hd_value(id, acc, pop->dim);
+}
+
+/*
+ * Per-bat draws of one update, in the order of update_bat(): frequency,
+ * then the local-walk decision (plus the key of its streams).
+ */
+void bat_hd_begin(BatHdPop *pop, BatHdScratch *s, int k, int i, double A_mean) {
+    const BatParams *p = &bat_params;
+    BatHdBat *b = &pop->bat[i];
+    BatHdSlot *slot = &s->slot[k];
+
+    b->f_i = p->f_min + (p->f_max - p->f_min) * bat_rng_uniform01(&b->rng_state);
+    slot->bat = i;
+    slot->walk = bat_rng_uniform01(&b->rng_state) > b->r_i;
+    slot->key = slot->walk ? bat_rng_init(b->rng_state, (uint32_t)(pop->bat0 + i)) : 0;
+    if (slot->walk) bat_rng_uniform01(&b->rng_state);   /* next update gets a new key */
+    slot->accept = 0;
+    slot->A_mean = A_mean;
+}
+
+/*
+ * Velocity of one tile and the partials of the candidate (and local walk,
+ * if drawn) on it. Only the bat's own v row and slot k are written: tiles
+ * of one bat can run concurrently.
+ */
+HD_INLINE long tile_pass(int id, const BatHdPop *pop, BatHdScratch *s, int k, int tile) {
+    const BatHdSlot *slot = &s->slot[k];
+    int d0, d1;
+    local_tile(pop, tile, &d0, &d1);
+    const int n = d1 - d0;
+    const size_t off = (size_t)slot->bat * (size_t)pop->stride + (size_t)(d0 - pop->d_lo);
+    const bat_real *restrict best = pop->best_x + (d0 - pop->d_lo);
+    const bat_real *restrict x = pop->x + off;
+    bat_real *restrict v = pop->v + off;
+    const bat_real f = (bat_real)pop->bat[slot->bat].f_i;
+    double *part = slot_part(pop, s, k, 0, tile);
+
+    double p0 = 0.0, p1 = (id == BAT_OBJ_GRIEWANK) ? 1.0 : 0.0, prev = 0.0;
+    long clamps = 0;
+    for (int l = 0; l < n; l++) {
+        bat_real vd = v[l] + (best[l] - x[l]) * f;
+        bat_real raw = x[l] + vd;
+        bat_real cd = clamp_coord(raw);
+        clamps += (cd != raw);
+        v[l] = vd;
+        add_term(id, (double)cd, prev, d0 + l, l == 0, &p0, &p1);
+        prev = (double)cd;
+    }
+    part[0] = p0;
+    part[1] = p1;
+    part[2] = (double)clamp_coord(x[0] + v[0]);
+    part[3] = prev;
+
+    if (slot->walk) {
+        uint32_t rng = bat_rng_init(slot->key, (uint32_t)(pop->tile0 + tile));
+        part = slot_part(pop, s, k, 1, tile);
+        p0 = 0.0;
+        p1 = (id == BAT_OBJ_GRIEWANK) ? 1.0 : 0.0;
+        for (int l = 0; l < n; l++) {
+            bat_real raw = walk_coord(best[l], bat_rng_normal(&rng, 0.0, 1.0), slot->A_mean);
+            bat_real wd = clamp_coord(raw);
+            clamps += (wd != raw);
+            if (l == 0) part[2] = (double)wd;
+            add_term(id, (double)wd, prev, d0 + l, l == 0, &p0, &p1);
+            prev = (double)wd;
+        }
+        part[0] = p0;
+        part[1] = p1;
+        part[3] = prev;
+    }
+    return clamps;
+}
+
+/*
+ * Tile pass of a transformed objective: the velocity, as tile_pass(), and
+ * the candidate (and local walk) minus the shift into their batch rows.
+ */
+static long batch_pass(const BatHdPop *pop, BatHdScratch *s, int k, int tile) {
+    const BatHdSlot *slot = &s->slot[k];
+    int d0, d1;
+    local_tile(pop, tile, &d0, &d1);
+    const int n = d1 - d0;
+    const size_t off = (size_t)slot->bat * (size_t)pop->stride + (size_t)(d0 - pop->d_lo);
+    const bat_real *restrict best = pop->best_x + (d0 - pop->d_lo);
+    const bat_real *restrict x = pop->x + off;
+    bat_real *restrict v = pop->v + off;
+    const bat_real f = (bat_real)pop->bat[slot->bat].f_i;
+    const double *restrict shift = pop->tf->shift + d0;
+    double *restrict z = bat_transform_row(pop->tf, k) + d0;
+
+    long clamps = 0;
+    for (int l = 0; l < n; l++) {
+        bat_real vd = v[l] + (best[l] - x[l]) * f;
+        bat_real raw = x[l] + vd;
+        bat_real cd = clamp_coord(raw);
+        clamps += (cd != raw);
+        v[l] = vd;
+        z[l] = (double)cd - shift[l];
+    }
+    if (slot->walk) {
+        uint32_t rng = bat_rng_init(slot->key, (uint32_t)(pop->tile0 + tile));
+        z = bat_transform_row(pop->tf, slot->walk_row) + d0;
+        for (int l = 0; l < n; l++) {
+            bat_real raw = walk_coord(best[l], bat_rng_normal(&rng, 0.0, 1.0), slot->A_mean);
+            bat_real wd = clamp_coord(raw);
+            clamps += (wd != raw);
+            z[l] = (double)wd - shift[l];
+        }
+    }
+    return clamps;
+}
+
+void bat_hd_tile(BatHdPop *pop, BatHdScratch *s, int k, int tile, BatCounters *cnt) {
+    long clamps;
+    if (pop->tf) {
+        cnt->clamps += batch_pass(pop, s, k, tile);
+        return;
+    }
+    /* One copy of the pass per objective: add_term() folds to a few instructions. */
+    switch (bat_get_objective()) {
+        case BAT_OBJ_SPHERE:     clamps = tile_pass(BAT_OBJ_SPHERE, pop, s, k, tile); break;
+        case BAT_OBJ_RASTRIGIN:  clamps = tile_pass(BAT_OBJ_RASTRIGIN, pop, s, k, tile); break;
+        case BAT_OBJ_ACKLEY:     clamps = tile_pass(BAT_OBJ_ACKLEY, pop, s, k, tile); break;
+        case BAT_OBJ_GRIEWANK:   clamps = tile_pass(BAT_OBJ_GRIEWANK, pop, s, k, tile); break;
+        case BAT_OBJ_ROSENBROCK: clamps = tile_pass(BAT_OBJ_ROSENBROCK, pop, s, k, tile); break;
+        default:                 clamps = tile_pass(BAT_OBJ_PARABOLOID, pop, s, k, tile); break;
+    }
+    cnt->clamps += clamps;
+}
+
+/*
+ * Acceptance test of slot k, as in update_bat(), given the values of the
+ * candidate (F_move) and of the local walk (F_walk, ignored if no walk
+ * was drawn). Returns the evaluations (1-2); an accepted candidate is
+ * written to the row by bat_hd_commit().
+ */
+int bat_hd_accept(BatHdPop *pop, BatHdScratch *s, int k, int t, double F_move, double F_walk, BatCounters *cnt) {
+    const BatParams *p = &bat_params;
+    BatHdSlot *slot = &s->slot[k];
+    BatHdBat *b = &pop->bat[slot->bat];
+
+    double Fnew = F_move;
+    int chosen = 1, evals = 1;
+
+    if (slot->walk) {
+        cnt->local_search++;
+        evals++;
+        if (F_walk > Fnew) {   /* we maximize */
+            Fnew = F_walk;
+            chosen = 2;
+        }
+    }
+
+    double rand_loud = bat_rng_uniform01(&b->rng_state);
+    if (Fnew > b->f_value && rand_loud < b->A_i) {
+        slot->accept = chosen;
+        b->f_value = Fnew;
+        b->A_i *= p->alpha;
+        b->r_i = p->r0 * (1.0 - exp(-p->gamma * t));
+        cnt->accepts++;
+    }
+    return evals;
+}
+
+int bat_hd_finish(BatHdPop *pop, BatHdScratch *s, int k, int t, BatCounters *cnt) {
+    const int id = bat_get_objective();
+    double F_move = slot_value(pop, s, k, 0, id);
+    double F_walk = s->slot[k].walk ? slot_value(pop, s, k, 1, id) : 0.0;
+    return bat_hd_accept(pop, s, k, t, F_move, F_walk, cnt);
+}
+
+int bat_hd_batch_rows(BatHdScratch *s, int count) {
+    int rows = count;
+    for (int k = 0; k < count; k++) s->slot[k].walk_row = s->slot[k].walk ? rows++ : -1;
+    return rows;
+}
+
+int bat_hd_accept_batch(BatHdPop *pop, BatHdScratch *s, int k, int t, BatCounters *cnt) {
+    const BatHdSlot *slot = &s->slot[k];
+    const double *f = pop->tf->f;
+    return bat_hd_accept(pop, s, k, t, f[k], slot->walk ? f[slot->walk_row] : 0.0, cnt);
+}
+
+/* Recomputes the accepted candidate on one tile, with the arithmetic of tile_pass(). */
+void bat_hd_commit(BatHdPop *pop, const BatHdScratch *s, int k, int tile) {
+    const BatHdSlot *slot = &s->slot[k];
+    if (!slot->accept) return;
+
+    int d0, d1;
+    local_tile(pop, tile, &d0, &d1);
+    const int n = d1 - d0;
+    const size_t off = (size_t)slot->bat * (size_t)pop->stride + (size_t)(d0 - pop->d_lo);
+    bat_real *x = pop->x + off;
+    const bat_real *v = pop->v + off;
+
+    if (slot->accept == 1) {
+        for (int l = 0; l < n; l++) x[l] = clamp_coord(x[l] + v[l]);
+    } else {
+        const bat_real *best = pop->best_x + (d0 - pop->d_lo);
+        uint32_t rng = bat_rng_init(slot->key, (uint32_t)(pop->tile0 + tile));
+        for (int l = 0; l < n; l++) {
+            x[l] = clamp_coord(walk_coord(best[l], bat_rng_normal(&rng, 0.0, 1.0), slot->A_mean));
+        }
+    }
+}
+
+int bat_hd_update_group(BatHdPop *pop, BatHdScratch *s, int first, int count, double A_mean, int t,
+                        BatCounters *cnt) {
+    int evals = 0, rows = 0;
+    for (int k = 0; k < count; k++) bat_hd_begin(pop, s, k, first + k, A_mean);
+    if (pop->tf) rows = bat_hd_batch_rows(s, count);
+
+    /* Tile-major: each tile of best_x is reused by the whole group. */
+    for (int j = 0; j < pop->n_tiles; j++) {
+        for (int k = 0; k < count; k++) bat_hd_tile(pop, s, k, j, cnt);
+    }
+    if (pop->tf) bat_transform_eval(pop->tf, bat_get_objective(), rows);
+    for (int k = 0; k < count; k++) {
+        evals += pop->tf ? bat_hd_accept_batch(pop, s, k, t, cnt) : bat_hd_finish(pop, s, k, t, cnt);
+        for (int j = 0; j < pop->n_tiles; j++) bat_hd_commit(pop, s, k, j);
+    }
+    return evals;
+}
+
+double bat_hd_mean_loudness(const BatHdPop *pop) {
+    BatExactSum sum;
+    bat_xsum_clear(&sum);
+    for (int i = 0; i < pop->n_bats; i++) bat_xsum_add(&sum, pop->bat[i].A_i);
+    return bat_xsum_value(&sum) / (double)pop->n_bats;
+}
+
+int bat_hd_select_best(BatHdPop *pop) {
+    int best = 0;
+    for (int i = 1; i < pop->n_bats; i++) {
+        if (pop->bat[i].f_value > pop->bat[best].f_value) best = i;
+    }
+    /* Accepted moves strictly increase f_value: an unchanged value means an unchanged row. */
+    if (pop->best_i >= 0 && pop->bat[best].f_value <= pop->best_f) return 0;
+
+    pop->best_i = pop->bat0 + best;
+    pop->best_f = pop->bat[best].f_value;
+    memcpy(pop->best_x, pop->x + (size_t)best * (size_t)pop->stride, (size_t)pop->stride * sizeof(bat_real));
+    return 1;
+}
+
+void bat_hd_print_bench(const BatHdPop *pop, int group, const char *mode) {
+    printf(" dim=%d tile=%d group=%d hd_mode=%s", pop->dim, BAT_HD_TILE, group, mode);
+}
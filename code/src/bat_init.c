@@ -0,0 +1,287 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "bat.h"
+#include "bat_init.h"
+#include "bat_constraint.h"
+#include "bat_mo.h"
+#include "bat_rng.h"
+#include "bat_utils.h"
+
+/*
+ * bat_init.c
+ *
+ * Purpose:
+ * Place the initial population in the search space.
+ *
+ * With few bats, i.i.d. uniform sampling leaves large empty regions, and
+ * the swarm spends many iterations discovering them. Low-discrepancy
+ * sequences (Sobol, Halton) and Latin hypercube sampling cover the box
+ * more evenly for the same number of bats.
+ *
+ * Determinism:
+ * - The randomization of each strategy (Sobol digital shift, Halton
+ *   rotation, LHS permutations and jitter) is derived from --seed only.
+ * - The per-bat RNG state is initialized exactly as before, so the
+ *   iterations that follow are reproducible as well.
+ */
+
+/* Stream ids used to derive the strategy randomization from the seed. */
+#define INIT_STREAM_SHIFT  0xC0FFEE00u
+#define INIT_STREAM_LHS    0x1A7E0000u
+#define INIT_SEED_MIX      0x85EBCA6Bu
+
+/*
+ * Sobol direction numbers (Joe & Kuo, "new-joe-kuo-6.21201"), for the
+ * dimensions after the first one: degree s, coefficients a, initial m_k.
+ */
+static const struct {
+    int s;
+    unsigned a;
+    unsigned m[5];
+} sobol_table[BAT_QMC_MAX_DIM - 1] = {
+    {1, 0, {1}},
+    {2, 1, {1, 3}},
+    {3, 1, {1, 3, 1}},
+    {3, 2, {1, 1, 1}},
+    {4, 1, {1, 1, 3, 3}},
+    {4, 4, {1, 3, 5, 13}},
+    {5, 2, {1, 1, 5, 5, 17}},
+    {5, 4, {1, 1, 5, 5, 5}},
+    {5, 7, {1, 1, 7, 11, 19}},
+};
+
+/* First primes, used as Halton bases. */
+static const unsigned halton_base[BAT_QMC_MAX_DIM] = {2, 3, 5, 7, 11, 13, 17, 19, 23, 29};
+
+/* Direction numbers V[d][k] (32-bit, k = bit index), built once. */
+static uint32_t sobol_v[BAT_QMC_MAX_DIM][32];
+static int sobol_ready = 0;
+
+static void sobol_build(void) {
+    /* Dimension 0: van der Corput sequence in base 2. */
+    for (int k = 0; k < 32; k++) sobol_v[0][k] = 1u << (31 - k);
+
+    for (int d = 1; d < BAT_QMC_MAX_DIM; d++) {
+        int s = sobol_table[d - 1].s;
+        unsigned a = sobol_table[d - 1].a;
+        uint32_t *v = sobol_v[d];
+
+        for (int k = 0; k < s; k++) v[k] = sobol_table[d - 1].m[k] << (31 - k);
+        for (int k = s; k < 32; k++) {
+            v[k] = v[k - s] ^ (v[k - s] >> s);
+            for (int l = 1; l < s; l++) {
+                if ((a >> (s - 1 - l)) & 1u) v[k] ^= v[k - l];
+            }
+        }
+    }
+    sobol_ready = 1;
+}
+
+/* Coordinate d of Sobol point `index` (direct formula, no Gray-code recursion). */
+static uint32_t sobol_point(uint32_t index, int d) {
+    uint32_t x = 0;
+    for (int k = 0; index != 0; k++, index >>= 1) {
+        if (index & 1u) x ^= sobol_v[d][k];
+    }
+    return x;
+}
+
+/* Radical inverse of `index` in the given base, in [0,1). */
+static double radical_inverse(uint32_t index, unsigned base) {
+    double inv = 1.0 / (double)base;
+    double f = inv;
+    double r = 0.0;
+    while (index > 0) {
+        r += f * (double)(index % base);
+        index /= base;
+        f *= inv;
+    }
+    return r;
+}
+
+int bat_init_kind_from_name(const char *name) {
+    if (strcmp(name, "uniform") == 0) return BAT_INIT_UNIFORM;
+    if (strcmp(name, "sobol") == 0)   return BAT_INIT_SOBOL;
+    if (strcmp(name, "halton") == 0)  return BAT_INIT_HALTON;
+    if (strcmp(name, "lhs") == 0)     return BAT_INIT_LHS;
+    return -1;
+}
+
+const char *bat_init_kind_name(int kind) {
+    switch (kind) {
+        case BAT_INIT_SOBOL:  return "sobol";
+        case BAT_INIT_HALTON: return "halton";
+        case BAT_INIT_LHS:    return "lhs";
+        default:              return "uniform";
+    }
+}
+
+/*
+ * Builds the per-seed randomization of an initialization strategy.
+ *
+ * Parameters:
+ *   - plan       : output plan
+ *   - kind       : BAT_INIT_* strategy
+ *   - opposition : 1 to enable opposition-based learning
+ *   - n_bats     : total population size (all ranks)
+ *   - seed       : global random seed
+ */
+int bat_init_plan_create(BatInitPlan *plan, int kind, int opposition, int n_bats, uint32_t seed) {
+    memset(plan, 0, sizeof(*plan));
+    plan->kind = kind;
+    plan->opposition = opposition;
+    plan->n_bats = n_bats;
+    plan->seed = seed;
+
+    if ((kind == BAT_INIT_SOBOL || kind == BAT_INIT_HALTON) && dimension > BAT_QMC_MAX_DIM) {
+        fprintf(stderr, "--init %s supports at most %d dimensions\n", bat_init_kind_name(kind), BAT_QMC_MAX_DIM);
+        return -1;
+    }
+
+    /* Scrambling values: one independent stream per dimension. */
+    for (int d = 0; d < dimension; d++) {
+        uint32_t s = bat_rng_init(seed ^ INIT_SEED_MIX, INIT_STREAM_SHIFT + (uint32_t)d);
+        plan->sobol_shift[d] = s;
+        plan->halton_shift[d] = bat_rng_uniform01(&s);
+    }
+
+    if (kind == BAT_INIT_SOBOL && !sobol_ready) {
+        sobol_build();
+    }
+
+    if (kind == BAT_INIT_LHS) {
+        plan->lhs_perm = malloc((size_t)dimension * (size_t)n_bats * sizeof(int));
+        if (!plan->lhs_perm) {
+            perror("malloc lhs_perm");
+            return -1;
+        }
+        /* One Fisher-Yates shuffle of the strata per dimension. */
+        for (int d = 0; d < dimension; d++) {
+            int *perm = plan->lhs_perm + (size_t)d * (size_t)n_bats;
+            uint32_t rng = bat_rng_init(seed ^ INIT_SEED_MIX, INIT_STREAM_LHS + (uint32_t)d);
+            for (int i = 0; i < n_bats; i++) perm[i] = i;
+            for (int i = n_bats - 1; i > 0; i--) {
+                int j = (int)(bat_rng_uniform01(&rng) * (double)(i + 1));
+                if (j > i) j = i;
+                int tmp = perm[i];
+                perm[i] = perm[j];
+                perm[j] = tmp;
+            }
+        }
+    }
+    return 0;
+}
+
+void bat_init_plan_free(BatInitPlan *plan) {
+    free(plan->lhs_perm);
+    plan->lhs_perm = NULL;
+}
+
+/*
+ * Computes the initial position of global bat `i` in [Lb, Ub].
+ * `rng` is the bat's own RNG state (used by the uniform strategy only, so
+ * the uniform strategy reproduces the historical initialization exactly).
+ */
+static void init_position(const BatInitPlan *plan, int i, uint32_t *rng, double x[]) {
+    const double width = (double)Ub - (double)Lb;
+
+    for (int d = 0; d < dimension; d++) {
+        double u;
+        switch (plan->kind) {
+            case BAT_INIT_SOBOL: {
+                uint32_t bits = sobol_point((uint32_t)i, d) ^ plan->sobol_shift[d];
+                u = ((double)bits + 0.5) / 4294967296.0;
+                break;
+            }
+            case BAT_INIT_HALTON: {
+                u = radical_inverse((uint32_t)i + 1u, halton_base[d]) + plan->halton_shift[d];
+                if (u >= 1.0) u -= 1.0;
+                break;
+            }
+            case BAT_INIT_LHS: {
+                /* Stratum from the permutation, jitter from a per-(bat, dim) stream. */
+                int stratum = plan->lhs_perm[(size_t)d * (size_t)plan->n_bats + (size_t)i];
+                uint32_t s = bat_rng_init(plan->seed, INIT_STREAM_LHS ^ ((uint32_t)i * dimension + (uint32_t)d));
+                u = ((double)stratum + bat_rng_uniform01(&s)) / (double)plan->n_bats;
+                break;
+            }
+            default:
+                x[d] = bat_rng_uniform(rng, (double)Lb, (double)Ub);
+                continue;
+        }
+        x[d] = (double)Lb + width * u;
+    }
+}
+
+/*
+ * Initializes global bat `i`: RNG state, position, velocity, Bat Algorithm
+ * parameters and fitness. With opposition-based learning the opposite
+ * point is evaluated too and the better of the two is kept. With
+ * constraints, f_value is the rank of the point (bat_constraint.h); with
+ * several objectives, f_mo is the objective vector (bat_mo.h).
+ *
+ * Parameters:
+ *   - plan : strategy built by bat_init_plan_create()
+ *   - bat  : bat to initialize
+ *   - i    : global index of the bat (0..n_bats-1)
+ */
+void bat_init_one(const BatInitPlan *plan, Bat *bat, int i) {
+    bat->rng_state = bat_rng_init(plan->seed, (uint32_t)i);
+
+    double x0[dimension];
+    init_position(plan, i, &bat->rng_state, x0);
+    for (int d = 0; d < dimension; d++) {
+        bat->x_i[d] = (bat_real)x0[d];
+        bat->v_i[d] = V0;
+    }
+
+    bat->f_i = bat_params.f_min;
+    bat->A_i = bat_params.a0;
+    bat->r_i = bat_params.r0;
+
+    bat->alpha_i = bat->m_alpha = bat_params.alpha;
+    bat->gamma_i = bat->m_gamma = bat_params.gamma;
+    bat->fmax_i = bat_params.f_max;
+    bat->n_success = 0;
+    bat->viol = 0.0;
+    if (bat_mo.n > 0) {
+        bat->f_obj = bat->f_value = bat_mo_point(bat->x_i, bat->f_mo);
+        return;   /* bat_mo_check() rejects --obl */
+    }
+    bat->f_obj = bat_objective_real(bat->x_i);
+    bat->f_value = bat_con.n > 0 ? bat_con_point(bat->x_i, bat->f_obj, &bat->viol) : bat->f_obj;
+
+    if (plan->opposition) {
+        bat_real opp[dimension];
+        for (int d = 0; d < dimension; d++) {
+            opp[d] = (bat_real)((double)Lb + (double)Ub - bat->x_i[d]);
+        }
+        double f_opp = bat_objective_real(opp), v_opp = 0.0;
+        double r_opp = bat_con.n > 0 ? bat_con_point(opp, f_opp, &v_opp) : f_opp;
+        if (r_opp > bat->f_value) {   /* we maximize */
+            for (int d = 0; d < dimension; d++) bat->x_i[d] = opp[d];
+            bat->f_value = r_opp;
+            bat->f_obj = f_opp;
+            bat->viol = v_opp;
+        }
+    }
+}
+
+void select_best_bat(const Bat bats[], int n_bats, Bat *best_bat) {
+    int best_index = 0;
+    for (int i = 1; i < n_bats; i++) {
+        if (bats[i].f_value > bats[best_index].f_value) {
+            best_index = i;
+        }
+    }
+    *best_bat = bats[best_index];
+}
+
+void initialize_bats_plan(Bat bats[], int n_bats, Bat *best_bat, const BatInitPlan *plan) {
+    for (int i = 0; i < n_bats; i++) {
+        bat_init_one(plan, &bats[i], i);
+    }
+    select_best_bat(bats, n_bats, best_bat);
+}
@@ -0,0 +1,207 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+
+#include "bat.h"
+#include "bat_io.h"
+
+struct BatDumpWriter {
+    pthread_t       thread;
+    pthread_mutex_t lock;
+    pthread_cond_t  cond;
+
+    Bat  *buffer;      /* spare copy of the population (in the caller's arena) */
+    int   capacity;    /* number of Bat records in buffer */
+    Bat   best;        /* copy of the best bat at dump time */
+
+    int      n_bats;
+    int      iteration;
+    uint32_t seed;
+    int      rank;
+    int      n_ranks;
+    char     path[256];
+
+    int pending;       /* a job is queued or being written */
+    int stop;          /* ask the thread to exit */
+};
+
+/*
+ * bat_io.c
+ *
+ * Purpose:
+ * Write the bat population to disk in a compact binary format, either
+ * synchronously (checkpoints) or from a background thread (state dumps
+ * requested while the optimizer is running).
+ *
+ * The background writer keeps a spare buffer: at dump time the caller only
+ * copies the population into it and returns to the iteration loop, while
+ * the slow file I/O happens on the writer thread.
+ */
+
+
+/*
+ * Writes a population file (header + best bat + population records).
+ *
+ * Parameters:
+ *   - path      : output file name
+ *   - bats      : population (or local slice) to write
+ *   - n_bats    : number of bats in `bats`
+ *   - best_bat  : global best at capture time
+ *   - iteration : iteration index at capture time
+ *   - seed      : run seed (stored for reference)
+ *   - rank      : MPI rank of the writer (0 if not MPI)
+ *   - n_ranks   : number of MPI ranks (1 if not MPI)
+ */
+int bat_write_population(const char *path, const Bat bats[], int n_bats, const Bat *best_bat,
+                         int iteration, uint32_t seed, int rank, int n_ranks) {
+    FILE *fp = fopen(path, "wb");
+    if (!fp) {
+        perror("fopen population");
+        return -1;
+    }
+
+    BatPopHeader h;
+    memset(&h, 0, sizeof(h));
+    memcpy(h.magic, BAT_POP_MAGIC, sizeof(h.magic));
+    h.version     = BAT_POP_VERSION;
+    h.dim         = (uint32_t)dimension;
+    h.record_size = (uint32_t)sizeof(Bat);
+    h.n_bats      = (uint32_t)n_bats;
+    h.iteration   = (int32_t)iteration;
+    h.rank        = (uint32_t)rank;
+    h.n_ranks     = (uint32_t)n_ranks;
+    h.seed        = seed;
+
+    int ok = fwrite(&h, sizeof(h), 1, fp) == 1
+          && fwrite(best_bat, sizeof(Bat), 1, fp) == 1
+          && fwrite(bats, sizeof(Bat), (size_t)n_bats, fp) == (size_t)n_bats;
+
+    if (fclose(fp) != 0) ok = 0;
+    if (!ok) {
+        fprintf(stderr, "Failed to write population file %s\n", path);
+        return -1;
+    }
+    return 0;
+}
+
+FILE *bat_trace_open(const char *path) {
+    FILE *fp = fopen(path, "w");
+    if (!fp) perror("fopen trace");
+    return fp;
+}
+
+void bat_trace_write(FILE *fp, int t, const Bat *best_bat) {
+    fprintf(fp, "%d %a", t, best_bat->f_value);
+    for (int d = 0; d < dimension; d++) {
+        fprintf(fp, " %a", best_bat->x_i[d]);
+    }
+    fputc('\n', fp);
+}
+
+/* Writer thread body: sleeps until a job is queued, writes it, repeats. */
+static void *dump_writer_main(void *arg) {
+    BatDumpWriter *w = (BatDumpWriter *)arg;
+
+    pthread_mutex_lock(&w->lock);
+    for (;;) {
+        while (!w->pending && !w->stop) {
+            pthread_cond_wait(&w->cond, &w->lock);
+        }
+        if (!w->pending && w->stop) break;
+
+        /* The buffer is owned by this thread until pending is cleared. */
+        pthread_mutex_unlock(&w->lock);
+        bat_write_population(w->path, w->buffer, w->n_bats, &w->best,
+                             w->iteration, w->seed, w->rank, w->n_ranks);
+        pthread_mutex_lock(&w->lock);
+
+        w->pending = 0;
+        pthread_cond_broadcast(&w->cond);
+    }
+    pthread_mutex_unlock(&w->lock);
+    return NULL;
+}
+
+size_t bat_dump_writer_bytes(int capacity) {
+    return bat_arena_need((size_t)capacity * sizeof(Bat));
+}
+
+BatDumpWriter *bat_dump_writer_create(BatArena *arena, int capacity) {
+    Bat *buffer = bat_arena_alloc(arena, (size_t)capacity * sizeof(Bat));
+    if (!buffer) return NULL;
+    BatDumpWriter *w = calloc(1, sizeof(*w));
+    if (!w) {
+        perror("calloc dump writer");
+        return NULL;
+    }
+    w->buffer = buffer;
+    w->capacity = capacity;
+
+    pthread_mutex_init(&w->lock, NULL);
+    pthread_cond_init(&w->cond, NULL);
+    if (pthread_create(&w->thread, NULL, dump_writer_main, w) != 0) {
+        fprintf(stderr, "Failed to start dump writer thread\n");
+        pthread_mutex_destroy(&w->lock);
+        pthread_cond_destroy(&w->cond);
+        free(w);
+        return NULL;
+    }
+    return w;
+}
+
+/*
+ * Copies the population into the spare buffer and wakes the writer.
+ * Unless `wait` is set, never blocks on file I/O: if the previous dump is
+ * not finished, the request is refused and the caller keeps it pending.
+ */
+int bat_dump_writer_submit(BatDumpWriter *w, const char *path, const Bat bats[], int n_bats,
+                           const Bat *best_bat, int iteration, uint32_t seed, int rank, int n_ranks,
+                           int wait) {
+    if (!w) {
+        fprintf(stderr, "Dump %s skipped: no dump writer\n", path);
+        return -1;
+    }
+    if (n_bats > w->capacity) {
+        fprintf(stderr, "Dump %s skipped: %d bats, writer sized for %d\n", path, n_bats, w->capacity);
+        return -1;
+    }
+
+    pthread_mutex_lock(&w->lock);
+    while (w->pending && wait) {
+        pthread_cond_wait(&w->cond, &w->lock);
+    }
+    if (w->pending) {
+        pthread_mutex_unlock(&w->lock);
+        return BAT_DUMP_BUSY;
+    }
+
+    memcpy(w->buffer, bats, (size_t)n_bats * sizeof(Bat));
+    w->best      = *best_bat;
+    w->n_bats    = n_bats;
+    w->iteration = iteration;
+    w->seed      = seed;
+    w->rank      = rank;
+    w->n_ranks   = n_ranks;
+    snprintf(w->path, sizeof(w->path), "%s", path);
+
+    w->pending = 1;
+    pthread_cond_broadcast(&w->cond);
+    pthread_mutex_unlock(&w->lock);
+    return 0;
+}
+
+/* Flushes the pending dump (if any), joins the writer thread and frees it. */
+void bat_dump_writer_destroy(BatDumpWriter *w) {
+    if (!w) return;
+
+    pthread_mutex_lock(&w->lock);
+    w->stop = 1;
+    pthread_cond_broadcast(&w->cond);
+    pthread_mutex_unlock(&w->lock);
+
+    pthread_join(w->thread, NULL);
+    pthread_mutex_destroy(&w->lock);
+    pthread_cond_destroy(&w->cond);
+    free(w);
+}
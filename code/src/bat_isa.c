@@ -0,0 +1,91 @@
+#include <string.h>
+
+#include "bat.h"
+#include "bat_isa.h"
+#include "bat_utils.h"
+
+/*
+ * bat_isa.c
+ *
+ * Purpose:
+ * Detect the instruction sets of the CPU and install the matching variant
+ * of the hot kernels (see bat_isa.h), with the update engine of the
+ * objective in use.
+ */
+
+static const char *isa_names[BAT_ISA_COUNT] = { "generic", "avx2", "avx512" };
+
+static const BatKernels isa_kernels[BAT_ISA_COUNT] = {
+    { update_bat_generic, bat_objective_eval_generic, bat_gemm_generic, bat_expr_run_generic,
+      bat_update_engine_generic },
+#ifdef BAT_ISA_X86
+    { update_bat_avx2,    bat_objective_eval_avx2,    bat_gemm_avx2,    bat_expr_run_avx2,
+      bat_update_engine_avx2 },
+    { update_bat_avx512,  bat_objective_eval_avx512,  bat_gemm_avx512,  bat_expr_run_avx512,
+      bat_update_engine_avx512 },
+#endif
+};
+
+BatKernels bat_kernels = { update_bat_generic, bat_objective_eval_generic, bat_gemm_generic, bat_expr_run_generic,
+                           bat_update_engine_generic };
+static int current_isa = BAT_ISA_GENERIC;
+static int current_engine = -1;
+
+int bat_isa_from_name(const char *name) {
+    if (strcmp(name, "auto") == 0) return BAT_ISA_AUTO;
+    for (int isa = 0; isa < BAT_ISA_COUNT; isa++) {
+        if (strcmp(name, isa_names[isa]) == 0) return isa;
+    }
+    return -2;
+}
+
+const char *bat_isa_name(int isa) {
+    if (isa == BAT_ISA_AUTO) return "auto";
+    return (isa >= 0 && isa < BAT_ISA_COUNT) ? isa_names[isa] : "unknown";
+}
+
+int bat_isa_supported(int isa) {
+    if (isa == BAT_ISA_AUTO || isa == BAT_ISA_GENERIC) return 1;
+#ifdef BAT_ISA_X86
+    __builtin_cpu_init();
+    if (isa == BAT_ISA_AVX2) {
+        return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+    }
+    if (isa == BAT_ISA_AVX512) {
+        return __builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512dq");
+    }
+#endif
+    return 0;
+}
+
+int bat_isa_select(int isa) {
+    if (isa == BAT_ISA_AUTO) {
+        /* Widest supported variant first. */
+        isa = BAT_ISA_GENERIC;
+        for (int k = BAT_ISA_COUNT - 1; k > BAT_ISA_GENERIC; k--) {
+            if (bat_isa_supported(k)) {
+                isa = k;
+                break;
+            }
+        }
+    }
+    if (isa < 0 || isa >= BAT_ISA_COUNT || !bat_isa_supported(isa)) return -1;
+
+    bat_kernels = isa_kernels[isa];
+    bat_kernels.update = bat_kernels.engine(current_engine);
+    current_isa = isa;
+    return isa;
+}
+
+int bat_isa_current(void) {
+    return current_isa;
+}
+
+void bat_isa_specialize(int id) {
+    current_engine = ((id >= 0 && id < BAT_OBJ_COUNT) || id == BAT_ENGINE_CONSTRAINED || id == BAT_ENGINE_MO) ? id : -1;
+    bat_kernels.update = bat_kernels.engine(current_engine);
+}
+
+int bat_isa_engine(void) {
+    return current_engine;
+}
@@ -0,0 +1,614 @@
+#include <math.h>
+#include <stddef.h>
+
+#include "bat.h"
+#include "bat_isa.h"
+#include "bat_constraint.h"
+#include "bat_mo.h"
+#include "bat_expr.h"
+#include "bat_rng.h"
+#include "bat_utils.h"
+
+/*
+ * bat_kernels.c
+ *
+ * Purpose:
+ * Hot kernels of the optimizer: the bat update (one engine per built-in
+ * objective, with the function inlined), the built-in objective
+ * functions, the matrix product of the rotated objectives and the
+ * interpreter of the objective expressions. This file is compiled once
+ * per instruction set (see the Makefile); BAT_KERNEL() appends the ISA suffix to every name, and
+ * bat_isa.c installs one set of variants at startup.
+ *
+ * Positions and velocities are bat_real (double, or float with
+ * PRECISION=float), so the same source also gives the single-precision
+ * kernels; fitness values and comparisons are always double.
+ *
+ * All variants are built with -ffp-contract=off: the compiler may use wider
+ * vectors, but never fuses a multiply and an add, so every variant returns
+ * bitwise identical results and runs stay reproducible on any CPU.
+ */
+
+#ifndef BAT_ISA_SUFFIX
+#define BAT_ISA_SUFFIX generic
+#endif
+#define BAT_KERNEL_CAT2(name, sfx) name##_##sfx
+#define BAT_KERNEL_CAT(name, sfx)  BAT_KERNEL_CAT2(name, sfx)
+#define BAT_KERNEL(name)           BAT_KERNEL_CAT(name, BAT_ISA_SUFFIX)
+
+/*
+ * Self-adaptation settings (--adapt).
+ * - history: on each accepted move, the bat's success-history means move
+ *   towards the alpha/gamma it was using, and a new alpha/gamma is sampled
+ *   around the means. Parameters that keep producing improvements are
+ *   reinforced; the rest drift away.
+ * - freq: jDE-style self-adaptation of the upper frequency bound: with
+ *   probability ADAPT_TAU a bat tries a new bound, kept only on success.
+ */
+#define ADAPT_MEMORY_RATE  0.1
+#define ADAPT_ALPHA_SD     0.02
+#define ADAPT_GAMMA_SD     0.05
+#define ADAPT_TAU          0.1
+
+static double clamp_range(double v, double lo, double hi) {
+    return v < lo ? lo : (v > hi ? hi : v);
+}
+
+/* Helpers instantiated with constant arguments: always inlined, so the constants fold. */
+#if defined(__GNUC__)
+#define KERNEL_INLINE static inline __attribute__((always_inline))
+#else
+#define KERNEL_INLINE static inline
+#endif
+
+/*
+ * Built-in test functions (maximized, see bat_utils.h), as a template over
+ * the coordinate type T: OBJECTIVE_TEMPLATE(name, T) defines
+ * double name(int id, const T x[], int n). Every coordinate is converted
+ * to double before use, so the float instance gives the value of the
+ * double one on the converted point.
+ *
+ * Instances: objective_double() for bat_objective_eval(), and
+ * objective_real() for the update engines, which evaluate the candidates
+ * in place (bat_real, no copy to double).
+ */
+#define OBJECTIVE_TEMPLATE(name, T)                                                     \
+KERNEL_INLINE double name(int id, const T x[], int n) {                                 \
+    switch (id) {                                                                       \
+        case BAT_OBJ_SPHERE: {                                                          \
+            double s = 0.0;                                                             \
+            for (int d = 0; d < n; d++) s += (double)x[d] * (double)x[d];               \
+            return -s;                                                                  \
+        }                                                                               \
+        case BAT_OBJ_RASTRIGIN: {                                                       \
+            double s = 10.0 * n;                                                        \
+            for (int d = 0; d < n; d++) {                                               \
+                double xd = (double)x[d];                                               \
+                s += xd * xd - 10.0 * cos(2.0 * M_PI * xd);                             \
+            }                                                                           \
+            return -s;                                                                  \
+        }                                                                               \
+        case BAT_OBJ_ACKLEY: {                                                          \
+            double sq = 0.0, cs = 0.0;                                                  \
+            for (int d = 0; d < n; d++) {                                               \
+                double xd = (double)x[d];                                               \
+                sq += xd * xd;                                                          \
+                cs += cos(2.0 * M_PI * xd);                                             \
+            }                                                                           \
+            double v = -20.0 * exp(-0.2 * sqrt(sq / n)) - exp(cs / n) + 20.0 + M_E;     \
+            return -v;                                                                  \
+        }                                                                               \
+        case BAT_OBJ_GRIEWANK: {                                                        \
+            double s = 0.0, p = 1.0;                                                    \
+            for (int d = 0; d < n; d++) {                                               \
+                double xd = (double)x[d];                                               \
+                s += xd * xd;                                                           \
+                p *= cos(xd / sqrt((double)(d + 1)));                                   \
+            }                                                                           \
+            return -(1.0 + s / 4000.0 - p);                                             \
+        }                                                                               \
+        case BAT_OBJ_ROSENBROCK: {                                                      \
+            double s = 0.0;                                                             \
+            for (int d = 0; d + 1 < n; d++) {                                           \
+                double a = (double)x[d + 1] - (double)x[d] * (double)x[d];              \
+                double b = 1.0 - (double)x[d];                                          \
+                s += 100.0 * a * a + b * b;                                             \
+            }                                                                           \
+            return -s;                                                                  \
+        }                                                                               \
+        default: {                                                                      \
+            double sum_sq = 0.0;                                                        \
+            for (int d = 0; d < n; d++) {                                               \
+                sum_sq += (double)x[d] * (double)x[d];                                  \
+            }                                                                           \
+            return 10.0 - sum_sq;                                                       \
+        }                                                                               \
+    }                                                                                   \
+}
+
+OBJECTIVE_TEMPLATE(objective_double, double)
+#ifdef BAT_REAL_FLOAT
+OBJECTIVE_TEMPLATE(objective_real, bat_real)
+#else
+#define objective_real objective_double
+#endif
+
+/*
+ * Built-in test functions (maximized, see bat_utils.h).
+ *
+ * Parameters:
+ *   - id : BAT_OBJ_* function
+ *   - x  : point to evaluate
+ *   - n  : number of coordinates of x
+ */
+double BAT_KERNEL(bat_objective_eval)(int id, const double x[], int n) {
+    return objective_double(id, x, n);
+}
+
+/*
+ * Register block of the matrix product: GEMM_MR rows x GEMM_NR columns of
+ * C stay in registers while the whole k loop runs (the column loop is what
+ * the compiler vectorizes, 2 to 8 doubles per instruction depending on the
+ * ISA).
+ */
+#define GEMM_MR 4
+#define GEMM_NR 8
+
+/* Edge of the product (rows or columns that do not fill a register block). */
+static void gemm_edge(int i0, int i1, int j0, int j1, int k, const double *a, int lda, const double *b, int ldb,
+                      double *c, int ldc) {
+    for (int i = i0; i < i1; i++) {
+        for (int j = j0; j < j1; j++) {
+            double acc = c[(size_t)i * ldc + j];
+            for (int p = 0; p < k; p++) acc += a[(size_t)i * lda + p] * b[(size_t)p * ldb + j];
+            c[(size_t)i * ldc + j] = acc;
+        }
+    }
+}
+
+/*
+ * C += A B on row-major blocks (A: m x k, B: k x n, C: m x n). Every
+ * element of C adds its k products in increasing k order, whatever the
+ * blocking: results do not depend on how the caller splits the product.
+ * Cache blocking is up to the caller (see bat_transform.c).
+ *
+ * Parameters:
+ *   - m, n, k       : block sizes
+ *   - a, b, c       : first element of each block
+ *   - lda, ldb, ldc : row strides (elements)
+ */
+void BAT_KERNEL(bat_gemm)(int m, int n, int k, const double *a, int lda, const double *b, int ldb, double *c,
+                          int ldc) {
+    int i = 0, j = 0;
+    for (; i + GEMM_MR <= m; i += GEMM_MR) {
+        for (j = 0; j + GEMM_NR <= n; j += GEMM_NR) {
+            double acc[GEMM_MR][GEMM_NR];
+            for (int r = 0; r < GEMM_MR; r++) {
+                for (int q = 0; q < GEMM_NR; q++) acc[r][q] = c[(size_t)(i + r) * ldc + j + q];
+            }
+            for (int p = 0; p < k; p++) {
+                const double *bp = b + (size_t)p * ldb + j;
+                #pragma GCC unroll 4
+                for (int r = 0; r < GEMM_MR; r++) {
+                    double ar = a[(size_t)(i + r) * lda + p];
+                    #pragma GCC unroll 8
+                    for (int q = 0; q < GEMM_NR; q++) acc[r][q] += ar * bp[q];
+                }
+            }
+            for (int r = 0; r < GEMM_MR; r++) {
+                for (int q = 0; q < GEMM_NR; q++) c[(size_t)(i + r) * ldc + j + q] = acc[r][q];
+            }
+        }
+        gemm_edge(i, i + GEMM_MR, j, n, k, a, lda, b, ldb, c, ldc);
+    }
+    gemm_edge(i, m, 0, n, k, a, lda, b, ldb, c, ldc);
+}
+
+/*
+ * Interpreter of the objective expressions (bat_expr.h).
+ *
+ * A register holds L x C values, lane-minor: element c * L + l belongs to
+ * lane l. Inside a reduction, c runs over C consecutive coordinates of
+ * every candidate; elsewhere the C values of a lane are copies. Every
+ * instruction is a loop over the whole register, so one dispatch is
+ * shared by L * C evaluations and the arithmetic compiles to whole
+ * vectors, and the running sums of the L lanes are independent chains
+ * that advance together.
+ *
+ * The functions below are always inlined with constant L and C: full
+ * blocks use L = BAT_EXPR_LANES and C = BAT_EXPR_CHUNK (the last block of
+ * a batch repeats its last candidate in the missing lanes), single points
+ * (the 2-D engine) use the same register width with L = 1.
+ */
+typedef double ExprRegs[BAT_EXPR_MAX_REGS][BAT_EXPR_LANES * BAT_EXPR_CHUNK];
+
+/*
+ * One instruction on the first m values. The compiler never gives an
+ * instruction an operand as destination: with restrict parameters the
+ * loops vectorize without runtime overlap checks.
+ */
+KERNEL_INLINE void expr_op(int op, double *restrict dst, const double *restrict a, const double *restrict b, int m) {
+    switch (op) {
+        case BAT_EXPR_ADD:  for (int e = 0; e < m; e++) dst[e] = a[e] + b[e]; break;
+        case BAT_EXPR_SUB:  for (int e = 0; e < m; e++) dst[e] = a[e] - b[e]; break;
+        case BAT_EXPR_MUL:  for (int e = 0; e < m; e++) dst[e] = a[e] * b[e]; break;
+        case BAT_EXPR_DIV:  for (int e = 0; e < m; e++) dst[e] = a[e] / b[e]; break;
+        case BAT_EXPR_POW:  for (int e = 0; e < m; e++) dst[e] = pow(a[e], b[e]); break;
+        case BAT_EXPR_MIN:  for (int e = 0; e < m; e++) dst[e] = a[e] < b[e] ? a[e] : b[e]; break;
+        case BAT_EXPR_MAX:  for (int e = 0; e < m; e++) dst[e] = a[e] > b[e] ? a[e] : b[e]; break;
+        case BAT_EXPR_NEG:  for (int e = 0; e < m; e++) dst[e] = -a[e]; break;
+        case BAT_EXPR_SIN:  for (int e = 0; e < m; e++) dst[e] = sin(a[e]); break;
+        case BAT_EXPR_COS:  for (int e = 0; e < m; e++) dst[e] = cos(a[e]); break;
+        case BAT_EXPR_TAN:  for (int e = 0; e < m; e++) dst[e] = tan(a[e]); break;
+        case BAT_EXPR_EXP:  for (int e = 0; e < m; e++) dst[e] = exp(a[e]); break;
+        case BAT_EXPR_LOG:  for (int e = 0; e < m; e++) dst[e] = log(a[e]); break;
+        case BAT_EXPR_SQRT: for (int e = 0; e < m; e++) dst[e] = sqrt(a[e]); break;
+        case BAT_EXPR_ABS:  for (int e = 0; e < m; e++) dst[e] = fabs(a[e]); break;
+        case BAT_EXPR_TANH: for (int e = 0; e < m; e++) dst[e] = tanh(a[e]); break;
+        default: break;
+    }
+}
+
+/* Instructions [lo, hi) without reductions or coordinates (a reduction body). */
+KERNEL_INLINE void expr_ops(const BatExprIns *ins, int lo, int hi, ExprRegs r, int m) {
+    for (int k = lo; k < hi; k++) {
+        expr_op(ins[k].op, r[ins[k].dst], r[ins[k].a], r[ins[k].b < 0 ? ins[k].a : ins[k].b], m);
+    }
+}
+
+/*
+ * Reduction instruction `ins`: chunks of C coordinates through the body,
+ * then the terms of every lane added (multiplied) in increasing coordinate
+ * order, like the built-in functions. The positions of a partial last
+ * chunk repeat its first coordinate and are not accumulated.
+ */
+KERNEL_INLINE void expr_reduce(const BatExprProg *p, const BatExprIns *ins, const double *const row[], int L,
+                             int C, ExprRegs r) {
+    const BatExprRed *red = &p->red[ins->arg];
+    const int prod = ins->op == BAT_EXPR_PROD, count = p->n - red->pairs;
+    double acc[BAT_EXPR_LANES];
+    for (int l = 0; l < L; l++) acc[l] = prod ? 1.0 : 0.0;
+
+    for (int d = 0; d < count; d += C) {
+        const int cc = count - d < C ? count - d : C;
+        for (int c = 0; c < C; c++) {
+            const int dc = d + (c < cc ? c : 0);
+            for (int l = 0; l < L; l++) r[BAT_EXPR_REG_X][c * L + l] = row[l][dc];
+            if (red->pairs) {
+                for (int l = 0; l < L; l++) r[BAT_EXPR_REG_XN][c * L + l] = row[l][dc + 1];
+            }
+            if (red->index) {
+                for (int l = 0; l < L; l++) r[BAT_EXPR_REG_I][c * L + l] = (double)(dc + 1);
+            }
+        }
+        expr_ops(p->ins, red->start, red->end, r, L * C);
+        const double *term = r[red->result];
+        for (int c = 0; c < cc; c++) {
+            if (prod) {
+                for (int l = 0; l < L; l++) acc[l] *= term[c * L + l];
+            } else {
+                for (int l = 0; l < L; l++) acc[l] += term[c * L + l];
+            }
+        }
+    }
+    for (int c = 0; c < C; c++) {
+        for (int l = 0; l < L; l++) r[ins->dst][c * L + l] = acc[l];
+    }
+}
+
+/* One block of L candidates (row[l] = coordinates of lane l). */
+KERNEL_INLINE void expr_block(const BatExprProg *p, const double *const row[], int L, int C, double out[]) {
+    ExprRegs r;
+    const int m = L * C;
+    for (int k = 0; k < p->main_end; k++) {
+        const BatExprIns *ins = &p->ins[k];
+        if (ins->op == BAT_EXPR_COORD) {
+            for (int e = 0; e < m; e++) r[ins->dst][e] = row[e % L][ins->arg];
+        } else if (ins->op == BAT_EXPR_CONST) {
+            for (int e = 0; e < m; e++) r[ins->dst][e] = p->const_val[ins->arg];
+        } else if (ins->op == BAT_EXPR_SUM || ins->op == BAT_EXPR_PROD) {
+            expr_reduce(p, ins, row, L, C, r);
+        } else {
+            expr_ops(p->ins, k, k + 1, r, m);
+        }
+    }
+    for (int l = 0; l < L; l++) {
+        const double v = r[p->result][l];
+        out[l] = isfinite(v) ? v : p->nonfinite;
+    }
+}
+
+/*
+ * Values of `count` candidates (row c at rows + c * ld) of a compiled
+ * expression, BAT_EXPR_LANES at a time. A candidate gets the same value
+ * in any block and at any position; NaN and infinite values are replaced
+ * by p->nonfinite.
+ */
+void BAT_KERNEL(bat_expr_run)(const BatExprProg *p, const double *rows, int ld, int count, double out[]) {
+    const double *row[BAT_EXPR_LANES];
+    double pad[BAT_EXPR_LANES];
+    if (count == 1) {
+        if (p->n < BAT_EXPR_CHUNK) expr_block(p, &rows, 1, 1, out);
+        else expr_block(p, &rows, 1, BAT_EXPR_LANES * BAT_EXPR_CHUNK, out);
+        return;
+    }
+    for (int c = 0; c < count; c += BAT_EXPR_LANES) {
+        const int w = count - c < BAT_EXPR_LANES ? count - c : BAT_EXPR_LANES;
+        for (int l = 0; l < BAT_EXPR_LANES; l++) row[l] = rows + (size_t)(c + (l < w ? l : w - 1)) * (size_t)ld;
+        if (w == BAT_EXPR_LANES) {
+            expr_block(p, row, BAT_EXPR_LANES, BAT_EXPR_CHUNK, out + c);
+        } else {
+            expr_block(p, row, BAT_EXPR_LANES, BAT_EXPR_CHUNK, pad);
+            for (int l = 0; l < w; l++) out[c + l] = pad[l];
+        }
+    }
+}
+
+/*
+ * Objective of the update engines: built-in function `id` inlined on the
+ * bat_real point, or (OBJ_INDIRECT) the objective selected at run time,
+ * called through bat_objective_real() (objective expressions, and any
+ * function installed behind bat_kernels.objective).
+ */
+#define OBJ_INDIRECT (-1)
+
+KERNEL_INLINE double engine_objective(int id, const bat_real x[]) {
+    if (id == OBJ_INDIRECT) return bat_objective_real(x);
+    return objective_real(id, x, dimension);
+}
+
+/*
+ * Constrained choice between the candidate and the local walk (walk = NULL
+ * if the pulse test skipped it): the violations of both in one batch,
+ * then the objective of each one bat_con_screen() cannot settle. The
+ * chosen point is left in cand. Returns its rank (-INFINITY if it cannot
+ * beat the bat), with its objective and violation in *f_obj / *viol.
+ */
+KERNEL_INLINE double con_choose(const Bat *bat, bat_real cand[], const bat_real walk[], double *f_obj, double *viol,
+                                int *evals, BatCounters *cnt) {
+    const int count = walk ? 2 : 1;
+    double rows[2][dimension], v[2], f[2], rank[2];
+
+    for (int d = 0; d < dimension; d++) {
+        rows[0][d] = (double)cand[d];
+        if (walk) rows[1][d] = (double)walk[d];
+    }
+    bat_con_violation(&rows[0][0], dimension, count, v);
+    cnt->con_evals += count;
+
+    for (int k = 0; k < count; k++) {
+        f[k] = NAN;
+        if (bat_con_screen(v[k], bat->f_value, &rank[k])) {
+            cnt->obj_skipped++;
+        } else {
+            f[k] = engine_objective(OBJ_INDIRECT, k ? walk : cand);
+            (*evals)++;
+            rank[k] = bat_con_rank(f[k], v[k]);
+        }
+    }
+
+    int pick = 0;
+    if (count == 2 && rank[1] > rank[0]) {   /* we maximize */
+        for (int d = 0; d < dimension; d++) cand[d] = walk[d];
+        pick = 1;
+    }
+    *f_obj = f[pick];
+    *viol = v[pick];
+    return rank[pick];
+}
+
+/*
+ * Multi-objective choice (--mo-objective): the objective vectors of the
+ * candidate and the local walk in one batch; the walk replaces the
+ * candidate if it dominates it. The chosen vector is left in f. Returns 1
+ * if the bat's own point does not dominate the candidate.
+ */
+KERNEL_INLINE int mo_choose(const Bat *bat, bat_real cand[], const bat_real walk[], double f[], int *evals) {
+    const int count = walk ? 2 : 1;
+    double rows[2][dimension], fv[2][BAT_MO_MAX];
+
+    for (int d = 0; d < dimension; d++) {
+        rows[0][d] = (double)cand[d];
+        if (walk) rows[1][d] = (double)walk[d];
+    }
+    bat_mo_eval(&rows[0][0], dimension, count, &fv[0][0]);
+    *evals += count;
+
+    int pick = 0;
+    if (count == 2 && bat_mo_dominates(fv[1], fv[0])) {
+        for (int d = 0; d < dimension; d++) cand[d] = walk[d];
+        pick = 1;
+    }
+    for (int k = 0; k < BAT_MO_MAX; k++) f[k] = fv[pick][k];
+    return !bat_mo_dominates(bat->f_mo, f);
+}
+
+/* Instances of update_body(): scalar objective, with constraints, multi-objective. */
+#define BODY_PLAIN 0
+#define BODY_CON   1
+#define BODY_MO    2
+
+/*
+ * Body of update_bat() (documented in bat_core.c), instantiated below once
+ * per objective with a constant `id`, and once per mode (`kind`): with
+ * constraints or several objectives, the candidates are built first and
+ * chosen by con_choose() / mo_choose(), which consume no random numbers,
+ * so the draws stay in the same order.
+ */
+KERNEL_INLINE int update_body(Bat *bat, const Bat *best_bat, double A_mean, int t, BatCounters *cnt, int id, int kind) {
+
+    const BatParams *p = &bat_params;
+    int evals = 0;
+
+    /* RNG state of this bat */
+    uint32_t *rng = &bat->rng_state;
+
+    /* Frequency range: global, or this bat's self-adapted upper bound. */
+    double f_max = p->f_max;
+    if (p->adapt & BAT_ADAPT_FREQ) {
+        f_max = bat->fmax_i;
+        if (bat_rng_uniform01(rng) < ADAPT_TAU) {
+            f_max = bat_rng_uniform(rng, p->f_min, p->f_max);
+        }
+    }
+
+    /* Random frequency in [f_min, f_max]. */
+    double beta = bat_rng_uniform01(rng);
+    bat->f_i = p->f_min + (f_max - p->f_min) * beta;
+
+    /* Velocity update: move toward global best. */
+    for (int d = 0; d < dimension; d++) {
+        bat->v_i[d] += (best_bat->x_i[d] - bat->x_i[d] ) * (bat_real)bat->f_i;
+    }
+
+    /*
+     * Candidate = position after the global move (+ bounds clamp).
+     * The bat itself only moves if the candidate is accepted below, so
+     * x_i always matches f_value (as in Yang's reference implementation).
+     */
+    bat_real candidate_x[dimension];
+    for (int d = 0; d < dimension; d++) {
+        candidate_x[d] = bat->x_i[d] + bat->v_i[d];
+        if (candidate_x[d] < Lb) { candidate_x[d] = Lb; cnt->clamps++; }
+        if (candidate_x[d] > Ub) { candidate_x[d] = Ub; cnt->clamps++; }
+    }
+
+    /* Evaluate the candidate obtained from the global move. */
+    double Fnew = 0.0, f_obj = 0.0, viol = 0.0, f_mo[BAT_MO_MAX];
+    if (kind == BODY_PLAIN) {
+        Fnew = engine_objective(id, candidate_x);
+        evals++;
+    }
+
+    /* Optional local search (triggered by pulse rate). */
+    bat_real local_x[dimension];
+    int walked = 0;
+    double rand_pulse = bat_rng_uniform01(rng);
+    if (rand_pulse > bat->r_i) {
+
+        walked = 1;
+        cnt->local_search++;
+
+        // local random walk around global best
+        for (int d = 0; d < dimension; d++) {
+            double eps = bat_rng_normal(rng, 0.0, 1.0);
+            local_x[d] = (bat_real)(best_bat->x_i[d] + 0.1 * eps * A_mean);
+
+            /* Clamp the local candidate to bounds. */
+            if (local_x[d] < Lb) { local_x[d] = Lb; cnt->clamps++; }
+            if (local_x[d] > Ub) { local_x[d] = Ub; cnt->clamps++; }
+        }
+        /* Evaluate the local (random-walk) candidate. */
+        if (kind == BODY_PLAIN) {
+            double F_local = engine_objective(id, local_x);
+            evals++;
+
+            /* If the local candidate is better, keep it as the new candidate. */
+            if (F_local > Fnew) {   /* we maximize */
+                for (int d = 0; d < dimension; d++) {
+                    candidate_x[d] = local_x[d];
+                }
+                Fnew = F_local;
+            }
+        }
+    }
+    int improved;
+    if (kind == BODY_MO) {
+        improved = mo_choose(bat, candidate_x, walked ? local_x : NULL, f_mo, &evals);
+        Fnew = f_mo[0];
+    } else {
+        if (kind == BODY_CON) Fnew = con_choose(bat, candidate_x, walked ? local_x : NULL, &f_obj, &viol, &evals, cnt);
+        improved = Fnew > bat->f_value;
+    }
+
+    /* Accept only if improved AND passes loudness test. */
+    double rand_loud = bat_rng_uniform01(rng);
+    if (improved && (rand_loud < bat->A_i)) {
+       
+        for (int d = 0; d < dimension; d++) {
+            bat->x_i[d] = candidate_x[d];
+        }
+        bat->f_value = Fnew;
+        if (kind == BODY_CON) {
+            bat->f_obj = f_obj;
+            bat->viol = viol;
+        }
+        if (kind == BODY_MO) {
+            for (int k = 0; k < BAT_MO_MAX; k++) bat->f_mo[k] = f_mo[k];
+        }
+        bat->n_success++;
+        cnt->accepts++;
+
+        if (p->adapt & BAT_ADAPT_FREQ) {
+            bat->fmax_i = f_max;   /* the tried bound produced a success */
+        }
+
+        if (p->adapt & BAT_ADAPT_HISTORY) {
+            /* Success: pull the history towards the parameters in use, then resample. */
+            bat->m_alpha += ADAPT_MEMORY_RATE * (bat->alpha_i - bat->m_alpha);
+            bat->m_gamma += ADAPT_MEMORY_RATE * (bat->gamma_i - bat->m_gamma);
+
+            bat->A_i *= bat->alpha_i;
+            /* Pulse rate follows the bat's own success count, not the global t. */
+            bat->r_i = p->r0 * (1.0 - exp(-bat->gamma_i * bat->n_success));
+
+            bat->alpha_i = clamp_range(bat_rng_normal(rng, bat->m_alpha, ADAPT_ALPHA_SD), 0.5, 0.999);
+            bat->gamma_i = clamp_range(bat_rng_normal(rng, bat->m_gamma, ADAPT_GAMMA_SD), 0.001, 1.0);
+        } else {
+            /* Update loudness (A_i) and pulse rate (r_i) using alpha, gamma (Yang) */
+            bat->A_i *= p->alpha;                       // A_i^{t+1} = alpha * A_i^t
+            bat->r_i = p->r0 * (1.0 - exp(-p->gamma * t)); // r_i^{t+1} = r0 * (1 - e^{-gamma t})
+        }
+
+        /* Caller recomputes the global best outside this function. */
+    }
+    return evals;
+}
+
+/*
+ * Update engines: one per built-in objective, with the function inlined
+ * (the call and the copy of float candidates to double disappear, and the
+ * loops over the coordinates unroll with the constant dimension), and the
+ * indirect one, update_bat_<isa>(), for the other objectives.
+ */
+#define UPDATE_ENGINE(name, id)                                                           \
+static int name(Bat *bat, const Bat *best_bat, double A_mean, int t, BatCounters *cnt) { \
+    return update_body(bat, best_bat, A_mean, t, cnt, id, BODY_PLAIN);                    \
+}
+
+UPDATE_ENGINE(update_paraboloid, BAT_OBJ_PARABOLOID)
+UPDATE_ENGINE(update_sphere, BAT_OBJ_SPHERE)
+UPDATE_ENGINE(update_rastrigin, BAT_OBJ_RASTRIGIN)
+UPDATE_ENGINE(update_ackley, BAT_OBJ_ACKLEY)
+UPDATE_ENGINE(update_griewank, BAT_OBJ_GRIEWANK)
+UPDATE_ENGINE(update_rosenbrock, BAT_OBJ_ROSENBROCK)
+
+/* Kernel of update_bat() for any objective (calls it through bat_objective_real()). */
+int BAT_KERNEL(update_bat)(Bat *bat, const Bat *best_bat, double A_mean, int t, BatCounters *cnt) {
+    return update_body(bat, best_bat, A_mean, t, cnt, OBJ_INDIRECT, BODY_PLAIN);
+}
+
+/* Constrained engine (--constraint): screening before the objective, any objective. */
+static int update_constrained(Bat *bat, const Bat *best_bat, double A_mean, int t, BatCounters *cnt) {
+    return update_body(bat, best_bat, A_mean, t, cnt, OBJ_INDIRECT, BODY_CON);
+}
+
+/* Multi-objective engine (--mo-objective): dominance instead of the scalar comparison. */
+static int update_mo(Bat *bat, const Bat *best_bat, double A_mean, int t, BatCounters *cnt) {
+    return update_body(bat, best_bat, A_mean, t, cnt, OBJ_INDIRECT, BODY_MO);
+}
+
+/* Update engine of objective `id` (BAT_OBJ_*, -1 for the indirect one, BAT_ENGINE_*). */
+BatUpdateFn BAT_KERNEL(bat_update_engine)(int id) {
+    switch (id) {
+        case BAT_ENGINE_CONSTRAINED: return update_constrained;
+        case BAT_ENGINE_MO:          return update_mo;
+        case BAT_OBJ_PARABOLOID: return update_paraboloid;
+        case BAT_OBJ_SPHERE:     return update_sphere;
+        case BAT_OBJ_RASTRIGIN:  return update_rastrigin;
+        case BAT_OBJ_ACKLEY:     return update_ackley;
+        case BAT_OBJ_GRIEWANK:   return update_griewank;
+        case BAT_OBJ_ROSENBROCK: return update_rosenbrock;
+        default:                 return BAT_KERNEL(update_bat);
+    }
+}
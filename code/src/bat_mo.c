@@ -0,0 +1,317 @@
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "bat.h"
+#include "bat_mo.h"
+#include "bat_expr.h"
+#include "bat_isa.h"
+#include "bat_mode.h"
+#include "bat_rng.h"
+#include "bat_utils.h"
+
+/*
+ * bat_mo.c
+ *
+ * Purpose:
+ * Multi-objective mode: the vector-valued objective, dominance, the
+ * non-dominated filter and the bounded Pareto archive with its crowding
+ * distances and leader selection (see bat_mo.h).
+ */
+
+BatMoProblem bat_mo = { 0, NULL, NULL };
+
+/* Compiled --mo-objective expressions. */
+static BatExprProg mo_progs[BAT_MO_MAX];
+
+int bat_mo_check(const BatOptions *opts) {
+    static BatExprProg prog;
+
+    if (opts->n_mo < 0 || opts->n_mo == 1) {
+        fprintf(stderr, "--mo-objective needs 2 to %d objectives\n", BAT_MO_MAX);
+        return -1;
+    }
+    if (opts->mo_archive < 1) {
+        fprintf(stderr, "Invalid --mo-archive %d\n", opts->mo_archive);
+        return -1;
+    }
+    if (bat_mode_check(opts, "--mo-objective") != 0) return -1;
+    if (opts->objective == BAT_OBJ_EXPR || opts->init_obl) {
+        fprintf(stderr, "--mo-objective cannot be combined with --objective-expr or --obl\n");
+        return -1;
+    }
+    for (int k = 0; k < opts->n_mo; k++) {
+        if (bat_expr_compile(&prog, opts->mo_expr[k], dimension) != 0) return -1;
+    }
+    return 0;
+}
+
+/* Batch objective of the compiled expressions (ctx = the BatExprProg array). */
+static void expr_objectives(const void *ctx, const double *rows, int ld, int count, double out[]) {
+    const BatExprProg *progs = ctx;
+    double v[BAT_EXPR_LANES];
+    for (int c0 = 0; c0 < count; c0 += BAT_EXPR_LANES) {
+        const int w = count - c0 < BAT_EXPR_LANES ? count - c0 : BAT_EXPR_LANES;
+        for (int k = 0; k < bat_mo.n; k++) {
+            bat_kernels.expr(&progs[k], rows + (size_t)c0 * (size_t)ld, ld, w, v);
+            for (int c = 0; c < w; c++) out[(size_t)(c0 + c) * BAT_MO_MAX + k] = v[c];
+        }
+    }
+}
+
+void bat_mo_install(const BatOptions *opts) {
+    memset(&bat_mo, 0, sizeof(bat_mo));
+    if (opts->n_mo <= 0) return;
+    for (int k = 0; k < opts->n_mo; k++) {
+        /* Already compiled once by bat_mo_check(). */
+        bat_expr_compile(&mo_progs[k], opts->mo_expr[k], dimension);
+    }
+    bat_mo_set_batch(expr_objectives, mo_progs, opts->n_mo);
+}
+
+int bat_mo_set_batch(BatMoFn fn, const void *ctx, int n_obj) {
+    if (n_obj < 2 || n_obj > BAT_MO_MAX) return -1;
+    bat_mo.fn = fn;
+    bat_mo.ctx = ctx;
+    bat_mo.n = n_obj;
+    return 0;
+}
+
+/*
+ * Objective vectors of `count` rows. The unused entries are set to 0, so
+ * vectors compare as wholes.
+ *
+ * Parameters:
+ *   - rows  : first coordinate of the first row
+ *   - ld    : stride between rows (doubles)
+ *   - count : number of rows
+ *   - out   : BAT_MO_MAX doubles per row
+ */
+void bat_mo_eval(const double *rows, int ld, int count, double out[]) {
+    for (int c = 0; c < count; c++) {
+        for (int k = bat_mo.n; k < BAT_MO_MAX; k++) out[(size_t)c * BAT_MO_MAX + k] = 0.0;
+    }
+    bat_mo.fn(bat_mo.ctx, rows, ld, count, out);
+}
+
+int bat_mo_dominates(const double a[], const double b[]) {
+    int better = 0;
+    for (int k = 0; k < bat_mo.n; k++) {
+        if (a[k] < b[k]) return 0;   /* we maximize */
+        if (a[k] > b[k]) better = 1;
+    }
+    return better;
+}
+
+double bat_mo_point(const bat_real x[], double f[]) {
+    double row[dimension];
+    for (int d = 0; d < dimension; d++) row[d] = (double)x[d];
+    bat_mo_eval(row, dimension, 1, f);
+    return f[0];
+}
+
+size_t bat_mo_bytes(int cap, int max_offers) {
+    size_t n = (size_t)cap + (size_t)max_offers;
+    return bat_arena_need(n * sizeof(BatMoPoint)) + bat_arena_need(n * sizeof(BatKeyIndex));
+}
+
+int bat_mo_create(BatMoArchive *a, BatArena *arena, int cap, int max_offers) {
+    memset(a, 0, sizeof(*a));
+    a->cap = cap;
+    a->max_offers = max_offers;
+    size_t n = (size_t)cap + (size_t)max_offers;
+    a->pt = bat_arena_alloc(arena, n * sizeof(BatMoPoint));
+    a->order = bat_arena_alloc(arena, n * sizeof(BatKeyIndex));
+    return (a->pt && a->order) ? 0 : -1;
+}
+
+/* Canonical order: objectives descending, then coordinates ascending. */
+static int canonical_cmp(const void *pa, const void *pb) {
+    const BatMoPoint *p = pa, *q = pb;
+    for (int k = 0; k < bat_mo.n; k++) {
+        if (p->f[k] != q->f[k]) return p->f[k] > q->f[k] ? -1 : 1;
+    }
+    for (int d = 0; d < dimension; d++) {
+        if (p->x[d] != q->x[d]) return p->x[d] < q->x[d] ? -1 : 1;
+    }
+    /* An offer equal to an archive point (a bat that did not move) is the one dropped. */
+    return p->fresh - q->fresh;
+}
+
+static int same_vector(const double a[], const double b[]) {
+    for (int k = 0; k < bat_mo.n; k++) {
+        if (a[k] != b[k]) return 0;
+    }
+    return 1;
+}
+
+/*
+ * Non-dominated points of pts[0..n), compacted to the front in canonical
+ * order; of several points with the same objective vector only the first
+ * is kept. Returns their number.
+ */
+static int nd_filter(BatMoPoint pts[], int n) {
+    if (n == 0) return 0;
+    qsort(pts, (size_t)n, sizeof(BatMoPoint), canonical_cmp);
+
+    int keep = 1;
+    if (bat_mo.n == 2) {
+        /* Sorted by f[0] descending: only a larger f[1] than every earlier point survives. */
+        double best1 = pts[0].f[1];
+        for (int i = 1; i < n; i++) {
+            if (pts[i].f[1] > best1) {
+                best1 = pts[i].f[1];
+                pts[keep++] = pts[i];
+            }
+        }
+        return keep;
+    }
+    /* A point can only be dominated by points before it. */
+    for (int i = 1; i < n; i++) {
+        int dominated = 0;
+        for (int j = 0; j < keep && !dominated; j++) {
+            dominated = bat_mo_dominates(pts[j].f, pts[i].f) || same_vector(pts[j].f, pts[i].f);
+        }
+        if (!dominated) pts[keep++] = pts[i];
+    }
+    return keep;
+}
+
+int bat_mo_collect(const Bat bats[], int n_bats, BatMoPoint out[]) {
+    for (int i = 0; i < n_bats; i++) {
+        for (int d = 0; d < dimension; d++) out[i].x[d] = bats[i].x_i[d];
+        for (int k = 0; k < BAT_MO_MAX; k++) out[i].f[k] = bats[i].f_mo[k];
+        out[i].crowd = 0.0;
+        out[i].fresh = 0;
+    }
+    return nd_filter(out, n_bats);
+}
+
+void bat_mo_worst(const Bat bats[], int n_bats, double worst[]) {
+    for (int k = 0; k < BAT_MO_MAX; k++) worst[k] = INFINITY;
+    for (int i = 0; i < n_bats; i++) {
+        for (int k = 0; k < bat_mo.n; k++) {
+            /* -INFINITY (undefined objective) would make every hypervolume infinite. */
+            if (isfinite(bats[i].f_mo[k]) && bats[i].f_mo[k] < worst[k]) worst[k] = bats[i].f_mo[k];
+        }
+    }
+}
+
+void bat_mo_set_ref(BatMoArchive *a, const double worst[]) {
+    for (int k = 0; k < BAT_MO_MAX; k++) a->ref[k] = worst[k];
+}
+
+/*
+ * Crowding distances (NSGA-II): per objective, the normalized gap between
+ * the two neighbours of a point; the extreme points get +inf.
+ */
+static void crowding(BatMoArchive *a) {
+    BatMoPoint *p = a->pt;
+    const int n = a->n;
+    for (int i = 0; i < n; i++) p[i].crowd = n <= 2 ? INFINITY : 0.0;
+    if (n <= 2) return;
+
+    if (bat_mo.n == 2) {
+        /* Canonical order of a front: f[0] descending and f[1] ascending. */
+        double r0 = p[0].f[0] - p[n - 1].f[0], r1 = p[n - 1].f[1] - p[0].f[1];
+        p[0].crowd = p[n - 1].crowd = INFINITY;
+        for (int i = 1; i + 1 < n; i++) {
+            if (r0 > 0.0 && isfinite(r0)) p[i].crowd += (p[i - 1].f[0] - p[i + 1].f[0]) / r0;
+            if (r1 > 0.0 && isfinite(r1)) p[i].crowd += (p[i + 1].f[1] - p[i - 1].f[1]) / r1;
+        }
+        return;
+    }
+    BatKeyIndex *o = a->order;
+    for (int k = 0; k < bat_mo.n; k++) {
+        for (int i = 0; i < n; i++) {
+            o[i].key = p[i].f[k];
+            o[i].index = i;
+        }
+        bat_sort_by_key(o, n);
+        double range = o[n - 1].key - o[0].key;
+        p[o[0].index].crowd = p[o[n - 1].index].crowd = INFINITY;
+        if (!(range > 0.0) || !isfinite(range)) continue;
+        for (int i = 1; i + 1 < n; i++) p[o[i].index].crowd += (o[i + 1].key - o[i - 1].key) / range;
+    }
+}
+
+/*
+ * Parameters:
+ *   - a     : archive, with the n_new offered points stored after its n points
+ *   - n_new : number of offered points
+ */
+int bat_mo_merge(BatMoArchive *a, int n_new) {
+    for (int i = 0; i < a->n; i++) a->pt[i].fresh = 0;
+    for (int i = a->n; i < a->n + n_new; i++) a->pt[i].fresh = 1;
+    a->merged += n_new;
+    a->n = nd_filter(a->pt, a->n + n_new);
+    crowding(a);
+
+    /* Capacity: drop the most crowded point (the last one on ties) until the archive fits. */
+    while (a->n > a->cap) {
+        int worst = 0;
+        for (int i = 1; i < a->n; i++) {
+            if (a->pt[i].crowd <= a->pt[worst].crowd) worst = i;
+        }
+        memmove(&a->pt[worst], &a->pt[worst + 1], (size_t)(a->n - worst - 1) * sizeof(BatMoPoint));
+        a->n--;
+        a->dropped++;
+        crowding(a);
+    }
+
+    int admitted = 0;
+    for (int i = 0; i < a->n; i++) admitted += a->pt[i].fresh;
+    return admitted;
+}
+
+void bat_mo_leader(const BatMoArchive *a, uint32_t *rng, Bat *leader) {
+    int i = (int)(bat_rng_uniform01(rng) * a->n);
+    int j = (int)(bat_rng_uniform01(rng) * a->n);
+    if (i >= a->n) i = a->n - 1;
+    if (j >= a->n) j = a->n - 1;
+    const BatMoPoint *p = a->pt[j].crowd > a->pt[i].crowd ? &a->pt[j] : &a->pt[i];
+    for (int d = 0; d < dimension; d++) leader->x_i[d] = p->x[d];
+}
+
+void bat_mo_best(const BatMoArchive *a, Bat *best) {
+    memset(best, 0, sizeof(*best));
+    for (int d = 0; d < dimension; d++) best->x_i[d] = a->pt[0].x[d];
+    best->f_value = a->pt[0].f[0];
+}
+
+double bat_mo_hypervolume(const BatMoArchive *a) {
+    if (bat_mo.n != 2) return -1.0;
+    /* f[0] descending, f[1] ascending: each point adds the slab above the previous one. */
+    double hv = 0.0, low1 = a->ref[1];
+    for (int i = 0; i < a->n; i++) {
+        const double *f = a->pt[i].f;
+        if (f[0] <= a->ref[0] || f[1] <= low1) continue;
+        hv += (f[0] - a->ref[0]) * (f[1] - low1);
+        low1 = f[1];
+    }
+    return hv;
+}
+
+int bat_mo_write_front(const BatMoArchive *a, const char *path) {
+    FILE *fp = fopen(path, "w");
+    if (!fp) {
+        perror("fopen front");
+        return -1;
+    }
+    for (int k = 0; k < bat_mo.n; k++) fprintf(fp, "%sf%d", k ? "," : "", k + 1);
+    for (int d = 0; d < dimension; d++) fprintf(fp, ",x%d", d + 1);
+    fprintf(fp, "\n");
+    for (int i = 0; i < a->n; i++) {
+        for (int k = 0; k < bat_mo.n; k++) fprintf(fp, "%s%.17g", k ? "," : "", a->pt[i].f[k]);
+        for (int d = 0; d < dimension; d++) fprintf(fp, ",%.17g", (double)a->pt[i].x[d]);
+        fprintf(fp, "\n");
+    }
+    return fclose(fp) == 0 ? 0 : -1;
+}
+
+void bat_mo_print_bench(const BatMoArchive *a) {
+    printf(" mo=%d mo_front=%d mo_cap=%d mo_merged=%ld mo_dropped=%ld", bat_mo.n, a->n, a->cap, a->merged,
+           a->dropped);
+    if (bat_mo.n == 2) printf(" mo_hv=%.17g", bat_mo_hypervolume(a));
+}
@@ -0,0 +1,103 @@
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "bat.h"
+#include "bat_io.h"
+#include "bat_mode.h"
+#include "bat_refine.h"
+#include "bat_restart.h"
+#include "bat_shrink.h"
+#include "bat_signal.h"
+
+/*
+ * bat_mode.c
+ *
+ * Purpose:
+ * Option check, setup, signals and BENCH line shared by the drivers of
+ * the population modes (see bat_mode.h).
+ */
+
+int bat_mode_check(const BatOptions *opts, const char *flag) {
+    /* Everything below works on a single best bat / a scalar value. */
+    if (opts->hd_dim > 0 || opts->con.n > 0) {
+        fprintf(stderr, "%s cannot be combined with --dim or --constraint\n", flag);
+        return -1;
+    }
+    if (opts->restart_kind != BAT_RESTART_NONE || opts->refine_method != BAT_REFINE_NONE
+        || opts->shrink_kind != BAT_SHRINK_NONE) {
+        fprintf(stderr, "%s cannot be combined with --restart, --refine or --shrink\n", flag);
+        return -1;
+    }
+    if (opts->has_target || opts->ttt.n > 0 || opts->deadline_ms > 0.0 || opts->trace_path || opts->final_pop_path) {
+        fprintf(stderr, "%s cannot be combined with --target(s), --deadline, --trace or --final-pop\n", flag);
+        return -1;
+    }
+    return 0;
+}
+
+int bat_mode_begin(BatModeRun *run, const BatArgs *args, size_t arena_bytes, BatBindSlot *where, int n_where,
+                   int rank, int n_ranks, int slices) {
+    run->where = where;
+    run->n_where = n_where;
+    run->rank = rank;
+    run->n_ranks = n_ranks;
+    run->slices = slices;
+    run->seed = (uint32_t)args->seed;
+    run->iters_done = args->max_iters;
+
+    if (bat_arena_create(&run->arena, arena_bytes, args->opts.pages) != 0) {
+        free(where);
+        return -1;
+    }
+    bat_signal_install();
+    return 0;
+}
+
+/* File of this rank for a dump / checkpoint of iteration t. */
+static void mode_path(const BatModeRun *run, const char *kind, int t, char *path, size_t size) {
+    if (run->slices > 1) snprintf(path, size, "%s_t%06d_r%d.bin", kind, t, run->rank);
+    else snprintf(path, size, "%s_t%06d.bin", kind, t);
+}
+
+int bat_mode_signals(BatModeRun *run, int sig, int t, const Bat bats[], int n_bats, const Bat *best) {
+    /* A replicated population is written by rank 0 only. */
+    int writes = run->slices > 1 || run->rank == 0;
+    int file_rank = run->slices > 1 ? run->rank : 0;
+    char path[64];
+    if (sig & BAT_SIG_DUMP) {
+        mode_path(run, "dump", t, path, sizeof(path));
+        if (writes) bat_write_population(path, bats, n_bats, best, t, run->seed, file_rank, run->slices);
+    }
+    if (sig & BAT_SIG_EXIT) {
+        mode_path(run, "checkpoint", t, path, sizeof(path));
+        if (writes) bat_write_population(path, bats, n_bats, best, t, run->seed, file_rank, run->slices);
+        if (run->rank == 0) {
+            fprintf(stderr, "SIGUSR2: checkpoint written to %s, stopping after iteration %d\n", path, t);
+        }
+        run->iters_done = t + 1;
+        return 1;
+    }
+    return 0;
+}
+
+void bat_mode_print_bench(const BatModeRun *run, const BatArgs *args, const char *version, int threads,
+                          double time_s, long evals, const BatCounters *cnt, double best_f) {
+    printf("BENCH version=%s n_bats=%d iters=%d procs=%d threads=%d time_s=%.6f evals=%ld", version,
+           args->n_bats, run->iters_done, run->n_ranks, threads, time_s, evals);
+    bat_counters_print_bench(cnt);
+    printf(" best_f=%.17g", best_f);
+    bat_options_print_bench(&args->opts);
+    bat_arena_print_bench(&run->arena);
+    bat_bind_print_bench(args->opts.bind, run->where, run->n_where);
+}
+
+void bat_mode_end_bench(const BatArgs *args) {
+    if (args->bench_extra) printf("%s", args->bench_extra);
+    printf("\n");
+}
+
+void bat_mode_end(BatModeRun *run) {
+    bat_arena_destroy(&run->arena);
+    free(run->where);
+    run->where = NULL;
+}
@@ -0,0 +1,258 @@
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "bat.h"
+#include "bat_mode.h"
+#include "bat_niche.h"
+
+/*
+ * bat_niche.c
+ *
+ * Purpose:
+ * Niching mode: speciation of the population around seeds found through
+ * a uniform hash grid, and the list of niche bests (see bat_niche.h).
+ */
+
+int bat_niche_check(const BatOptions *opts) {
+    if (!(opts->niche_radius > 0.0)) {
+        fprintf(stderr, "Invalid --niche-radius %g\n", opts->niche_radius);
+        return -1;
+    }
+    if (opts->niche_max < 1) {
+        fprintf(stderr, "Invalid --niche-max %d\n", opts->niche_max);
+        return -1;
+    }
+    if (bat_mode_check(opts, "--niche-radius") != 0) return -1;
+    if (opts->n_mo != 0) {
+        fprintf(stderr, "--niche-radius cannot be combined with --mo-objective\n");
+        return -1;
+    }
+    return 0;
+}
+
+/* Hash table size: a power of two with at least twice as many slots as bats. */
+static int table_size(int n_bats) {
+    int size = 16;
+    while (size < 2 * n_bats) size *= 2;
+    return size;
+}
+
+size_t bat_niche_bytes(int n_bats, int cap) {
+    size_t n = (size_t)n_bats, slots = (size_t)table_size(n_bats);
+    return bat_arena_need(n * sizeof(BatKeyIndex)) + 2 * bat_arena_need(n * sizeof(int)) + bat_arena_need(n * sizeof(Bat))
+         + bat_arena_need(slots * dimension * sizeof(int64_t)) + 2 * bat_arena_need(slots * sizeof(int))
+         + bat_arena_need((size_t)cap * sizeof(BatNicheBest));
+}
+
+/*
+ * Parameters:
+ *   - nc     : state to set up
+ *   - arena  : arena sized with bat_niche_bytes()
+ *   - n_bats : population size
+ *   - cap    : niche bests kept (--niche-max)
+ *   - radius : niche radius (--niche-radius)
+ */
+int bat_niche_create(BatNiche *nc, BatArena *arena, int n_bats, int cap, double radius) {
+    memset(nc, 0, sizeof(*nc));
+    size_t n = (size_t)n_bats, slots = (size_t)table_size(n_bats);
+    nc->radius = radius;
+    nc->n_bats = n_bats;
+    nc->cap = cap;
+    nc->table_mask = (int)slots - 1;
+    nc->order = bat_arena_alloc(arena, n * sizeof(BatKeyIndex));
+    nc->species = bat_arena_alloc(arena, n * sizeof(int));
+    nc->next = bat_arena_alloc(arena, n * sizeof(int));
+    nc->guide = bat_arena_alloc(arena, n * sizeof(Bat));
+    nc->cell = bat_arena_alloc(arena, slots * dimension * sizeof(int64_t));
+    nc->head = bat_arena_alloc(arena, slots * sizeof(int));
+    nc->stamp = bat_arena_alloc(arena, slots * sizeof(int));
+    nc->found = bat_arena_alloc(arena, (size_t)cap * sizeof(BatNicheBest));
+    if (!nc->order || !nc->species || !nc->next || !nc->guide || !nc->cell || !nc->head || !nc->stamp
+        || !nc->found) {
+        return -1;
+    }
+    for (size_t s = 0; s < slots; s++) nc->stamp[s] = -1;
+    return 0;
+}
+
+static double dist2(const bat_real a[], const bat_real b[]) {
+    double s = 0.0;
+    for (int d = 0; d < dimension; d++) {
+        double e = (double)a[d] - (double)b[d];
+        s += e * e;
+    }
+    return s;
+}
+
+/* Slot of a cell: the filled slot holding it, or the empty slot where it goes. */
+static int find_slot(const BatNiche *nc, const int64_t c[]) {
+    uint64_t h = 0;
+    for (int d = 0; d < dimension; d++) h = (h ^ (uint64_t)c[d]) * 0x9E3779B97F4A7C15ull;
+    int s = (int)(h >> 32) & nc->table_mask;
+    for (;;) {
+        if (nc->stamp[s] != nc->sweep) return s;
+        const int64_t *k = &nc->cell[(size_t)s * dimension];
+        int same = 1;
+        for (int d = 0; d < dimension && same; d++) same = k[d] == c[d];
+        if (same) return s;
+        s = (s + 1) & nc->table_mask;
+    }
+}
+
+/*
+ * Best species (lowest number) whose seed lies within the radius of x,
+ * or -1: the seeds of the 3^dimension cells around the cell of x.
+ */
+static int nearest_species(BatNiche *nc, const bat_real x[], const int64_t c[]) {
+    const double r2 = nc->radius * nc->radius;
+    int best = -1;
+    int off[dimension];
+    for (int d = 0; d < dimension; d++) off[d] = -1;
+    for (;;) {
+        int64_t q[dimension];
+        for (int d = 0; d < dimension; d++) q[d] = c[d] + off[d];
+        int s = find_slot(nc, q);
+        if (nc->stamp[s] == nc->sweep) {
+            /* Seeds of a cell are chained newest first: the first hit is not the best one. */
+            for (int k = nc->head[s]; k >= 0; k = nc->next[k]) {
+                nc->checks++;
+                if ((best < 0 || k < best) && dist2(x, nc->guide[k].x_i) <= r2) best = k;
+            }
+        }
+        /* Next offset in {-1, 0, 1}^dimension. */
+        int d = 0;
+        while (d < dimension && off[d] == 1) off[d++] = -1;
+        if (d == dimension) break;
+        off[d]++;
+    }
+    return best;
+}
+
+void bat_niche_speciate(BatNiche *nc, const Bat bats[]) {
+    const int n = nc->n_bats;
+    /* Decreasing f_value, then increasing index. */
+    for (int i = 0; i < n; i++) {
+        nc->order[i].key = -bats[i].f_value;
+        nc->order[i].index = i;
+    }
+    bat_sort_by_key(nc->order, n);
+
+    /* A new sweep number empties the table. */
+    nc->sweep++;
+    nc->n_species = 0;
+    for (int r = 0; r < n; r++) {
+        const int i = nc->order[r].index;
+        int64_t c[dimension];
+        for (int d = 0; d < dimension; d++) c[d] = (int64_t)floor(((double)bats[i].x_i[d] - (double)Lb) / nc->radius);
+        nc->queries++;
+        int k = nearest_species(nc, bats[i].x_i, c);
+        if (k < 0) {
+            /* New seed, inserted at once so the worse bats can join it. */
+            k = nc->n_species++;
+            nc->guide[k] = bats[i];
+            int s = find_slot(nc, c);
+            if (nc->stamp[s] != nc->sweep) {
+                nc->stamp[s] = nc->sweep;
+                for (int d = 0; d < dimension; d++) nc->cell[(size_t)s * dimension + d] = c[d];
+                nc->head[s] = -1;
+            }
+            nc->next[k] = nc->head[s];
+            nc->head[s] = k;
+        }
+        nc->species[i] = k;
+    }
+}
+
+/* Entry of the niche bests within the radius of x (the nearest), or -1. */
+static int find_niche(const BatNiche *nc, const bat_real x[], int skip) {
+    const double r2 = nc->radius * nc->radius;
+    int best = -1;
+    double best_d = 0.0;
+    for (int j = 0; j < nc->n_found; j++) {
+        if (j == skip) continue;
+        double d = dist2(x, nc->found[j].x);
+        if (d <= r2 && (best < 0 || d < best_d)) {
+            best = j;
+            best_d = d;
+        }
+    }
+    return best;
+}
+
+static void set_best(BatNicheBest *e, const Bat *seed, int iter, long evals, double time_s) {
+    for (int d = 0; d < dimension; d++) e->x[d] = seed->x_i[d];
+    e->f = seed->f_value;
+    e->iter = iter;
+    e->evals = evals;
+    e->time_s = time_s;
+}
+
+static void drop_niche(BatNiche *nc, int j) {
+    memmove(&nc->found[j], &nc->found[j + 1], (size_t)(nc->n_found - j - 1) * sizeof(BatNicheBest));
+    nc->n_found--;
+}
+
+/*
+ * Parameters:
+ *   - nc     : state after bat_niche_speciate()
+ *   - iter   : iterations done (0 = initial population)
+ *   - evals  : objective evaluations so far (all threads / ranks)
+ *   - time_s : seconds since the start of the iterations
+ */
+void bat_niche_record(BatNiche *nc, int iter, long evals, double time_s) {
+    for (int k = 0; k < nc->n_species; k++) {
+        const Bat *seed = &nc->guide[k];
+        int j = find_niche(nc, seed->x_i, -1);
+        if (j >= 0) {
+            if (!(seed->f_value > nc->found[j].f)) continue;
+            set_best(&nc->found[j], seed, iter, evals, time_s);
+            /* The moved entry may now share its niche with another one: keep the better. */
+            int o;
+            while ((o = find_niche(nc, nc->found[j].x, j)) >= 0) {
+                int keep = nc->found[o].f > nc->found[j].f ? o : j, drop = keep == o ? j : o;
+                if (nc->found[drop].iter_first < nc->found[keep].iter_first) {
+                    nc->found[keep].iter_first = nc->found[drop].iter_first;
+                }
+                drop_niche(nc, drop);
+                j = keep > drop ? keep - 1 : keep;
+            }
+            continue;
+        }
+        if (nc->n_found == nc->cap) {
+            /* Full: a better niche replaces the worst entry (the last one on ties). */
+            int worst = 0;
+            for (int w = 1; w < nc->n_found; w++) {
+                if (nc->found[w].f <= nc->found[worst].f) worst = w;
+            }
+            if (!(seed->f_value > nc->found[worst].f)) continue;
+            drop_niche(nc, worst);
+        }
+        BatNicheBest *e = &nc->found[nc->n_found++];
+        set_best(e, seed, iter, evals, time_s);
+        e->iter_first = iter;
+    }
+}
+
+static int niche_cmp(const void *pa, const void *pb) {
+    const BatNicheBest *p = pa, *q = pb;
+    if (p->f != q->f) return p->f > q->f ? -1 : 1;
+    return (p->iter_first > q->iter_first) - (p->iter_first < q->iter_first);
+}
+
+void bat_niche_report(BatNiche *nc) {
+    qsort(nc->found, (size_t)nc->n_found, sizeof(BatNicheBest), niche_cmp);
+    for (int j = 0; j < nc->n_found; j++) {
+        const BatNicheBest *e = &nc->found[j];
+        printf("NICHE rank=%d f=%.17g iter=%d evals=%ld time_s=%.6f first_iter=%d x=", j + 1, e->f, e->iter,
+               e->evals, e->time_s, e->iter_first);
+        for (int d = 0; d < dimension; d++) printf("%s%.17g", d ? "," : "", (double)e->x[d]);
+        printf("\n");
+    }
+}
+
+void bat_niche_print_bench(const BatNiche *nc) {
+    printf(" niche_r=%g species=%d niches=%d niche_queries=%ld niche_checks=%ld", nc->radius, nc->n_species,
+           nc->n_found, nc->queries, nc->checks);
+}
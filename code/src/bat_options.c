@@ -0,0 +1,484 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "bat_options.h"
+#include "bat_init.h"
+#include "bat_refine.h"
+#include "bat_restart.h"
+#include "bat_shrink.h"
+#include "bat_utils.h"
+#include "bat_isa.h"
+#include "bat_arena.h"
+#include "bat_bind.h"
+#include "bat_hd.h"
+#include "bat_transform.h"
+#include "bat_cc.h"
+#include "bat_mo.h"
+#include "bat_niche.h"
+#include "bat_expr.h"
+
+/*
+ * bat_options.c
+ *
+ * Purpose:
+ * Parse the command-line options that are common to the sequential,
+ * OpenMP and MPI front-ends.
+ */
+
+void bat_options_defaults(BatOptions *opts) {
+    memset(opts, 0, sizeof(*opts));
+    opts->deadline_ms = 0.0;
+    opts->init_kind = BAT_INIT_UNIFORM;
+    opts->init_obl = 0;
+    opts->refine_method = BAT_REFINE_NONE;
+    opts->refine_every = 100;
+    opts->refine_evals = 50;
+    opts->refine_step = 0.1;
+    opts->objective = BAT_OBJ_PARABOLOID;
+    opts->params = bat_params;
+    opts->has_target = 0;
+    opts->target = 0.0;
+    opts->restart_kind = BAT_RESTART_NONE;
+    opts->restart_div = 1e-3;
+    opts->restart_frac = 0.5;
+    opts->restart_grow = 2;
+    opts->restart_max_bats = 0;
+    opts->restart_gap = 50;
+    opts->restart_stall = 1e-3;
+    opts->shrink_kind = BAT_SHRINK_NONE;
+    opts->isa = BAT_ISA_AUTO;
+    opts->pages = BAT_PAGES_AUTO;
+    opts->bind = BAT_BIND_NONE;
+    opts->hd_dim = 0;
+    opts->hd_group = BAT_HD_GROUP;
+    opts->hd_slices = 1;
+    opts->transform = BAT_TRANSFORM_NONE;
+    opts->cc_kind = BAT_CC_NONE;
+    opts->cc_size = BAT_CC_SIZE;
+    opts->cc_iters = BAT_CC_ITERS;
+    opts->shrink_min = 4;
+    opts->con.mode = BAT_CON_DEB;
+    opts->con.eps = -1.0;
+    opts->con.penalty = 1.0;
+    opts->mo_archive = BAT_MO_ARCHIVE;
+    opts->niche_max = BAT_NICHE_MAX;
+}
+
+/* Maps "none" / "history" / "freq" / "both" to a BAT_ADAPT_* mask, or -1. */
+static int adapt_from_name(const char *name) {
+    if (strcmp(name, "none") == 0)    return BAT_ADAPT_NONE;
+    if (strcmp(name, "history") == 0) return BAT_ADAPT_HISTORY;
+    if (strcmp(name, "freq") == 0)    return BAT_ADAPT_FREQ;
+    if (strcmp(name, "both") == 0)    return BAT_ADAPT_HISTORY | BAT_ADAPT_FREQ;
+    return -1;
+}
+
+static const char *adapt_name(int adapt) {
+    switch (adapt) {
+        case BAT_ADAPT_HISTORY:                   return "history";
+        case BAT_ADAPT_FREQ:                      return "freq";
+        case BAT_ADAPT_HISTORY | BAT_ADAPT_FREQ:  return "both";
+        default:                                  return "none";
+    }
+}
+
+/*
+ * Parses one shared option.
+ *
+ * Parameters:
+ *   - opts : options being filled
+ *   - argc : number of command-line arguments
+ *   - argv : array of command-line arguments
+ *   - i    : index of the current argument (advanced past the option value)
+ */
+int bat_options_parse(BatOptions *opts, int argc, char **argv, int *i) {
+    const char *arg = argv[*i];
+    int has_value = (*i + 1 < argc);
+
+    if (strcmp(arg, "--deadline") == 0 && has_value) {
+        opts->deadline_ms = atof(argv[++(*i)]);
+        return 1;
+    }
+    if (strcmp(arg, "--init") == 0 && has_value) {
+        opts->init_kind = bat_init_kind_from_name(argv[++(*i)]);
+        return 1;
+    }
+    if (strcmp(arg, "--obl") == 0) {
+        opts->init_obl = 1;
+        return 1;
+    }
+    if (strcmp(arg, "--refine") == 0 && has_value) {
+        opts->refine_method = bat_refine_from_name(argv[++(*i)]);
+        return 1;
+    }
+    if (strcmp(arg, "--refine-every") == 0 && has_value) {
+        opts->refine_every = atoi(argv[++(*i)]);
+        return 1;
+    }
+    if (strcmp(arg, "--refine-evals") == 0 && has_value) {
+        opts->refine_evals = atoi(argv[++(*i)]);
+        return 1;
+    }
+    if (strcmp(arg, "--refine-step") == 0 && has_value) {
+        opts->refine_step = atof(argv[++(*i)]);
+        return 1;
+    }
+    if (strcmp(arg, "--objective") == 0 && has_value) {
+        opts->objective = bat_objective_from_name(argv[++(*i)]);
+        return 1;
+    }
+    if (strcmp(arg, "--objective-expr") == 0 && has_value) {
+        opts->objective_expr = argv[++(*i)];
+        opts->objective = BAT_OBJ_EXPR;
+        return 1;
+    }
+    if (strcmp(arg, "--target") == 0 && has_value) {
+        opts->has_target = 1;
+        opts->target = atof(argv[++(*i)]);
+        return 1;
+    }
+    if (strcmp(arg, "--targets") == 0 && has_value) {
+        bat_ttt_parse(&opts->ttt, argv[++(*i)]);
+        return 1;
+    }
+    if (strcmp(arg, "--adapt") == 0 && has_value) {
+        opts->params.adapt = adapt_from_name(argv[++(*i)]);
+        return 1;
+    }
+    if (strcmp(arg, "--restart") == 0 && has_value) {
+        opts->restart_kind = bat_restart_from_name(argv[++(*i)]);
+        return 1;
+    }
+    if (strcmp(arg, "--restart-div") == 0 && has_value) {
+        opts->restart_div = atof(argv[++(*i)]);
+        return 1;
+    }
+    if (strcmp(arg, "--restart-frac") == 0 && has_value) {
+        opts->restart_frac = atof(argv[++(*i)]);
+        return 1;
+    }
+    if (strcmp(arg, "--restart-grow") == 0 && has_value) {
+        opts->restart_grow = atoi(argv[++(*i)]);
+        return 1;
+    }
+    if (strcmp(arg, "--restart-max-bats") == 0 && has_value) {
+        opts->restart_max_bats = atoi(argv[++(*i)]);
+        return 1;
+    }
+    if (strcmp(arg, "--restart-gap") == 0 && has_value) {
+        opts->restart_gap = atoi(argv[++(*i)]);
+        return 1;
+    }
+    if (strcmp(arg, "--restart-stall") == 0 && has_value) {
+        opts->restart_stall = atof(argv[++(*i)]);
+        return 1;
+    }
+    if (strcmp(arg, "--shrink") == 0 && has_value) {
+        opts->shrink_kind = bat_shrink_from_name(argv[++(*i)]);
+        return 1;
+    }
+    if (strcmp(arg, "--shrink-min") == 0 && has_value) {
+        opts->shrink_min = atoi(argv[++(*i)]);
+        return 1;
+    }
+    if (strcmp(arg, "--indirect-objective") == 0) {
+        opts->indirect_objective = 1;
+        return 1;
+    }
+    if (strcmp(arg, "--isa") == 0 && has_value) {
+        opts->isa = bat_isa_from_name(argv[++(*i)]);
+        return 1;
+    }
+    if (strcmp(arg, "--hugepages") == 0 && has_value) {
+        opts->pages = bat_pages_from_name(argv[++(*i)]);
+        return 1;
+    }
+    if (strcmp(arg, "--bind") == 0 && has_value) {
+        opts->bind = bat_bind_from_name(argv[++(*i)]);
+        return 1;
+    }
+    if (strcmp(arg, "--dim") == 0 && has_value) {
+        opts->hd_dim = atoi(argv[++(*i)]);
+        return 1;
+    }
+    if (strcmp(arg, "--hd-group") == 0 && has_value) {
+        opts->hd_group = atoi(argv[++(*i)]);
+        return 1;
+    }
+    if (strcmp(arg, "--hd-slices") == 0 && has_value) {
+        opts->hd_slices = atoi(argv[++(*i)]);
+        return 1;
+    }
+    if (strcmp(arg, "--transform") == 0 && has_value) {
+        opts->transform = bat_transform_from_name(argv[++(*i)]);
+        return 1;
+    }
+    if (strcmp(arg, "--cc") == 0 && has_value) {
+        opts->cc_kind = bat_cc_from_name(argv[++(*i)]);
+        return 1;
+    }
+    if (strcmp(arg, "--cc-size") == 0 && has_value) {
+        opts->cc_size = atoi(argv[++(*i)]);
+        return 1;
+    }
+    if (strcmp(arg, "--cc-iters") == 0 && has_value) {
+        opts->cc_iters = atoi(argv[++(*i)]);
+        return 1;
+    }
+    if (strcmp(arg, "--constraint") == 0 && has_value) {
+        const char *expr = argv[++(*i)];
+        if (opts->con.n >= 0 && opts->con.n < BAT_CON_MAX) opts->con.expr[opts->con.n++] = expr;
+        else opts->con.n = -1;
+        return 1;
+    }
+    if (strcmp(arg, "--con-mode") == 0 && has_value) {
+        opts->con.mode = bat_con_from_name(argv[++(*i)]);
+        return 1;
+    }
+    if (strcmp(arg, "--con-eps") == 0 && has_value) {
+        opts->con.eps = atof(argv[++(*i)]);
+        return 1;
+    }
+    if (strcmp(arg, "--con-penalty") == 0 && has_value) {
+        opts->con.penalty = atof(argv[++(*i)]);
+        return 1;
+    }
+    if (strcmp(arg, "--mo-objective") == 0 && has_value) {
+        const char *expr = argv[++(*i)];
+        if (opts->n_mo >= 0 && opts->n_mo < BAT_MO_MAX) opts->mo_expr[opts->n_mo++] = expr;
+        else opts->n_mo = -1;
+        return 1;
+    }
+    if (strcmp(arg, "--mo-archive") == 0 && has_value) {
+        opts->mo_archive = atoi(argv[++(*i)]);
+        return 1;
+    }
+    if (strcmp(arg, "--mo-front") == 0 && has_value) {
+        opts->mo_front_path = argv[++(*i)];
+        return 1;
+    }
+    if (strcmp(arg, "--niche-radius") == 0 && has_value) {
+        opts->niche_radius = atof(argv[++(*i)]);
+        return 1;
+    }
+    if (strcmp(arg, "--niche-max") == 0 && has_value) {
+        opts->niche_max = atoi(argv[++(*i)]);
+        return 1;
+    }
+    if (strcmp(arg, "--trace") == 0 && has_value) {
+        opts->trace_path = argv[++(*i)];
+        return 1;
+    }
+    if (strcmp(arg, "--final-pop") == 0 && has_value) {
+        opts->final_pop_path = argv[++(*i)];
+        return 1;
+    }
+
+    /* Bat Algorithm parameters (defaults in bat.h). */
+    if (strcmp(arg, "--fmin") == 0 && has_value) {
+        opts->params.f_min = atof(argv[++(*i)]);
+        return 1;
+    }
+    if (strcmp(arg, "--fmax") == 0 && has_value) {
+        opts->params.f_max = atof(argv[++(*i)]);
+        return 1;
+    }
+    if (strcmp(arg, "--a0") == 0 && has_value) {
+        opts->params.a0 = atof(argv[++(*i)]);
+        return 1;
+    }
+    if (strcmp(arg, "--r0") == 0 && has_value) {
+        opts->params.r0 = atof(argv[++(*i)]);
+        return 1;
+    }
+    if (strcmp(arg, "--alpha") == 0 && has_value) {
+        opts->params.alpha = atof(argv[++(*i)]);
+        return 1;
+    }
+    if (strcmp(arg, "--gamma") == 0 && has_value) {
+        opts->params.gamma = atof(argv[++(*i)]);
+        return 1;
+    }
+    return 0;
+}
+
+int bat_options_check(const BatOptions *opts) {
+    if (opts->init_kind < 0) {
+        fprintf(stderr, "Invalid --init (expected uniform, sobol, halton or lhs)\n");
+        return -1;
+    }
+    if (opts->refine_method < 0) {
+        fprintf(stderr, "Invalid --refine (expected none, coord or nm)\n");
+        return -1;
+    }
+    if (opts->refine_every <= 0 || opts->refine_evals <= 0 || opts->refine_step <= 0.0) {
+        fprintf(stderr, "Invalid refinement settings: every=%d evals=%d step=%f\n",
+                opts->refine_every, opts->refine_evals, opts->refine_step);
+        return -1;
+    }
+    if (opts->objective < 0) {
+        fprintf(stderr, "Invalid --objective (expected paraboloid, sphere, rastrigin, ackley, griewank or rosenbrock)\n");
+        return -1;
+    }
+    if (opts->params.adapt < 0) {
+        fprintf(stderr, "Invalid --adapt (expected none, history, freq or both)\n");
+        return -1;
+    }
+    if (opts->params.f_min < 0.0 || opts->params.f_max < opts->params.f_min
+        || opts->params.a0 <= 0.0 || opts->params.r0 < 0.0 || opts->params.r0 > 1.0
+        || opts->params.alpha <= 0.0 || opts->params.alpha > 1.0 || opts->params.gamma < 0.0) {
+        fprintf(stderr, "Invalid parameters: fmin=%f fmax=%f a0=%f r0=%f alpha=%f gamma=%f\n",
+                opts->params.f_min, opts->params.f_max, opts->params.a0, opts->params.r0,
+                opts->params.alpha, opts->params.gamma);
+        return -1;
+    }
+    if (opts->restart_kind < 0) {
+        fprintf(stderr, "Invalid --restart (expected none, partial, full or ipop)\n");
+        return -1;
+    }
+    if (opts->restart_div <= 0.0 || opts->restart_frac <= 0.0 || opts->restart_frac > 1.0
+        || opts->restart_grow < 1 || opts->restart_max_bats < 0 || opts->restart_gap < 1
+        || opts->restart_stall < 0.0) {
+        fprintf(stderr, "Invalid restart settings: div=%g frac=%g grow=%d max-bats=%d gap=%d\n",
+                opts->restart_div, opts->restart_frac, opts->restart_grow,
+                opts->restart_max_bats, opts->restart_gap);
+        return -1;
+    }
+    if (opts->ttt.n < 0) {
+        fprintf(stderr, "Invalid --targets (expected up to %d positive precisions, e.g. 1e1,1e-1,1e-3,1e-5,1e-8)\n",
+                BAT_TTT_MAX);
+        return -1;
+    }
+    if (opts->shrink_kind < 0) {
+        fprintf(stderr, "Invalid --shrink (expected none, linear or nonlinear)\n");
+        return -1;
+    }
+    if (opts->shrink_min < 1) {
+        fprintf(stderr, "Invalid --shrink-min %d\n", opts->shrink_min);
+        return -1;
+    }
+    /* Restarts reset the population (and ipop grows it): the two schedules conflict. */
+    if (opts->shrink_kind != BAT_SHRINK_NONE && opts->restart_kind != BAT_RESTART_NONE) {
+        fprintf(stderr, "--shrink cannot be combined with --restart\n");
+        return -1;
+    }
+    if (opts->deadline_ms < 0.0) {
+        fprintf(stderr, "Invalid --deadline %f\n", opts->deadline_ms);
+        return -1;
+    }
+    if (opts->isa < BAT_ISA_AUTO) {
+        fprintf(stderr, "Invalid --isa (expected auto, generic, avx2 or avx512)\n");
+        return -1;
+    }
+    if (!bat_isa_supported(opts->isa)) {
+        fprintf(stderr, "--isa %s is not supported by this CPU or build\n", bat_isa_name(opts->isa));
+        return -1;
+    }
+    if (opts->pages < 0) {
+        fprintf(stderr, "Invalid --hugepages (expected auto, off, thp or hugetlb)\n");
+        return -1;
+    }
+    if (opts->bind < 0) {
+        fprintf(stderr, "Invalid --bind (expected none, compact, spread or numa)\n");
+        return -1;
+    }
+    if (opts->hd_dim < 0) {
+        fprintf(stderr, "Invalid --dim %d\n", opts->hd_dim);
+        return -1;
+    }
+    if (opts->transform < 0) {
+        fprintf(stderr, "Invalid --transform (expected none, shift or rotate)\n");
+        return -1;
+    }
+    if (opts->transform != BAT_TRANSFORM_NONE && opts->hd_dim == 0) {
+        fprintf(stderr, "--transform needs --dim\n");
+        return -1;
+    }
+    if (opts->cc_kind < 0) {
+        fprintf(stderr, "Invalid --cc (expected none, random or diff)\n");
+        return -1;
+    }
+    if (opts->objective == BAT_OBJ_EXPR) {
+        static BatExprProg prog;
+        if (bat_expr_compile(&prog, opts->objective_expr, opts->hd_dim > 0 ? opts->hd_dim : dimension) != 0) {
+            return -1;
+        }
+        /* Targets are precisions relative to the known optimum of a built-in function. */
+        if (opts->ttt.n > 0) {
+            fprintf(stderr, "--targets needs a built-in --objective (use --target with --objective-expr)\n");
+            return -1;
+        }
+    }
+    if (opts->hd_dim > 0 && bat_hd_check(opts) != 0) {
+        return -1;
+    }
+    if (opts->cc_kind != BAT_CC_NONE && bat_cc_check(opts) != 0) {
+        return -1;
+    }
+    if (bat_con_check(&opts->con) != 0) {
+        return -1;
+    }
+    if (opts->con.n > 0) {
+        /* The refinements and the --dim engines compare raw objective values. */
+        if (opts->hd_dim > 0) {
+            fprintf(stderr, "--constraint needs the 2-D engine (no --dim)\n");
+            return -1;
+        }
+        if (opts->refine_method != BAT_REFINE_NONE) {
+            fprintf(stderr, "--constraint cannot be combined with --refine\n");
+            return -1;
+        }
+    }
+    if (opts->n_mo != 0 && bat_mo_check(opts) != 0) {
+        return -1;
+    }
+    if (opts->niche_radius != 0.0 && bat_niche_check(opts) != 0) {
+        return -1;
+    }
+    return 0;
+}
+
+int bat_options_max_bats(const BatOptions *opts, int n_bats) {
+    if (opts->restart_kind != BAT_RESTART_IPOP) return n_bats;
+    int cap = opts->restart_max_bats > 0 ? opts->restart_max_bats : 16 * n_bats;
+    return cap > n_bats ? cap : n_bats;
+}
+
+void bat_options_apply(const BatOptions *opts) {
+    /* Already compiled once by bat_options_check(). */
+    if (opts->objective == BAT_OBJ_EXPR) bat_expr_install(opts->objective_expr, opts->hd_dim > 0 ? opts->hd_dim : dimension);
+    bat_set_objective(opts->objective);
+    bat_params = opts->params;
+    bat_con_install(&opts->con, opts->objective);
+    bat_mo_install(opts);
+    if (opts->n_mo > 0) bat_isa_specialize(BAT_ENGINE_MO);
+    else if (opts->con.n > 0) bat_isa_specialize(BAT_ENGINE_CONSTRAINED);
+    else bat_isa_specialize(opts->indirect_objective ? -1 : opts->objective);
+    bat_isa_select(opts->isa);
+}
+
+void bat_options_print_bench(const BatOptions *opts) {
+    const BatParams *p = &opts->params;
+
+    printf(" isa=%s", bat_isa_name(bat_isa_current()));
+    if (opts->indirect_objective) printf(" engine=indirect");
+#ifdef BAT_REAL_FLOAT
+    printf(" precision=%s", BAT_REAL_NAME);
+#endif
+    if (opts->objective != BAT_OBJ_PARABOLOID) {
+        printf(" objective=%s", bat_objective_name(opts->objective));
+        if (opts->objective == BAT_OBJ_EXPR) printf(" expr_ins=%d", bat_expr_current()->n_ins);
+    }
+    if (opts->init_kind != BAT_INIT_UNIFORM || opts->init_obl) {
+        printf(" init=%s obl=%d", bat_init_kind_name(opts->init_kind), opts->init_obl);
+    }
+    if (p->adapt != BAT_ADAPT_NONE) {
+        printf(" adapt=%s", adapt_name(p->adapt));
+    }
+    if (p->f_min != F_MIN || p->f_max != F_MAX || p->a0 != A0 || p->r0 != R0
+        || p->alpha != ALPHA || p->gamma != GAMMA) {
+        printf(" fmin=%g fmax=%g a0=%g r0=%g alpha=%g gamma=%g",
+               p->f_min, p->f_max, p->a0, p->r0, p->alpha, p->gamma);
+    }
+}
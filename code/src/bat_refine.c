@@ -0,0 +1,222 @@
+#include <string.h>
+
+#include "bat.h"
+#include "bat_refine.h"
+#include "bat_utils.h"
+
+/*
+ * bat_refine.c
+ *
+ * Purpose:
+ * Deterministic local optimizers used to polish the global best.
+ *
+ * Both methods only need objective values (no gradients) and keep every
+ * trial point inside the box [Lb, Ub]. As in the rest of the code, the
+ * objective is maximized.
+ *
+ * Methods:
+ * - coordinate search: try x +/- step along each axis, move on improvement,
+ *   halve the step when no axis improves.
+ * - Nelder-Mead: classic reflection / expansion / contraction / shrink
+ *   simplex method, started from a simplex of size `step` around x.
+ */
+
+/* Stop when the step (or simplex) becomes smaller than this. */
+#define REFINE_MIN_STEP 1e-12
+
+static void clamp_point(double x[]) {
+    for (int d = 0; d < dimension; d++) {
+        if (x[d] < Lb) x[d] = Lb;
+        if (x[d] > Ub) x[d] = Ub;
+    }
+}
+
+int bat_refine_from_name(const char *name) {
+    if (strcmp(name, "none") == 0)  return BAT_REFINE_NONE;
+    if (strcmp(name, "coord") == 0) return BAT_REFINE_COORD;
+    if (strcmp(name, "nm") == 0)    return BAT_REFINE_NM;
+    return -1;
+}
+
+const char *bat_refine_name(int method) {
+    switch (method) {
+        case BAT_REFINE_COORD: return "coord";
+        case BAT_REFINE_NM:    return "nm";
+        default:               return "none";
+    }
+}
+
+/* Coordinate (compass) search. */
+static int refine_coord(double x[], double *f_x, int max_evals, double step) {
+    int evals = 0;
+    double trial[dimension];
+
+    while (evals < max_evals && step > REFINE_MIN_STEP) {
+        int improved = 0;
+        for (int d = 0; d < dimension && evals < max_evals; d++) {
+            for (int sgn = -1; sgn <= 1 && evals < max_evals; sgn += 2) {
+                memcpy(trial, x, sizeof(trial));
+                trial[d] += sgn * step;
+                clamp_point(trial);
+
+                double f = objective_function(trial);
+                evals++;
+                if (f > *f_x) {
+                    memcpy(x, trial, sizeof(trial));
+                    *f_x = f;
+                    improved = 1;
+                    break;
+                }
+            }
+        }
+        if (!improved) step *= 0.5;
+    }
+    return evals;
+}
+
+/* Nelder-Mead simplex search (standard coefficients 1, 2, 0.5, 0.5). */
+static int refine_nm(double x[], double *f_x, int max_evals, double step) {
+    double simplex[dimension + 1][dimension];
+    double fs[dimension + 1];
+    double centroid[dimension], xr[dimension], xe[dimension], xc[dimension];
+    int evals = 0;
+
+    /* Initial simplex: x and x + step * e_d. */
+    memcpy(simplex[0], x, sizeof(simplex[0]));
+    fs[0] = *f_x;
+    for (int k = 1; k <= dimension; k++) {
+        memcpy(simplex[k], x, sizeof(simplex[k]));
+        simplex[k][k - 1] += step;
+        clamp_point(simplex[k]);
+        fs[k] = objective_function(simplex[k]);
+        evals++;
+    }
+
+    while (evals < max_evals) {
+        /* Sort vertices from best (highest f) to worst (insertion sort). */
+        for (int a = 1; a <= dimension; a++) {
+            for (int b = a; b > 0 && fs[b] > fs[b - 1]; b--) {
+                double tf = fs[b]; fs[b] = fs[b - 1]; fs[b - 1] = tf;
+                for (int d = 0; d < dimension; d++) {
+                    double tx = simplex[b][d];
+                    simplex[b][d] = simplex[b - 1][d];
+                    simplex[b - 1][d] = tx;
+                }
+            }
+        }
+
+        /* Simplex size (max distance along an axis from the best vertex). */
+        double size = 0.0;
+        for (int k = 1; k <= dimension; k++) {
+            for (int d = 0; d < dimension; d++) {
+                double diff = simplex[k][d] - simplex[0][d];
+                if (diff < 0) diff = -diff;
+                if (diff > size) size = diff;
+            }
+        }
+        if (size < REFINE_MIN_STEP) break;
+
+        /* Centroid of all vertices except the worst. */
+        for (int d = 0; d < dimension; d++) {
+            centroid[d] = 0.0;
+            for (int k = 0; k < dimension; k++) centroid[d] += simplex[k][d];
+            centroid[d] /= (double)dimension;
+        }
+        double *worst = simplex[dimension];
+
+        /* Reflection. */
+        for (int d = 0; d < dimension; d++) xr[d] = centroid[d] + (centroid[d] - worst[d]);
+        clamp_point(xr);
+        double fr = objective_function(xr);
+        evals++;
+
+        if (fr > fs[0]) {
+            /* Expansion. */
+            if (evals >= max_evals) {
+                memcpy(worst, xr, sizeof(xr));
+                fs[dimension] = fr;
+                continue;
+            }
+            for (int d = 0; d < dimension; d++) xe[d] = centroid[d] + 2.0 * (centroid[d] - worst[d]);
+            clamp_point(xe);
+            double fe = objective_function(xe);
+            evals++;
+            if (fe > fr) {
+                memcpy(worst, xe, sizeof(xe));
+                fs[dimension] = fe;
+            } else {
+                memcpy(worst, xr, sizeof(xr));
+                fs[dimension] = fr;
+            }
+        } else if (fr > fs[dimension - 1]) {
+            /* Better than the second worst: accept the reflection. */
+            memcpy(worst, xr, sizeof(xr));
+            fs[dimension] = fr;
+        } else {
+            /* Contraction (towards the better of worst / reflected). */
+            if (evals >= max_evals) break;
+            const double *from = (fr > fs[dimension]) ? xr : worst;
+            double f_from = (fr > fs[dimension]) ? fr : fs[dimension];
+            for (int d = 0; d < dimension; d++) xc[d] = centroid[d] + 0.5 * (from[d] - centroid[d]);
+            clamp_point(xc);
+            double fc = objective_function(xc);
+            evals++;
+            if (fc > f_from) {
+                memcpy(worst, xc, sizeof(xc));
+                fs[dimension] = fc;
+            } else {
+                /* Shrink every vertex towards the best one. */
+                for (int k = 1; k <= dimension && evals < max_evals; k++) {
+                    for (int d = 0; d < dimension; d++) {
+                        simplex[k][d] = simplex[0][d] + 0.5 * (simplex[k][d] - simplex[0][d]);
+                    }
+                    fs[k] = objective_function(simplex[k]);
+                    evals++;
+                }
+            }
+        }
+    }
+
+    /* Return the best vertex. */
+    int best = 0;
+    for (int k = 1; k <= dimension; k++) {
+        if (fs[k] > fs[best]) best = k;
+    }
+    if (fs[best] > *f_x) {
+        memcpy(x, simplex[best], sizeof(simplex[best]));
+        *f_x = fs[best];
+    }
+    return evals;
+}
+
+/*
+ * Polishes x with the selected local optimizer.
+ *
+ * Parameters:
+ *   - method    : BAT_REFINE_* method
+ *   - x         : starting point (a bat position), replaced by the refined point
+ *   - f_x       : in: stored objective value at x; out: value at the returned x
+ *   - max_evals : evaluation budget
+ *   - step      : initial step / simplex size
+ */
+int bat_refine(int method, double x[], double *f_x, int max_evals, double step) {
+    if (method == BAT_REFINE_NONE || max_evals <= 0) return 0;
+
+    /* A bat only moves together with its f_value, so the start point is not evaluated again. */
+    if (method == BAT_REFINE_COORD) return refine_coord(x, f_x, max_evals, step);
+    return refine_nm(x, f_x, max_evals, step);
+}
+
+int bat_inject(Bat bats[], int n_bats, const double x[], double f_x) {
+    int worst = 0;
+    for (int i = 1; i < n_bats; i++) {
+        if (bats[i].f_value < bats[worst].f_value) worst = i;
+    }
+    /* With PRECISION=float the stored point is rounded; f_x is kept as is. */
+    for (int d = 0; d < dimension; d++) {
+        bats[worst].x_i[d] = (bat_real)x[d];
+        bats[worst].v_i[d] = V0;
+    }
+    bats[worst].f_value = f_x;
+    return worst;
+}
@@ -0,0 +1,195 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include "bat.h"
+#include "bat_restart.h"
+#include "bat_init.h"
+#include "bat_utils.h"
+
+/*
+ * bat_restart.c
+ *
+ * Purpose:
+ * Track the diversity of the population incrementally and re-initialize
+ * it (partially, fully, or with a larger population) once it collapses.
+ */
+
+/* Golden-ratio increment used to derive one init seed per restart. */
+#define RESTART_SEED_STEP 0x9E3779B9u
+
+int bat_restart_from_name(const char *name) {
+    if (strcmp(name, "none") == 0)    return BAT_RESTART_NONE;
+    if (strcmp(name, "partial") == 0) return BAT_RESTART_PARTIAL;
+    if (strcmp(name, "full") == 0)    return BAT_RESTART_FULL;
+    if (strcmp(name, "ipop") == 0)    return BAT_RESTART_IPOP;
+    return -1;
+}
+
+const char *bat_restart_name(int kind) {
+    switch (kind) {
+        case BAT_RESTART_PARTIAL: return "partial";
+        case BAT_RESTART_FULL:    return "full";
+        case BAT_RESTART_IPOP:    return "ipop";
+        default:                  return "none";
+    }
+}
+
+void bat_diversity_reset(BatDiversity *div, const Bat bats[], int n_bats, const bat_real ref[]) {
+    bat_real r[dimension];
+    memcpy(r, ref, sizeof(r));
+    memset(div, 0, sizeof(*div));
+    memcpy(div->ref, r, sizeof(r));
+
+    for (int i = 0; i < n_bats; i++) {
+        for (int d = 0; d < dimension; d++) {
+            double y = (double)bats[i].x_i[d] - r[d];
+            div->sum[d] += y;
+            div->sum_sq[d] += y * y;
+        }
+    }
+    div->n = (double)n_bats;
+}
+
+void bat_diversity_delta(const BatDiversity *div, BatDiversity *delta) {
+    memset(delta, 0, sizeof(*delta));
+    memcpy(delta->ref, div->ref, sizeof(delta->ref));
+}
+
+void bat_diversity_move(BatDiversity *div, const bat_real old_x[], const bat_real new_x[]) {
+    for (int d = 0; d < dimension; d++) {
+        double y_old = (double)old_x[d] - div->ref[d];
+        double y_new = (double)new_x[d] - div->ref[d];
+        div->sum[d] += y_new - y_old;
+        div->sum_sq[d] += y_new * y_new - y_old * y_old;
+    }
+}
+
+void bat_diversity_merge(BatDiversity *dst, const BatDiversity *src) {
+    for (int d = 0; d < dimension; d++) {
+        dst->sum[d] += src->sum[d];
+        dst->sum_sq[d] += src->sum_sq[d];
+    }
+    dst->n += src->n;
+}
+
+double bat_diversity_value(const BatDiversity *div) {
+    if (div->n <= 0.0) return 0.0;
+
+    double var = 0.0;
+    for (int d = 0; d < dimension; d++) {
+        double mean = div->sum[d] / div->n;
+        double v = div->sum_sq[d] / div->n - mean * mean;
+        if (v > 0.0) var += v;   /* rounding can make a collapsed dimension slightly negative */
+    }
+    return sqrt(var) / ((double)Ub - (double)Lb);
+}
+
+int update_bat_tracked(Bat *bat, const Bat *best_bat, double A_mean, int t, BatCounters *cnt,
+                       BatDiversity *delta) {
+    if (!delta) {
+        return update_bat(bat, best_bat, A_mean, t, cnt);
+    }
+
+    bat_real old_x[dimension];
+    memcpy(old_x, bat->x_i, sizeof(old_x));
+    int used = update_bat(bat, best_bat, A_mean, t, cnt);
+    bat_diversity_move(delta, old_x, bat->x_i);
+    return used;
+}
+
+void bat_restart_init(BatRestart *rs, int kind, double threshold, double frac, int grow, int max_bats,
+                      int gap, double stall, const Bat *best) {
+    memset(rs, 0, sizeof(*rs));
+    rs->kind = kind;
+    rs->threshold = threshold;
+    rs->frac = frac;
+    rs->grow = grow;
+    rs->max_bats = max_bats;
+    rs->gap = gap;
+    rs->stall = stall;
+    rs->count = 0;
+    rs->t_last = 0;
+    rs->d_window = -1.0;
+    rs->t_window = 0;
+    rs->archive = *best;
+}
+
+void bat_restart_archive(BatRestart *rs, const Bat *best) {
+    if (best->f_value > rs->archive.f_value) {
+        rs->archive = *best;
+    }
+}
+
+int bat_restart_due(BatRestart *rs, double diversity, int t) {
+    if (rs->kind == BAT_RESTART_NONE) return 0;
+
+    /* Stall window: compare with the diversity `gap` iterations ago. */
+    int stalled = 0;
+    if (t - rs->t_window >= rs->gap) {
+        stalled = rs->d_window >= 0.0 && fabs(diversity - rs->d_window) <= rs->stall * rs->d_window;
+        rs->d_window = diversity;
+        rs->t_window = t;
+    }
+
+    if (t - rs->t_last < rs->gap) return 0;
+    return diversity < rs->threshold || stalled;
+}
+
+int bat_restart_next_size(const BatRestart *rs, int n_bats, int multiple) {
+    if (rs->kind != BAT_RESTART_IPOP) return n_bats;
+
+    long next = (long)n_bats * rs->grow;
+    if (next > rs->max_bats) next = rs->max_bats;
+    next -= next % multiple;
+    return next > n_bats ? (int)next : n_bats;
+}
+
+long bat_restart_apply(BatRestart *rs, Bat bats[], int local_n, int offset, int global_n,
+                       int init_kind, int obl, uint32_t seed, int t) {
+    BatInitPlan plan;
+    uint32_t restart_seed = seed + (uint32_t)(rs->count + 1) * RESTART_SEED_STEP;
+    if (bat_init_plan_create(&plan, init_kind, obl, global_n, restart_seed) != 0) {
+        return -1;
+    }
+
+    /* Full restart by default; partial restarts only re-sample the worst bats. */
+    int n_reinit = local_n;
+    BatKeyIndex *order = NULL;
+    if (rs->kind == BAT_RESTART_PARTIAL) {
+        n_reinit = (int)(rs->frac * (double)local_n);
+        order = malloc((size_t)local_n * sizeof(BatKeyIndex));
+        if (!order) {
+            perror("malloc restart order");
+            bat_init_plan_free(&plan);
+            return -1;
+        }
+        /* Worst first. */
+        for (int i = 0; i < local_n; i++) {
+            order[i].key = bats[i].f_value;
+            order[i].index = i;
+        }
+        bat_sort_by_key(order, local_n);
+    }
+
+    for (int k = 0; k < n_reinit; k++) {
+        int i = order ? order[k].index : k;
+        bat_init_one(&plan, &bats[i], offset + i);
+    }
+
+    free(order);
+    bat_init_plan_free(&plan);
+
+    rs->count++;
+    rs->t_last = t + 1;
+    rs->d_window = -1.0;
+    rs->t_window = t + 1;
+    return (long)n_reinit * (obl ? 2 : 1);
+}
+
+void bat_restart_print_bench(const BatRestart *rs, int n_bats_final, double diversity) {
+    if (rs->kind == BAT_RESTART_NONE) return;
+    printf(" restart=%s restarts=%d n_bats_final=%d diversity=%.3g",
+           bat_restart_name(rs->kind), rs->count, n_bats_final, diversity);
+}
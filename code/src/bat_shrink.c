@@ -0,0 +1,82 @@
+#include <string.h>
+#include <math.h>
+
+#include "bat.h"
+#include "bat_shrink.h"
+#include "bat_utils.h"
+
+/*
+ * bat_shrink.c
+ *
+ * Purpose:
+ * Population-size schedules and in-place removal of the worst bats.
+ */
+
+int bat_shrink_from_name(const char *name) {
+    if (strcmp(name, "none") == 0)      return BAT_SHRINK_NONE;
+    if (strcmp(name, "linear") == 0)    return BAT_SHRINK_LINEAR;
+    if (strcmp(name, "nonlinear") == 0) return BAT_SHRINK_NONLINEAR;
+    return -1;
+}
+
+const char *bat_shrink_name(int kind) {
+    switch (kind) {
+        case BAT_SHRINK_LINEAR:    return "linear";
+        case BAT_SHRINK_NONLINEAR: return "nonlinear";
+        default:                   return "none";
+    }
+}
+
+int bat_shrink_target(int kind, int n0, int n_min, int t, int t_max) {
+    if (kind == BAT_SHRINK_NONE || n0 <= n_min || t_max <= 0) return n0;
+
+    double s = (double)t / (double)t_max;
+    if (s > 1.0) s = 1.0;
+    if (kind == BAT_SHRINK_NONLINEAR) {
+        s = pow(s, 1.0 - s);
+    }
+
+    int n = (int)lround((double)n0 + (double)(n_min - n0) * s);
+    if (n < n_min) n = n_min;
+    if (n > n0) n = n0;
+    return n;
+}
+
+int bat_shrink_compact(Bat bats[], int n_bats, const unsigned char drop[]) {
+    int kept = 0;
+    for (int i = 0; i < n_bats; i++) {
+        if (drop[i]) continue;
+        if (kept != i) bats[kept] = bats[i];
+        kept++;
+    }
+    return kept;
+}
+
+size_t bat_shrink_scratch_bytes(int n_bats) {
+    return bat_arena_need((size_t)n_bats * sizeof(BatKeyIndex)) + bat_arena_need((size_t)n_bats);
+}
+
+int bat_shrink_local(Bat bats[], int n_bats, int target, BatArena *scratch) {
+    if (target >= n_bats) return n_bats;
+
+    size_t mark = bat_arena_mark(scratch);
+    BatKeyIndex *order = bat_arena_alloc(scratch, (size_t)n_bats * sizeof(BatKeyIndex));
+    unsigned char *drop = bat_arena_alloc(scratch, (size_t)n_bats);
+    if (!order || !drop) {
+        bat_arena_release(scratch, mark);
+        return n_bats;
+    }
+    memset(drop, 0, (size_t)n_bats);
+
+    /* Worst first. */
+    for (int i = 0; i < n_bats; i++) {
+        order[i].key = bats[i].f_value;
+        order[i].index = i;
+    }
+    bat_sort_by_key(order, n_bats);
+    for (int k = 0; k < n_bats - target; k++) drop[order[k].index] = 1;
+
+    int kept = bat_shrink_compact(bats, n_bats, drop);
+    bat_arena_release(scratch, mark);
+    return kept;
+}
@@ -0,0 +1,56 @@
+#include <signal.h>
+#include <string.h>
+
+#include "bat_signal.h"
+
+/*
+ * bat_signal.c
+ *
+ * Purpose:
+ * Let an operator inspect or stop a long run without killing it.
+ *
+ * Only async-signal-safe work is done inside the handlers: they set a
+ * flag and return. Copying the population and writing files is done by
+ * the front-end at the next iteration boundary, where the state is
+ * consistent (no bat is half-updated).
+ */
+
+static volatile sig_atomic_t dump_requested = 0;
+static volatile sig_atomic_t exit_requested = 0;
+
+static void on_sigusr1(int sig) {
+    (void)sig;
+    dump_requested = 1;
+}
+
+static void on_sigusr2(int sig) {
+    (void)sig;
+    exit_requested = 1;
+}
+
+void bat_signal_install(void) {
+    struct sigaction sa;
+    memset(&sa, 0, sizeof(sa));
+    sigemptyset(&sa.sa_mask);
+    /* Restart interrupted system calls (e.g. the background writer's I/O). */
+    sa.sa_flags = SA_RESTART;
+
+    sa.sa_handler = on_sigusr1;
+    sigaction(SIGUSR1, &sa, NULL);
+
+    sa.sa_handler = on_sigusr2;
+    sigaction(SIGUSR2, &sa, NULL);
+}
+
+int bat_signal_take(void) {
+    int flags = 0;
+    if (dump_requested) {
+        dump_requested = 0;
+        flags |= BAT_SIG_DUMP;
+    }
+    if (exit_requested) {
+        exit_requested = 0;
+        flags |= BAT_SIG_EXIT;
+    }
+    return flags;
+}
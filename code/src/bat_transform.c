@@ -0,0 +1,192 @@
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+
+#include "bat.h"
+#include "bat_isa.h"
+#include "bat_rng.h"
+#include "bat_deadline.h"
+#include "bat_expr.h"
+#include "bat_utils.h"
+#include "bat_transform.h"
+
+/*
+ * bat_transform.c
+ *
+ * Purpose:
+ * Shift vector and rotation of the transformed objectives, and the batch
+ * evaluation Y = Z M^T (see bat_transform.h).
+ */
+
+/* Seed of the problem instance (o and M), fixed so that --seed only changes the run. */
+#define TF_SEED 0x7F4A7C15u
+
+static const char *transform_names[] = { "none", "shift", "rotate" };
+
+int bat_transform_from_name(const char *name) {
+    for (int k = BAT_TRANSFORM_NONE; k <= BAT_TRANSFORM_ROTATE; k++) {
+        if (strcmp(name, transform_names[k]) == 0) return k;
+    }
+    return -1;
+}
+
+const char *bat_transform_name(int kind) {
+    return (kind >= BAT_TRANSFORM_NONE && kind <= BAT_TRANSFORM_ROTATE) ? transform_names[kind] : "unknown";
+}
+
+/* Row stride: dim rounded up to a whole number of cache lines. */
+static int row_stride(int dim) {
+    int per_line = BAT_ARENA_ALIGN / (int)sizeof(double);
+    return (dim + per_line - 1) / per_line * per_line;
+}
+
+size_t bat_transform_bytes(int kind, int dim, int max_rows) {
+    if (max_rows < 2) max_rows = 2;
+    size_t row = (size_t)row_stride(dim) * sizeof(double);
+    size_t bytes = bat_arena_need(row) + bat_arena_need((size_t)max_rows * row)
+                 + bat_arena_need((size_t)max_rows * sizeof(double));
+    if (kind == BAT_TRANSFORM_ROTATE) {
+        size_t panels = (size_t)(dim + BAT_TF_NC - 1) / BAT_TF_NC;
+        bytes += bat_arena_need(panels * (size_t)dim * BAT_TF_NC * sizeof(double))
+               + bat_arena_need((size_t)max_rows * row);
+    }
+    return bytes;
+}
+
+/*
+ * M^T = (H_1 ... H_k)^T, built from the identity: every reflection
+ * H = I - 2 u u^T (u a random unit vector) is applied as B <- B H with
+ * B = M^T transposed, which costs 4 D^2 flops. `u` and `w` are D doubles
+ * of scratch.
+ *
+ * The product reads M^T by column panels: with rows of D doubles the rows
+ * of a block are a power-of-two stride apart for common D and map to the
+ * same L1 sets. M^T is therefore stored packed, panel after panel, each
+ * panel as D rows of BAT_TF_NC contiguous doubles (zero-padded), and built
+ * in that layout: B[j][p] is M^T[p][j].
+ */
+static void draw_rotation(BatTransform *tf, uint32_t *rng, double *u, double *w) {
+    const int n = tf->dim;
+
+    for (int panel = 0; panel < bat_transform_panels(tf); panel++) {
+        double *P = tf->rot_p + (size_t)panel * (size_t)n * BAT_TF_NC;
+        memset(P, 0, (size_t)n * BAT_TF_NC * sizeof(double));
+        for (int q = 0; q < BAT_TF_NC && panel * BAT_TF_NC + q < n; q++) {
+            P[(size_t)(panel * BAT_TF_NC + q) * BAT_TF_NC + q] = 1.0;
+        }
+    }
+    for (int h = 0; h < BAT_TF_REFLECTIONS; h++) {
+        double norm = 0.0;
+        for (int d = 0; d < n; d++) {
+            u[d] = bat_rng_normal(rng, 0.0, 1.0);
+            norm += u[d] * u[d];
+        }
+        norm = sqrt(norm);
+        for (int d = 0; d < n; d++) u[d] /= norm;
+
+        for (int panel = 0; panel < bat_transform_panels(tf); panel++) {
+            double *P = tf->rot_p + (size_t)panel * (size_t)n * BAT_TF_NC;
+            double *wp = w + panel * BAT_TF_NC;
+            int j0 = panel * BAT_TF_NC, nc = n - j0 < BAT_TF_NC ? n - j0 : BAT_TF_NC;
+            for (int q = 0; q < nc; q++) wp[q] = 0.0;
+            for (int p = 0; p < n; p++) {
+                for (int q = 0; q < nc; q++) wp[q] += P[(size_t)p * BAT_TF_NC + q] * u[p];
+            }
+            for (int q = 0; q < nc; q++) wp[q] *= 2.0;
+            for (int p = 0; p < n; p++) {
+                for (int q = 0; q < nc; q++) P[(size_t)p * BAT_TF_NC + q] -= wp[q] * u[p];
+            }
+        }
+    }
+}
+
+/* Block of M^T used by panel `panel` of Y: dim rows of BAT_TF_NC columns. */
+static const double *packed_panel(const BatTransform *tf, int panel) {
+    return tf->rot_p + (size_t)panel * (size_t)tf->dim * BAT_TF_NC;
+}
+
+int bat_transform_create(BatTransform *tf, BatArena *arena, int kind, int dim, int max_rows) {
+    memset(tf, 0, sizeof(*tf));
+    if (max_rows < 2) max_rows = 2;
+    tf->kind = kind;
+    tf->dim = dim;
+    tf->ld = row_stride(dim);
+    tf->max_rows = max_rows;
+
+    size_t row = (size_t)tf->ld * sizeof(double);
+    tf->shift = bat_arena_alloc(arena, row);
+    tf->z = bat_arena_alloc(arena, (size_t)max_rows * row);
+    tf->f = bat_arena_alloc(arena, (size_t)max_rows * sizeof(double));
+    if (!tf->shift || !tf->z || !tf->f) return -1;
+    if (kind == BAT_TRANSFORM_ROTATE) {
+        tf->rot_p = bat_arena_alloc(arena, (size_t)bat_transform_panels(tf) * (size_t)dim * BAT_TF_NC * sizeof(double));
+        tf->y = bat_arena_alloc(arena, (size_t)max_rows * row);
+        if (!tf->rot_p || !tf->y) return -1;
+    }
+
+    uint32_t rng = bat_rng_init(TF_SEED, (uint32_t)dim);
+    for (int d = 0; d < dim; d++) {
+        tf->shift[d] = kind == BAT_TRANSFORM_NONE ? 0.0 : bat_rng_uniform(&rng, 0.8 * Lb, 0.8 * Ub);
+    }
+    /* The first rows of Z and Y are free until the first evaluation. */
+    if (kind == BAT_TRANSFORM_ROTATE) draw_rotation(tf, &rng, bat_transform_row(tf, 0), tf->y);
+    return 0;
+}
+
+double *bat_transform_row(const BatTransform *tf, int r) {
+    return tf->z + (size_t)r * (size_t)tf->ld;
+}
+
+int bat_transform_panels(const BatTransform *tf) {
+    return tf->kind == BAT_TRANSFORM_ROTATE ? (tf->dim + BAT_TF_NC - 1) / BAT_TF_NC : 0;
+}
+
+/*
+ * Columns [j0, j0 + BAT_TF_NC) of Y = Z M^T for rows [0, rows): the block
+ * of M^T (BAT_TF_KC rows of the packed panel) is reused by every row of Z
+ * before moving to the next one.
+ */
+void bat_transform_panel(BatTransform *tf, int rows, int panel) {
+    const int n = tf->dim, ld = tf->ld;
+    const int j0 = panel * BAT_TF_NC;
+    const int nc = n - j0 < BAT_TF_NC ? n - j0 : BAT_TF_NC;
+
+    for (int r = 0; r < rows; r++) memset(tf->y + (size_t)r * ld + j0, 0, (size_t)nc * sizeof(double));
+    for (int p0 = 0; p0 < n; p0 += BAT_TF_KC) {
+        int kc = n - p0 < BAT_TF_KC ? n - p0 : BAT_TF_KC;
+        for (int i0 = 0; i0 < rows; i0 += BAT_TF_MC) {
+            int mc = rows - i0 < BAT_TF_MC ? rows - i0 : BAT_TF_MC;
+            bat_kernels.gemm(mc, nc, kc, tf->z + (size_t)i0 * ld + p0, ld,
+                             packed_panel(tf, panel) + (size_t)p0 * BAT_TF_NC, BAT_TF_NC, tf->y + (size_t)i0 * ld + j0, ld);
+        }
+    }
+}
+
+void bat_transform_values(BatTransform *tf, int id, int r0, int r1) {
+    const double *rows = (tf->kind == BAT_TRANSFORM_ROTATE ? tf->y : tf->z) + (size_t)r0 * tf->ld;
+    if (id == BAT_OBJ_EXPR) {
+        bat_kernels.expr(bat_expr_current(), rows, tf->ld, r1 - r0, tf->f + r0);
+        return;
+    }
+    for (int r = r0; r < r1; r++, rows += tf->ld) tf->f[r] = bat_kernels.objective(id, rows, tf->dim);
+}
+
+void bat_transform_eval(BatTransform *tf, int id, int rows) {
+    double start = bat_deadline_now();
+    for (int p = 0; p < bat_transform_panels(tf); p++) bat_transform_panel(tf, rows, p);
+    bat_transform_account(tf, rows, bat_deadline_now() - start);
+    bat_transform_values(tf, id, 0, rows);
+}
+
+void bat_transform_account(BatTransform *tf, int rows, double seconds) {
+    if (tf->kind != BAT_TRANSFORM_ROTATE) return;
+    tf->gemm_flops += 2.0 * (double)rows * (double)tf->dim * (double)tf->dim;
+    tf->gemm_s += seconds;
+}
+
+void bat_transform_print_bench(const BatTransform *tf, double flops, double seconds) {
+    printf(" transform=%s", bat_transform_name(tf->kind));
+    if (tf->kind == BAT_TRANSFORM_ROTATE) {
+        printf(" gemm_gflops=%.2f gemm_s=%.4f", seconds > 0.0 ? flops * 1e-9 / seconds : 0.0, seconds);
+    }
+}
@@ -0,0 +1,67 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "bat_ttt.h"
+
+/*
+ * bat_ttt.c
+ *
+ * Purpose:
+ * Record the evaluations and seconds needed to reach a list of f-targets.
+ */
+
+int bat_ttt_parse(BatTimeToTarget *ttt, const char *list) {
+    memset(ttt, 0, sizeof(*ttt));
+
+    const char *p = list;
+    while (*p) {
+        char *end;
+        double v = strtod(p, &end);
+        if (end == p || v <= 0.0 || ttt->n == BAT_TTT_MAX) {
+            ttt->n = -1;
+            return -1;
+        }
+        ttt->prec[ttt->n++] = v;
+        p = end;
+        if (*p == ',') p++;
+        else if (*p) {
+            ttt->n = -1;
+            return -1;
+        }
+    }
+    return ttt->n > 0 ? 0 : -1;
+}
+
+void bat_ttt_start(BatTimeToTarget *ttt, double f_opt) {
+    for (int k = 0; k < ttt->n; k++) {
+        ttt->f_target[k] = f_opt - ttt->prec[k];
+        ttt->evals[k] = -1;
+        ttt->secs[k] = -1.0;
+    }
+    ttt->n_hit = 0;
+}
+
+int bat_ttt_update(BatTimeToTarget *ttt, double best_f, long evals, double secs) {
+    if (ttt->n <= 0) return 0;
+
+    for (int k = 0; k < ttt->n; k++) {
+        if (ttt->evals[k] < 0 && best_f >= ttt->f_target[k]) {
+            ttt->evals[k] = evals;
+            ttt->secs[k] = secs;
+            ttt->n_hit++;
+        }
+    }
+    return ttt->n_hit == ttt->n;
+}
+
+void bat_ttt_print_bench(const BatTimeToTarget *ttt) {
+    if (ttt->n <= 0) return;
+
+    printf(" ttt_prec=");
+    for (int k = 0; k < ttt->n; k++) printf("%s%g", k ? "," : "", ttt->prec[k]);
+    printf(" ttt_evals=");
+    for (int k = 0; k < ttt->n; k++) printf("%s%ld", k ? "," : "", ttt->evals[k]);
+    printf(" ttt_s=");
+    for (int k = 0; k < ttt->n; k++) printf("%s%.6f", k ? "," : "", ttt->secs[k]);
+}
@@ -0,0 +1,176 @@
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "bat.h"
+#include "bat_isa.h"
+#include "bat_tune.h"
+#include "bat_utils.h"
+
+/*
+ * bat_tune.c
+ *
+ * Purpose:
+ * Candidate configurations and tuning cache of --autotune (see
+ * bat_tune.h). The timing itself is done by the OpenMP front-end.
+ */
+
+/* Maximum length of one cache line. */
+#define TUNE_LINE_MAX 256
+
+/* Schedules tried for every thread count: static blocks, then load-balancing ones. */
+static const struct {
+    int sched;
+    int chunk;
+} tune_schedules[] = {
+    {BAT_SCHED_STATIC, 0},
+    {BAT_SCHED_STATIC, 64},
+    {BAT_SCHED_DYNAMIC, 16},
+    {BAT_SCHED_DYNAMIC, 64},
+    {BAT_SCHED_DYNAMIC, 256},
+    {BAT_SCHED_GUIDED, 0},
+};
+
+int bat_sched_from_name(const char *name) {
+    if (strcmp(name, "static") == 0)  return BAT_SCHED_STATIC;
+    if (strcmp(name, "dynamic") == 0) return BAT_SCHED_DYNAMIC;
+    if (strcmp(name, "guided") == 0)  return BAT_SCHED_GUIDED;
+    return -1;
+}
+
+const char *bat_sched_name(int sched) {
+    switch (sched) {
+        case BAT_SCHED_DYNAMIC: return "dynamic";
+        case BAT_SCHED_GUIDED:  return "guided";
+        default:                return "static";
+    }
+}
+
+/* FNV-1a of a string, its terminating zero included (so "a","b" and "ab" differ). */
+static uint64_t hash_text(uint64_t h, const char *text) {
+    const unsigned char *c = (const unsigned char *)text;
+    do {
+        h = (h ^ *c) * 0x100000001B3ull;
+    } while (*c++);
+    return h;
+}
+
+void bat_tune_key(BatTuneKey *key, int n_bats, const BatOptions *opts) {
+    memset(key, 0, sizeof(*key));
+    if (gethostname(key->host, sizeof(key->host) - 1) != 0 || key->host[0] == '\0') {
+        strcpy(key->host, "unknown");
+    }
+    /* The cache is whitespace-separated. */
+    for (char *c = key->host; *c; c++) {
+        if (*c == ' ' || *c == '\t') *c = '_';
+    }
+
+    key->bucket = 1;
+    while (key->bucket < n_bats && key->bucket < (1 << 30)) key->bucket <<= 1;
+    key->dim = dimension;
+    key->precision = (int)sizeof(bat_real);
+    snprintf(key->isa, sizeof(key->isa), "%s", bat_isa_name(bat_isa_current()));
+
+    /* Two expressions cost differently under the same name: the texts go into the key. */
+    uint64_t h = 0xCBF29CE484222325ull;
+    if (opts->objective_expr) h = hash_text(h, opts->objective_expr);
+    for (int c = 0; c < opts->con.n; c++) h = hash_text(hash_text(h, "con"), opts->con.expr[c]);
+    for (int m = 0; m < opts->n_mo; m++) h = hash_text(hash_text(h, "mo"), opts->mo_expr[m]);
+    if (opts->objective_expr || opts->con.n > 0 || opts->n_mo > 0) {
+        snprintf(key->objective, sizeof(key->objective), "%s-%016llx", bat_objective_name(opts->objective),
+                 (unsigned long long)h);
+    } else {
+        snprintf(key->objective, sizeof(key->objective), "%s", bat_objective_name(opts->objective));
+    }
+}
+
+int bat_tune_candidates(int max_threads, BatTuneChoice out[], int cap) {
+    int n = 0;
+    int n_sched = (int)(sizeof(tune_schedules) / sizeof(tune_schedules[0]));
+
+    int threads = 1;
+    for (;;) {
+        for (int s = 0; s < n_sched && n < cap; s++) {
+            out[n].threads = threads;
+            out[n].sched = tune_schedules[s].sched;
+            out[n].chunk = tune_schedules[s].chunk;
+            out[n].ns_per_update = 0.0;
+            n++;
+        }
+        if (threads >= max_threads) break;
+        threads = threads * 2 < max_threads ? threads * 2 : max_threads;
+    }
+    return n;
+}
+
+/* Parses one cache line; returns 1 if it is a valid entry. */
+static int parse_line(const char *line, BatTuneKey *key, BatTuneChoice *choice) {
+    char sched[16];
+    memset(key, 0, sizeof(*key));
+    if (sscanf(line, "%63s %d %d %d %15s %31s %d %15s %d %lf", key->host, &key->bucket, &key->dim,
+               &key->precision, key->isa, key->objective, &choice->threads, sched, &choice->chunk,
+               &choice->ns_per_update) != 10) {
+        return 0;
+    }
+    choice->sched = bat_sched_from_name(sched);
+    return choice->sched >= 0 && choice->threads > 0 && choice->chunk >= 0;
+}
+
+static int same_key(const BatTuneKey *a, const BatTuneKey *b) {
+    return strcmp(a->host, b->host) == 0 && a->bucket == b->bucket && a->dim == b->dim
+        && a->precision == b->precision && strcmp(a->isa, b->isa) == 0 && strcmp(a->objective, b->objective) == 0;
+}
+
+int bat_tune_lookup(const char *path, const BatTuneKey *key, BatTuneChoice *choice) {
+    FILE *fp = fopen(path, "r");
+    if (!fp) return 0;
+
+    char line[TUNE_LINE_MAX];
+    int found = 0;
+    while (!found && fgets(line, sizeof(line), fp)) {
+        BatTuneKey k;
+        BatTuneChoice c;
+        if (line[0] != '#' && parse_line(line, &k, &c) && same_key(&k, key)) {
+            *choice = c;
+            found = 1;
+        }
+    }
+    fclose(fp);
+    return found;
+}
+
+int bat_tune_store(const char *path, const BatTuneKey *key, const BatTuneChoice *choice) {
+    char tmp_path[1024];
+    snprintf(tmp_path, sizeof(tmp_path), "%s.tmp%ld", path, (long)getpid());
+    FILE *out = fopen(tmp_path, "w");
+    if (!out) {
+        perror("fopen tuning cache");
+        return -1;
+    }
+
+    /* Copy every other entry (and the comments), then append the new one. */
+    FILE *in = fopen(path, "r");
+    if (in) {
+        char line[TUNE_LINE_MAX];
+        while (fgets(line, sizeof(line), in)) {
+            BatTuneKey k;
+            BatTuneChoice c;
+            if (line[0] != '#' && parse_line(line, &k, &c) && same_key(&k, key)) continue;
+            fputs(line, out);
+        }
+        fclose(in);
+    } else {
+        fprintf(out, "# host bucket dim precision isa objective threads schedule chunk ns_per_update\n");
+    }
+    fprintf(out, "%s %d %d %d %s %s %d %s %d %.3f\n", key->host, key->bucket, key->dim, key->precision, key->isa,
+            key->objective, choice->threads, bat_sched_name(choice->sched), choice->chunk, choice->ns_per_update);
+
+    if (fclose(out) != 0 || rename(tmp_path, path) != 0) {
+        perror("write tuning cache");
+        remove(tmp_path);
+        return -1;
+    }
+    return 0;
+}
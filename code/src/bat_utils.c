@@ -1,10 +1,20 @@
 #include <math.h>
 #include <stdlib.h>
+#include <string.h>
 #include "bat.h"
 #include "bat_utils.h"
+#include "bat_isa.h"
+#include "bat_expr.h"
 
 #define PI 3.14
 
+/* Objective used by objective_function() (set once at startup). */
+static int current_objective = BAT_OBJ_PARABOLOID;
+
+static const char *objective_names[BAT_OBJ_COUNT] = {
+    "paraboloid", "sphere", "rastrigin", "ackley", "griewank", "rosenbrock"
+};
+
 double uniform_random(double a, double b) {
     double u = (double) rand() / (double) RAND_MAX;
     return a + (b - a) * u;
@@ -18,12 +28,66 @@ double uniform_random(double a, double b) {
 //     return exp(-sum_sq);
 // }
 
+/*
+ * Built-in test functions (maximized, see bat_utils.h).
+ *
+ * Parameters:
+ *   - id : BAT_OBJ_* function
+ *   - x  : point to evaluate
+ *   - n  : number of coordinates of x
+ */
+double bat_objective_eval(int id, const double x[], int n) {
+    if (id == BAT_OBJ_EXPR) return bat_expr_eval(x);
+    /* ISA variant selected at startup (bat_isa.c, --isa). */
+    return bat_kernels.objective(id, x, n);
+}
+
 double objective_function(const double x[]) {
-    double sum_sq = 0.0;
-    for (int d = 0; d < dimension; d++) {
-        sum_sq += x[d] * x[d];
+    return bat_objective_eval(current_objective, x, dimension);
+}
+
+double bat_objective_real(const bat_real x[]) {
+#ifdef BAT_REAL_FLOAT
+    double xd[dimension];
+    for (int d = 0; d < dimension; d++) xd[d] = (double)x[d];
+    return objective_function(xd);
+#else
+    return objective_function(x);
+#endif
+}
+
+int bat_objective_from_name(const char *name) {
+    for (int id = 0; id < BAT_OBJ_COUNT; id++) {
+        if (strcmp(name, objective_names[id]) == 0) return id;
     }
-    return 10.0 - sum_sq;
+    return -1;
+}
+
+const char *bat_objective_name(int id) {
+    if (id == BAT_OBJ_EXPR) return "expr";
+    return (id >= 0 && id < BAT_OBJ_COUNT) ? objective_names[id] : "unknown";
+}
+
+void bat_set_objective(int id) {
+    current_objective = id;
+}
+
+int bat_get_objective(void) {
+    return current_objective;
+}
+
+double bat_objective_optimum(int id) {
+    return (id == BAT_OBJ_PARABOLOID) ? 10.0 : 0.0;
+}
+
+static int key_index_cmp(const void *pa, const void *pb) {
+    const BatKeyIndex *a = pa, *b = pb;
+    if (a->key != b->key) return a->key < b->key ? -1 : 1;
+    return (a->index > b->index) - (a->index < b->index);
+}
+
+void bat_sort_by_key(BatKeyIndex pairs[], int n) {
+    qsort(pairs, (size_t)n, sizeof(BatKeyIndex), key_index_cmp);
 }
 
 // Gaussian N(mean, stddev) using Box-Muller
@@ -32,4 +96,4 @@ double normal_random(double mean, double stddev) {
     double u2 = uniform_random(0.0, 1.0);
     double z0 = sqrt(-2.0 * log(u1)) * cos(2.0 * PI * u2);
     return mean + stddev * z0;
-}
\ No newline at end of file
+}
@@ -0,0 +1,69 @@
+#include <math.h>
+#include <string.h>
+
+#include "bat_xsum.h"
+
+/*
+ * bat_xsum.c
+ *
+ * Purpose:
+ * Exact summation with a fixed-point superaccumulator (see bat_xsum.h).
+ *
+ * Layout:
+ * bit k of the fixed-point number has weight 2^(k - XSUM_OFFSET); bin b
+ * holds bits [32 b, 32 b + 32). XSUM_OFFSET covers the smallest subnormal
+ * (2^-1074), and the bins reach past the largest double.
+ */
+
+#define XSUM_OFFSET 1128
+#define XSUM_BITS   32
+#define XSUM_MASK   0xFFFFFFFFu
+
+void bat_xsum_clear(BatExactSum *s) {
+    memset(s, 0, sizeof(*s));
+}
+
+void bat_xsum_add(BatExactSum *s, double v) {
+    if (v == 0.0 || !isfinite(v)) return;
+
+    /* v = m * 2^e with 0.5 <= |m| < 1, i.e. an integer mantissa of 53 bits. */
+    int e;
+    double m = frexp(fabs(v), &e);
+    uint64_t mant = (uint64_t)ldexp(m, 53);
+    int pos = e - 53 + XSUM_OFFSET;        /* position of the mantissa's lowest bit */
+
+    int b = pos / XSUM_BITS;
+    int shift = pos % XSUM_BITS;
+    unsigned __int128 wide = (unsigned __int128)mant << shift;   /* at most 85 bits */
+
+    for (int k = 0; k < 3 && b + k < BAT_XSUM_BINS; k++) {
+        int64_t chunk = (int64_t)((uint64_t)(wide >> (XSUM_BITS * k)) & XSUM_MASK);
+        s->bin[b + k] += (v < 0.0) ? -chunk : chunk;
+    }
+}
+
+void bat_xsum_merge(BatExactSum *dst, const BatExactSum *src) {
+    for (int b = 0; b < BAT_XSUM_BINS; b++) {
+        dst->bin[b] += src->bin[b];
+    }
+}
+
+double bat_xsum_value(const BatExactSum *s) {
+    /* Propagate carries so every bin but the last is in [0, 2^32). */
+    int64_t bin[BAT_XSUM_BINS];
+    memcpy(bin, s->bin, sizeof(bin));
+    for (int b = 0; b < BAT_XSUM_BINS - 1; b++) {
+        int64_t carry = bin[b] >> XSUM_BITS;   /* arithmetic shift: floor division */
+        bin[b] -= carry * ((int64_t)1 << XSUM_BITS);
+        bin[b + 1] += carry;
+    }
+
+    /* Add from the most significant bin down (a fixed order). */
+    double sum = 0.0;
+    for (int b = BAT_XSUM_BINS - 1; b >= 0; b--) {
+        if (bin[b] != 0) {
+            sum += ldexp((double)bin[b], XSUM_BITS * b - XSUM_OFFSET);
+        }
+    }
+    return sum;
+}
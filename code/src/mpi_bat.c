@@ -6,6 +6,25 @@
 
 #include "bat.h"
 #include "bat_utils.h"
+#include "bat_io.h"
+#include "bat_signal.h"
+#include "bat_options.h"
+#include "bat_deadline.h"
+#include "bat_init.h"
+#include "bat_refine.h"
+#include "bat_restart.h"
+#include "bat_shrink.h"
+#include "bat_arena.h"
+#include "bat_bind.h"
+#include "bat_cli.h"
+#include "bat_hd.h"
+#include "bat_cc.h"
+#include "bat_constraint.h"
+#include "bat_mo.h"
+#include "bat_niche.h"
+#include "bat_mode.h"
+#include "bat_transform.h"
+#include "bat_xsum.h"
 
 /*
  * MPI version of the Bat Algorithm.
@@ -21,48 +40,1115 @@
  * is computed collectively with Allreduce.
  */
 
-static void parse_args(int argc, char **argv, int *n_bats, int *max_iters, unsigned int *seed, int *quiet) {
-    *n_bats = N_BATS;
-    *max_iters = MAX_ITERS;
-    *seed = (unsigned int)time(NULL);
-    *quiet = 0;
+/*
+ * Determines the global best bat and makes it available on every rank.
+ *
+ * Parameters:
+ *   - local_bats  : bats owned by this rank
+ *   - local_n     : number of local bats
+ *   - rank        : rank of this process
+ *   - global_best : output, identical on all ranks after the call
+ */
+static void reduce_global_best(const Bat local_bats[], int local_n, int rank, Bat *global_best) {
+    /* Determine the best bat on this rank */
+    Bat local_best = local_bats[0];
+    for (int i = 1; i < local_n; i++) {
+        if (local_bats[i].f_value > local_best.f_value) {
+            local_best = local_bats[i];
+        }
+    }
+
+    /* Global best computation
+     *
+     * Goal:
+     * After each iteration (and after initialization), every rank has its own local_best.
+     * We need to determine which rank owns the best solution overall
+     * and make this solution available to all ranks.
+     *
+     * Step 1:
+     * Reduce only the objective value (f_value) together with the rank.
+     * We cannot directly reduce a Bat structure, so we use MPI_MAXLOC
+     * on a (value, rank) pair.
+     */
+    struct {
+        double value;
+        int rank;
+    } local_data, global_data;
+   
+    /* Prepare local contribution: best score on this rank */
+    local_data.value = local_best.f_value;
+    local_data.rank  = rank;
+   
+    /* Find the maximum objective value and the rank that owns it */
+    MPI_Allreduce(
+        &local_data,
+        &global_data,
+        1,
+        MPI_DOUBLE_INT,
+        MPI_MAXLOC,
+        MPI_COMM_WORLD
+    );
+
+    /*
+     * Step 2:
+     * Now all ranks know which rank owns the global best solution.
+     * That rank copies its local_best into global_best.
+     */
+    if (rank == global_data.rank) {
+        *global_best = local_best;
+    }
+    /*
+     * Step 3:
+     * Broadcast the full global_best structure from the owning rank
+     * so that all ranks use the same global best in the next iteration.
+     */
+    MPI_Bcast(
+        global_best,
+        sizeof(Bat),
+        MPI_BYTE,
+        global_data.rank,
+        MPI_COMM_WORLD
+    );
+}
+
+/*
+ * Takes `bytes` of scratch space from the arena (sized by
+ * shrink_scratch_bytes(), so running out is a bug).
+ */
+static void *scratch_alloc(BatArena *scratch, size_t bytes) {
+    void *p = bat_arena_alloc(scratch, bytes);
+    if (!p) MPI_Abort(MPI_COMM_WORLD, 1);
+    return p;
+}
+
+/*
+ * Scratch space needed by one --shrink step (shrink_global() then
+ * rebalance_bats(), which release their buffers before returning).
+ *
+ * Parameters:
+ *   - n_bats  : global population size (upper bound)
+ *   - local_n : initial slice size (upper bound of a balanced slice)
+ *   - size    : number of ranks
+ */
+static size_t shrink_scratch_bytes(int n_bats, int local_n, int size) {
+    size_t ranks = bat_arena_need((size_t)size * sizeof(int));
+    size_t shrink = 2 * ranks + bat_arena_need((size_t)local_n * sizeof(double))
+                  + bat_arena_need((size_t)n_bats * sizeof(double)) + bat_arena_need((size_t)n_bats * sizeof(BatKeyIndex))
+                  + bat_arena_need((size_t)local_n);
+    size_t rebalance = 8 * ranks + bat_arena_need((size_t)local_n * sizeof(Bat));
+    return shrink > rebalance ? shrink : rebalance;
+}
+
+/*
+ * Drops the `n_drop` globally worst bats (--shrink).
+ *
+ * Every rank gathers all the f_values (one double per bat), sorts them in
+ * the same deterministic order and removes its own bats among the worst.
+ * The slices can become unbalanced: see rebalance_bats().
+ *
+ * Parameters:
+ *   - local_bats : bats owned by this rank (compacted in place)
+ *   - local_n    : number of bats owned by this rank
+ *   - n_drop     : number of bats to remove over all ranks
+ *   - rank, size : MPI rank and number of ranks
+ *   - scratch    : arena for the temporary buffers (released on return)
+ *
+ * Returns the new number of bats owned by this rank.
+ */
+static int shrink_global(Bat local_bats[], int local_n, int n_drop, int rank, int size, BatArena *scratch) {
+    size_t mark = bat_arena_mark(scratch);
+    int *counts = scratch_alloc(scratch, (size_t)size * sizeof(int));
+    int *displs = scratch_alloc(scratch, (size_t)size * sizeof(int));
+    MPI_Allgather(&local_n, 1, MPI_INT, counts, 1, MPI_INT, MPI_COMM_WORLD);
+
+    int total = 0;
+    for (int r = 0; r < size; r++) {
+        displs[r] = total;
+        total += counts[r];
+    }
+
+    double *local_f = scratch_alloc(scratch, (size_t)local_n * sizeof(double));
+    double *all_f = scratch_alloc(scratch, (size_t)total * sizeof(double));
+    BatKeyIndex *order = scratch_alloc(scratch, (size_t)total * sizeof(BatKeyIndex));
+    unsigned char *drop = scratch_alloc(scratch, (size_t)local_n);
+    memset(drop, 0, (size_t)local_n);
+
+    for (int i = 0; i < local_n; i++) local_f[i] = local_bats[i].f_value;
+    MPI_Allgatherv(local_f, local_n, MPI_DOUBLE, all_f, counts, displs, MPI_DOUBLE, MPI_COMM_WORLD);
+
+    /* Worst first (global indices). */
+    for (int g = 0; g < total; g++) {
+        order[g].key = all_f[g];
+        order[g].index = g;
+    }
+    bat_sort_by_key(order, total);
+
+    for (int k = 0; k < n_drop && k < total; k++) {
+        int i = order[k].index - displs[rank];
+        if (i >= 0 && i < local_n) drop[i] = 1;
+    }
+    int kept = bat_shrink_compact(local_bats, local_n, drop);
+
+    bat_arena_release(scratch, mark);
+    return kept;
+}
+
+/* Length of the intersection of [a0, a1) and [b0, b1). */
+static int overlap(int a0, int a1, int b0, int b1) {
+    int lo = a0 > b0 ? a0 : b0;
+    int hi = a1 < b1 ? a1 : b1;
+    return hi > lo ? hi - lo : 0;
+}
+
+/*
+ * Migrates bats so that every rank owns total/size bats (+1 for the first
+ * total%size ranks) after a --shrink step.
+ *
+ * The population is seen as the concatenation of the slices in rank order;
+ * each rank keeps or sends the part of its slice that falls into another
+ * rank's balanced range, with one MPI_Alltoallv. Bats only move between
+ * neighbouring ranges, so little data is exchanged.
+ *
+ * Parameters:
+ *   - local_bats : bats owned by this rank (capacity >= balanced size)
+ *   - local_n    : number of bats owned by this rank
+ *   - rank, size : MPI rank and number of ranks
+ *   - scratch    : arena for the temporary buffers (released on return)
+ *
+ * Returns the new number of bats owned by this rank.
+ */
+static int rebalance_bats(Bat local_bats[], int local_n, int rank, int size, BatArena *scratch) {
+    size_t mark = bat_arena_mark(scratch);
+    int *counts = scratch_alloc(scratch, (size_t)size * sizeof(int));
+    int *start = scratch_alloc(scratch, (size_t)size * sizeof(int));
+    int *target = scratch_alloc(scratch, (size_t)size * sizeof(int));
+    int *target_start = scratch_alloc(scratch, (size_t)size * sizeof(int));
+    MPI_Allgather(&local_n, 1, MPI_INT, counts, 1, MPI_INT, MPI_COMM_WORLD);
+
+    int total = 0, min_n = counts[0], max_n = counts[0];
+    for (int r = 0; r < size; r++) {
+        start[r] = total;
+        total += counts[r];
+        if (counts[r] < min_n) min_n = counts[r];
+        if (counts[r] > max_n) max_n = counts[r];
+    }
 
-    for (int i = 1; i < argc; i++) {
-        if (strcmp(argv[i], "--n-bats") == 0 && i + 1 < argc) {
-            *n_bats = atoi(argv[++i]);
-        } else if (strcmp(argv[i], "--iters") == 0 && i + 1 < argc) {
-            *max_iters = atoi(argv[++i]);
-        } else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc) {
-            *seed = (unsigned int)strtoul(argv[++i], NULL, 10);
-        } else if (strcmp(argv[i], "--quiet") == 0) {
-            *quiet = 1;
+    int new_n = local_n;
+    if (max_n - min_n > 1) {
+        int pos = 0;
+        for (int r = 0; r < size; r++) {
+            target[r] = total / size + (r < total % size ? 1 : 0);
+            target_start[r] = pos;
+            pos += target[r];
         }
+
+        /* Byte counts and displacements for MPI_Alltoallv (Bat records as MPI_BYTE). */
+        int *send_counts = scratch_alloc(scratch, (size_t)size * sizeof(int));
+        int *send_displs = scratch_alloc(scratch, (size_t)size * sizeof(int));
+        int *recv_counts = scratch_alloc(scratch, (size_t)size * sizeof(int));
+        int *recv_displs = scratch_alloc(scratch, (size_t)size * sizeof(int));
+        Bat *incoming = scratch_alloc(scratch, (size_t)target[rank] * sizeof(Bat));
+        memset(send_counts, 0, (size_t)size * sizeof(int));
+        memset(send_displs, 0, (size_t)size * sizeof(int));
+        memset(recv_counts, 0, (size_t)size * sizeof(int));
+        memset(recv_displs, 0, (size_t)size * sizeof(int));
+
+        int my0 = start[rank], my1 = start[rank] + local_n;
+        int want0 = target_start[rank], want1 = target_start[rank] + target[rank];
+        for (int q = 0; q < size; q++) {
+            int out = overlap(my0, my1, target_start[q], target_start[q] + target[q]);
+            if (out > 0) {
+                int first = my0 > target_start[q] ? my0 : target_start[q];
+                send_counts[q] = out * (int)sizeof(Bat);
+                send_displs[q] = (first - my0) * (int)sizeof(Bat);
+            }
+            int in = overlap(start[q], start[q] + counts[q], want0, want1);
+            if (in > 0) {
+                int first = start[q] > want0 ? start[q] : want0;
+                recv_counts[q] = in * (int)sizeof(Bat);
+                recv_displs[q] = (first - want0) * (int)sizeof(Bat);
+            }
+        }
+
+        MPI_Alltoallv(local_bats, send_counts, send_displs, MPI_BYTE,
+                      incoming, recv_counts, recv_displs, MPI_BYTE, MPI_COMM_WORLD);
+        new_n = target[rank];
+        memcpy(local_bats, incoming, (size_t)new_n * sizeof(Bat));
     }
+
+    bat_arena_release(scratch, mark);
+    return new_n;
 }
 
-int main(int argc, char *argv[]) {
+/*
+ * Writes the whole population to one file (--final-pop): the slices are
+ * gathered on rank 0 in rank order, so the file has the same layout as the
+ * sequential one and the two can be compared byte for byte.
+ *
+ * Parameters:
+ *   - path       : output file name (written by rank 0)
+ *   - local_bats : bats owned by this rank
+ *   - local_n    : number of bats owned by this rank
+ *   - best_bat   : global best (identical on all ranks)
+ *   - iteration  : iteration count stored in the header
+ *   - seed       : run seed
+ *   - rank, size : MPI rank and number of ranks
+ */
+static void write_global_population(const char *path, const Bat local_bats[], int local_n, const Bat *best_bat,
+                                    int iteration, uint32_t seed, int rank, int size) {
+    int bytes = local_n * (int)sizeof(Bat);
+    int *counts = NULL, *displs = NULL;
+    Bat *all = NULL;
+    int total = 0;
+
+    if (rank == 0) {
+        counts = malloc((size_t)size * sizeof(int));
+        displs = malloc((size_t)size * sizeof(int));
+        if (!counts || !displs) {
+            perror("malloc final-pop counts");
+            MPI_Abort(MPI_COMM_WORLD, 1);
+        }
+    }
+    MPI_Gather(&bytes, 1, MPI_INT, counts, 1, MPI_INT, 0, MPI_COMM_WORLD);
+
+    if (rank == 0) {
+        for (int r = 0; r < size; r++) {
+            displs[r] = total;
+            total += counts[r];
+        }
+        all = malloc((size_t)total);
+        if (!all) {
+            perror("malloc final-pop buffer");
+            MPI_Abort(MPI_COMM_WORLD, 1);
+        }
+    }
+    MPI_Gatherv(local_bats, bytes, MPI_BYTE, all, counts, displs, MPI_BYTE, 0, MPI_COMM_WORLD);
+
+    if (rank == 0) {
+        bat_write_population(path, all, total / (int)sizeof(Bat), best_bat, iteration, seed, 0, 1);
+    }
+    free(counts);
+    free(displs);
+    free(all);
+}
+
+/*
+ * Serves the signal requests of all ranks at the end of iteration t
+ * (collective: the flags are OR-reduced first). SIGUSR1 queues a dump of
+ * this rank's bats, SIGUSR2 writes a checkpoint.
+ *
+ * Parameters:
+ *   - writer     : background dump writer of this rank
+ *   - local_bats : bats owned by this rank
+ *   - local_n    : number of bats owned by this rank
+ *   - best_bat   : global best (identical on all ranks)
+ *   - t          : iteration just completed
+ *   - seed       : run seed
+ *   - rank, size : MPI rank and number of ranks
+ *
+ * Returns 1 if the run must stop (SIGUSR2), 0 otherwise.
+ */
+static int serve_signals(BatDumpWriter *writer, const Bat local_bats[], int local_n, const Bat *best_bat, int t,
+                         uint32_t seed, int rank, int size) {
+    int local_sig = bat_signal_take();
+    int sig = 0;
+    MPI_Allreduce(&local_sig, &sig, 1, MPI_INT, MPI_BOR, MPI_COMM_WORLD);
+
+    char path[64];
+    if (sig & BAT_SIG_EXIT) {
+        snprintf(path, sizeof(path), "checkpoint_t%06d_r%03d.bin", t, rank);
+        bat_write_population(path, local_bats, local_n, best_bat, t, seed, rank, size);
+        if (rank == 0) {
+            fprintf(stderr, "SIGUSR2: checkpoint written, stopping after iteration %d\n", t);
+        }
+        return 1;
+    }
+    if (sig & BAT_SIG_DUMP) {
+        /* Wait for this rank's previous dump so no rank skips the iteration. */
+        snprintf(path, sizeof(path), "dump_t%06d_r%03d.bin", t, rank);
+        bat_dump_writer_submit(writer, path, local_bats, local_n, best_bat, t, seed, rank, size, 1);
+    }
+    return 0;
+}
+
+/*
+ * --bind: ranks are pinned per host (slot = rank among the ranks of the
+ * host, from MPI_COMM_TYPE_SHARED). Rank 0 gathers where every rank runs
+ * for the BENCH line.
+ *
+ * Returns the placement of every rank on rank 0 (to free), NULL elsewhere.
+ */
+static BatBindSlot *bind_rank(const BatOptions *opts, int rank, int size) {
+    MPI_Comm host_comm;
+    int host_rank, host_size, host_id = rank;
+    MPI_Comm_split_type(MPI_COMM_WORLD, MPI_COMM_TYPE_SHARED, 0, MPI_INFO_NULL, &host_comm);
+    MPI_Comm_rank(host_comm, &host_rank);
+    MPI_Comm_size(host_comm, &host_size);
+    MPI_Bcast(&host_id, 1, MPI_INT, 0, host_comm);
+    MPI_Comm_free(&host_comm);
+
+    BatTopology topo;
+    BatBindSlot where;
+    if (bat_topology_load(&topo) != 0) MPI_Abort(MPI_COMM_WORLD, 1);
+    bat_bind_self(&topo, opts->bind, host_rank, host_size);
+    bat_bind_where(&topo, host_id, &where);
+    BatBindSlot *all_where = NULL;
+    if (rank == 0) {
+        all_where = malloc((size_t)size * sizeof(BatBindSlot));
+        if (!all_where) {
+            perror("malloc bind slots");
+            MPI_Abort(MPI_COMM_WORLD, 1);
+        }
+    }
+    MPI_Gather(&where, 5, MPI_INT, all_where, 5, MPI_INT, 0, MPI_COMM_WORLD);
+    return all_where;
+}
+
+/* Part k of [0, n) split in `parts` blocks (the first n % parts get one more). */
+static void block_range(int n, int parts, int k, int *first, int *count) {
+    int base = n / parts, extra = n % parts;
+    *first = k * base + (k < extra ? k : extra);
+    *count = base + (k < extra ? 1 : 0);
+}
+
+/*
+ * Grid of a --dim run: rank (row, col) holds bat group `row` restricted to
+ * dimension slice `col`.
+ */
+typedef struct {
+    int rows, cols;
+    int row, col;
+    MPI_Comm row_comm;     /* same bats, every slice */
+    MPI_Comm col_comm;     /* same slice, every bat group */
+    int *counts;           /* doubles of partials sent by each rank of the row */
+    int *displs;
+    double *gathered;      /* partials of the row's bats, every tile */
+} BatHdGrid;
+
+/*
+ * Objective value of slot k, candidate c, from the partials gathered along
+ * the row: the blocks of the slices hold consecutive tiles, so combining
+ * them block by block is combining every tile in global tile order.
+ */
+static double grid_value(const BatHdGrid *g, const BatHdPop *pop, int k, int c, int id) {
+    double acc[BAT_HD_PARTS];
+    int first = 1;
+    for (int col = 0; col < g->cols; col++) {
+        int nt = g->counts[col] / (2 * pop->n_bats * BAT_HD_PARTS);
+        const double *p = g->gathered + g->displs[col] + ((size_t)k * 2 + (size_t)c) * (size_t)nt * BAT_HD_PARTS;
+        for (int j = 0; j < nt; j++, p += BAT_HD_PARTS) {
+            if (first) memcpy(acc, p, sizeof(acc));
+            else bat_hd_combine(id, acc, p);
+            first = 0;
+        }
+    }
+    return bat_hd_value(id, acc, pop->dim);
+}
+
+/* Gathers the partials of every slot (one per local bat) along the row. */
+static void grid_gather(BatHdGrid *g, const BatHdPop *pop, const BatHdScratch *s) {
+    MPI_Allgatherv(bat_hd_slot_parts(pop, s, 0, 0), g->counts[g->col], MPI_DOUBLE,
+                   g->gathered, g->counts, g->displs, MPI_DOUBLE, g->row_comm);
+}
+
+/*
+ * Best bat over the grid (lowest index on ties, as bat_hd_select_best()):
+ * MAXLOC of (value, bat) along the column, then the owner of the bat
+ * broadcasts its slice of the row to the column. The rows hold the same
+ * values, so every column finds the same bat.
+ * Returns 1 if the best value improved.
+ */
+static int grid_select_best(BatHdGrid *g, BatHdPop *pop, int n_bats) {
+    struct {
+        double value;
+        int bat;
+    } local_data, global_data;
+
+    int best = 0;
+    for (int i = 1; i < pop->n_bats; i++) {
+        if (pop->bat[i].f_value > pop->bat[best].f_value) best = i;
+    }
+    local_data.value = pop->bat[best].f_value;
+    local_data.bat = pop->bat0 + best;
+    MPI_Allreduce(&local_data, &global_data, 1, MPI_DOUBLE_INT, MPI_MAXLOC, g->col_comm);
+    if (pop->best_i >= 0 && global_data.value <= pop->best_f) return 0;
+
+    int owner = 0, first, count;
+    for (int r = 0; r < g->rows; r++) {
+        block_range(n_bats, g->rows, r, &first, &count);
+        if (global_data.bat >= first && global_data.bat < first + count) owner = r;
+    }
+    if (owner == g->row) {
+        memcpy(pop->best_x, pop->x + (size_t)(global_data.bat - pop->bat0) * (size_t)pop->stride,
+               (size_t)pop->stride * sizeof(bat_real));
+    }
+    MPI_Bcast(pop->best_x, pop->stride * (int)sizeof(bat_real), MPI_BYTE, owner, g->col_comm);
+    pop->best_i = global_data.bat;
+    pop->best_f = global_data.value;
+    return 1;
+}
+
+/*
+ * High-dimensional run (--dim, see bat_hd.h) on a grid of size / slices
+ * rows by --hd-slices columns.
+ *
+ * Idea:
+ * - Rank (i, j) holds the bats of group i (rows split the population)
+ *   restricted to dimension slice j (columns split the tiles): with S
+ *   slices a rank stores 1/S of each of its bats' vectors, so vectors
+ *   larger than one node's memory fit on the grid.
+ * - The scalar state of a bat (frequency, loudness, pulse rate, RNG) is
+ *   replicated on its row: every rank of the row makes the same draws.
+ * - The tile passes only need the rank's own slice and the same slice of
+ *   the best position. The tile partials of all the group's bats are then
+ *   gathered along the row and combined in global tile order, so the row
+ *   agrees on the values and they match the sequential program (summing
+ *   per-slice totals would round differently for every grid shape).
+ *   Rosenbrock's terms across slices come from the first / last
+ *   coordinate kept with each tile partial: no halo exchange is needed.
+ * - Along the columns, the loudness sums (exact accumulators) and the best
+ *   (value, bat) are reduced, and the new best bat's slices are broadcast.
+ * - With --transform or --objective-expr there is a single slice: every
+ *   rank evaluates the candidates of its bats as one batch (bat_transform.h).
+ *
+ * Parameters:
+ *   - args : parsed command line
+ *   - opts : checked and applied options
+ *   - rank : rank of this process
+ *   - size : number of processes
+ */
+static int run_hd(const BatArgs *args, const BatOptions *opts, int rank, int size) {
+    int n_bats = args->n_bats, max_iters = args->max_iters, dim = opts->hd_dim;
+    int n_all_tiles = bat_hd_tile_count(dim);
+    int batch = bat_hd_batched(opts);
+    const int id = bat_get_objective();
+
+    BatHdGrid g;
+    g.cols = opts->hd_slices;
+    if (size % g.cols != 0) {
+        if (rank == 0) fprintf(stderr, "--hd-slices %d must divide the number of processes (%d)\n", g.cols, size);
+        return 1;
+    }
+    if (size / g.cols > n_bats) {
+        if (rank == 0) {
+            fprintf(stderr, "%d bat groups for %d bats: use fewer processes or more --hd-slices\n",
+                    size / g.cols, n_bats);
+        }
+        return 1;
+    }
+    g.rows = size / g.cols;
+    g.row = rank / g.cols;
+    g.col = rank % g.cols;
+    MPI_Comm_split(MPI_COMM_WORLD, g.row, g.col, &g.row_comm);
+    MPI_Comm_split(MPI_COMM_WORLD, g.col, g.row, &g.col_comm);
+
+    BatBindSlot *all_where = bind_rank(opts, rank, size);
+
+    int bat0, n_local, tile0, n_tiles, lo, hi;
+    block_range(n_bats, g.rows, g.row, &bat0, &n_local);
+    block_range(n_all_tiles, g.cols, g.col, &tile0, &n_tiles);
+    bat_hd_tile_range(dim, tile0, n_tiles, &lo, &hi);
+
+    /* Block, one scratch slot per local bat, and the partials of the whole row. */
+    size_t gathered_len = (size_t)n_local * 2 * (size_t)n_all_tiles * BAT_HD_PARTS;
+    size_t arena_bytes = bat_hd_pop_bytes(n_local, hi - lo) + bat_hd_scratch_bytes(n_tiles, n_local)
+                       + bat_arena_need(gathered_len * sizeof(double)) + 2 * bat_arena_need((size_t)g.cols * sizeof(int))
+                       + (batch ? bat_transform_bytes(opts->transform, dim, 2 * n_local) : 0);
+    BatArena arena;
+    if (bat_arena_create(&arena, arena_bytes, opts->pages) != 0) MPI_Abort(MPI_COMM_WORLD, 1);
+    BatHdPop pop;
+    BatHdScratch scratch;
+    BatTransform tf;
+    g.gathered = bat_arena_alloc(&arena, gathered_len * sizeof(double));
+    g.counts = bat_arena_alloc(&arena, (size_t)g.cols * sizeof(int));
+    g.displs = bat_arena_alloc(&arena, (size_t)g.cols * sizeof(int));
+    if (bat_hd_pop_create_block(&pop, &arena, bat0, n_local, dim, tile0, n_tiles) != 0
+        || bat_hd_scratch_create(&scratch, &arena, &pop, n_local) != 0 || !g.gathered || !g.counts || !g.displs
+        || (batch && bat_transform_create(&tf, &arena, opts->transform, dim, 2 * n_local) != 0)) {
+        MPI_Abort(MPI_COMM_WORLD, 1);
+    }
+    if (batch) pop.tf = &tf;
+    for (int c = 0, off = 0; c < g.cols; c++) {
+        int t0, nt;
+        block_range(n_all_tiles, g.cols, c, &t0, &nt);
+        g.counts[c] = n_local * 2 * nt * BAT_HD_PARTS;
+        g.displs[c] = off;
+        off += g.counts[c];
+    }
+
+    /* Initial values: the row partials of every bat, combined along the grid row. */
+    for (int i = 0; i < n_local; i++) {
+        bat_hd_init_bat(&pop, i, (uint32_t)args->seed);
+        if (!batch) bat_hd_row_parts(&pop, i, id, bat_hd_slot_parts(&pop, &scratch, i, 0));
+    }
+    if (batch) {
+        bat_hd_eval_init(&pop);
+    } else {
+        grid_gather(&g, &pop, &scratch);
+        for (int i = 0; i < n_local; i++) pop.bat[i].f_value = grid_value(&g, &pop, i, 0, id);
+    }
+    grid_select_best(&g, &pop, n_bats);
+
+    bat_signal_install();
+    int group = opts->hd_group < n_local ? opts->hd_group : n_local;
+    int iters_done = max_iters;
+    long evals = n_local;
+    long evals_to_target = -1;
+    BatCounters cnt = {0};
+
+    MPI_Barrier(MPI_COMM_WORLD);
+    double t0 = MPI_Wtime();
+
+    for (int t = 0; t < max_iters; t++) {
+        BatExactSum loud_local, loud_sum;
+        bat_xsum_clear(&loud_local);
+        for (int i = 0; i < n_local; i++) bat_xsum_add(&loud_local, pop.bat[i].A_i);
+        MPI_Allreduce(loud_local.bin, loud_sum.bin, BAT_XSUM_BINS, MPI_INT64_T, MPI_SUM, g.col_comm);
+        double A_mean = bat_xsum_value(&loud_sum) / (double)n_bats;
+        cnt.amean_calls++;
+        cnt.amean_scanned += n_local;
+
+        /* Tile passes of the rank's slice, group by group (tile-major within a group). */
+        for (int i = 0; i < n_local; i++) bat_hd_begin(&pop, &scratch, i, i, A_mean);
+        int rows = batch ? bat_hd_batch_rows(&scratch, n_local) : 0;
+        for (int first = 0; first < n_local; first += group) {
+            int count = n_local - first < group ? n_local - first : group;
+            for (int j = 0; j < n_tiles; j++) {
+                for (int k = first; k < first + count; k++) bat_hd_tile(&pop, &scratch, k, j, &cnt);
+            }
+        }
+
+        /* Values along the row, then the same acceptance test on every rank of the row. */
+        if (batch) {
+            bat_transform_eval(&tf, id, rows);
+        } else {
+            grid_gather(&g, &pop, &scratch);
+        }
+        for (int i = 0; i < n_local; i++) {
+            if (batch) {
+                evals += bat_hd_accept_batch(&pop, &scratch, i, t, &cnt);
+            } else {
+                double F_move = grid_value(&g, &pop, i, 0, id);
+                double F_walk = scratch.slot[i].walk ? grid_value(&g, &pop, i, 1, id) : 0.0;
+                evals += bat_hd_accept(&pop, &scratch, i, t, F_move, F_walk, &cnt);
+            }
+            for (int j = 0; j < n_tiles; j++) bat_hd_commit(&pop, &scratch, i, j);
+        }
+        if (grid_select_best(&g, &pop, n_bats) && rank == 0) cnt.best_changes++;
+
+        if (!args->quiet && rank == 0 && t % 100 == 0) {
+            printf("[Iter %d] Global best = %f\n", t, pop.best_f);
+        }
+        if (opts->has_target && pop.best_f >= opts->target) {
+            evals_to_target = evals;
+            iters_done = t + 1;
+            break;
+        }
+        /* SIGUSR2 stops the run (no checkpoint with --dim); flags are OR-reduced as in the main loop. */
+        if ((t + 1) % BAT_SIGNAL_POLL_ITERS == 0) {
+            int local_sig = bat_signal_take(), sig = 0;
+            MPI_Allreduce(&local_sig, &sig, 1, MPI_INT, MPI_BOR, MPI_COMM_WORLD);
+            if (sig & BAT_SIG_EXIT) {
+                if (rank == 0) fprintf(stderr, "SIGUSR2: stopping after iteration %d\n", t);
+                iters_done = t + 1;
+                break;
+            }
+        }
+    }
+
+    MPI_Barrier(MPI_COMM_WORLD);
+    double local_elapsed = MPI_Wtime() - t0, elapsed = 0.0;
+    MPI_Reduce(&local_elapsed, &elapsed, 1, MPI_DOUBLE, MPI_MAX, 0, MPI_COMM_WORLD);
+
+    /*
+     * Evaluations and per-bat counters are replicated on every rank of a
+     * row: only the first slice reports them. Clamps are per coordinate and
+     * summed over the whole grid.
+     */
+    if (g.col != 0) {
+        long clamps = cnt.clamps;
+        memset(&cnt, 0, sizeof(cnt));
+        cnt.clamps = clamps;
+        evals = 0;
+        evals_to_target = 0;
+    }
+    long total_evals = 0, total_evals_to_target = 0;
+    MPI_Reduce(&evals, &total_evals, 1, MPI_LONG, MPI_SUM, 0, MPI_COMM_WORLD);
+    MPI_Reduce(&evals_to_target, &total_evals_to_target, 1, MPI_LONG, MPI_SUM, 0, MPI_COMM_WORLD);
+    if (evals_to_target < 0) total_evals_to_target = -1;
+    BatCounters total_cnt = {0};
+    MPI_Reduce(&cnt, &total_cnt, BAT_COUNTERS_N, MPI_LONG, MPI_SUM, 0, MPI_COMM_WORLD);
+    /* GEMM rate of the grid: all the flops over the slowest rank's product time. */
+    double gemm_flops = 0.0, gemm_s = 0.0;
+    if (batch) {
+        MPI_Reduce(&tf.gemm_flops, &gemm_flops, 1, MPI_DOUBLE, MPI_SUM, 0, MPI_COMM_WORLD);
+        MPI_Reduce(&tf.gemm_s, &gemm_s, 1, MPI_DOUBLE, MPI_MAX, 0, MPI_COMM_WORLD);
+    }
+
+    if (rank == 0) {
+        if (!args->quiet) {
+            printf("\nFinal best f_value = %f (bat %d, %d coordinates)\n", pop.best_f, pop.best_i, dim);
+        }
+        printf("BENCH version=mpi n_bats=%d iters=%d procs=%d threads=1 time_s=%.6f evals=%ld",
+               n_bats, iters_done, size, elapsed, total_evals);
+        bat_counters_print_bench(&total_cnt);
+        printf(" best_f=%.17g", pop.best_f);
+        bat_options_print_bench(opts);
+        bat_arena_print_bench(&arena);
+        bat_bind_print_bench(opts->bind, all_where, size);
+        bat_hd_print_bench(&pop, group, batch ? "batch" : "grid");
+        printf(" grid=%dx%d", g.rows, g.cols);
+        if (batch) bat_transform_print_bench(&tf, gemm_flops, gemm_s);
+        if (opts->has_target) {
+            printf(" target=%g hit=%d evals_to_target=%ld", opts->target, total_evals_to_target >= 0,
+                   total_evals_to_target);
+        }
+        if (args->bench_extra) printf("%s", args->bench_extra);
+        printf("\n");
+    }
+
+    MPI_Comm_free(&g.row_comm);
+    MPI_Comm_free(&g.col_comm);
+    bat_arena_destroy(&arena);
+    free(all_where);
+    return 0;
+}
+
+/*
+ * Replaces, on every rank, the ranges [lo[r], hi[r]) of `buf` (in units
+ * of `unit` bytes) by those of rank r.
+ */
+static void allgather_ranges(void *buf, const int *lo, const int *hi, size_t unit, int size, int *counts,
+                             int *displs) {
+    for (int r = 0; r < size; r++) {
+        displs[r] = lo[r] * (int)unit;
+        counts[r] = (hi[r] - lo[r]) * (int)unit;
+    }
+    MPI_Allgatherv(MPI_IN_PLACE, 0, MPI_DATATYPE_NULL, buf, counts, displs, MPI_BYTE, MPI_COMM_WORLD);
+}
+
+/*
+ * Cooperative coevolution run (--cc, see bat_cc.h).
+ *
+ * - Every rank holds the whole population and the context; the
+ *   decomposition and the merge are replicated (same draws everywhere).
+ * - The sub-swarms of a round are split in blocks of consecutive groups.
+ *   Consecutive groups are contiguous in every array of BatCc, so after
+ *   the round each array is exchanged with one MPI_Allgatherv, and every
+ *   rank unpacks and merges the same data: the result is the sequential
+ *   one for any number of processes.
+ * - Replicated evaluations (initialization, differential grouping, merge)
+ *   are counted on rank 0 only.
+ *
+ * Parameters:
+ *   - args : parsed command line
+ *   - opts : checked and applied options
+ *   - rank : rank of this process
+ *   - size : number of processes
+ */
+static int run_cc(const BatArgs *args, const BatOptions *opts, int rank, int size) {
+    int n_bats = args->n_bats, max_iters = args->max_iters, dim = opts->hd_dim;
+
+    BatBindSlot *all_where = bind_rank(opts, rank, size);
+
+    size_t arena_bytes = bat_hd_pop_bytes(n_bats, dim) + bat_cc_bytes(dim, n_bats, opts->cc_size)
+                       + bat_cc_scratch_bytes(dim) + 6 * bat_arena_need((size_t)size * sizeof(int));
+    BatArena arena;
+    if (bat_arena_create(&arena, arena_bytes, opts->pages) != 0) MPI_Abort(MPI_COMM_WORLD, 1);
+    BatHdPop pop;
+    BatCc cc;
+    BatCcScratch scratch;
+    int *glo = bat_arena_alloc(&arena, (size_t)size * sizeof(int));
+    int *ghi = bat_arena_alloc(&arena, (size_t)size * sizeof(int));
+    int *plo = bat_arena_alloc(&arena, (size_t)size * sizeof(int));
+    int *phi = bat_arena_alloc(&arena, (size_t)size * sizeof(int));
+    int *counts = bat_arena_alloc(&arena, (size_t)size * sizeof(int));
+    int *displs = bat_arena_alloc(&arena, (size_t)size * sizeof(int));
+    if (bat_hd_pop_create(&pop, &arena, n_bats, dim) != 0
+        || bat_cc_create(&cc, &arena, opts->cc_kind, dim, n_bats, opts->cc_size, (uint32_t)args->seed) != 0
+        || bat_cc_scratch_create(&scratch, &arena, &cc) != 0 || !glo || !ghi || !plo || !phi || !counts || !displs) {
+        MPI_Abort(MPI_COMM_WORLD, 1);
+    }
+    for (int i = 0; i < n_bats; i++) bat_hd_init_bat(&pop, i, (uint32_t)args->seed);
+    bat_hd_select_best(&pop);
+
+    bat_signal_install();
+    int iters_done = max_iters;
+    long evals = rank == 0 ? n_bats : 0;
+    long evals_to_target = -1;
+    BatCounters cnt = {0};
+    BatCounters merge_cnt = {0};
+
+    MPI_Barrier(MPI_COMM_WORLD);
+    double t0 = MPI_Wtime();
+
+    for (int t = 0, round = 0; t < max_iters; t += opts->cc_iters, round++) {
+        int len = max_iters - t < opts->cc_iters ? max_iters - t : opts->cc_iters;
+        long dg = bat_cc_regroup(&cc, &scratch, round);
+        if (rank == 0) evals += dg;
+
+        for (int r = 0; r < size; r++) {
+            int first, count;
+            block_range(cc.n_groups, size, r, &first, &count);
+            glo[r] = first;
+            ghi[r] = first + count;
+            plo[r] = cc.start[first];
+            phi[r] = cc.start[first + count];
+        }
+        bat_cc_pack(&cc, &pop, 0, n_bats);
+        for (int g = glo[rank]; g < ghi[rank]; g++) evals += bat_cc_run_group(&cc, &pop, &scratch, g, t, len, &cnt);
+
+        allgather_ranges(cc.xb, plo, phi, (size_t)n_bats * sizeof(bat_real), size, counts, displs);
+        allgather_ranges(cc.vb, plo, phi, (size_t)n_bats * sizeof(bat_real), size, counts, displs);
+        allgather_ranges(cc.guide, plo, phi, sizeof(bat_real), size, counts, displs);
+        allgather_ranges(cc.bat, glo, ghi, (size_t)n_bats * sizeof(BatHdBat), size, counts, displs);
+        allgather_ranges(cc.guide_f, glo, ghi, sizeof(double), size, counts, displs);
+        allgather_ranges(cc.base_f, glo, ghi, sizeof(double), size, counts, displs);
+        bat_cc_unpack(&cc, &pop, 0, n_bats);
+        long merged = bat_cc_merge(&cc, &pop, &scratch, &merge_cnt);
+        if (rank == 0) evals += merged;
+        iters_done = t + len;
+
+        if (!args->quiet && rank == 0 && round % 10 == 0) {
+            printf("[Iter %d] Global best = %f\n", t, pop.best_f);
+        }
+        if (opts->has_target && pop.best_f >= opts->target) {
+            evals_to_target = evals;
+            break;
+        }
+        /* One SIGUSR2 poll per round (a round already ends with collectives). */
+        int local_sig = bat_signal_take(), sig = 0;
+        MPI_Allreduce(&local_sig, &sig, 1, MPI_INT, MPI_BOR, MPI_COMM_WORLD);
+        if (sig & BAT_SIG_EXIT) {
+            if (rank == 0) fprintf(stderr, "SIGUSR2: stopping after iteration %d\n", iters_done - 1);
+            break;
+        }
+    }
+
+    MPI_Barrier(MPI_COMM_WORLD);
+    double local_elapsed = MPI_Wtime() - t0, elapsed = 0.0;
+    MPI_Reduce(&local_elapsed, &elapsed, 1, MPI_DOUBLE, MPI_MAX, 0, MPI_COMM_WORLD);
+
+    if (rank == 0) cnt.best_changes += merge_cnt.best_changes;
+    long total_evals = 0, total_evals_to_target = 0;
+    MPI_Reduce(&evals, &total_evals, 1, MPI_LONG, MPI_SUM, 0, MPI_COMM_WORLD);
+    MPI_Reduce(&evals_to_target, &total_evals_to_target, 1, MPI_LONG, MPI_SUM, 0, MPI_COMM_WORLD);
+    if (evals_to_target < 0) total_evals_to_target = -1;
+    BatCounters total_cnt = {0};
+    MPI_Reduce(&cnt, &total_cnt, BAT_COUNTERS_N, MPI_LONG, MPI_SUM, 0, MPI_COMM_WORLD);
+
+    if (rank == 0) {
+        if (!args->quiet) {
+            printf("\nFinal best f_value = %f (context of %d groups, %d coordinates)\n", pop.best_f, cc.n_groups,
+                   dim);
+        }
+        printf("BENCH version=mpi n_bats=%d iters=%d procs=%d threads=1 time_s=%.6f evals=%ld",
+               n_bats, iters_done, size, elapsed, total_evals);
+        bat_counters_print_bench(&total_cnt);
+        printf(" best_f=%.17g", pop.best_f);
+        bat_options_print_bench(opts);
+        bat_arena_print_bench(&arena);
+        bat_bind_print_bench(opts->bind, all_where, size);
+        bat_cc_print_bench(&cc, opts->cc_iters);
+        if (opts->has_target) {
+            printf(" target=%g hit=%d evals_to_target=%ld", opts->target, total_evals_to_target >= 0,
+                   total_evals_to_target);
+        }
+        if (args->bench_extra) printf("%s", args->bench_extra);
+        printf("\n");
+    }
+
+    bat_arena_destroy(&arena);
+    free(all_where);
+    return 0;
+}
+
+/*
+ * Offers of every rank to the archive: the non-dominated points of the
+ * local bats, gathered after the archive points on every rank (in rank
+ * order), then merged. The filtered union does not depend on the split,
+ * so every rank keeps the sequential archive. Returns the number of
+ * offers the archive kept.
+ *
+ * Parameters:
+ *   - arch       : archive (same on every rank)
+ *   - local_bats : bats owned by this rank
+ *   - local_n    : number of local bats
+ *   - local_pts  : scratch of local_n points
+ *   - counts     : scratch of `size` ints
+ *   - displs     : scratch of `size` ints
+ */
+static int mo_merge_ranks(BatMoArchive *arch, const Bat local_bats[], int local_n, BatMoPoint local_pts[],
+                           int size, int *counts, int *displs) {
+    int kept = bat_mo_collect(local_bats, local_n, local_pts);
+    int bytes = kept * (int)sizeof(BatMoPoint);
+    MPI_Allgather(&bytes, 1, MPI_INT, counts, 1, MPI_INT, MPI_COMM_WORLD);
+    int total = 0;
+    for (int r = 0; r < size; r++) {
+        displs[r] = total;
+        total += counts[r];
+    }
+    MPI_Allgatherv(local_pts, bytes, MPI_BYTE, arch->pt + arch->n, counts, displs, MPI_BYTE, MPI_COMM_WORLD);
+    return bat_mo_merge(arch, total / (int)sizeof(BatMoPoint));
+}
+
+/*
+ * Multi-objective run (--mo-objective, see bat_mo.h).
+ *
+ * - Every rank owns a block of bats and holds the whole archive; the
+ *   guides are drawn from it with the bats' own RNG.
+ * - After each iteration the ranks exchange the non-dominated points of
+ *   their bats and all merge the same union (mo_merge_ranks()): the result
+ *   is the sequential one for any number of processes.
+ *
+ * Parameters:
+ *   - args : parsed command line
+ *   - opts : checked and applied options
+ *   - rank : rank of this process
+ *   - size : number of processes
+ */
+static int run_mo(const BatArgs *args, const BatOptions *opts, int rank, int size) {
+    int n_bats = args->n_bats, max_iters = args->max_iters;
+    int first, local_n;
+    block_range(n_bats, size, rank, &first, &local_n);
+
+    BatBindSlot *all_where = bind_rank(opts, rank, size);
+
+    /* Split population: one dump file per rank. */
+    size_t arena_bytes = bat_arena_need((size_t)local_n * sizeof(Bat))
+                       + bat_arena_need((size_t)local_n * sizeof(BatMoPoint)) + bat_mo_bytes(opts->mo_archive, n_bats) + 2 * bat_arena_need((size_t)size * sizeof(int));
+    BatModeRun run;
+    if (bat_mode_begin(&run, args, arena_bytes, all_where, size, rank, size, size) != 0) MPI_Abort(MPI_COMM_WORLD, 1);
+    Bat *local_bats = bat_arena_alloc(&run.arena, (size_t)local_n * sizeof(Bat));
+    BatMoPoint *local_pts = bat_arena_alloc(&run.arena, (size_t)local_n * sizeof(BatMoPoint));
+    int *counts = bat_arena_alloc(&run.arena, (size_t)size * sizeof(int));
+    int *displs = bat_arena_alloc(&run.arena, (size_t)size * sizeof(int));
+    BatMoArchive arch;
+    BatInitPlan plan;
+    if ((local_n > 0 && (!local_bats || !local_pts)) || !counts || !displs
+        || bat_mo_create(&arch, &run.arena, opts->mo_archive, n_bats) != 0
+        || bat_init_plan_create(&plan, opts->init_kind, 0, n_bats, (uint32_t)args->seed) != 0) {
+        MPI_Abort(MPI_COMM_WORLD, 1);
+    }
+    for (int i = 0; i < local_n; i++) bat_init_one(&plan, &local_bats[i], first + i);
+    bat_init_plan_free(&plan);
+    mo_merge_ranks(&arch, local_bats, local_n, local_pts, size, counts, displs);
+    double worst_local[BAT_MO_MAX], worst[BAT_MO_MAX];
+    bat_mo_worst(local_bats, local_n, worst_local);
+    MPI_Allreduce(worst_local, worst, BAT_MO_MAX, MPI_DOUBLE, MPI_MIN, MPI_COMM_WORLD);
+    bat_mo_set_ref(&arch, worst);
+
+    long evals = local_n;
+    BatCounters cnt = {0};
+
+    MPI_Barrier(MPI_COMM_WORLD);
+    double t0 = MPI_Wtime();
+
+    for (int t = 0; t < max_iters; t++) {
+        BatExactSum loud_local, loud_sum;
+        bat_xsum_clear(&loud_local);
+        bat_loudness_sum(local_bats, local_n, &loud_local);
+        MPI_Allreduce(loud_local.bin, loud_sum.bin, BAT_XSUM_BINS, MPI_INT64_T, MPI_SUM, MPI_COMM_WORLD);
+        double A_mean = bat_xsum_value(&loud_sum) / (double)n_bats;
+        cnt.amean_calls++;
+        cnt.amean_scanned += local_n;
+
+        for (int i = 0; i < local_n; i++) {
+            Bat leader;
+            bat_mo_leader(&arch, &local_bats[i].rng_state, &leader);
+            evals += update_bat(&local_bats[i], &leader, A_mean, t, &cnt);
+        }
+        /* Every rank merges the same union: count the change once. */
+        if (mo_merge_ranks(&arch, local_bats, local_n, local_pts, size, counts, displs) > 0 && rank == 0) {
+            cnt.best_changes++;
+        }
+
+        if (!args->quiet && rank == 0 && t % 100 == 0) {
+            printf("[Iter %d] Pareto front = %d points\n", t, arch.n);
+        }
+        int local_sig = bat_signal_take(), sig = 0;
+        MPI_Allreduce(&local_sig, &sig, 1, MPI_INT, MPI_BOR, MPI_COMM_WORLD);
+        if (sig) {
+            Bat best;
+            bat_mo_best(&arch, &best);
+            if (bat_mode_signals(&run, sig, t, local_bats, local_n, &best)) break;
+        }
+    }
+
+    MPI_Barrier(MPI_COMM_WORLD);
+    double local_elapsed = MPI_Wtime() - t0, elapsed = 0.0;
+    MPI_Reduce(&local_elapsed, &elapsed, 1, MPI_DOUBLE, MPI_MAX, 0, MPI_COMM_WORLD);
+
+    long total_evals = 0;
+    MPI_Reduce(&evals, &total_evals, 1, MPI_LONG, MPI_SUM, 0, MPI_COMM_WORLD);
+    BatCounters total_cnt = {0};
+    MPI_Reduce(&cnt, &total_cnt, BAT_COUNTERS_N, MPI_LONG, MPI_SUM, 0, MPI_COMM_WORLD);
+
+    int rc = 0;
+    if (rank == 0) {
+        if (!args->quiet) {
+            printf("\nFinal Pareto front = %d points (%d objectives)\n", arch.n, bat_mo.n);
+        }
+        bat_mode_print_bench(&run, args, "mpi", 1, elapsed, total_evals, &total_cnt, arch.pt[0].f[0]);
+        bat_mo_print_bench(&arch);
+        bat_mode_end_bench(args);
+        rc = opts->mo_front_path && bat_mo_write_front(&arch, opts->mo_front_path) != 0;
+    }
+
+    bat_mode_end(&run);
+    return rc;
+}
+
+/*
+ * Niching run (--niche-radius, see bat_niche.h).
+ *
+ * - Every rank holds the whole population and updates one block of it;
+ *   the blocks are exchanged with one MPI_Allgatherv per iteration.
+ * - The speciation and the niche bests are replicated: every rank splits
+ *   the same population, so the result is the sequential one for any
+ *   number of processes. The evaluation count of each iteration is summed
+ *   over the ranks for the records of the niche bests.
+ *
+ * Parameters:
+ *   - args : parsed command line
+ *   - opts : checked and applied options
+ *   - rank : rank of this process
+ *   - size : number of processes
+ */
+static int run_niche(const BatArgs *args, const BatOptions *opts, int rank, int size) {
+    int n_bats = args->n_bats, max_iters = args->max_iters;
+
+    BatBindSlot *all_where = bind_rank(opts, rank, size);
+
+    /* Replicated population: rank 0 writes the dumps. */
+    size_t arena_bytes = bat_arena_need((size_t)n_bats * sizeof(Bat)) + bat_niche_bytes(n_bats, opts->niche_max)
+                       + 4 * bat_arena_need((size_t)size * sizeof(int));
+    BatModeRun run;
+    if (bat_mode_begin(&run, args, arena_bytes, all_where, size, rank, size, 1) != 0) MPI_Abort(MPI_COMM_WORLD, 1);
+    Bat *bats = bat_arena_alloc(&run.arena, (size_t)n_bats * sizeof(Bat));
+    int *lo = bat_arena_alloc(&run.arena, (size_t)size * sizeof(int));
+    int *hi = bat_arena_alloc(&run.arena, (size_t)size * sizeof(int));
+    int *counts = bat_arena_alloc(&run.arena, (size_t)size * sizeof(int));
+    int *displs = bat_arena_alloc(&run.arena, (size_t)size * sizeof(int));
+    BatNiche niche;
+    BatInitPlan plan;
+    if (!bats || !lo || !hi || !counts || !displs
+        || bat_niche_create(&niche, &run.arena, n_bats, opts->niche_max, opts->niche_radius) != 0
+        || bat_init_plan_create(&plan, opts->init_kind, opts->init_obl, n_bats, (uint32_t)args->seed) != 0) {
+        MPI_Abort(MPI_COMM_WORLD, 1);
+    }
+    for (int r = 0; r < size; r++) {
+        int first, count;
+        block_range(n_bats, size, r, &first, &count);
+        lo[r] = first;
+        hi[r] = first + count;
+    }
+    for (int i = 0; i < n_bats; i++) bat_init_one(&plan, &bats[i], i);
+    bat_init_plan_free(&plan);
+
+    long evals = (long)n_bats * (opts->init_obl ? 2 : 1);
+    BatCounters cnt = {0};
+
+    MPI_Barrier(MPI_COMM_WORLD);
+    double t0 = MPI_Wtime();
+    bat_niche_speciate(&niche, bats);
+    bat_niche_record(&niche, 0, evals, 0.0);
+
+    for (int t = 0; t < max_iters; t++) {
+        double A_mean = bat_mean_loudness(bats, n_bats);
+        cnt.amean_calls++;
+        cnt.amean_scanned += n_bats;
+
+        long local_evals = 0, iter_evals = 0;
+        for (int i = lo[rank]; i < hi[rank]; i++) {
+            local_evals += update_bat(&bats[i], &niche.guide[niche.species[i]], A_mean, t, &cnt);
+        }
+        allgather_ranges(bats, lo, hi, sizeof(Bat), size, counts, displs);
+        MPI_Allreduce(&local_evals, &iter_evals, 1, MPI_LONG, MPI_SUM, MPI_COMM_WORLD);
+        evals += iter_evals;
+        double prev_best_f = niche.guide[0].f_value;
+        bat_niche_speciate(&niche, bats);
+        /* Every rank speciates the same gathered population: count the change once. */
+        if (rank == 0 && niche.guide[0].f_value > prev_best_f) cnt.best_changes++;
+        bat_niche_record(&niche, t + 1, evals, MPI_Wtime() - t0);
+
+        if (!args->quiet && rank == 0 && t % 100 == 0) {
+            printf("[Iter %d] Species = %d  Best f_value = %f\n", t, niche.n_species, niche.guide[0].f_value);
+        }
+        int local_sig = bat_signal_take(), sig = 0;
+        MPI_Allreduce(&local_sig, &sig, 1, MPI_INT, MPI_BOR, MPI_COMM_WORLD);
+        if (sig && bat_mode_signals(&run, sig, t, bats, n_bats, &niche.guide[0])) break;
+    }
+
+    MPI_Barrier(MPI_COMM_WORLD);
+    double local_elapsed = MPI_Wtime() - t0, elapsed = 0.0;
+    MPI_Reduce(&local_elapsed, &elapsed, 1, MPI_DOUBLE, MPI_MAX, 0, MPI_COMM_WORLD);
+
+    BatCounters total_cnt = {0};
+    MPI_Reduce(&cnt, &total_cnt, BAT_COUNTERS_N, MPI_LONG, MPI_SUM, 0, MPI_COMM_WORLD);
+
+    if (rank == 0) {
+        bat_niche_report(&niche);
+        bat_mode_print_bench(&run, args, "mpi", 1, elapsed, evals, &total_cnt, niche.found[0].f);
+        bat_niche_print_bench(&niche);
+        bat_mode_end_bench(args);
+    }
+
+    bat_mode_end(&run);
+    return 0;
+}
+
+/*
+ * MPI back-end (see bat_cli.h). MPI must be initialized by the caller.
+ *
+ * Parameters:
+ *   - args : parsed command line (same on all processes)
+ */
+int bat_run_mpi(const BatArgs *args) {
 
-    /* Initialize the MPI environment */
-    MPI_Init(&argc, &argv);
     /* Get the rank of the current process and the total number of processes */
     int rank, size;
     MPI_Comm_rank(MPI_COMM_WORLD, &rank);
     MPI_Comm_size(MPI_COMM_WORLD, &size);
 
-    int n_bats, max_iters;
-    int quiet;
-    unsigned int seed;
-   /* Parse command-line arguments (same on all processes) */
-    parse_args(argc, argv, &n_bats, &max_iters, &seed, &quiet);
-   
+    int n_bats = args->n_bats, max_iters = args->max_iters;
+    int quiet = args->quiet;
+    unsigned int seed = args->seed;
+    BatOptions opts = args->opts;
+
     /* Check input parameters */
     if (n_bats <= 0 || max_iters <= 0) {
         if (rank == 0) {
             fprintf(stderr, "Invalid parameters: n_bats=%d iters=%d\n", n_bats, max_iters);
         }
-        MPI_Finalize();
         return 1;
     }
+    /*
+     * bat_options_check() prints its own reason. Rank 0 checks first; the
+     * others check only if it passed (--isa support can differ between
+     * nodes), so a reason is printed once, plus once per rank that disagrees.
+     */
+    int opts_bad = rank == 0 ? bat_options_check(&opts) != 0 : 0, any_bad = 0;
+    MPI_Bcast(&opts_bad, 1, MPI_INT, 0, MPI_COMM_WORLD);
+    if (!opts_bad && rank != 0) opts_bad = bat_options_check(&opts) != 0;
+    MPI_Allreduce(&opts_bad, &any_bad, 1, MPI_INT, MPI_MAX, MPI_COMM_WORLD);
+    if (any_bad) {
+        return 1;
+    }
+    bat_options_apply(&opts);
+    if (opts.n_mo > 0) return run_mo(args, &opts, rank, size);
+    if (opts.niche_radius > 0.0) return run_niche(args, &opts, rank, size);
+    if (opts.cc_kind != BAT_CC_NONE) return run_cc(args, &opts, rank, size);
+    if (opts.hd_dim > 0) return run_hd(args, &opts, rank, size);
+
+    /*
+     * --deadline: rank 0 owns the clock and decides for everybody (one
+     * MPI_Bcast per iteration), so all ranks stop at the same iteration.
+     * The budget covers initialization and distribution too.
+     */
+    BatDeadline deadline;
+    int use_deadline = opts.deadline_ms > 0.0;
+    if (use_deadline) bat_deadline_start(&deadline, opts.deadline_ms);
 
    /* Require an equal number of bats per process */
     if (n_bats % size != 0) {
@@ -70,117 +1156,277 @@ int main(int argc, char *argv[]) {
             printf("N_BATS must be divisible by number of processes\n");
             printf("Hint: choose --n-bats divisible by procs (n_bats=%d, procs=%d)\n", n_bats, size);
         }
-        MPI_Finalize();
         return 0;
     }
    
     /* Number of bats handled by each process */
     int local_n = n_bats / size;
 
-    /* Local and global bat storage */
-    Bat *all_bats = NULL;     /* full population (on rank 0) */
-    Bat local_bats[local_n];  /* bats handled by this process */
-   
-    /* Best bat on this process and best bat globally */
-    Bat local_best, global_best;
+    /* --bind: pin this rank before its slice is touched. */
+    BatBindSlot *all_where = bind_rank(&opts, rank, size);
 
-    /* Rank 0 allocates and initializes the full bat population */
-    if (rank == 0) {
-        /* Rank 0 creates and initializes the full population */
-        all_bats = malloc((size_t)n_bats * sizeof(Bat));
-        initialize_bats_seeded(all_bats, n_bats, &global_best, (uint32_t)seed);
+    /*
+     * Bats handled by this process, the spare buffer of the dump writer and
+     * the scratch space of --shrink, in one arena reserved up front
+     * (--hugepages). The slice has room for the largest ipop population
+     * (explicit huge pages for the initial slice only), so nothing is
+     * allocated in the loop.
+     */
+    int max_bats = bat_options_max_bats(&opts, n_bats);
+    int local_cap = max_bats / size;
+    size_t arena_bytes = bat_arena_need((size_t)local_cap * sizeof(Bat)) + bat_dump_writer_bytes(local_cap);
+    if (opts.shrink_kind != BAT_SHRINK_NONE) arena_bytes += shrink_scratch_bytes(n_bats, local_n, size);
+    BatArena arena;
+    if (bat_arena_create_hot(&arena, arena_bytes, bat_arena_need((size_t)local_n * sizeof(Bat)), opts.pages) != 0) {
+        MPI_Abort(MPI_COMM_WORLD, 1);
     }
+    Bat *local_bats = bat_arena_alloc(&arena, (size_t)local_cap * sizeof(Bat));
 
-    /* Distribute the population evenly: each rank receives local_n bats */
-    MPI_Scatter(
-        all_bats,
-        local_n * sizeof(Bat),
-        MPI_BYTE,
-        local_bats,
-        local_n * sizeof(Bat),
-        MPI_BYTE,
-        0,
-        MPI_COMM_WORLD
-    );
+    /* Best bat globally (same on every rank) */
+    Bat global_best;
+
+    /*
+     * Each rank builds its own slice [rank*local_n, (rank+1)*local_n) of the
+     * population. Initialization strategies are index-addressable, so the
+     * slices are identical to what a single process would generate, and no
+     * MPI_Scatter of the full population is needed.
+     */
+    BatInitPlan plan;
+    int plan_ok = bat_init_plan_create(&plan, opts.init_kind, opts.init_obl, n_bats, (uint32_t)seed) == 0;
+    if (!plan_ok) {
+        bat_arena_destroy(&arena);
+        return 1;
+    }
+    for (int i = 0; i < local_n; i++) {
+        bat_init_one(&plan, &local_bats[i], rank * local_n + i);
+    }
+    bat_init_plan_free(&plan);
+    reduce_global_best(local_bats, local_n, rank, &global_best);
+
+    /* --constraint: epsilon level from the violations of all ranks, ranks under it. */
+    if (bat_con.n > 0) {
+        BatExactSum viol_local, viol;
+        bat_con_violation_sum(local_bats, local_n, &viol_local);
+        MPI_Allreduce(viol_local.bin, viol.bin, BAT_XSUM_BINS, MPI_INT64_T, MPI_SUM, MPI_COMM_WORLD);
+        bat_con_start(&viol, n_bats, max_iters);
+        bat_con_rerank(local_bats, local_n);
+        reduce_global_best(local_bats, local_n, rank, &global_best);
+    }
+
+    /*
+     * --restart: every rank tracks the diversity sums of its own slice
+     * around the same reference point (the global best), and the sums are
+     * added with one small MPI_Allreduce per iteration. All ranks then see
+     * the same diversity and restart at the same iteration. The archive
+     * (best bat over all restarts) is identical on all ranks too.
+     */
+    int use_restart = opts.restart_kind != BAT_RESTART_NONE;
+    int n_bats_init = n_bats;
+    BatRestart restart;
+    bat_restart_init(&restart, opts.restart_kind, opts.restart_div, opts.restart_frac, opts.restart_grow,
+                     max_bats, opts.restart_gap,
+                     opts.restart_stall, &global_best);
+    BatDiversity local_div, div;
+    bat_diversity_reset(&local_div, local_bats, local_n, global_best.x_i);
+    div = local_div;
+
+    /* SIGUSR1 = background dump (writer started before the loop), SIGUSR2 = checkpoint and exit (per rank). */
+    bat_signal_install();
+    int iters_done = max_iters;
+    int signal_stop = 0;   /* the loop ended on SIGUSR2 */
+
+    /* --refine statistics (rank 0 does the refinements). */
+    long refine_evals = 0;
+    int refine_hits = 0;
+
+    /*
+     * Objective evaluations done by this rank (initialization included).
+     * The global best is identical on all ranks, so every rank reaches
+     * --target at the same iteration; the counts are summed at the end.
+     */
+    long evals = (long)local_n * (opts.init_obl ? 2 : 1);
+    long evals_to_target = -1;
+
+    /* Behavior counters of this rank (summed on rank 0 at the end). */
+    BatCounters cnt = {0};
+
+    /* --trace: rank 0 writes the global best of every iteration. */
+    FILE *trace = NULL;
+    if (rank == 0 && opts.trace_path && !(trace = bat_trace_open(opts.trace_path))) {
+        MPI_Abort(MPI_COMM_WORLD, 1);
+    }
 
     /* Synchronize all ranks before starting the timed parallel section */
+    BatDumpWriter *writer = bat_dump_writer_create(&arena, local_cap);
+
     MPI_Barrier(MPI_COMM_WORLD);
     double t0 = MPI_Wtime();
+    if (use_deadline) bat_deadline_loop_start(&deadline);
+
+    /*
+     * --targets: every rank sees the same global best, so all ranks reach a
+     * target at the same iteration; each records its own evaluations and
+     * clock, and the records are combined (sum / max) at the end.
+     */
+    BatTimeToTarget ttt = opts.ttt;
+    bat_ttt_start(&ttt, bat_objective_optimum(opts.objective));
+    bat_ttt_update(&ttt, global_best.f_value, evals, 0.0);
 
     /* Main loop  */
     for (int t = 0; t < max_iters; t++) {
 
-        /* Update the bats owned by this rank */
-        for (int i = 0; i < local_n; i++) {
-            update_bat(local_bats, local_n, &global_best, i, t);
+        /*
+         * --constraint: epsilon level / penalty weight of this iteration.
+         * Every rank decides from the same global best, so all re-rank
+         * together.
+         */
+        if (bat_con.n > 0 && bat_con_advance(t, &global_best)) {
+            bat_con_rerank(local_bats, local_n);
+            bat_con_rerank(&restart.archive, 1);
+            reduce_global_best(local_bats, local_n, rank, &global_best);
+            bat_restart_archive(&restart, &global_best);
         }
 
-        /* Determine the best bat on this rank */
-        local_best = local_bats[0];
-        for (int i = 1; i < local_n; i++) {
-            if (local_bats[i].f_value > local_best.f_value) {
-                local_best = local_bats[i];
+        /*
+         * Periodic local refinement (--refine): rank 0 polishes the global
+         * best while the other ranks already update their bats. The refined
+         * point replaces rank 0's worst bat, so the MAXLOC reduction below
+         * propagates it if it is the new global best.
+         */
+        if (rank == 0 && opts.refine_method != BAT_REFINE_NONE && (t + 1) % opts.refine_every == 0) {
+            double x[dimension];
+            double f_x = global_best.f_value;
+            for (int d = 0; d < dimension; d++) x[d] = global_best.x_i[d];
+            int used = bat_refine(opts.refine_method, x, &f_x, opts.refine_evals, opts.refine_step);
+            refine_evals += used;
+            evals += used;
+            if (f_x > global_best.f_value) {
+                bat_inject(local_bats, local_n, x, f_x);
+                refine_hits++;
+                if (use_restart) bat_diversity_reset(&local_div, local_bats, local_n, local_div.ref);
             }
         }
 
-       
-        /* Global best computation  
-         *
-         * Goal:
-         * After each iteration, every rank has its own local_best.
-         * We need to determine which rank owns the best solution overall
-         * and make this solution available to all ranks.
-         *
-         * Step 1:
-         * Reduce only the objective value (f_value) together with the rank.
-         * We cannot directly reduce a Bat structure, so we use MPI_MAXLOC
-         * on a (value, rank) pair.
+        /*
+         * Average loudness of the whole population at the start of the
+         * iteration. The exact partial sums add up to the same value in any
+         * order, so every rank count reproduces the sequential A_mean.
          */
-        struct {
-            double value;
-            int rank;
-        } local_data, global_data;
-       
-        /* Prepare local contribution: best score on this rank */
-        local_data.value = local_best.f_value;
-        local_data.rank  = rank;
-       
-        /* Find the maximum objective value and the rank that owns it */
-        MPI_Allreduce(
-            &local_data,
-            &global_data,
-            1,
-            MPI_DOUBLE_INT,
-            MPI_MAXLOC,
-            MPI_COMM_WORLD
-        );
+        BatExactSum loud_local, loud_sum;
+        bat_xsum_clear(&loud_local);
+        bat_loudness_sum(local_bats, local_n, &loud_local);
+        MPI_Allreduce(loud_local.bin, loud_sum.bin, BAT_XSUM_BINS, MPI_INT64_T, MPI_SUM, MPI_COMM_WORLD);
+        double A_mean = bat_xsum_value(&loud_sum) / (double)n_bats;
+        cnt.amean_calls++;
+        cnt.amean_scanned += local_n;
+
+        /* Update the bats owned by this rank */
+        for (int i = 0; i < local_n; i++) {
+            evals += update_bat_tracked(&local_bats[i], &global_best, A_mean, t - restart.t_last, &cnt,
+                                        use_restart ? &local_div : NULL);
+        }
+
+        /* Find the global best and share it with every rank (counted once, on rank 0) */
+        double prev_best_f = global_best.f_value;
+        reduce_global_best(local_bats, local_n, rank, &global_best);
+        if (rank == 0 && global_best.f_value > prev_best_f) cnt.best_changes++;
+        bat_restart_archive(&restart, &global_best);
+
+        /* --restart: re-initialize the population once it has collapsed. */
+        if (use_restart) {
+            if ((t + 1) % BAT_DIVERSITY_RESYNC == 0) {
+                bat_diversity_reset(&local_div, local_bats, local_n, global_best.x_i);
+            }
+            /* sum[], sum_sq[] and n are contiguous doubles: one reduction. */
+            div = local_div;
+            MPI_Allreduce(local_div.sum, div.sum, 2 * dimension + 1, MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD);
+
+            if (bat_restart_due(&restart, bat_diversity_value(&div), t)) {
+                int new_n = bat_restart_next_size(&restart, n_bats, size);
+                if (new_n > n_bats) {   /* the arena holds local_cap bats per rank */
+                    n_bats = new_n;
+                    local_n = n_bats / size;
+                }
+                long used = bat_restart_apply(&restart, local_bats, local_n, rank * local_n, n_bats,
+                                              opts.init_kind, opts.init_obl, (uint32_t)seed, t);
+                if (used > 0) evals += used;
+                /* The new population is guided by its own best, not by the archive. */
+                reduce_global_best(local_bats, local_n, rank, &global_best);
+                bat_restart_archive(&restart, &global_best);
+                bat_diversity_reset(&local_div, local_bats, local_n, global_best.x_i);
+            }
+        }
 
         /*
-         * Step 2:
-         * Now all ranks know which rank owns the global best solution.
-         * That rank copies its local_best into global_best.
+         * --shrink: the worst bats are chosen over the whole population,
+         * each rank drops its own, then bats migrate between ranks so the
+         * slices stay balanced and every rank's cost falls at the same rate.
+         * Every rank keeps at least one bat.
          */
-        if (rank == global_data.rank) {
-            global_best = local_best;
+        if (opts.shrink_kind != BAT_SHRINK_NONE) {
+            int shrink_min = opts.shrink_min > size ? opts.shrink_min : size;
+            int target_n = bat_shrink_target(opts.shrink_kind, n_bats_init, shrink_min, t + 1, max_iters);
+            if (target_n < n_bats) {
+                local_n = shrink_global(local_bats, local_n, n_bats - target_n, rank, size, &arena);
+                local_n = rebalance_bats(local_bats, local_n, rank, size, &arena);
+                n_bats = target_n;
+            }
         }
+
+        if (trace) bat_trace_write(trace, t, &global_best);
+
         /*
-         * Step 3:
-         * Broadcast the full global_best structure from the owning rank
-         * so that all ranks use the same global best in the next iteration.
+         * Signal requests.
+         * A signal may reach the ranks at slightly different times, so the
+         * flags are OR-reduced every BAT_SIGNAL_POLL_ITERS iterations: all
+         * ranks then act on the same iteration and the per-rank files form
+         * one consistent snapshot.
          */
-        MPI_Bcast(
-            &global_best,
-            sizeof(Bat),
-            MPI_BYTE,
-            global_data.rank,
-            MPI_COMM_WORLD
-        );
+        if ((t + 1) % BAT_SIGNAL_POLL_ITERS == 0
+            && serve_signals(writer, local_bats, local_n, &restart.archive, t, (uint32_t)seed, rank, size)) {
+            iters_done = t + 1;
+            signal_stop = 1;
+            break;
+        }
+
         /* Periodic progress output (only on rank 0) */
         if (!quiet && rank == 0 && t % 1000 == 0) {
-            printf("[Iter %d] Global best = %f\n", t, global_best.f_value);
+            printf("[Iter %d] Global best = %f\n", t, restart.archive.f_value);
+        }
+
+        /* --target: stop as soon as the best reaches the target value. */
+        if (opts.has_target && restart.archive.f_value >= opts.target) {
+            evals_to_target = evals;
+            iters_done = t + 1;
+            break;
+        }
+
+        /* --targets: record the targets reached, stop after the last one. */
+        if (ttt.n > 0 && bat_ttt_update(&ttt, restart.archive.f_value, evals, MPI_Wtime() - t0)) {
+            iters_done = t + 1;
+            break;
+        }
+
+        /* Stop early when the next iteration would not fit in the budget. */
+        if (use_deadline) {
+            int go_on = (rank == 0) ? bat_deadline_next(&deadline) : 0;
+            MPI_Bcast(&go_on, 1, MPI_INT, 0, MPI_COMM_WORLD);
+            if (!go_on) {
+                iters_done = t + 1;
+                break;
+            }
         }
     }
 
+    /*
+     * Every rank leaves the loop after the same iteration: serve the
+     * signals of the last partial poll window (or of a run shorter than
+     * one window).
+     */
+    if (!signal_stop) {
+        serve_signals(writer, local_bats, local_n, &restart.archive, iters_done - 1, (uint32_t)seed, rank, size);
+    }
+
     /* Synchronize all ranks before stopping the timer */
     MPI_Barrier(MPI_COMM_WORLD);
     double t1 = MPI_Wtime();
@@ -191,24 +1437,92 @@ int main(int argc, char *argv[]) {
     /* Compute the global execution time (maximum over all ranks) */
     double elapsed = 0.0;
     MPI_Reduce(&local_elapsed, &elapsed, 1, MPI_DOUBLE, MPI_MAX, 0, MPI_COMM_WORLD);
+
+    /* Let an in-flight background dump finish before exiting. */
+    bat_dump_writer_destroy(writer);
+
+    if (trace) fclose(trace);
+    if (opts.final_pop_path) {
+        write_global_population(opts.final_pop_path, local_bats, local_n, &restart.archive, iters_done,
+                                (uint32_t)seed, rank, size);
+    }
+
+    /* Total evaluations over all ranks. */
+    long total_evals = 0, total_evals_to_target = 0;
+    MPI_Reduce(&evals, &total_evals, 1, MPI_LONG, MPI_SUM, 0, MPI_COMM_WORLD);
+    MPI_Reduce(&evals_to_target, &total_evals_to_target, 1, MPI_LONG, MPI_SUM, 0, MPI_COMM_WORLD);
+    if (evals_to_target < 0) total_evals_to_target = -1;
+    BatCounters total_cnt = {0};
+    MPI_Reduce(&cnt, &total_cnt, BAT_COUNTERS_N, MPI_LONG, MPI_SUM, 0, MPI_COMM_WORLD);
+
+    /* Time-to-target: evaluations summed over ranks, slowest rank's clock. */
+    if (ttt.n > 0) {
+        long ttt_evals[BAT_TTT_MAX];
+        double ttt_secs[BAT_TTT_MAX];
+        MPI_Reduce(ttt.evals, ttt_evals, ttt.n, MPI_LONG, MPI_SUM, 0, MPI_COMM_WORLD);
+        MPI_Reduce(ttt.secs, ttt_secs, ttt.n, MPI_DOUBLE, MPI_MAX, 0, MPI_COMM_WORLD);
+        for (int k = 0; k < ttt.n; k++) {
+            if (ttt.evals[k] >= 0) {
+                ttt.evals[k] = ttt_evals[k];
+                ttt.secs[k] = ttt_secs[k];
+            }
+        }
+    }
    
     /* Final output and benchmark report (rank 0 only) */
     if (rank == 0) {
+        if (use_deadline) bat_deadline_finish(&deadline);
         if (!quiet) {
-            printf("\nFinal best f_value = %f\n", global_best.f_value);
+            printf("\nFinal best f_value = %f\n", restart.archive.f_value);
             printf("Final position = (");
             for (int d = 0; d < dimension; d++) {
-                printf("%s%f", d == 0 ? "" : ", ", global_best.x_i[d]);
+                printf("%s%f", d == 0 ? "" : ", ", restart.archive.x_i[d]);
             }
             printf(")\n");
         }
          /* Machine-readable benchmark line */
-         printf("BENCH version=mpi n_bats=%d iters=%d procs=%d threads=1 time_s=%.6f\n",
-             n_bats, max_iters, size, elapsed);
-        /* Free global population allocated on rank 0 */
-        free(all_bats);
+         printf("BENCH version=mpi n_bats=%d iters=%d procs=%d threads=1 time_s=%.6f evals=%ld",
+             n_bats_init, iters_done, size, elapsed, total_evals);
+         bat_counters_print_bench(&total_cnt);
+         printf(" best_f=%.17g", restart.archive.f_value);
+         if (use_deadline) {
+             printf(" deadline_ms=%.3f deadline_miss=%d slack_ms=%.3f pred_iters=%d",
+                    opts.deadline_ms, deadline.missed, bat_deadline_slack_ms(&deadline), deadline.pred_iters);
+         }
+         bat_options_print_bench(&opts);
+         if (bat_con.n > 0) bat_con_print_bench(&restart.archive);
+         bat_arena_print_bench(&arena);
+         bat_bind_print_bench(opts.bind, all_where, size);
+         if (opts.refine_method != BAT_REFINE_NONE) {
+             printf(" refine=%s refine_evals=%ld refine_hits=%d", bat_refine_name(opts.refine_method), refine_evals, refine_hits);
+         }
+         bat_restart_print_bench(&restart, n_bats, bat_diversity_value(&div));
+         if (opts.shrink_kind != BAT_SHRINK_NONE) {
+             printf(" shrink=%s n_bats_final=%d", bat_shrink_name(opts.shrink_kind), n_bats);
+         }
+         if (opts.has_target) {
+             printf(" target=%g hit=%d evals_to_target=%ld", opts.target, total_evals_to_target >= 0, total_evals_to_target);
+         }
+         bat_ttt_print_bench(&ttt);
+         if (args->bench_extra) printf("%s", args->bench_extra);
+         printf("\n");
     }
 
-    MPI_Finalize();
+    bat_arena_destroy(&arena);
+    free(all_where);
     return 0;
 }
+
+#ifndef BAT_NO_MAIN
+int main(int argc, char *argv[]) {
+    /* Initialize the MPI environment */
+    MPI_Init(&argc, &argv);
+
+    BatArgs args;
+    bat_args_parse(&args, argc, argv);
+    int status = bat_run_mpi(&args);
+
+    MPI_Finalize();
+    return status;
+}
+#endif
@@ -6,6 +6,26 @@
 
 #include "bat.h"
 #include "bat_utils.h"
+#include "bat_io.h"
+#include "bat_signal.h"
+#include "bat_options.h"
+#include "bat_deadline.h"
+#include "bat_init.h"
+#include "bat_refine.h"
+#include "bat_restart.h"
+#include "bat_shrink.h"
+#include "bat_arena.h"
+#include "bat_bind.h"
+#include "bat_tune.h"
+#include "bat_cli.h"
+#include "bat_hd.h"
+#include "bat_cc.h"
+#include "bat_constraint.h"
+#include "bat_mo.h"
+#include "bat_niche.h"
+#include "bat_mode.h"
+#include "bat_transform.h"
+#include "bat_expr.h"
 
 /*
  * OpenMP version of the Bat Algorithm.
@@ -17,36 +37,654 @@
  * - At the end, we merge the thread bests to get the iteration best (iter_best).
  */
 
-static void parse_args(int argc, char **argv, int *n_bats, int *max_iters, unsigned int *seed, int *quiet) {
-    *n_bats = N_BATS;
-    *max_iters = MAX_ITERS;
-    *seed = (unsigned int)time(NULL);
-    *quiet = 0;
+/* --autotune: blocks of sweeps are sized to about this long; the first one calibrates. */
+#define TUNE_BLOCK_S 0.005
+#define TUNE_BLOCKS  4
+#define TUNE_MAX_CANDIDATES 128
 
-    for (int i = 1; i < argc; i++) {
-        if (strcmp(argv[i], "--n-bats") == 0 && i + 1 < argc) {
-            *n_bats = atoi(argv[++i]);
-        } else if (strcmp(argv[i], "--iters") == 0 && i + 1 < argc) {
-            *max_iters = atoi(argv[++i]);
-        } else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc) {
-            *seed = (unsigned int)strtoul(argv[++i], NULL, 10);
-        } else if (strcmp(argv[i], "--quiet") == 0) {
-            *quiet = 1;
+static omp_sched_t omp_sched_of(int sched) {
+    switch (sched) {
+        case BAT_SCHED_DYNAMIC: return omp_sched_dynamic;
+        case BAT_SCHED_GUIDED:  return omp_sched_guided;
+        default:                return omp_sched_static;
+    }
+}
+
+/*
+ * Times one candidate configuration on the real problem: sweeps of
+ * update_bat() over `work`, a fresh copy of the population, so the run
+ * itself is not affected.
+ *
+ * Parameters:
+ *   - work   : scratch population (n_bats bats)
+ *   - bats   : initial population (read-only)
+ *   - n_bats : population size
+ *   - best   : guide bat
+ *   - c      : candidate (threads, schedule, chunk)
+ *
+ * Returns the best time per bat update (ns) over the measured blocks.
+ */
+static double tune_trial(Bat work[], const Bat bats[], int n_bats, const Bat *best, const BatTuneChoice *c) {
+    memcpy(work, bats, (size_t)n_bats * sizeof(Bat));
+    omp_set_schedule(omp_sched_of(c->sched), c->chunk);
+    double A_mean = bat_mean_loudness(bats, n_bats);
+
+    double best_ns = -1.0;
+    int sweeps = 1;
+    for (int block = 0; block < TUNE_BLOCKS; block++) {
+        double start = omp_get_wtime();
+        for (int s = 0; s < sweeps; s++) {
+            #pragma omp parallel num_threads(c->threads)
+            {
+                BatCounters trial_cnt = {0};
+                #pragma omp for schedule(runtime)
+                for (int i = 0; i < n_bats; i++) {
+                    update_bat(&work[i], best, A_mean, s, &trial_cnt);
+                }
+            }
+        }
+        double elapsed = omp_get_wtime() - start;
+
+        if (block == 0) {
+            /* Warm-up block: size the measured blocks to about TUNE_BLOCK_S. */
+            sweeps = elapsed > 0.0 ? (int)(TUNE_BLOCK_S / elapsed) : 1000;
+            if (sweeps < 1) sweeps = 1;
+            if (sweeps > 1000) sweeps = 1000;
+            continue;
         }
+        double ns = elapsed * 1e9 / ((double)sweeps * (double)n_bats);
+        if (best_ns < 0.0 || ns < best_ns) best_ns = ns;
     }
+    return best_ns;
 }
 
-int main(int argc, char **argv) {
+/*
+ * Tries every candidate of bat_tune_candidates() and returns the fastest
+ * (ties keep the earlier candidate, i.e. fewer threads / static schedule).
+ */
+static BatTuneChoice tune_run(Bat work[], const Bat bats[], int n_bats, const Bat *best, int max_threads) {
+    BatTuneChoice cand[TUNE_MAX_CANDIDATES];
+    int n_cand = bat_tune_candidates(max_threads, cand, TUNE_MAX_CANDIDATES);
+
+    int best_k = 0;
+    for (int k = 0; k < n_cand; k++) {
+        cand[k].ns_per_update = tune_trial(work, bats, n_bats, best, &cand[k]);
+        if (cand[k].ns_per_update < cand[best_k].ns_per_update) best_k = k;
+    }
+    return cand[best_k];
+}
+
+/*
+ * High-dimensional run (--dim, see bat_hd.h).
+ *
+ * - group mode: threads take groups of --hd-group bats (dynamic schedule),
+ *   each with its own scratch, and update them tile by tile.
+ * - tiles mode: with fewer groups than threads the population cannot keep
+ *   every thread busy, so the bats are updated one after the other and the
+ *   tiles of each bat are split between the threads.
+ * - batch mode (--transform, --objective-expr): the whole population is
+ *   one batch; the threads share the tile passes, then the column panels
+ *   of the batch matrix product, then the row values (in blocks of
+ *   BAT_EXPR_LANES rows) and acceptance tests.
+ * All modes give the sequential result (bat_hd.h).
+ *
+ * Parameters:
+ *   - args : parsed command line
+ *   - opts : checked and applied options
+ */
+static int run_hd(const BatArgs *args, const BatOptions *opts) {
+    int n_bats = args->n_bats, max_iters = args->max_iters, dim = opts->hd_dim;
+    int batch = bat_hd_batched(opts);
+    int group = batch ? n_bats : (opts->hd_group < n_bats ? opts->hd_group : n_bats);
+    int n_threads = omp_get_max_threads();
+    int n_groups = (n_bats + group - 1) / group;
+    int tiles_mode = !batch && n_groups < n_threads && bat_hd_tile_count(dim) > 1;
+
+    if (args->autotune) {
+        fprintf(stderr, "--autotune is not supported with --dim\n");
+        return 1;
+    }
+    if (opts->hd_slices > 1) {
+        fprintf(stderr, "--hd-slices needs the MPI back-end\n");
+        return 1;
+    }
+
+    BatTopology topo;
+    if (bat_topology_load(&topo) != 0) return 1;
+    BatBindSlot *where = calloc((size_t)n_threads, sizeof(BatBindSlot));
+    if (!where) {
+        perror("calloc bind slots");
+        return 1;
+    }
+    #pragma omp parallel
+    {
+        int tid = omp_get_thread_num();
+        bat_bind_self(&topo, opts->bind, tid, omp_get_num_threads());
+        bat_bind_where(&topo, 0, &where[tid]);
+    }
+
+    /*
+     * One scratch per thread (group mode), one shared single-bat scratch
+     * (tiles mode) or one shared scratch for the population (batch mode).
+     */
+    int n_scratch = tiles_mode || batch ? 1 : n_threads;
+    int slots = tiles_mode ? 1 : group;
+    BatArena arena;
+    size_t arena_bytes = bat_hd_pop_bytes(n_bats, dim)
+                       + (size_t)n_scratch * bat_hd_scratch_bytes(bat_hd_tile_count(dim), slots)
+                       + (batch ? bat_transform_bytes(opts->transform, dim, 2 * n_bats) : 0);
+    if (bat_arena_create(&arena, arena_bytes, opts->pages) != 0) {
+        free(where);
+        return 1;
+    }
+    BatHdPop pop;
+    BatHdScratch scratch[n_scratch];
+    BatTransform tf;
+    int ok = bat_hd_pop_create(&pop, &arena, n_bats, dim) == 0;
+    for (int k = 0; ok && k < n_scratch; k++) ok = bat_hd_scratch_create(&scratch[k], &arena, &pop, slots) == 0;
+    if (ok && batch) ok = bat_transform_create(&tf, &arena, opts->transform, dim, 2 * n_bats) == 0;
+    if (!ok) {
+        bat_arena_destroy(&arena);
+        free(where);
+        return 1;
+    }
+    if (batch) pop.tf = &tf;
+
+    /* First touch of every row by the thread that updates it in group mode. */
+    #pragma omp parallel for schedule(dynamic, 1)
+    for (int i = 0; i < n_bats; i++) bat_hd_init_bat(&pop, i, (uint32_t)args->seed);
+    if (batch) bat_hd_eval_init(&pop);
+    bat_hd_select_best(&pop);
+    const int id = bat_get_objective();
+    int rows = 0;
+    double gemm_start = 0.0;
+
+    bat_signal_install();
+    long evals = n_bats;
+    long evals_to_target = -1;
+    int iters_done = max_iters;
+    BatCounters cnt = {0};
+
+    double t0 = omp_get_wtime();
+
+    for (int t = 0; t < max_iters; t++) {
+        double A_mean = bat_hd_mean_loudness(&pop);
+        cnt.amean_calls++;
+        cnt.amean_scanned += n_bats;
+        long iter_evals = 0;
+
+        #pragma omp parallel reduction(+:iter_evals)
+        {
+            BatCounters thread_cnt = {0};
+            if (batch) {
+                BatHdScratch *s = &scratch[0];
+                #pragma omp for schedule(static)
+                for (int i = 0; i < n_bats; i++) bat_hd_begin(&pop, s, i, i, A_mean);
+                #pragma omp single
+                rows = bat_hd_batch_rows(s, n_bats);
+                #pragma omp for schedule(dynamic, 1)
+                for (int i = 0; i < n_bats; i++) {
+                    for (int j = 0; j < pop.n_tiles; j++) bat_hd_tile(&pop, s, i, j, &thread_cnt);
+                }
+                #pragma omp single
+                gemm_start = omp_get_wtime();
+                #pragma omp for schedule(dynamic, 1)
+                for (int p = 0; p < bat_transform_panels(&tf); p++) bat_transform_panel(&tf, rows, p);
+                #pragma omp single
+                bat_transform_account(&tf, rows, omp_get_wtime() - gemm_start);
+                #pragma omp for schedule(static)
+                for (int r = 0; r < rows; r += BAT_EXPR_LANES) {
+                    bat_transform_values(&tf, id, r, r + BAT_EXPR_LANES < rows ? r + BAT_EXPR_LANES : rows);
+                }
+                #pragma omp for schedule(dynamic, 1)
+                for (int i = 0; i < n_bats; i++) {
+                    iter_evals += bat_hd_accept_batch(&pop, s, i, t, &thread_cnt);
+                    for (int j = 0; j < pop.n_tiles; j++) bat_hd_commit(&pop, s, i, j);
+                }
+            } else if (tiles_mode) {
+                BatHdScratch *s = &scratch[0];
+                for (int i = 0; i < n_bats; i++) {
+                    #pragma omp single
+                    bat_hd_begin(&pop, s, 0, i, A_mean);
+                    #pragma omp for schedule(static)
+                    for (int j = 0; j < pop.n_tiles; j++) bat_hd_tile(&pop, s, 0, j, &thread_cnt);
+                    #pragma omp single
+                    iter_evals += bat_hd_finish(&pop, s, 0, t, &thread_cnt);
+                    #pragma omp for schedule(static)
+                    for (int j = 0; j < pop.n_tiles; j++) bat_hd_commit(&pop, s, 0, j);
+                }
+            } else {
+                BatHdScratch *s = &scratch[omp_get_thread_num()];
+                #pragma omp for schedule(dynamic, 1)
+                for (int g = 0; g < n_groups; g++) {
+                    int first = g * group;
+                    int count = n_bats - first < group ? n_bats - first : group;
+                    iter_evals += bat_hd_update_group(&pop, s, first, count, A_mean, t, &thread_cnt);
+                }
+            }
+            #pragma omp critical
+            bat_counters_merge(&cnt, &thread_cnt);
+        }
+        evals += iter_evals;
+        if (bat_hd_select_best(&pop)) cnt.best_changes++;
+
+        if (!args->quiet && t % 100 == 0) {
+            printf("[Iter %d] Best f_value = %f\n", t, pop.best_f);
+        }
+        if (opts->has_target && pop.best_f >= opts->target) {
+            evals_to_target = evals;
+            iters_done = t + 1;
+            break;
+        }
+        if (bat_signal_take() & BAT_SIG_EXIT) {
+            fprintf(stderr, "SIGUSR2: stopping after iteration %d\n", t);
+            iters_done = t + 1;
+            break;
+        }
+    }
+    double elapsed = omp_get_wtime() - t0;
+
+    if (!args->quiet) {
+        printf("\nFinal best f_value = %f (bat %d, %d coordinates)\n", pop.best_f, pop.best_i, dim);
+    }
+    printf("BENCH version=openmp n_bats=%d iters=%d procs=1 threads=%d time_s=%.6f evals=%ld",
+           n_bats, iters_done, n_threads, elapsed, evals);
+    bat_counters_print_bench(&cnt);
+    printf(" best_f=%.17g", pop.best_f);
+    bat_options_print_bench(opts);
+    bat_arena_print_bench(&arena);
+    bat_bind_print_bench(opts->bind, where, n_threads);
+    bat_hd_print_bench(&pop, group, batch ? "batch" : (tiles_mode ? "tiles" : "group"));
+    if (batch) bat_transform_print_bench(&tf, tf.gemm_flops, tf.gemm_s);
+    if (opts->has_target) {
+        printf(" target=%g hit=%d evals_to_target=%ld", opts->target, evals_to_target >= 0, evals_to_target);
+    }
+    if (args->bench_extra) printf("%s", args->bench_extra);
+    printf("\n");
+
+    bat_arena_destroy(&arena);
+    free(where);
+    return 0;
+}
+
+/*
+ * Cooperative coevolution run (--cc, see bat_cc.h): the threads take the
+ * sub-swarms of a round (dynamic schedule, one scratch per thread) and
+ * split the packing of the bats; the decomposition and the merge are
+ * sequential. Same result as the sequential back-end.
+ *
+ * Parameters:
+ *   - args : parsed command line
+ *   - opts : checked and applied options
+ */
+static int run_cc(const BatArgs *args, const BatOptions *opts) {
+    int n_bats = args->n_bats, max_iters = args->max_iters, dim = opts->hd_dim;
+    int n_threads = omp_get_max_threads();
+
+    if (args->autotune) {
+        fprintf(stderr, "--autotune is not supported with --dim\n");
+        return 1;
+    }
+
+    BatTopology topo;
+    if (bat_topology_load(&topo) != 0) return 1;
+    BatBindSlot *where = calloc((size_t)n_threads, sizeof(BatBindSlot));
+    if (!where) {
+        perror("calloc bind slots");
+        return 1;
+    }
+    #pragma omp parallel
+    {
+        int tid = omp_get_thread_num();
+        bat_bind_self(&topo, opts->bind, tid, omp_get_num_threads());
+        bat_bind_where(&topo, 0, &where[tid]);
+    }
+
+    BatArena arena;
+    size_t arena_bytes = bat_hd_pop_bytes(n_bats, dim) + bat_cc_bytes(dim, n_bats, opts->cc_size)
+                       + (size_t)n_threads * bat_cc_scratch_bytes(dim);
+    if (bat_arena_create(&arena, arena_bytes, opts->pages) != 0) {
+        free(where);
+        return 1;
+    }
+    BatHdPop pop;
+    BatCc cc;
+    BatCcScratch scratch[n_threads];
+    int ok = bat_hd_pop_create(&pop, &arena, n_bats, dim) == 0
+          && bat_cc_create(&cc, &arena, opts->cc_kind, dim, n_bats, opts->cc_size, (uint32_t)args->seed) == 0;
+    for (int k = 0; ok && k < n_threads; k++) ok = bat_cc_scratch_create(&scratch[k], &arena, &cc) == 0;
+    if (!ok) {
+        bat_arena_destroy(&arena);
+        free(where);
+        return 1;
+    }
+
+    #pragma omp parallel for schedule(static)
+    for (int i = 0; i < n_bats; i++) bat_hd_init_bat(&pop, i, (uint32_t)args->seed);
+    bat_hd_select_best(&pop);
+
+    bat_signal_install();
+    long evals = n_bats;
+    long evals_to_target = -1;
+    int iters_done = max_iters;
+    BatCounters cnt = {0};
+
+    double t0 = omp_get_wtime();
+
+    for (int t = 0, round = 0; t < max_iters; t += opts->cc_iters, round++) {
+        int len = max_iters - t < opts->cc_iters ? max_iters - t : opts->cc_iters;
+        long round_evals = bat_cc_regroup(&cc, &scratch[0], round);
+
+        #pragma omp parallel reduction(+:round_evals)
+        {
+            BatCounters thread_cnt = {0};
+            BatCcScratch *s = &scratch[omp_get_thread_num()];
+            #pragma omp for schedule(static)
+            for (int i = 0; i < n_bats; i++) bat_cc_pack(&cc, &pop, i, 1);
+            #pragma omp for schedule(dynamic, 1)
+            for (int g = 0; g < cc.n_groups; g++) round_evals += bat_cc_run_group(&cc, &pop, s, g, t, len, &thread_cnt);
+            #pragma omp for schedule(static)
+            for (int i = 0; i < n_bats; i++) bat_cc_unpack(&cc, &pop, i, 1);
+            #pragma omp critical
+            bat_counters_merge(&cnt, &thread_cnt);
+        }
+        evals += round_evals + bat_cc_merge(&cc, &pop, &scratch[0], &cnt);
+        iters_done = t + len;
+
+        if (!args->quiet && round % 10 == 0) {
+            printf("[Iter %d] Best f_value = %f\n", t, pop.best_f);
+        }
+        if (opts->has_target && pop.best_f >= opts->target) {
+            evals_to_target = evals;
+            break;
+        }
+        if (bat_signal_take() & BAT_SIG_EXIT) {
+            fprintf(stderr, "SIGUSR2: stopping after iteration %d\n", iters_done - 1);
+            break;
+        }
+    }
+    double elapsed = omp_get_wtime() - t0;
+
+    if (!args->quiet) {
+        printf("\nFinal best f_value = %f (context of %d groups, %d coordinates)\n", pop.best_f, cc.n_groups, dim);
+    }
+    printf("BENCH version=openmp n_bats=%d iters=%d procs=1 threads=%d time_s=%.6f evals=%ld",
+           n_bats, iters_done, n_threads, elapsed, evals);
+    bat_counters_print_bench(&cnt);
+    printf(" best_f=%.17g", pop.best_f);
+    bat_options_print_bench(opts);
+    bat_arena_print_bench(&arena);
+    bat_bind_print_bench(opts->bind, where, n_threads);
+    bat_cc_print_bench(&cc, opts->cc_iters);
+    if (opts->has_target) {
+        printf(" target=%g hit=%d evals_to_target=%ld", opts->target, evals_to_target >= 0, evals_to_target);
+    }
+    if (args->bench_extra) printf("%s", args->bench_extra);
+    printf("\n");
+
+    bat_arena_destroy(&arena);
+    free(where);
+    return 0;
+}
+
+/*
+ * Binds every thread of the team (--bind) and returns their slots
+ * (calloc'ed, n_threads of them), NULL on error.
+ */
+static BatBindSlot *bind_threads(const BatOptions *opts, int n_threads) {
+    BatTopology topo;
+    if (bat_topology_load(&topo) != 0) return NULL;
+    BatBindSlot *where = calloc((size_t)n_threads, sizeof(BatBindSlot));
+    if (!where) {
+        perror("calloc bind slots");
+        return NULL;
+    }
+    #pragma omp parallel
+    {
+        int tid = omp_get_thread_num();
+        bat_bind_self(&topo, opts->bind, tid, omp_get_num_threads());
+        bat_bind_where(&topo, 0, &where[tid]);
+    }
+    return where;
+}
+
+/*
+ * Multi-objective run (--mo-objective, see bat_mo.h). Every thread
+ * updates a contiguous block of bats and filters their non-dominated
+ * points into its own region after the archive; the regions are then
+ * compacted and merged on one thread. The filtered union does not depend
+ * on the blocks: same archive as the sequential back-end.
+ *
+ * Parameters:
+ *   - args : parsed command line
+ *   - opts : checked and applied options
+ */
+static int run_mo(const BatArgs *args, const BatOptions *opts) {
+    int n_bats = args->n_bats, max_iters = args->max_iters;
+    int n_threads = omp_get_max_threads();
+
+    if (args->autotune) {
+        fprintf(stderr, "--autotune is not supported with --mo-objective\n");
+        return 1;
+    }
+
+    int *kept = calloc((size_t)n_threads, sizeof(int));
+    if (!kept) {
+        perror("calloc kept");
+        return 1;
+    }
+    BatBindSlot *where = bind_threads(opts, n_threads);
+    BatModeRun run;
+    size_t arena_bytes = bat_arena_need((size_t)n_bats * sizeof(Bat)) + bat_mo_bytes(opts->mo_archive, n_bats);
+    if (!where || bat_mode_begin(&run, args, arena_bytes, where, n_threads, 0, 1, 1) != 0) {
+        free(kept);
+        return 1;
+    }
+    Bat *bats = bat_arena_alloc(&run.arena, (size_t)n_bats * sizeof(Bat));
+    BatMoArchive arch;
+    BatInitPlan plan;
+    if (!bats || bat_mo_create(&arch, &run.arena, opts->mo_archive, n_bats) != 0
+        || bat_init_plan_create(&plan, opts->init_kind, 0, n_bats, (uint32_t)args->seed) != 0) {
+        bat_mode_end(&run);
+        free(kept);
+        return 1;
+    }
+    #pragma omp parallel for schedule(static)
+    for (int i = 0; i < n_bats; i++) bat_init_one(&plan, &bats[i], i);
+    bat_init_plan_free(&plan);
+    bat_mo_merge(&arch, bat_mo_collect(bats, n_bats, arch.pt + arch.n));
+    double worst[BAT_MO_MAX];
+    bat_mo_worst(bats, n_bats, worst);
+    bat_mo_set_ref(&arch, worst);
+
+    long evals = n_bats;
+    BatCounters cnt = {0};
+
+    double t0 = omp_get_wtime();
+
+    for (int t = 0; t < max_iters; t++) {
+        long iter_evals = 0;
+        int team = 1;
+        BatExactSum loud_sum;
+        bat_xsum_clear(&loud_sum);
+
+        #pragma omp parallel reduction(+:iter_evals)
+        {
+            int tid = omp_get_thread_num(), nt = omp_get_num_threads();
+            BatCounters thread_cnt = {0};
+            if (tid == 0) team = nt;
+
+            /* Exact partial sums: A_mean does not depend on the thread count. */
+            BatExactSum thread_loud;
+            bat_xsum_clear(&thread_loud);
+            #pragma omp for schedule(static)
+            for (int i = 0; i < n_bats; i++) bat_xsum_add(&thread_loud, bats[i].A_i);
+            #pragma omp critical
+            bat_xsum_merge(&loud_sum, &thread_loud);
+            #pragma omp barrier
+            double A_mean = bat_xsum_value(&loud_sum) / (double)n_bats;
 
-    int n_bats, max_iters;
-    int quiet;
-    unsigned int seed;
-    parse_args(argc, argv, &n_bats, &max_iters, &seed, &quiet);
+            /* Block of this thread; its offers go to the same offsets after the archive. */
+            int first = (int)((long)n_bats * tid / nt), last = (int)((long)n_bats * (tid + 1) / nt);
+            for (int i = first; i < last; i++) {
+                Bat leader;
+                bat_mo_leader(&arch, &bats[i].rng_state, &leader);
+                iter_evals += update_bat(&bats[i], &leader, A_mean, t, &thread_cnt);
+            }
+            kept[tid] = bat_mo_collect(bats + first, last - first, arch.pt + arch.n + first);
+            #pragma omp critical
+            bat_counters_merge(&cnt, &thread_cnt);
+        }
+        evals += iter_evals;
+        cnt.amean_calls++;
+        cnt.amean_scanned += n_bats;
+
+        /* Compact the regions of the threads behind the archive, then merge. */
+        int n_new = 0;
+        for (int k = 0; k < team; k++) {
+            int first = (int)((long)n_bats * k / team);
+            if (first != n_new) {
+                memmove(&arch.pt[arch.n + n_new], &arch.pt[arch.n + first], (size_t)kept[k] * sizeof(BatMoPoint));
+            }
+            n_new += kept[k];
+        }
+        if (bat_mo_merge(&arch, n_new) > 0) cnt.best_changes++;
+
+        if (!args->quiet && t % 100 == 0) {
+            printf("[Iter %d] Pareto front = %d points\n", t, arch.n);
+        }
+        int sig = bat_signal_take();
+        if (sig) {
+            Bat best;
+            bat_mo_best(&arch, &best);
+            if (bat_mode_signals(&run, sig, t, bats, n_bats, &best)) break;
+        }
+    }
+    double elapsed = omp_get_wtime() - t0;
+
+    if (!args->quiet) {
+        printf("\nFinal Pareto front = %d points (%d objectives)\n", arch.n, bat_mo.n);
+    }
+    bat_mode_print_bench(&run, args, "openmp", n_threads, elapsed, evals, &cnt, arch.pt[0].f[0]);
+    bat_mo_print_bench(&arch);
+    bat_mode_end_bench(args);
+
+    int rc = opts->mo_front_path && bat_mo_write_front(&arch, opts->mo_front_path) != 0;
+    bat_mode_end(&run);
+    free(kept);
+    return rc;
+}
+
+/*
+ * Niching run (--niche-radius, see bat_niche.h). The bats are updated in
+ * parallel with their species seeds as guides; the speciation and the
+ * niche bests run on one thread. Same niches as the sequential back-end.
+ *
+ * Parameters:
+ *   - args : parsed command line
+ *   - opts : checked and applied options
+ */
+static int run_niche(const BatArgs *args, const BatOptions *opts) {
+    int n_bats = args->n_bats, max_iters = args->max_iters;
+    int n_threads = omp_get_max_threads();
+
+    if (args->autotune) {
+        fprintf(stderr, "--autotune is not supported with --niche-radius\n");
+        return 1;
+    }
+
+    BatBindSlot *where = bind_threads(opts, n_threads);
+    BatModeRun run;
+    size_t arena_bytes = bat_arena_need((size_t)n_bats * sizeof(Bat)) + bat_niche_bytes(n_bats, opts->niche_max);
+    if (!where || bat_mode_begin(&run, args, arena_bytes, where, n_threads, 0, 1, 1) != 0) {
+        return 1;
+    }
+    Bat *bats = bat_arena_alloc(&run.arena, (size_t)n_bats * sizeof(Bat));
+    BatNiche niche;
+    BatInitPlan plan;
+    if (!bats || bat_niche_create(&niche, &run.arena, n_bats, opts->niche_max, opts->niche_radius) != 0
+        || bat_init_plan_create(&plan, opts->init_kind, opts->init_obl, n_bats, (uint32_t)args->seed) != 0) {
+        bat_mode_end(&run);
+        return 1;
+    }
+    #pragma omp parallel for schedule(static)
+    for (int i = 0; i < n_bats; i++) bat_init_one(&plan, &bats[i], i);
+    bat_init_plan_free(&plan);
+
+    long evals = (long)n_bats * (opts->init_obl ? 2 : 1);
+    BatCounters cnt = {0};
+
+    double t0 = omp_get_wtime();
+    bat_niche_speciate(&niche, bats);
+    bat_niche_record(&niche, 0, evals, 0.0);
+
+    for (int t = 0; t < max_iters; t++) {
+        double A_mean = bat_mean_loudness(bats, n_bats);
+        cnt.amean_calls++;
+        cnt.amean_scanned += n_bats;
+        long iter_evals = 0;
+
+        #pragma omp parallel reduction(+:iter_evals)
+        {
+            BatCounters thread_cnt = {0};
+            #pragma omp for schedule(static)
+            for (int i = 0; i < n_bats; i++) {
+                iter_evals += update_bat(&bats[i], &niche.guide[niche.species[i]], A_mean, t, &thread_cnt);
+            }
+            #pragma omp critical
+            bat_counters_merge(&cnt, &thread_cnt);
+        }
+        evals += iter_evals;
+        double prev_best_f = niche.guide[0].f_value;
+        bat_niche_speciate(&niche, bats);
+        if (niche.guide[0].f_value > prev_best_f) cnt.best_changes++;
+        bat_niche_record(&niche, t + 1, evals, omp_get_wtime() - t0);
+
+        if (!args->quiet && t % 100 == 0) {
+            printf("[Iter %d] Species = %d  Best f_value = %f\n", t, niche.n_species, niche.guide[0].f_value);
+        }
+        int sig = bat_signal_take();
+        if (sig && bat_mode_signals(&run, sig, t, bats, n_bats, &niche.guide[0])) break;
+    }
+    double elapsed = omp_get_wtime() - t0;
+
+    bat_niche_report(&niche);
+    bat_mode_print_bench(&run, args, "openmp", n_threads, elapsed, evals, &cnt, niche.found[0].f);
+    bat_niche_print_bench(&niche);
+    bat_mode_end_bench(args);
+
+    bat_mode_end(&run);
+    return 0;
+}
+
+/*
+ * OpenMP back-end (see bat_cli.h). The number of threads is the OpenMP
+ * default (OMP_NUM_THREADS, or omp_set_num_threads() by the caller).
+ *
+ * Parameters:
+ *   - args : parsed command line
+ */
+int bat_run_openmp(const BatArgs *args) {
+
+    int n_bats = args->n_bats, max_iters = args->max_iters;
+    int quiet = args->quiet;
+    int autotune = args->autotune;
+    const char *tune_cache = args->tune_cache;
+    unsigned int seed = args->seed;
+    BatOptions opts = args->opts;
 
     if (n_bats <= 0 || max_iters <= 0) {
         fprintf(stderr, "Invalid parameters: n_bats=%d iters=%d\n", n_bats, max_iters);
         return 1;
     }
+    if (bat_options_check(&opts) != 0) {
+        return 1;
+    }
+    bat_options_apply(&opts);
+    if (opts.n_mo > 0) return run_mo(args, &opts);
+    if (opts.niche_radius > 0.0) return run_niche(args, &opts);
+    if (opts.cc_kind != BAT_CC_NONE) return run_cc(args, &opts);
+    if (opts.hd_dim > 0) return run_hd(args, &opts);
 
     /*
      * Deterministic seed.
@@ -54,76 +692,421 @@ int main(int argc, char **argv) {
      * benchmark is reproducible and thread-safe.
      */
 
-    Bat *bats = malloc((size_t)n_bats * sizeof(Bat));
-    if (!bats) {
-        perror("malloc bats");
+    /* --deadline: the budget covers initialization too. */
+    BatDeadline deadline;
+    int use_deadline = opts.deadline_ms > 0.0;
+    if (use_deadline) bat_deadline_start(&deadline, opts.deadline_ms);
+
+    /*
+     * --bind: every thread pins itself (thread number = slot) before the
+     * population is touched, so the first-touch placement below follows the
+     * binding. libgomp keeps the same threads for the later parallel
+     * regions. Where each thread runs is recorded for the BENCH line.
+     */
+    BatTopology topo;
+    if (bat_topology_load(&topo) != 0) return 1;
+    int n_threads = omp_get_max_threads();
+    BatBindSlot *where = calloc((size_t)n_threads, sizeof(BatBindSlot));
+    if (!where) {
+        perror("calloc bind slots");
+        return 1;
+    }
+    #pragma omp parallel
+    {
+        int tid = omp_get_thread_num();
+        bat_bind_self(&topo, opts.bind, tid, omp_get_num_threads());
+        bat_bind_where(&topo, 0, &where[tid]);
+    }
+
+    /*
+     * Reserve the memory of the whole run up front (--hugepages), with room
+     * for the largest ipop population (explicit huge pages for the initial
+     * one only), the spare buffer of the dump writer and the --shrink sort
+     * buffers. The pages are first touched by the parallel initialization
+     * below, i.e. by the threads that update them.
+     */
+    int max_bats = bat_options_max_bats(&opts, n_bats);
+    size_t arena_bytes = bat_arena_need((size_t)max_bats * sizeof(Bat)) + bat_dump_writer_bytes(max_bats);
+    if (opts.shrink_kind != BAT_SHRINK_NONE) arena_bytes += bat_shrink_scratch_bytes(n_bats);
+    if (autotune) arena_bytes += bat_arena_need((size_t)n_bats * sizeof(Bat));   /* tuning copy */
+    BatArena arena;
+    if (bat_arena_create_hot(&arena, arena_bytes, bat_arena_need((size_t)n_bats * sizeof(Bat)), opts.pages) != 0) {
         return 1;
     }
+    Bat *bats = bat_arena_alloc(&arena, (size_t)max_bats * sizeof(Bat));
     Bat best_bat;
 
-    /* Create initial bats and compute the first best bat */
-    initialize_bats_seeded(bats, n_bats, &best_bat, (uint32_t)seed);
+    /* SIGUSR1 = background dump (writer started before the loop), SIGUSR2 = checkpoint and exit. */
+    bat_signal_install();
+    int dump_pending = 0;
+    int iters_done = max_iters;
+
+    /* --refine statistics (objective evaluations, accepted refinements). */
+    long refine_evals = 0;
+    int refine_hits = 0;
+
+    /* Objective evaluations (initialization included) and --target bookkeeping. */
+    long evals = (long)n_bats * (opts.init_obl ? 2 : 1);
+    long evals_to_target = -1;
+
+    /* Behavior counters: each thread counts privately, merged once per iteration. */
+    BatCounters cnt = {0};
+
+    /*
+     * Create initial bats in parallel and compute the first best bat.
+     * Every bat is generated from its own index only (see bat_init.h), so
+     * the population does not depend on the number of threads.
+     */
+    BatInitPlan plan;
+    if (bat_init_plan_create(&plan, opts.init_kind, opts.init_obl, n_bats, (uint32_t)seed) != 0) {
+        bat_arena_destroy(&arena);
+        return 1;
+    }
+    #pragma omp parallel for
+    for (int i = 0; i < n_bats; i++) {
+        bat_init_one(&plan, &bats[i], i);
+    }
+    bat_init_plan_free(&plan);
+    select_best_bat(bats, n_bats, &best_bat);
+
+    /* --constraint: epsilon level from the initial violations, ranks under it. */
+    if (bat_con.n > 0) {
+        BatExactSum viol;
+        bat_con_violation_sum(bats, n_bats, &viol);
+        bat_con_start(&viol, n_bats, max_iters);
+        bat_con_rerank(bats, n_bats);
+        select_best_bat(bats, n_bats, &best_bat);
+    }
+
+    /*
+     * --restart: diversity monitor and archive of the best bat over all
+     * restarts (the archive is what the program reports). Each thread sums
+     * the moves of its own bats into a private delta; the deltas are merged
+     * in the critical section that already merges the thread bests.
+     */
+    int use_restart = opts.restart_kind != BAT_RESTART_NONE;
+    int n_bats_init = n_bats;
+    BatRestart restart;
+    bat_restart_init(&restart, opts.restart_kind, opts.restart_div, opts.restart_frac, opts.restart_grow,
+                     max_bats, opts.restart_gap,
+                     opts.restart_stall, &best_bat);
+    BatDiversity div;
+    bat_diversity_reset(&div, bats, n_bats, best_bat.x_i);
+
+    /*
+     * --autotune: thread count, schedule and chunk size of the update loop,
+     * from the tuning cache or timed now on a copy of the population (the
+     * thread count cannot change the result, see bat_xsum.h). A cached
+     * thread count is capped by the current OMP_NUM_THREADS.
+     */
+    int sched_kind = BAT_SCHED_STATIC, sched_chunk = 0;
+    const char *tune_source = NULL;
+    double tune_ms = 0.0;
+    if (autotune) {
+        double tune_start = omp_get_wtime();
+        BatTuneKey key;
+        BatTuneChoice choice;
+        bat_tune_key(&key, n_bats, &opts);
+        if (bat_tune_lookup(tune_cache, &key, &choice)) {
+            tune_source = "cached";
+        } else {
+            size_t mark = bat_arena_mark(&arena);
+            Bat *work = bat_arena_alloc(&arena, (size_t)n_bats * sizeof(Bat));
+            choice = tune_run(work, bats, n_bats, &best_bat, n_threads);
+            bat_arena_release(&arena, mark);
+            bat_tune_store(tune_cache, &key, &choice);
+            tune_source = "tuned";
+        }
+        if (choice.threads > n_threads) choice.threads = n_threads;
+        n_threads = choice.threads;
+        omp_set_num_threads(n_threads);
+        sched_kind = choice.sched;
+        sched_chunk = choice.chunk;
+        tune_ms = (omp_get_wtime() - tune_start) * 1e3;
+        if (!quiet) {
+            printf("Autotune (%s): threads=%d schedule=%s chunk=%d (%.1f ns/update)\n", tune_source,
+                   n_threads, bat_sched_name(sched_kind), sched_chunk, choice.ns_per_update);
+        }
+    }
+
+    /* --trace: best bat of every iteration (for cross-back-end comparisons). */
+    FILE *trace = NULL;
+    if (opts.trace_path && !(trace = bat_trace_open(opts.trace_path))) {
+        bat_arena_destroy(&arena);
+        return 1;
+    }
 
     /* Wall-clock timing around the full iteration loop. */
+    BatDumpWriter *writer = bat_dump_writer_create(&arena, max_bats);
+
     double t0 = omp_get_wtime();
+    if (use_deadline) bat_deadline_loop_start(&deadline);
+
+    /* --targets: time-to-target records (initialization counts as time 0). */
+    BatTimeToTarget ttt = opts.ttt;
+    bat_ttt_start(&ttt, bat_objective_optimum(opts.objective));
+    bat_ttt_update(&ttt, best_bat.f_value, evals, 0.0);
 
     for (int t = 0; t < max_iters; t++) {
 
+        /* --constraint: epsilon level / penalty weight of this iteration (re-ranks when it changes). */
+        if (bat_con.n > 0 && bat_con_advance(t, &best_bat)) {
+            bat_con_rerank(bats, n_bats);
+            bat_con_rerank(&restart.archive, 1);
+            select_best_bat(bats, n_bats, &best_bat);
+            bat_restart_archive(&restart, &best_bat);
+        }
+
         /* iter_best is the best solution from the previous iteration (read-only guide) */
         Bat iter_best = best_bat;
-        Bat next_best = iter_best;
+
+        /* Index of the best bat after this iteration (lowest index on ties, as in sequential) */
+        int best_i = -1;
+
+        /* Exact loudness sum, merged from the threads' partial sums */
+        BatExactSum loud_sum;
+        bat_xsum_clear(&loud_sum);
+
+        /*
+         * Periodic local refinement (--refine): one thread polishes a copy of
+         * iter_best while the others update the population. The loop switches
+         * to a dynamic schedule for that iteration, so the refining thread
+         * simply takes fewer bats.
+         */
+        int refine_now = opts.refine_method != BAT_REFINE_NONE && (t + 1) % opts.refine_every == 0;
+        int refine_evals_now = 0;
+        double refine_x[dimension];
+        double refine_f = iter_best.f_value;
+        for (int d = 0; d < dimension; d++) refine_x[d] = iter_best.x_i[d];
+        if (refine_now) {
+            omp_set_schedule(omp_sched_dynamic, 16);
+        } else {
+            omp_set_schedule(omp_sched_of(sched_kind), sched_chunk);
+        }
+
+        /* Objective evaluations of this iteration (summed over threads). */
+        long iter_evals = 0;
 
         /* Parallel region: multiple threads work together */
         #pragma omp parallel
         {
-            /* Each thread keeps its own best bat (private variable) */
-            Bat thread_best = iter_best;
+            /* Each thread keeps the index of its own best bat (private variable) */
+            int thread_best_i = -1;
+            BatCounters thread_cnt = {0};
+
+            /* Diversity change caused by this thread's bats */
+            BatDiversity thread_div;
+            bat_diversity_delta(&div, &thread_div);
+
+            /*
+             * Average loudness at the start of the iteration. The partial
+             * sums are exact, so the merge order does not matter and every
+             * thread count gives the sequential value bit for bit.
+             */
+            BatExactSum thread_loud;
+            bat_xsum_clear(&thread_loud);
+            #pragma omp for schedule(static)
+            for (int i = 0; i < n_bats; i++) {
+                bat_xsum_add(&thread_loud, bats[i].A_i);
+            }
+            #pragma omp critical
+            bat_xsum_merge(&loud_sum, &thread_loud);
+            #pragma omp barrier
+            double A_mean = bat_xsum_value(&loud_sum) / (double)n_bats;
+
+            if (refine_now) {
+                #pragma omp single nowait
+                {
+                    refine_evals_now = bat_refine(opts.refine_method, refine_x, &refine_f,
+                                                  opts.refine_evals, opts.refine_step);
+                }
+            }
 
             /* Split the bats between threads */
-            #pragma omp for
+            #pragma omp for schedule(runtime) reduction(+:iter_evals)
             for (int i = 0; i < n_bats; i++) {
                 /* Update one bat using the best solution known at this moment */
-                update_bat(bats, n_bats, &iter_best, i, t);
+                iter_evals += update_bat_tracked(&bats[i], &iter_best, A_mean, t - restart.t_last, &thread_cnt,
+                                                 use_restart ? &thread_div : NULL);
 
-                /* Track the best bat seen by this thread */
-                if (bats[i].f_value > thread_best.f_value) {
-                    thread_best = bats[i];
+                /* Track the best bat seen by this thread (chunks come in increasing i) */
+                if (thread_best_i < 0 || bats[i].f_value > bats[thread_best_i].f_value) {
+                    thread_best_i = i;
                 }
             }
 
-            /* Merge the thread bests into a single iter_best (one thread at a time) */
+            /* Merge the thread bests into a single best index (one thread at a time) */
             #pragma omp critical
             {
-                if (thread_best.f_value > next_best.f_value) {
-                    next_best = thread_best;
+                if (thread_best_i >= 0) {
+                    double f = bats[thread_best_i].f_value;
+                    if (best_i < 0 || f > bats[best_i].f_value
+                        || (f == bats[best_i].f_value && thread_best_i < best_i)) {
+                        best_i = thread_best_i;
+                    }
                 }
+                bat_diversity_merge(&div, &thread_div);
+                bat_counters_merge(&cnt, &thread_cnt);
             }
         }
+        Bat next_best = bats[best_i];
+        cnt.amean_calls++;
+        cnt.amean_scanned += n_bats;
+
+        evals += iter_evals + refine_evals_now;
+        refine_evals += refine_evals_now;
+
+        /* Feed the polished point back: it replaces the worst bat. */
+        if (refine_now && refine_f > iter_best.f_value) {
+            int k = bat_inject(bats, n_bats, refine_x, refine_f);
+            if (refine_f > next_best.f_value) next_best = bats[k];
+            refine_hits++;
+            if (use_restart) bat_diversity_reset(&div, bats, n_bats, div.ref);
+        }
 
         /* Save the best solution for the next iteration */
+        if (next_best.f_value > iter_best.f_value) cnt.best_changes++;
         best_bat = next_best;
+        bat_restart_archive(&restart, &best_bat);
+
+        /* --restart: re-initialize the population once it has collapsed. */
+        if (use_restart) {
+            if ((t + 1) % BAT_DIVERSITY_RESYNC == 0) {
+                bat_diversity_reset(&div, bats, n_bats, best_bat.x_i);
+            }
+            if (bat_restart_due(&restart, bat_diversity_value(&div), t)) {
+                int new_n = bat_restart_next_size(&restart, n_bats, 1);
+                if (new_n > n_bats) n_bats = new_n;   /* the arena holds max_bats bats */
+                long used = bat_restart_apply(&restart, bats, n_bats, 0, n_bats, opts.init_kind, opts.init_obl,
+                                              (uint32_t)seed, t);
+                if (used > 0) evals += used;
+                /* The new population is guided by its own best, not by the archive. */
+                select_best_bat(bats, n_bats, &best_bat);
+                bat_restart_archive(&restart, &best_bat);
+                bat_diversity_reset(&div, bats, n_bats, best_bat.x_i);
+            }
+        }
+
+        /*
+         * --shrink: drop the worst bats to follow the population-size
+         * schedule (the best bat is never dropped, so best_bat stays valid).
+         */
+        if (opts.shrink_kind != BAT_SHRINK_NONE) {
+            int target_n = bat_shrink_target(opts.shrink_kind, n_bats_init, opts.shrink_min, t + 1, max_iters);
+            if (target_n < n_bats) n_bats = bat_shrink_local(bats, n_bats, target_n, &arena);
+        }
+
+        if (trace) bat_trace_write(trace, t, &best_bat);
+
+        /*
+         * Signal requests are served between parallel regions, where no
+         * thread is touching the population.
+         */
+        int sig = bat_signal_take();
+        if (sig & BAT_SIG_DUMP) dump_pending = 1;
+        if (dump_pending) {
+            char path[64];
+            snprintf(path, sizeof(path), "dump_t%06d.bin", t);
+            if (bat_dump_writer_submit(writer, path, bats, n_bats, &restart.archive, t, (uint32_t)seed, 0, 1, 0)
+                != BAT_DUMP_BUSY) {
+                dump_pending = 0;
+            }
+        }
+        if (sig & BAT_SIG_EXIT) {
+            char path[64];
+            snprintf(path, sizeof(path), "checkpoint_t%06d.bin", t);
+            bat_write_population(path, bats, n_bats, &restart.archive, t, (uint32_t)seed, 0, 1);
+            fprintf(stderr, "SIGUSR2: checkpoint written to %s, stopping after iteration %d\n", path, t);
+            iters_done = t + 1;
+            break;
+        }
 
         if (!quiet && t % 100 == 0) {
-            printf("[Iter %d] Best f_value = %f\n", t, best_bat.f_value);
+            printf("[Iter %d] Best f_value = %f\n", t, restart.archive.f_value);
+        }
+
+        /* --target: stop as soon as the best reaches the target value. */
+        if (opts.has_target && restart.archive.f_value >= opts.target) {
+            evals_to_target = evals;
+            iters_done = t + 1;
+            break;
+        }
+
+        /* --targets: record the targets reached, stop after the last one. */
+        if (ttt.n > 0 && bat_ttt_update(&ttt, restart.archive.f_value, evals, omp_get_wtime() - t0)) {
+            iters_done = t + 1;
+            break;
+        }
+
+        /* Stop early when the next iteration would not fit in the budget. */
+        if (use_deadline && !bat_deadline_next(&deadline)) {
+            iters_done = t + 1;
+            break;
         }
     }
+    if (use_deadline) bat_deadline_finish(&deadline);
 
     if (!quiet) {
-        printf("\nFinal best f_value = %f\n", best_bat.f_value);
+        printf("\nFinal best f_value = %f\n", restart.archive.f_value);
         printf("Final position = (");
         for (int d = 0; d < dimension; d++) {
-            printf("%s%f", (d == 0 ? "" : ", "), best_bat.x_i[d]);
+            printf("%s%f", (d == 0 ? "" : ", "), restart.archive.x_i[d]);
         }
         printf(")\n");
     }
 
     double elapsed = omp_get_wtime() - t0;
+
+    /* Let an in-flight background dump finish before exiting. */
+    bat_dump_writer_destroy(writer);
+
+    if (trace) fclose(trace);
+    if (opts.final_pop_path) {
+        bat_write_population(opts.final_pop_path, bats, n_bats, &restart.archive, iters_done, (uint32_t)seed, 0, 1);
+    }
+
     /* Report the maximum number of OpenMP threads for this run. */
     int threads = omp_get_max_threads();
-    printf("BENCH version=openmp n_bats=%d iters=%d procs=1 threads=%d time_s=%.6f\n",
-           n_bats, max_iters, threads, elapsed);
+    printf("BENCH version=openmp n_bats=%d iters=%d procs=1 threads=%d time_s=%.6f evals=%ld",
+           n_bats_init, iters_done, threads, elapsed, evals);
+    bat_counters_print_bench(&cnt);
+    printf(" best_f=%.17g", restart.archive.f_value);
+    if (use_deadline) {
+        printf(" deadline_ms=%.3f deadline_miss=%d slack_ms=%.3f pred_iters=%d",
+               opts.deadline_ms, deadline.missed, bat_deadline_slack_ms(&deadline), deadline.pred_iters);
+    }
+    bat_options_print_bench(&opts);
+    if (bat_con.n > 0) bat_con_print_bench(&restart.archive);
+    bat_arena_print_bench(&arena);
+    bat_bind_print_bench(opts.bind, where, n_threads);
+    if (tune_source) {
+        printf(" autotune=%s sched=%s chunk=%d tune_ms=%.1f", tune_source, bat_sched_name(sched_kind), sched_chunk,
+               tune_ms);
+    }
+    if (opts.refine_method != BAT_REFINE_NONE) {
+        printf(" refine=%s refine_evals=%ld refine_hits=%d", bat_refine_name(opts.refine_method), refine_evals, refine_hits);
+    }
+    bat_restart_print_bench(&restart, n_bats, bat_diversity_value(&div));
+    if (opts.shrink_kind != BAT_SHRINK_NONE) {
+        printf(" shrink=%s n_bats_final=%d", bat_shrink_name(opts.shrink_kind), n_bats);
+    }
+    if (opts.has_target) {
+        printf(" target=%g hit=%d evals_to_target=%ld", opts.target, evals_to_target >= 0, evals_to_target);
+    }
+    bat_ttt_print_bench(&ttt);
+    if (args->bench_extra) printf("%s", args->bench_extra);
+    printf("\n");
 
-    free(bats);
+    bat_arena_destroy(&arena);
+    free(where);
 
     return 0;
 }
+
+#ifndef BAT_NO_MAIN
+int main(int argc, char **argv) {
+    BatArgs args;
+    bat_args_parse(&args, argc, argv);
+    return bat_run_openmp(&args);
+}
+#endif
@@ -6,6 +6,24 @@
 
 #include "bat.h"
 #include "bat_utils.h"
+#include "bat_io.h"
+#include "bat_signal.h"
+#include "bat_options.h"
+#include "bat_deadline.h"
+#include "bat_init.h"
+#include "bat_refine.h"
+#include "bat_restart.h"
+#include "bat_shrink.h"
+#include "bat_arena.h"
+#include "bat_bind.h"
+#include "bat_hd.h"
+#include "bat_cc.h"
+#include "bat_constraint.h"
+#include "bat_mo.h"
+#include "bat_niche.h"
+#include "bat_mode.h"
+#include "bat_transform.h"
+#include "bat_cli.h"
 
 /*
  * Sequential version of the Bat Algorithm.
@@ -62,74 +80,518 @@ static double seconds_since(const struct timespec *start, const struct timespec
 
 
 /*
- * Parses command-line arguments and sets execution parameters.
+ * High-dimensional run (--dim, see bat_hd.h): groups of --hd-group bats
+ * are updated tile by tile, so each tile of the best position is reused
+ * by the whole group. With --transform or --objective-expr the whole
+ * population is one group, so the candidates of an iteration are evaluated
+ * in a single batch.
  *
  * Parameters:
- *   - argc        : number of command-line arguments
- *   - argv        : array of command-line arguments
- *   - n_bats      : number of bats in the population
- *   - max_iters   : maximum number of iterations
- *   - seed        : random seed
- *   - do_snapshot : enable or disable snapshots
- *   - quiet       : enable or disable console output
+ *   - args : parsed command line
+ *   - opts : checked and applied options
  */
-static void parse_args(int argc, char **argv, int *n_bats, int *max_iters, unsigned int *seed, int *do_snapshot, int *quiet) {
-    *n_bats = N_BATS;
-    *max_iters = MAX_ITERS;
-    *seed = (unsigned int)time(NULL);
-    *do_snapshot = 1;
-    *quiet = 0;
-
-    for (int i = 1; i < argc; i++) {
-        if (strcmp(argv[i], "--n-bats") == 0 && i + 1 < argc) {
-            *n_bats = atoi(argv[++i]);
-        } else if (strcmp(argv[i], "--iters") == 0 && i + 1 < argc) {
-            *max_iters = atoi(argv[++i]);
-        } else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc) {
-            *seed = (unsigned int)strtoul(argv[++i], NULL, 10);
-        } else if (strcmp(argv[i], "--no-snapshot") == 0) {
-            *do_snapshot = 0;
-        } else if (strcmp(argv[i], "--quiet") == 0) {
-            *quiet = 1;
+static int run_hd(const BatArgs *args, const BatOptions *opts) {
+    int n_bats = args->n_bats, max_iters = args->max_iters, dim = opts->hd_dim;
+    int batch = bat_hd_batched(opts);
+    int group = batch ? n_bats : (opts->hd_group < n_bats ? opts->hd_group : n_bats);
+
+    if (opts->hd_slices > 1) {
+        fprintf(stderr, "--hd-slices needs the MPI back-end\n");
+        return 1;
+    }
+
+    BatTopology topo;
+    BatBindSlot where;
+    if (bat_topology_load(&topo) != 0) return 1;
+    bat_bind_self(&topo, opts->bind, 0, 1);
+    bat_bind_where(&topo, 0, &where);
+
+    BatArena arena;
+    size_t arena_bytes = bat_hd_pop_bytes(n_bats, dim) + bat_hd_scratch_bytes(bat_hd_tile_count(dim), group)
+                       + (batch ? bat_transform_bytes(opts->transform, dim, 2 * group) : 0);
+    if (bat_arena_create(&arena, arena_bytes, opts->pages) != 0) {
+        return 1;
+    }
+    BatHdPop pop;
+    BatHdScratch scratch;
+    BatTransform tf;
+    if (bat_hd_pop_create(&pop, &arena, n_bats, dim) != 0 || bat_hd_scratch_create(&scratch, &arena, &pop, group) != 0
+        || (batch && bat_transform_create(&tf, &arena, opts->transform, dim, 2 * group) != 0)) {
+        bat_arena_destroy(&arena);
+        return 1;
+    }
+    if (batch) pop.tf = &tf;
+    for (int i = 0; i < n_bats; i++) bat_hd_init_bat(&pop, i, (uint32_t)args->seed);
+    if (batch) bat_hd_eval_init(&pop);
+    bat_hd_select_best(&pop);
+
+    /* SIGUSR2 stops the run after the current iteration (no population dump with --dim). */
+    bat_signal_install();
+    long evals = n_bats;
+    long evals_to_target = -1;
+    int iters_done = max_iters;
+    BatCounters cnt = {0};
+
+    struct timespec t0, t1;
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+
+    for (int t = 0; t < max_iters; t++) {
+        double A_mean = bat_hd_mean_loudness(&pop);
+        cnt.amean_calls++;
+        cnt.amean_scanned += n_bats;
+
+        for (int first = 0; first < n_bats; first += group) {
+            int count = n_bats - first < group ? n_bats - first : group;
+            evals += bat_hd_update_group(&pop, &scratch, first, count, A_mean, t, &cnt);
+        }
+        if (bat_hd_select_best(&pop)) cnt.best_changes++;
+
+        if (!args->quiet && t % 100 == 0) {
+            printf("[Iteration %d] Best f_value = %f\n", t, pop.best_f);
         }
+        if (opts->has_target && pop.best_f >= opts->target) {
+            evals_to_target = evals;
+            iters_done = t + 1;
+            break;
+        }
+        if (bat_signal_take() & BAT_SIG_EXIT) {
+            fprintf(stderr, "SIGUSR2: stopping after iteration %d\n", t);
+            iters_done = t + 1;
+            break;
+        }
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    double elapsed = seconds_since(&t0, &t1);
+
+    if (!args->quiet) {
+        printf("Final best f_value = %f (bat %d, %d coordinates)\n", pop.best_f, pop.best_i, dim);
+    }
+    printf("BENCH version=sequential n_bats=%d iters=%d procs=1 threads=1 time_s=%.6f evals=%ld",
+           n_bats, iters_done, elapsed, evals);
+    bat_counters_print_bench(&cnt);
+    printf(" best_f=%.17g", pop.best_f);
+    bat_options_print_bench(opts);
+    bat_arena_print_bench(&arena);
+    bat_bind_print_bench(opts->bind, &where, 1);
+    bat_hd_print_bench(&pop, group, batch ? "batch" : "group");
+    if (batch) bat_transform_print_bench(&tf, tf.gemm_flops, tf.gemm_s);
+    if (opts->has_target) {
+        printf(" target=%g hit=%d evals_to_target=%ld", opts->target, evals_to_target >= 0, evals_to_target);
     }
+    if (args->bench_extra) printf("%s", args->bench_extra);
+    printf("\n");
+
+    bat_arena_destroy(&arena);
+    return 0;
 }
 
-int main(int argc, char **argv) {
-    int n_bats, max_iters, do_snapshot;
-    int quiet;
-    unsigned int seed;
-    parse_args(argc, argv, &n_bats, &max_iters, &seed, &do_snapshot, &quiet);
+/*
+ * Cooperative coevolution run (--cc, see bat_cc.h): rounds of --cc-iters
+ * iterations, the sub-swarms one after the other.
+ *
+ * Parameters:
+ *   - args : parsed command line
+ *   - opts : checked and applied options
+ */
+static int run_cc(const BatArgs *args, const BatOptions *opts) {
+    int n_bats = args->n_bats, max_iters = args->max_iters, dim = opts->hd_dim;
+
+    BatTopology topo;
+    BatBindSlot where;
+    if (bat_topology_load(&topo) != 0) return 1;
+    bat_bind_self(&topo, opts->bind, 0, 1);
+    bat_bind_where(&topo, 0, &where);
+
+    BatArena arena;
+    size_t arena_bytes = bat_hd_pop_bytes(n_bats, dim) + bat_cc_bytes(dim, n_bats, opts->cc_size)
+                       + bat_cc_scratch_bytes(dim);
+    if (bat_arena_create(&arena, arena_bytes, opts->pages) != 0) {
+        return 1;
+    }
+    BatHdPop pop;
+    BatCc cc;
+    BatCcScratch scratch;
+    if (bat_hd_pop_create(&pop, &arena, n_bats, dim) != 0
+        || bat_cc_create(&cc, &arena, opts->cc_kind, dim, n_bats, opts->cc_size, (uint32_t)args->seed) != 0
+        || bat_cc_scratch_create(&scratch, &arena, &cc) != 0) {
+        bat_arena_destroy(&arena);
+        return 1;
+    }
+    for (int i = 0; i < n_bats; i++) bat_hd_init_bat(&pop, i, (uint32_t)args->seed);
+    bat_hd_select_best(&pop);
+
+    /* SIGUSR2 stops the run after the current round. */
+    bat_signal_install();
+    long evals = n_bats;
+    long evals_to_target = -1;
+    int iters_done = max_iters;
+    BatCounters cnt = {0};
+
+    struct timespec t0, t1;
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+
+    for (int t = 0, round = 0; t < max_iters; t += opts->cc_iters, round++) {
+        int len = max_iters - t < opts->cc_iters ? max_iters - t : opts->cc_iters;
+        evals += bat_cc_regroup(&cc, &scratch, round);
+        bat_cc_pack(&cc, &pop, 0, n_bats);
+        for (int g = 0; g < cc.n_groups; g++) {
+            evals += bat_cc_run_group(&cc, &pop, &scratch, g, t, len, &cnt);
+        }
+        bat_cc_unpack(&cc, &pop, 0, n_bats);
+        evals += bat_cc_merge(&cc, &pop, &scratch, &cnt);
+        iters_done = t + len;
+
+        if (!args->quiet && round % 10 == 0) {
+            printf("[Iteration %d] Best f_value = %f\n", t, pop.best_f);
+        }
+        if (opts->has_target && pop.best_f >= opts->target) {
+            evals_to_target = evals;
+            break;
+        }
+        if (bat_signal_take() & BAT_SIG_EXIT) {
+            fprintf(stderr, "SIGUSR2: stopping after iteration %d\n", iters_done - 1);
+            break;
+        }
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    double elapsed = seconds_since(&t0, &t1);
+
+    if (!args->quiet) {
+        printf("Final best f_value = %f (context of %d groups, %d coordinates)\n", pop.best_f, cc.n_groups, dim);
+    }
+    printf("BENCH version=sequential n_bats=%d iters=%d procs=1 threads=1 time_s=%.6f evals=%ld",
+           n_bats, iters_done, elapsed, evals);
+    bat_counters_print_bench(&cnt);
+    printf(" best_f=%.17g", pop.best_f);
+    bat_options_print_bench(opts);
+    bat_arena_print_bench(&arena);
+    bat_bind_print_bench(opts->bind, &where, 1);
+    bat_cc_print_bench(&cc, opts->cc_iters);
+    if (opts->has_target) {
+        printf(" target=%g hit=%d evals_to_target=%ld", opts->target, evals_to_target >= 0, evals_to_target);
+    }
+    if (args->bench_extra) printf("%s", args->bench_extra);
+    printf("\n");
+
+    bat_arena_destroy(&arena);
+    return 0;
+}
+
+/* Binds the process (--bind) and returns its slot (malloc'ed), NULL on error. */
+static BatBindSlot *bind_self(const BatOptions *opts) {
+    BatTopology topo;
+    if (bat_topology_load(&topo) != 0) return NULL;
+    BatBindSlot *where = malloc(sizeof(*where));
+    if (!where) return NULL;
+    bat_bind_self(&topo, opts->bind, 0, 1);
+    bat_bind_where(&topo, 0, where);
+    return where;
+}
+
+/*
+ * Multi-objective run (--mo-objective, see bat_mo.h): every bat follows a
+ * guide drawn from the Pareto archive, and the non-dominated bats are
+ * merged into the archive after each iteration.
+ *
+ * Parameters:
+ *   - args : parsed command line
+ *   - opts : checked and applied options
+ */
+static int run_mo(const BatArgs *args, const BatOptions *opts) {
+    int n_bats = args->n_bats, max_iters = args->max_iters;
+
+    BatBindSlot *where = bind_self(opts);
+    if (!where) return 1;
+
+    BatModeRun run;
+    size_t arena_bytes = bat_arena_need((size_t)n_bats * sizeof(Bat)) + bat_mo_bytes(opts->mo_archive, n_bats);
+    if (bat_mode_begin(&run, args, arena_bytes, where, 1, 0, 1, 1) != 0) {
+        return 1;
+    }
+    Bat *bats = bat_arena_alloc(&run.arena, (size_t)n_bats * sizeof(Bat));
+    BatMoArchive arch;
+    if (!bats || bat_mo_create(&arch, &run.arena, opts->mo_archive, n_bats) != 0) {
+        bat_mode_end(&run);
+        return 1;
+    }
+
+    BatInitPlan plan;
+    if (bat_init_plan_create(&plan, opts->init_kind, 0, n_bats, (uint32_t)args->seed) != 0) {
+        bat_mode_end(&run);
+        return 1;
+    }
+    for (int i = 0; i < n_bats; i++) bat_init_one(&plan, &bats[i], i);
+    bat_init_plan_free(&plan);
+    bat_mo_merge(&arch, bat_mo_collect(bats, n_bats, arch.pt + arch.n));
+    double worst[BAT_MO_MAX];
+    bat_mo_worst(bats, n_bats, worst);
+    bat_mo_set_ref(&arch, worst);
+
+    long evals = n_bats;
+    BatCounters cnt = {0};
+
+    struct timespec t0, t1;
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+
+    for (int t = 0; t < max_iters; t++) {
+        double A_mean = bat_mean_loudness(bats, n_bats);
+        cnt.amean_calls++;
+        cnt.amean_scanned += n_bats;
+
+        for (int i = 0; i < n_bats; i++) {
+            Bat leader;
+            bat_mo_leader(&arch, &bats[i].rng_state, &leader);
+            evals += update_bat(&bats[i], &leader, A_mean, t, &cnt);
+        }
+        if (bat_mo_merge(&arch, bat_mo_collect(bats, n_bats, arch.pt + arch.n)) > 0) cnt.best_changes++;
+
+        if (!args->quiet && t % 100 == 0) {
+            printf("[Iteration %d] Pareto front = %d points\n", t, arch.n);
+        }
+        int sig = bat_signal_take();
+        if (sig) {
+            Bat best;
+            bat_mo_best(&arch, &best);
+            if (bat_mode_signals(&run, sig, t, bats, n_bats, &best)) break;
+        }
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    double elapsed = seconds_since(&t0, &t1);
+
+    if (!args->quiet) {
+        printf("Final Pareto front = %d points (%d objectives)\n", arch.n, bat_mo.n);
+    }
+    bat_mode_print_bench(&run, args, "sequential", 1, elapsed, evals, &cnt, arch.pt[0].f[0]);
+    bat_mo_print_bench(&arch);
+    bat_mode_end_bench(args);
+
+    int rc = opts->mo_front_path && bat_mo_write_front(&arch, opts->mo_front_path) != 0;
+    bat_mode_end(&run);
+    return rc;
+}
+
+/*
+ * Niching run (--niche-radius, see bat_niche.h): every bat follows the
+ * seed of its species, the population is split into species again after
+ * each iteration, and the niche bests are printed at the end.
+ *
+ * Parameters:
+ *   - args : parsed command line
+ *   - opts : checked and applied options
+ */
+static int run_niche(const BatArgs *args, const BatOptions *opts) {
+    int n_bats = args->n_bats, max_iters = args->max_iters;
+
+    BatBindSlot *where = bind_self(opts);
+    if (!where) return 1;
+
+    BatModeRun run;
+    size_t arena_bytes = bat_arena_need((size_t)n_bats * sizeof(Bat)) + bat_niche_bytes(n_bats, opts->niche_max);
+    if (bat_mode_begin(&run, args, arena_bytes, where, 1, 0, 1, 1) != 0) {
+        return 1;
+    }
+    Bat *bats = bat_arena_alloc(&run.arena, (size_t)n_bats * sizeof(Bat));
+    BatNiche niche;
+    BatInitPlan plan;
+    if (!bats || bat_niche_create(&niche, &run.arena, n_bats, opts->niche_max, opts->niche_radius) != 0
+        || bat_init_plan_create(&plan, opts->init_kind, opts->init_obl, n_bats, (uint32_t)args->seed) != 0) {
+        bat_mode_end(&run);
+        return 1;
+    }
+    for (int i = 0; i < n_bats; i++) bat_init_one(&plan, &bats[i], i);
+    bat_init_plan_free(&plan);
+
+    long evals = (long)n_bats * (opts->init_obl ? 2 : 1);
+    BatCounters cnt = {0};
+
+    struct timespec t0, t1, now;
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    bat_niche_speciate(&niche, bats);
+    bat_niche_record(&niche, 0, evals, 0.0);
+
+    for (int t = 0; t < max_iters; t++) {
+        double A_mean = bat_mean_loudness(bats, n_bats);
+        cnt.amean_calls++;
+        cnt.amean_scanned += n_bats;
+
+        for (int i = 0; i < n_bats; i++) {
+            evals += update_bat(&bats[i], &niche.guide[niche.species[i]], A_mean, t, &cnt);
+        }
+        double prev_best_f = niche.guide[0].f_value;
+        bat_niche_speciate(&niche, bats);
+        if (niche.guide[0].f_value > prev_best_f) cnt.best_changes++;
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        bat_niche_record(&niche, t + 1, evals, seconds_since(&t0, &now));
+
+        if (!args->quiet && t % 100 == 0) {
+            printf("[Iteration %d] Species = %d  Best f_value = %f\n", t, niche.n_species, niche.guide[0].f_value);
+        }
+        int sig = bat_signal_take();
+        if (sig && bat_mode_signals(&run, sig, t, bats, n_bats, &niche.guide[0])) break;
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    double elapsed = seconds_since(&t0, &t1);
+
+    bat_niche_report(&niche);
+    bat_mode_print_bench(&run, args, "sequential", 1, elapsed, evals, &cnt, niche.found[0].f);
+    bat_niche_print_bench(&niche);
+    bat_mode_end_bench(args);
+
+    bat_mode_end(&run);
+    return 0;
+}
+
+/*
+ * Sequential back-end (see bat_cli.h).
+ *
+ * Parameters:
+ *   - args : parsed command line
+ */
+int bat_run_sequential(const BatArgs *args) {
+    int n_bats = args->n_bats, max_iters = args->max_iters, do_snapshot = args->do_snapshot;
+    int quiet = args->quiet;
+    unsigned int seed = args->seed;
+    BatOptions opts = args->opts;
 
     if (n_bats <= 0 || max_iters <= 0) {
         fprintf(stderr, "Invalid parameters: n_bats=%d iters=%d\n", n_bats, max_iters);
         return 1;
     }
+    if (bat_options_check(&opts) != 0) {
+        return 1;
+    }
+    bat_options_apply(&opts);
+    if (opts.n_mo > 0) return run_mo(args, &opts);
+    if (opts.niche_radius > 0.0) return run_niche(args, &opts);
+    if (opts.cc_kind != BAT_CC_NONE) return run_cc(args, &opts);
+    if (opts.hd_dim > 0) return run_hd(args, &opts);
+
+    /*
+     * --deadline: the budget covers initialization too (it is the caller's
+     * latency budget); --iters then only acts as an upper bound.
+     */
+    BatDeadline deadline;
+    int use_deadline = opts.deadline_ms > 0.0;
+    if (use_deadline) bat_deadline_start(&deadline, opts.deadline_ms);
 
-    /* Allocate memory for the entire population of bats */
-    Bat *bats = malloc((size_t)n_bats * sizeof(Bat));
-    if (!bats) {
-        perror("malloc bats");
+    /* --bind: pin the (single) thread before the population is touched. */
+    BatTopology topo;
+    BatBindSlot where;
+    if (bat_topology_load(&topo) != 0) return 1;
+    bat_bind_self(&topo, opts.bind, 0, 1);
+    bat_bind_where(&topo, 0, &where);
+
+    /*
+     * Reserve the memory of the whole run up front (--hugepages): the
+     * population, with room for the largest ipop population, so nothing is
+     * allocated once the iterations start: the spare buffer of the dump
+     * writer and the --shrink sort buffers come from the same arena. Only
+     * the initial population is put on explicit huge pages.
+     */
+    int max_bats = bat_options_max_bats(&opts, n_bats);
+    size_t arena_bytes = bat_arena_need((size_t)max_bats * sizeof(Bat)) + bat_dump_writer_bytes(max_bats);
+    if (opts.shrink_kind != BAT_SHRINK_NONE) arena_bytes += bat_shrink_scratch_bytes(n_bats);
+    BatArena arena;
+    if (bat_arena_create_hot(&arena, arena_bytes, bat_arena_need((size_t)n_bats * sizeof(Bat)), opts.pages) != 0) {
         return 1;
     }
+    Bat *bats = bat_arena_alloc(&arena, (size_t)max_bats * sizeof(Bat));
+
+    /* SIGUSR1 = background dump (writer started before the loop), SIGUSR2 = checkpoint and exit. */
+    bat_signal_install();
+    int dump_pending = 0;
+    int iters_done = max_iters;
+
+    /* --refine statistics (objective evaluations, accepted refinements). */
+    long refine_evals = 0;
+    int refine_hits = 0;
+
+    /* Objective evaluations (initialization included) and --target bookkeeping. */
+    long evals = (long)n_bats * (opts.init_obl ? 2 : 1);
+    long evals_to_target = -1;
+
+    /* Behavior counters (local searches, acceptances, ...) for the BENCH line. */
+    BatCounters cnt = {0};
 
     Bat best_bat;
-    /* Initialize the population with random positions and find the initial best solution */
-    initialize_bats_seeded(bats, n_bats, &best_bat, (uint32_t)seed);
+    /* Initialize the population (--init / --obl strategy) and find the initial best solution */
+    BatInitPlan plan;
+    if (bat_init_plan_create(&plan, opts.init_kind, opts.init_obl, n_bats, (uint32_t)seed) != 0) {
+        bat_arena_destroy(&arena);
+        return 1;
+    }
+    initialize_bats_plan(bats, n_bats, &best_bat, &plan);
+    bat_init_plan_free(&plan);
+
+    /* --constraint: epsilon level from the initial violations, ranks under it. */
+    if (bat_con.n > 0) {
+        BatExactSum viol;
+        bat_con_violation_sum(bats, n_bats, &viol);
+        bat_con_start(&viol, n_bats, max_iters);
+        bat_con_rerank(bats, n_bats);
+        select_best_bat(bats, n_bats, &best_bat);
+    }
+
+    /*
+     * --restart: diversity monitor and archive of the best bat over all
+     * restarts. The archive is what the program reports; best_bat only
+     * guides the current population. n_bats may grow (ipop), the BENCH
+     * line keeps the initial size.
+     */
+    int use_restart = opts.restart_kind != BAT_RESTART_NONE;
+    int n_bats_init = n_bats;
+    BatRestart restart;
+    bat_restart_init(&restart, opts.restart_kind, opts.restart_div, opts.restart_frac, opts.restart_grow,
+                     max_bats, opts.restart_gap, opts.restart_stall, &best_bat);
+    BatDiversity div;
+    bat_diversity_reset(&div, bats, n_bats, best_bat.x_i);
+
+    /* --trace: best bat of every iteration (for cross-back-end comparisons). */
+    FILE *trace = NULL;
+    if (opts.trace_path && !(trace = bat_trace_open(opts.trace_path))) {
+        bat_arena_destroy(&arena);
+        return 1;
+    }
 
     /* Start timing the execution */
+    BatDumpWriter *writer = bat_dump_writer_create(&arena, max_bats);
+
     struct timespec t0, t1;
     clock_gettime(CLOCK_MONOTONIC, &t0);
+    if (use_deadline) bat_deadline_loop_start(&deadline);
+
+    /* --targets: time-to-target records (initialization counts as time 0). */
+    BatTimeToTarget ttt = opts.ttt;
+    bat_ttt_start(&ttt, bat_objective_optimum(opts.objective));
+    bat_ttt_update(&ttt, best_bat.f_value, evals, 0.0);
 
     /* Main optimization loop */
     for (int t = 0; t < max_iters; t++) {
 
+        /* --constraint: epsilon level / penalty weight of this iteration (re-ranks when it changes). */
+        if (bat_con.n > 0 && bat_con_advance(t, &best_bat)) {
+            bat_con_rerank(bats, n_bats);
+            bat_con_rerank(&restart.archive, 1);
+            select_best_bat(bats, n_bats, &best_bat);
+            bat_restart_archive(&restart, &best_bat);
+        }
+
         /* Use the best solution from the previous iteration as a read-only guide */
         Bat best_snapshot = best_bat;
-        
+
+        /* Average loudness at the start of the iteration (same for every bat) */
+        double A_mean = bat_mean_loudness(bats, n_bats);
+        cnt.amean_calls++;
+        cnt.amean_scanned += n_bats;
+
         /* Update each bat in the population sequentially */
         for (int i = 0; i < n_bats; i++) {
-            update_bat(bats, n_bats, &best_snapshot, i, t);
+            evals += update_bat_tracked(&bats[i], &best_snapshot, A_mean, t - restart.t_last, &cnt,
+                                        use_restart ? &div : NULL);
         }
 
         /* Recompute best after all bats have been updated */
@@ -140,6 +602,52 @@ int main(int argc, char **argv) {
             }
         }
 
+        /* Periodic local refinement of the global best (--refine). */
+        if (opts.refine_method != BAT_REFINE_NONE && (t + 1) % opts.refine_every == 0) {
+            double x[dimension];
+            double f_x = best_bat.f_value;
+            for (int d = 0; d < dimension; d++) x[d] = best_bat.x_i[d];
+            int used = bat_refine(opts.refine_method, x, &f_x, opts.refine_evals, opts.refine_step);
+            refine_evals += used;
+            evals += used;
+            if (f_x > best_bat.f_value) {
+                /* Feed the polished point back: it replaces the worst bat. */
+                best_bat = bats[bat_inject(bats, n_bats, x, f_x)];
+                refine_hits++;
+                if (use_restart) bat_diversity_reset(&div, bats, n_bats, div.ref);
+            }
+        }
+        if (best_bat.f_value > best_snapshot.f_value) cnt.best_changes++;
+        bat_restart_archive(&restart, &best_bat);
+
+        /* --restart: re-initialize the population once it has collapsed. */
+        if (use_restart) {
+            if ((t + 1) % BAT_DIVERSITY_RESYNC == 0) {
+                bat_diversity_reset(&div, bats, n_bats, best_bat.x_i);
+            }
+            if (bat_restart_due(&restart, bat_diversity_value(&div), t)) {
+                int new_n = bat_restart_next_size(&restart, n_bats, 1);
+                if (new_n > n_bats) n_bats = new_n;   /* the arena holds max_bats bats */
+                long used = bat_restart_apply(&restart, bats, n_bats, 0, n_bats, opts.init_kind, opts.init_obl,
+                                              (uint32_t)seed, t);
+                if (used > 0) evals += used;
+                select_best_bat(bats, n_bats, &best_bat);
+                bat_restart_archive(&restart, &best_bat);
+                bat_diversity_reset(&div, bats, n_bats, best_bat.x_i);
+            }
+        }
+
+        /*
+         * --shrink: drop the worst bats to follow the population-size
+         * schedule (the best bat is never dropped, so best_bat stays valid).
+         */
+        if (opts.shrink_kind != BAT_SHRINK_NONE) {
+            int target_n = bat_shrink_target(opts.shrink_kind, n_bats_init, opts.shrink_min, t + 1, max_iters);
+            if (target_n < n_bats) n_bats = bat_shrink_local(bats, n_bats, target_n, &arena);
+        }
+
+        if (trace) bat_trace_write(trace, t, &best_bat);
+
         /* Optional snapshots at fixed iteration numbers (for the report). */
         if (do_snapshot) {
             if (t == 0) {
@@ -153,33 +661,117 @@ int main(int argc, char **argv) {
             }
         }
 
+        /* Signal requests are served here, where every bat is fully updated. */
+        int sig = bat_signal_take();
+        if (sig & BAT_SIG_DUMP) dump_pending = 1;
+        if (dump_pending) {
+            char path[64];
+            snprintf(path, sizeof(path), "dump_t%06d.bin", t);
+            /* If the previous dump is still being written, retry next iteration (errors are printed and dropped). */
+            if (bat_dump_writer_submit(writer, path, bats, n_bats, &restart.archive, t, (uint32_t)seed, 0, 1, 0)
+                != BAT_DUMP_BUSY) {
+                dump_pending = 0;
+            }
+        }
+        if (sig & BAT_SIG_EXIT) {
+            char path[64];
+            snprintf(path, sizeof(path), "checkpoint_t%06d.bin", t);
+            bat_write_population(path, bats, n_bats, &restart.archive, t, (uint32_t)seed, 0, 1);
+            fprintf(stderr, "SIGUSR2: checkpoint written to %s, stopping after iteration %d\n", path, t);
+            iters_done = t + 1;
+            break;
+        }
+
         /* Print progress every 100 iterations (disabled in --quiet mode). */
         if (!quiet && t % 100 == 0) {
-            printf("[Iteration %d] Best f_value = %f  Position = (", t, best_bat.f_value);
+            printf("[Iteration %d] Best f_value = %f  Position = (", t, restart.archive.f_value);
             for (int d = 0; d < dimension; d++) {
-                printf("%s%f", (d == 0 ? "" : ", "), best_bat.x_i[d]);
+                printf("%s%f", (d == 0 ? "" : ", "), restart.archive.x_i[d]);
             }
             printf(")\n");
         }
+
+        /* --target: stop as soon as the best reaches the target value. */
+        if (opts.has_target && restart.archive.f_value >= opts.target) {
+            evals_to_target = evals;
+            iters_done = t + 1;
+            break;
+        }
+
+        /* --targets: record the targets reached, stop after the last one. */
+        if (ttt.n > 0) {
+            struct timespec now;
+            clock_gettime(CLOCK_MONOTONIC, &now);
+            if (bat_ttt_update(&ttt, restart.archive.f_value, evals, seconds_since(&t0, &now))) {
+                iters_done = t + 1;
+                break;
+            }
+        }
+
+        /* Stop early when the next iteration would not fit in the budget. */
+        if (use_deadline && !bat_deadline_next(&deadline)) {
+            iters_done = t + 1;
+            break;
+        }
     }
 
     /* Stop timing */
     clock_gettime(CLOCK_MONOTONIC, &t1);
     double elapsed = seconds_since(&t0, &t1);
+    if (use_deadline) bat_deadline_finish(&deadline);
+
+    /* Let an in-flight background dump finish before exiting. */
+    bat_dump_writer_destroy(writer);
+
+    if (trace) fclose(trace);
+    if (opts.final_pop_path) {
+        bat_write_population(opts.final_pop_path, bats, n_bats, &restart.archive, iters_done, (uint32_t)seed, 0, 1);
+    }
 
     if (!quiet) {
-        printf("Final best f_value = %f\n", best_bat.f_value);
+        printf("Final best f_value = %f\n", restart.archive.f_value);
         printf("Final position = (");
         for (int d = 0; d < dimension; d++) {
-            printf("%s%f", (d == 0 ? "" : ", "), best_bat.x_i[d]);
+            printf("%s%f", (d == 0 ? "" : ", "), restart.archive.x_i[d]);
         }
         printf(")\n");
     }
 
     /* Output benchmark result in a machine-readable format */
-    printf("BENCH version=sequential n_bats=%d iters=%d procs=1 threads=1 time_s=%.6f\n",
-           n_bats, max_iters, elapsed);
+    printf("BENCH version=sequential n_bats=%d iters=%d procs=1 threads=1 time_s=%.6f evals=%ld",
+           n_bats_init, iters_done, elapsed, evals);
+    bat_counters_print_bench(&cnt);
+    printf(" best_f=%.17g", restart.archive.f_value);
+    if (use_deadline) {
+        printf(" deadline_ms=%.3f deadline_miss=%d slack_ms=%.3f pred_iters=%d",
+               opts.deadline_ms, deadline.missed, bat_deadline_slack_ms(&deadline), deadline.pred_iters);
+    }
+    bat_options_print_bench(&opts);
+    if (bat_con.n > 0) bat_con_print_bench(&restart.archive);
+    bat_arena_print_bench(&arena);
+    bat_bind_print_bench(opts.bind, &where, 1);
+    if (opts.refine_method != BAT_REFINE_NONE) {
+        printf(" refine=%s refine_evals=%ld refine_hits=%d", bat_refine_name(opts.refine_method), refine_evals, refine_hits);
+    }
+    bat_restart_print_bench(&restart, n_bats, bat_diversity_value(&div));
+    if (opts.shrink_kind != BAT_SHRINK_NONE) {
+        printf(" shrink=%s n_bats_final=%d", bat_shrink_name(opts.shrink_kind), n_bats);
+    }
+    if (opts.has_target) {
+        printf(" target=%g hit=%d evals_to_target=%ld", opts.target, evals_to_target >= 0, evals_to_target);
+    }
+    bat_ttt_print_bench(&ttt);
+    if (args->bench_extra) printf("%s", args->bench_extra);
+    printf("\n");
 
-    free(bats);
+    bat_arena_destroy(&arena);
     return 0;
 }
+
+#ifndef BAT_NO_MAIN
+int main(int argc, char **argv) {
+    BatArgs args;
+    bat_args_parse(&args, argc, argv);
+    return bat_run_sequential(&args);
+}
+#endif
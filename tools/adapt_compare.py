@@ -0,0 +1,88 @@
+#!/usr/bin/env python3
+"""Compare fixed-parameter and adaptive Bat Algorithm variants.
+
+Usage:
+  python3 tools/adapt_compare.py --exe code/sequential --seeds 10 --iters 5000
+
+For every built-in objective and every `--adapt` mode, the program is run with
+`--target <optimum - tol>` over several seeds. The script reads the BENCH lines
+(`hit=` and `evals_to_target=` fields) and prints, per objective and mode:
+
+- success rate: fraction of seeds that reached the target
+- mean evaluations to target over the successful seeds
+- ERT (expected running time): total evaluations spent over all seeds
+  divided by the number of successes
+"""
+
+from __future__ import annotations
+
+import argparse
+import os
+import subprocess
+import sys
+from typing import Dict, List
+
+sys.path.insert(0, os.path.dirname(os.path.abspath(__file__)))
+from bench_analyze import parse_lines  # noqa: E402
+
+# Maximum value of each objective (see bat_objective_optimum() in bat_utils.c).
+OBJECTIVES = {
+    "paraboloid": 10.0,
+    "sphere": 0.0,
+    "rastrigin": 0.0,
+    "ackley": 0.0,
+    "griewank": 0.0,
+    "rosenbrock": 0.0,
+}
+
+MODES = ["none", "history", "freq", "both"]
+
+
+def run_one(exe: str, objective: str, mode: str, seed: int, args: argparse.Namespace) -> Dict[str, str]:
+    target = OBJECTIVES[objective] - args.tol
+    cmd = [
+        exe,
+        "--objective", objective,
+        "--adapt", mode,
+        "--target", repr(target),
+        "--n-bats", str(args.n_bats),
+        "--iters", str(args.iters),
+        "--seed", str(seed),
+        "--quiet",
+        "--no-snapshot",
+    ]
+    out = subprocess.run(cmd, check=True, capture_output=True, text=True).stdout
+    rows = parse_lines(out.splitlines())
+    if not rows:
+        raise SystemExit(f"No BENCH line from: {' '.join(cmd)}")
+    return rows[-1].extra
+
+
+def main() -> None:
+    ap = argparse.ArgumentParser()
+    ap.add_argument("--exe", default="code/sequential", help="Program to run (sequential or openmp_bat)")
+    ap.add_argument("--seeds", type=int, default=10, help="Number of seeds per configuration")
+    ap.add_argument("--n-bats", type=int, default=40)
+    ap.add_argument("--iters", type=int, default=5000, help="Iteration cap of each run")
+    ap.add_argument("--tol", type=float, default=1e-6, help="Target is optimum - tol")
+    args = ap.parse_args()
+
+    print(f"{'objective':<12} {'adapt':<8} {'success':>8} {'mean_evals':>12} {'ERT':>12}")
+    for objective in OBJECTIVES:
+        for mode in MODES:
+            hits: List[int] = []
+            spent = 0
+            for seed in range(1, args.seeds + 1):
+                extra = run_one(args.exe, objective, mode, seed, args)
+                spent += int(extra["evals"])
+                if extra.get("hit") == "1":
+                    hits.append(int(extra["evals_to_target"]))
+
+            rate = len(hits) / args.seeds
+            mean = f"{sum(hits) / len(hits):.0f}" if hits else "-"
+            ert = f"{spent / len(hits):.0f}" if hits else "inf"
+            print(f"{objective:<12} {mode:<8} {rate:>8.2f} {mean:>12} {ert:>12}")
+
+
+if __name__ == "__main__":
+    main()
@@ -7,6 +7,48 @@ Usage:
 The program expects lines like:
   BENCH version=openmp n_bats=2000 iters=2000 procs=1 threads=4 time_s=3.890662
 
+Optional features append extra `key=value` fields after time_s (for example
+`deadline_ms=50.000 deadline_miss=0 slack_ms=1.3 pred_iters=31` with
+--deadline). They are kept in `BenchRow.extra` and ignored by the scaling
+metrics.
+
+Time-to-target runs (`--targets`, see code/ttt.pbs) carry
+`ttt_prec= ttt_evals= ttt_s=` lists. They are excluded from the scaling
+metrics (their iteration counts vary) and analysed COCO-style instead:
+
+- ERT (expected running time) per objective, backend, binding, p and target:
+      ERT = (sum over runs of the evaluations [or seconds] spent until the
+             target was reached, or until the run stopped if it was not)
+            / (number of runs that reached the target)
+  written to `ert.csv` and printed as a table.
+- Runtime distributions: for each backend, binding and p, the ECDF of the
+  evaluations (and seconds) needed over all (run, target) pairs, pooled over
+  objectives and seeds; unreached pairs count as "never". Written to
+  `ecdf.csv` (+ `ecdf_evals.png` / `ecdf_seconds.png` with matplotlib).
+
+Work counters (`evals= local_search= accepts= clamps= amean_calls=
+amean_scanned= best_changes=`, summed over threads and ranks) explain run
+times that the scaling metrics alone cannot (e.g. a parallel run doing
+less work than the sequential one). For every row that has them,
+`work_metrics.csv` gives the time per unit of actual work:
+
+- ns_per_eval   = time_s / evals
+- ns_per_update = time_s / (n_bats * iters)   (one bat update = one move)
+- rates per bat update: local searches, acceptances, clamps, bats scanned
+  by the average-loudness computations
+- work_ratio    = evals / evals of the sequential run with the same
+                  (n_bats, iters); != 1 means the runs did different work
+- work_speedup  = (T_seq / evals_seq) / (Tp / evals_p): speedup per
+                  evaluation, unaffected by differences in work
+
+Thread / rank placement (`--bind`, see code/include/bat_bind.h) is part
+of every grouping key: rows with different `bind=` values are separate
+series, so a compact 4-thread run is never compared with (or used as the
+baseline of) a spread one. Rows without the field count as `bind=none`.
+`bench_metrics.csv` and `work_metrics.csv` carry the `bind`, `cores` and
+`smt_shared` fields (physical cores used, and threads / ranks sharing a
+core with another one).
+
 Key ideas / conventions used by this script:
 
 - `p` (parallelism level):
@@ -49,7 +91,7 @@ import argparse
 import csv
 import os
 import re
-from dataclasses import dataclass
+from dataclasses import dataclass, field
 from typing import Iterable, List, Dict, Tuple, Optional
 
 BENCH_RE = re.compile(
@@ -59,7 +101,8 @@ BENCH_RE = re.compile(
     r"iters=(?P<iters>\d+)\s+"
     r"procs=(?P<procs>\d+)\s+"
     r"threads=(?P<threads>\d+)\s+"
-    r"time_s=(?P<time_s>[0-9.]+)\s*$"
+    r"time_s=(?P<time_s>[0-9.]+)"
+    r"(?P<extra>(?:\s+\S+=\S+)*)\s*$"
 )
 
 
@@ -71,6 +114,8 @@ class BenchRow:
     procs: int
     threads: int
     time_s: float
+    # Optional trailing key=value fields (feature-specific, kept as strings).
+    extra: Dict[str, str] = field(default_factory=dict, compare=False, hash=False)
 
     @property
     def p(self) -> int:
@@ -81,6 +126,11 @@ class BenchRow:
             return self.procs
         return 1
 
+    @property
+    def bind(self) -> str:
+        """Placement policy (--bind), `none` for runs without the field."""
+        return self.extra.get("bind", "none")
+
 
 def parse_lines(lines: Iterable[str]) -> List[BenchRow]:
     """Extract BENCH lines from a text stream.
@@ -101,14 +151,20 @@ def parse_lines(lines: Iterable[str]) -> List[BenchRow]:
                 procs=int(m.group("procs")),
                 threads=int(m.group("threads")),
                 time_s=float(m.group("time_s")),
+                extra=dict(kv.split("=", 1) for kv in m.group("extra").split()),
             )
         )
     return rows
 
 
-def group_key(row: BenchRow) -> Tuple[str, int, int]:
-    """Group key for strong scaling: version + (n_bats, iters)."""
-    return (row.version, row.n_bats, row.iters)
+def group_key(row: BenchRow) -> Tuple[str, str, int, int]:
+    """Group key for strong scaling: version + binding + (n_bats, iters)."""
+    return (row.version, row.bind, row.n_bats, row.iters)
+
+
+def placement(row: BenchRow) -> Dict[str, object]:
+    """Placement fields of a row (--bind report), for the CSV outputs."""
+    return {"bind": row.bind, "cores": row.extra.get("cores", ""), "smt_shared": row.extra.get("smt_shared", "")}
 
 
 def find_baseline(rows: List[BenchRow], n_bats: int, iters: int) -> float:
@@ -124,9 +180,11 @@ def find_baseline(rows: List[BenchRow], n_bats: int, iters: int) -> float:
     return min(r.time_s for r in candidates)
 
 
-def find_self_baseline(rows: List[BenchRow], version: str, n_bats: int, iters: int) -> Optional[float]:
-    """Self baseline for a version: Tp at p=1 for the same (n_bats, iters)."""
-    candidates = [r for r in rows if r.version == version and r.n_bats == n_bats and r.iters == iters and r.p == 1]
+def find_self_baseline(rows: List[BenchRow], version: str, n_bats: int, iters: int,
+                       bind: str = "none") -> Optional[float]:
+    """Self baseline for a version: Tp at p=1 for the same (n_bats, iters) and binding."""
+    candidates = [r for r in rows if r.version == version and r.n_bats == n_bats and r.iters == iters and r.p == 1
+                  and r.bind == bind]
     if not candidates:
         return None
     return min(r.time_s for r in candidates)
@@ -141,12 +199,12 @@ def _strong_metrics(rows: List[BenchRow]) -> List[Dict[str, object]]:
     # In weak scaling, n_bats changes with p, so you often get only one point per
     # (n_bats, iters). If we plotted those as strong scaling, we'd create lots of
     # useless single-point PNGs.
-    strong_keys: set[Tuple[str, int, int]] = set()
-    by_key: Dict[Tuple[str, int, int], set[int]] = {}
+    strong_keys: set[Tuple[str, str, int, int]] = set()
+    by_key: Dict[Tuple[str, str, int, int], set[int]] = {}
     for r in rows:
         if r.version == "sequential":
             continue
-        k = (r.version, r.n_bats, r.iters)
+        k = group_key(r)
         by_key.setdefault(k, set()).add(r.p)
     for k, ps in by_key.items():
         if len(ps) >= 2:
@@ -163,8 +221,7 @@ def _strong_metrics(rows: List[BenchRow]) -> List[Dict[str, object]]:
 
     for r in rows:
         if r.version != "sequential":
-            k = (r.version, r.n_bats, r.iters)
-            if k not in strong_keys:
+            if group_key(r) not in strong_keys:
                 continue
 
         key = (r.n_bats, r.iters)
@@ -172,7 +229,7 @@ def _strong_metrics(rows: List[BenchRow]) -> List[Dict[str, object]]:
             continue
 
         t_seq1 = baselines[key]
-        t_self1 = find_self_baseline(rows, r.version, r.n_bats, r.iters)
+        t_self1 = find_self_baseline(rows, r.version, r.n_bats, r.iters, r.bind)
         if t_self1 is None:
             # If a version doesn't have p=1 data, we cannot compute self-baseline metrics.
             t_self1 = t_seq1
@@ -190,6 +247,7 @@ def _strong_metrics(rows: List[BenchRow]) -> List[Dict[str, object]]:
             {
                 "mode": "strong",
                 "version": r.version,
+                **placement(r),
                 "n_bats": r.n_bats,
                 "iters": r.iters,
                 "procs": r.procs,
@@ -239,14 +297,14 @@ def _weak_metrics(rows: List[BenchRow]) -> List[Dict[str, object]]:
 
     iters_set = sorted({r.iters for r in rows})
     for iters in iters_set:
-        for version in sorted({r.version for r in rows}):
+        for version, bind in sorted({(r.version, r.bind) for r in rows}):
             if version == "sequential":
                 continue
 
             baseline_seq = _weak_baseline(rows, iters, version)
             baseline_self = _weak_baseline(rows, iters, version)
-            # For self baseline, prefer p=1 run of the same version.
-            same = [r for r in rows if r.iters == iters and r.version == version and r.p == 1]
+            # For self baseline, prefer p=1 run of the same version and binding.
+            same = [r for r in rows if r.iters == iters and r.version == version and r.p == 1 and r.bind == bind]
             if same:
                 baseline_self = min(same, key=lambda r: r.n_bats)
 
@@ -258,7 +316,7 @@ def _weak_metrics(rows: List[BenchRow]) -> List[Dict[str, object]]:
             base_n = baseline.n_bats
             t_base_self = baseline_self.time_s if baseline_self is not None else t_base_seq
 
-            candidates = [r for r in rows if r.iters == iters and r.version == version]
+            candidates = [r for r in rows if r.iters == iters and r.version == version and r.bind == bind]
             for r in candidates:
                 p = r.p
                 weak_eff_seq = t_base_seq / r.time_s if r.time_s > 0 else 0.0
@@ -270,6 +328,7 @@ def _weak_metrics(rows: List[BenchRow]) -> List[Dict[str, object]]:
                     {
                         "mode": "weak",
                         "version": r.version,
+                        **placement(r),
                         "n_bats": r.n_bats,
                         "iters": r.iters,
                         "procs": r.procs,
@@ -294,6 +353,7 @@ def _weak_metrics(rows: List[BenchRow]) -> List[Dict[str, object]]:
                 {
                     "mode": "weak",
                     "version": baseline.version,
+                    **placement(baseline),
                     "n_bats": baseline.n_bats,
                     "iters": baseline.iters,
                     "procs": baseline.procs,
@@ -319,6 +379,7 @@ def _weak_metrics(rows: List[BenchRow]) -> List[Dict[str, object]]:
         key = (
             m["mode"],
             m["version"],
+            m["bind"],
             m["n_bats"],
             m["iters"],
             m["procs"],
@@ -328,6 +389,191 @@ def _weak_metrics(rows: List[BenchRow]) -> List[Dict[str, object]]:
     return list(uniq.values())
 
 
+def _ttt_records(row: BenchRow) -> List[Tuple[float, int, float]]:
+    """(precision, evals, seconds) per target of a --targets run (-1 = not reached)."""
+    precs = [float(v) for v in row.extra["ttt_prec"].split(",")]
+    evals = [int(v) for v in row.extra["ttt_evals"].split(",")]
+    secs = [float(v) for v in row.extra["ttt_s"].split(",")]
+    return list(zip(precs, evals, secs))
+
+
+def compute_ert(rows: List[BenchRow]) -> List[Dict[str, object]]:
+    """ERT per (objective, version, binding, p, n_bats, target precision)."""
+    groups: Dict[Tuple[str, str, str, int, int], List[BenchRow]] = {}
+    for r in rows:
+        key = (r.extra.get("objective", "paraboloid"), r.version, r.bind, r.p, r.n_bats)
+        groups.setdefault(key, []).append(r)
+
+    out: List[Dict[str, object]] = []
+    for (objective, version, bind, p, n_bats), runs in sorted(groups.items()):
+        precs = sorted({prec for r in runs for prec, _, _ in _ttt_records(r)}, reverse=True)
+        for prec in precs:
+            hits = 0
+            spent_evals = 0.0
+            spent_s = 0.0
+            n_runs = 0
+            for r in runs:
+                rec = {pr: (ev, sec) for pr, ev, sec in _ttt_records(r)}
+                if prec not in rec:
+                    continue
+                n_runs += 1
+                ev, sec = rec[prec]
+                if ev >= 0:
+                    hits += 1
+                    spent_evals += ev
+                    spent_s += sec
+                else:
+                    # Unsuccessful run: everything it spent counts.
+                    spent_evals += float(r.extra.get("evals", 0))
+                    spent_s += r.time_s
+            out.append(
+                {
+                    "objective": objective,
+                    "version": version,
+                    "bind": bind,
+                    "p": p,
+                    "n_bats": n_bats,
+                    "prec": prec,
+                    "runs": n_runs,
+                    "successes": hits,
+                    "success_rate": hits / n_runs if n_runs else 0.0,
+                    "ert_evals": spent_evals / hits if hits else float("inf"),
+                    "ert_s": spent_s / hits if hits else float("inf"),
+                }
+            )
+    return out
+
+
+def compute_ecdf(rows: List[BenchRow]) -> List[Dict[str, object]]:
+    """Runtime-distribution ECDF points per (version, binding, p), in evaluations and seconds."""
+    groups: Dict[Tuple[str, str, int], List[Tuple[int, float]]] = {}
+    for r in rows:
+        for _, ev, sec in _ttt_records(r):
+            groups.setdefault((r.version, r.bind, r.p), []).append((ev, sec))
+
+    out: List[Dict[str, object]] = []
+    for (version, bind, p), pairs in sorted(groups.items()):
+        total = len(pairs)
+        for measure, idx in (("evals", 0), ("seconds", 1)):
+            reached = sorted(float(pair[idx]) for pair in pairs if pair[0] >= 0)
+            for i, x in enumerate(reached, start=1):
+                out.append({"version": version, "bind": bind, "p": p, "measure": measure, "x": x,
+                            "fraction": i / total})
+    return out
+
+
+def print_ert_table(ert: List[Dict[str, object]]) -> None:
+    print(f"{'objective':<12} {'version':<10} {'bind':<8} {'p':>3} {'n_bats':>7} {'prec':>8} {'succ':>6} "
+          f"{'ERT_evals':>12} {'ERT_s':>10}")
+    for m in ert:
+        print(
+            f"{m['objective']:<12} {m['version']:<10} {m['bind']:<8} {m['p']:>3} {m['n_bats']:>7} {m['prec']:>8g} "
+            f"{m['success_rate']:>6.2f} {m['ert_evals']:>12.0f} {m['ert_s']:>10.4g}"
+        )
+
+
+def try_plot_ecdf(ecdf: List[Dict[str, object]], outdir: str) -> None:
+    try:
+        import matplotlib.pyplot as plt  # type: ignore
+    except Exception:
+        print("matplotlib not available; skipping ECDF plots. Install with: pip install matplotlib")
+        return
+
+    for measure, xlabel in (("evals", "objective evaluations"), ("seconds", "seconds")):
+        series: Dict[Tuple[str, str, int], List[Dict[str, object]]] = {}
+        for m in ecdf:
+            if m["measure"] == measure:
+                series.setdefault((str(m["version"]), str(m["bind"]), int(m["p"])), []).append(m)
+        if not series:
+            continue
+
+        plt.figure()
+        for (version, bind, p), ms in sorted(series.items()):
+            xs = [float(m["x"]) for m in ms]
+            ys = [float(m["fraction"]) for m in ms]
+            label = f"{version} p={p}" if bind == "none" else f"{version} ({bind}) p={p}"
+            plt.step(xs, ys, where="post", label=label)
+        plt.xscale("log")
+        plt.ylim(0.0, 1.0)
+        plt.xlabel(f"{xlabel} to reach the target")
+        plt.ylabel("fraction of (run, target) pairs")
+        plt.title(f"Runtime distribution ({measure})")
+        plt.grid(True, alpha=0.3)
+        plt.legend()
+        plt.savefig(os.path.join(outdir, f"ecdf_{measure}.png"), dpi=150, bbox_inches="tight")
+        plt.close()
+
+
+def write_csv(path: str, rows: List[Dict[str, object]], fieldnames: List[str]) -> None:
+    with open(path, "w", newline="", encoding="utf-8") as f:
+        w = csv.DictWriter(f, fieldnames=fieldnames)
+        w.writeheader()
+        for r in rows:
+            w.writerow(r)
+    print(f"Wrote {path}")
+
+
+WORK_FIELDS = [
+    "version", "bind", "cores", "smt_shared", "n_bats", "iters", "p", "time_s", "evals", "ns_per_eval", "ns_per_update",
+    "local_search_rate", "accept_rate", "clamp_rate", "scanned_per_update", "best_changes",
+    "work_ratio", "work_speedup",
+]
+
+
+def compute_work_metrics(rows: List[BenchRow]) -> List[Dict[str, object]]:
+    """Time per unit of work, from the behavior counters of each row."""
+    counted = [r for r in rows if "evals" in r.extra and "local_search" in r.extra]
+
+    # Sequential reference per (n_bats, iters): fastest run, with its evaluations.
+    seq_ref: Dict[Tuple[int, int], Tuple[float, int]] = {}
+    for r in counted:
+        if r.version == "sequential":
+            key = (r.n_bats, r.iters)
+            if key not in seq_ref or r.time_s < seq_ref[key][0]:
+                seq_ref[key] = (r.time_s, int(r.extra["evals"]))
+
+    out: List[Dict[str, object]] = []
+    for r in counted:
+        evals = int(r.extra["evals"])
+        updates = r.n_bats * r.iters
+        m: Dict[str, object] = {
+            "version": r.version,
+            **placement(r),
+            "n_bats": r.n_bats,
+            "iters": r.iters,
+            "p": r.p,
+            "time_s": r.time_s,
+            "evals": evals,
+            "ns_per_eval": r.time_s * 1e9 / evals if evals > 0 else 0.0,
+            "ns_per_update": r.time_s * 1e9 / updates if updates > 0 else 0.0,
+            "local_search_rate": int(r.extra["local_search"]) / updates if updates > 0 else 0.0,
+            "accept_rate": int(r.extra["accepts"]) / updates if updates > 0 else 0.0,
+            "clamp_rate": int(r.extra["clamps"]) / updates if updates > 0 else 0.0,
+            "scanned_per_update": int(r.extra["amean_scanned"]) / updates if updates > 0 else 0.0,
+            "best_changes": int(r.extra["best_changes"]),
+            "work_ratio": "",
+            "work_speedup": "",
+        }
+        ref = seq_ref.get((r.n_bats, r.iters))
+        if ref and ref[1] > 0 and evals > 0 and r.time_s > 0:
+            m["work_ratio"] = evals / ref[1]
+            m["work_speedup"] = (ref[0] / ref[1]) / (r.time_s / evals)
+        out.append(m)
+    return out
+
+
+def print_work_table(work: List[Dict[str, object]]) -> None:
+    print(f"{'version':<10} {'bind':<8} {'n_bats':>7} {'iters':>7} {'p':>3} {'ns/eval':>9} {'ls/upd':>7} "
+          f"{'scan/upd':>9} {'work_ratio':>10} {'work_speedup':>12}")
+    for m in work:
+        ratio = f"{m['work_ratio']:.3f}" if m["work_ratio"] != "" else "-"
+        speedup = f"{m['work_speedup']:.2f}" if m["work_speedup"] != "" else "-"
+        print(
+            f"{m['version']:<10} {m['bind']:<8} {m['n_bats']:>7} {m['iters']:>7} {m['p']:>3} {m['ns_per_eval']:>9.1f} "
+            f"{m['local_search_rate']:>7.3f} {m['scanned_per_update']:>9.2f} {ratio:>10} {speedup:>12}"
+        )
+
+
 def compute_metrics(rows: List[BenchRow]) -> List[Dict[str, object]]:
     """Compute both strong and weak scaling metrics (written to one CSV)."""
     strong = _strong_metrics(rows)
@@ -342,6 +588,17 @@ def try_plot(metrics: List[Dict[str, object]], outdir: str) -> None:
         print("matplotlib not available; skipping plots. Install with: pip install matplotlib")
         return
 
+    def _parallel(ms: List[Dict[str, object]]) -> List[Tuple[str, List[Dict[str, object]]]]:
+        """One series per (parallel version, binding), labelled e.g. "OpenMP (spread)"."""
+        names = {"openmp": "OpenMP", "mpi": "MPI"}
+        out = []
+        for version, bind in sorted({(str(m["version"]), str(m.get("bind", "none"))) for m in ms}):
+            if version not in names:
+                continue
+            label = names[version] if bind == "none" else f"{names[version]} ({bind})"
+            out.append((label, [m for m in ms if m["version"] == version and m.get("bind", "none") == bind]))
+        return out
+
     def _series(ms: List[Dict[str, object]], ykey: str) -> Tuple[List[int], List[float]]:
         ms = sorted(ms, key=lambda x: int(x["p"]))
         xs = [int(x["p"]) for x in ms]
@@ -363,12 +620,9 @@ def try_plot(metrics: List[Dict[str, object]], outdir: str) -> None:
 
         # Time
         plt.figure()
-        if omp:
-            x, y = _series(omp, "time_s")
-            plt.plot(x, y, marker="o", label="OpenMP")
-        if mpi:
-            x, y = _series(mpi, "time_s")
-            plt.plot(x, y, marker="o", label="MPI")
+        for label, series in _parallel(ms):
+            x, y = _series(series, "time_s")
+            plt.plot(x, y, marker="o", label=label)
         if t_seq1 > 0:
             plt.axhline(t_seq1, linestyle="--", linewidth=1.0, label="Sequential (p=1)")
         plt.xlabel("p (threads or MPI processes)")
@@ -381,12 +635,9 @@ def try_plot(metrics: List[Dict[str, object]], outdir: str) -> None:
 
         def _plot_speed_eff(ykey: str, ylabel: str, filename: str, ideal: str) -> None:
             plt.figure()
-            if omp:
-                x, y = _series(omp, ykey)
-                plt.plot(x, y, marker="o", label="OpenMP")
-            if mpi:
-                x, y = _series(mpi, ykey)
-                plt.plot(x, y, marker="o", label="MPI")
+            for label, series in _parallel(ms):
+                x, y = _series(series, ykey)
+                plt.plot(x, y, marker="o", label=label)
             # Ideal line (strong scaling)
             x_ideal = sorted({int(m["p"]) for m in omp + mpi})
             if x_ideal:
@@ -422,12 +673,9 @@ def try_plot(metrics: List[Dict[str, object]], outdir: str) -> None:
 
         # Time (ideal is constant time at baseline)
         plt.figure()
-        if omp:
-            x, y = _series(omp, "time_s")
-            plt.plot(x, y, marker="o", label="OpenMP")
-        if mpi:
-            x, y = _series(mpi, "time_s")
-            plt.plot(x, y, marker="o", label="MPI")
+        for label, series in _parallel(ms):
+            x, y = _series(series, "time_s")
+            plt.plot(x, y, marker="o", label=label)
         if t_base_seq > 0:
             plt.axhline(t_base_seq, linestyle="--", linewidth=1.0, label="ideal (constant time)")
         plt.xlabel("p (threads or MPI processes)")
@@ -440,12 +688,9 @@ def try_plot(metrics: List[Dict[str, object]], outdir: str) -> None:
 
         def _plot_eff(ykey: str, ylabel: str, filename: str) -> None:
             plt.figure()
-            if omp:
-                x, y = _series(omp, ykey)
-                plt.plot(x, y, marker="o", label="OpenMP")
-            if mpi:
-                x, y = _series(mpi, ykey)
-                plt.plot(x, y, marker="o", label="MPI")
+            for label, series in _parallel(ms):
+                x, y = _series(series, ykey)
+                plt.plot(x, y, marker="o", label=label)
             x_ideal = sorted({int(m["p"]) for m in omp + mpi})
             if x_ideal:
                 plt.plot(x_ideal, [1.0 for _ in x_ideal], linestyle="--", label="ideal")
@@ -494,6 +739,29 @@ def main() -> None:
     if not rows:
         raise SystemExit("No BENCH lines found in input.")
 
+    # Time-to-target runs have their own analysis (ERT / ECDF).
+    ttt_rows = [r for r in rows if "ttt_prec" in r.extra]
+    rows = [r for r in rows if "ttt_prec" not in r.extra]
+    if ttt_rows:
+        ert = compute_ert(ttt_rows)
+        print_ert_table(ert)
+        write_csv(
+            os.path.join(args.outdir, "ert.csv"),
+            ert,
+            ["objective", "version", "bind", "p", "n_bats", "prec", "runs", "successes", "success_rate", "ert_evals",
+             "ert_s"],
+        )
+        ecdf = compute_ecdf(ttt_rows)
+        write_csv(os.path.join(args.outdir, "ecdf.csv"), ecdf, ["version", "bind", "p", "measure", "x", "fraction"])
+        try_plot_ecdf(ecdf, args.outdir)
+    if not rows:
+        return
+
+    work = compute_work_metrics(rows)
+    if work:
+        print_work_table(work)
+        write_csv(os.path.join(args.outdir, "work_metrics.csv"), work, WORK_FIELDS)
+
     metrics = compute_metrics(rows)
 
     # Write CSV
@@ -504,6 +772,9 @@ def main() -> None:
             fieldnames=[
                 "mode",
                 "version",
+                "bind",
+                "cores",
+                "smt_shared",
                 "n_bats",
                 "iters",
                 "procs",
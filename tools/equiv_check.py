@@ -0,0 +1,195 @@
+#!/usr/bin/env python3
+"""Check that the sequential, OpenMP and MPI programs compute the same run.
+
+Usage:
+  python3 tools/equiv_check.py --bin-dir code --seeds 3 --iters 300
+
+For a given --seed, the three back-ends must produce bitwise identical
+results whatever the number of threads or ranks. For every configuration
+(options x population size x seed), the script runs:
+
+- code/sequential (reference)
+- code/openmp_bat with OMP_NUM_THREADS = each of --threads
+- code/mpi_bat under mpiexec with each of --ranks (sizes not divisible by
+  the rank count are skipped)
+
+with `--trace` (best bat of every iteration, hex floats) and `--final-pop`
+(binary population file), and compares both files byte for byte with the
+reference. On a mismatch it reports the first divergent iteration of the
+trace and the first divergent record of the final population.
+
+It then checks the expression compiler on its own (--objective-expr): for
+every expression of EXPRESSIONS it runs code/sequential with `--trace` and
+recomputes the value of every traced best bat from its coordinates, which
+must give the traced f bitwise. A wrong register allocation gives wrong
+values on every back-end at once, so the equivalence runs cannot see it.
+
+Excluded on purpose (documented divergences, see README):
+- --refine: the parallel programs refine the previous best concurrently
+- --restart partial: MPI ranks re-sample the worst bats of their own slice
+
+Exit status: 0 if every run matched, 1 otherwise.
+"""
+
+from __future__ import annotations
+
+import argparse
+import os
+import shlex
+import struct
+import subprocess
+import sys
+import tempfile
+from typing import List, Optional, Tuple
+
+# Option sets exercised by default (on top of --n-bats / --iters / --seed).
+CONFIGS = [
+    [],
+    ["--init", "sobol", "--obl"],
+    ["--init", "lhs"],
+    ["--adapt", "both"],
+    ["--objective", "rastrigin"],
+    ["--objective", "rosenbrock", "--adapt", "history"],
+    ["--shrink", "linear", "--shrink-min", "12"],
+    ["--restart", "full", "--restart-gap", "30"],
+]
+
+# Expressions of the self-check and the same value in Python, evaluated in the
+# same order (x1, x2 = the coordinates). x[1]^2 - 4 once evaluated as x1^2 - x1
+# (a constant in a register an earlier instruction wrote); the long sum needs
+# more constants than there are registers.
+EXPRESSIONS = [
+    ("x[1]^2 - 4", "x1 * x1 - 4"),
+    ("-sum(x^2)", "-(x1 * x1 + x2 * x2)"),
+    ("1.5*x[1] - 2.25*x[2] + 3", "1.5 * x1 - 2.25 * x2 + 3"),
+    (" + ".join(f"{k + 0.5}*x[{k % 2 + 1}]" for k in range(70)),
+     " + ".join(f"{k + 0.5} * x{k % 2 + 1}" for k in range(70))),
+]
+
+# BatPopHeader: magic[8] + 8 x uint32 (see include/bat_io.h).
+HEADER = struct.Struct("<8s8I")
+
+
+def run(cmd: List[str], env: Optional[dict] = None) -> None:
+    res = subprocess.run(cmd, capture_output=True, text=True, env=env)
+    if res.returncode != 0:
+        raise SystemExit(f"Command failed ({res.returncode}): {shlex.join(cmd)}\n{res.stderr}")
+
+
+def first_trace_divergence(ref: str, other: str) -> Optional[str]:
+    with open(ref) as f:
+        a = f.read().splitlines()
+    with open(other) as f:
+        b = f.read().splitlines()
+    for k, (la, lb) in enumerate(zip(a, b)):
+        if la != lb:
+            return f"iteration {la.split()[0]}: {la!r} != {lb!r}"
+    if len(a) != len(b):
+        return f"trace lengths differ ({len(a)} vs {len(b)} iterations)"
+    return None
+
+
+def first_pop_divergence(ref: str, other: str) -> Optional[str]:
+    with open(ref, "rb") as f:
+        a = f.read()
+    with open(other, "rb") as f:
+        b = f.read()
+    if a == b:
+        return None
+    if len(a) < HEADER.size or len(b) < HEADER.size:
+        return "population file truncated"
+    ha, hb = HEADER.unpack_from(a), HEADER.unpack_from(b)
+    if ha != hb:
+        return f"headers differ: {ha} != {hb}"
+    record = ha[3]
+    for off in range(HEADER.size, min(len(a), len(b)), record):
+        if a[off:off + record] != b[off:off + record]:
+            k = (off - HEADER.size) // record
+            return "best record differs" if k == 0 else f"bat {k - 1} differs"
+    return f"population sizes differ ({len(a)} vs {len(b)} bytes)"
+
+
+def first_expr_mismatch(trace: str, formula: str) -> Optional[str]:
+    """First traced best bat whose f is not `formula` of its coordinates."""
+    with open(trace) as f:
+        for line in f:
+            it, fx, x1, x2 = line.split()[:4]
+            want = eval(formula, {}, {"x1": float.fromhex(x1), "x2": float.fromhex(x2)})
+            if float.fromhex(fx) != want:
+                return f"iteration {it}: f={float.fromhex(fx)!r}, expected {want!r}"
+    return None
+
+
+def main() -> None:
+    ap = argparse.ArgumentParser()
+    ap.add_argument("--bin-dir", default="code", help="Directory with sequential, openmp_bat and mpi_bat")
+    ap.add_argument("--suffix", default="", help="Binary name suffix (e.g. _f32 for `make PRECISION=float`)")
+    ap.add_argument("--seeds", type=int, default=3, help="Number of seeds per configuration")
+    ap.add_argument("--sizes", default="24,48", help="Population sizes (comma-separated)")
+    ap.add_argument("--iters", type=int, default=300)
+    ap.add_argument("--threads", default="1,2,3,4", help="OMP_NUM_THREADS values")
+    ap.add_argument("--ranks", default="1,2,3,4", help="MPI rank counts (empty = skip MPI)")
+    ap.add_argument("--mpiexec", default="mpiexec --oversubscribe",
+                    help="MPI launcher prefix (e.g. add --allow-run-as-root in containers)")
+    args = ap.parse_args()
+
+    sizes = [int(s) for s in args.sizes.split(",") if s]
+    threads = [int(s) for s in args.threads.split(",") if s]
+    ranks = [int(s) for s in args.ranks.split(",") if s]
+    seq = os.path.join(args.bin_dir, "sequential" + args.suffix)
+    omp = os.path.join(args.bin_dir, "openmp_bat" + args.suffix)
+    mpi = os.path.join(args.bin_dir, "mpi_bat" + args.suffix)
+
+    failures: List[Tuple[str, str]] = []
+    n_runs = 0
+    n_expr = n_expr_bad = 0
+    with tempfile.TemporaryDirectory() as tmp:
+        ref_trace = os.path.join(tmp, "ref.trace")
+        ref_pop = os.path.join(tmp, "ref.bin")
+        trace = os.path.join(tmp, "run.trace")
+        pop = os.path.join(tmp, "run.bin")
+
+        for config in CONFIGS:
+            for n_bats in sizes:
+                for seed in range(1, args.seeds + 1):
+                    base = ["--n-bats", str(n_bats), "--iters", str(args.iters), "--seed", str(seed),
+                            "--quiet"] + config
+                    run([seq] + base + ["--no-snapshot", "--trace", ref_trace, "--final-pop", ref_pop])
+
+                    variants = []
+                    for t in threads:
+                        env = dict(os.environ, OMP_NUM_THREADS=str(t))
+                        variants.append((f"openmp threads={t}", [omp] + base, env))
+                    for r in ranks:
+                        if n_bats % r == 0:
+                            cmd = shlex.split(args.mpiexec) + ["-n", str(r), mpi] + base
+                            variants.append((f"mpi ranks={r}", cmd, None))
+
+                    for name, cmd, env in variants:
+                        run(cmd + ["--trace", trace, "--final-pop", pop], env)
+                        n_runs += 1
+                        problem = first_trace_divergence(ref_trace, trace) or first_pop_divergence(ref_pop, pop)
+                        if problem:
+                            label = f"{name} n_bats={n_bats} seed={seed} {' '.join(config) or '(defaults)'}"
+                            failures.append((label, problem))
+                            print(f"MISMATCH {label}: {problem}")
+
+        for text, formula in EXPRESSIONS:
+            for seed in range(1, args.seeds + 1):
+                run([seq, "--n-bats", str(sizes[0]), "--iters", str(args.iters), "--seed", str(seed), "--quiet",
+                     "--no-snapshot", "--objective-expr", text, "--trace", trace])
+                n_expr += 1
+                problem = first_expr_mismatch(trace, formula)
+                if problem:
+                    n_expr_bad += 1
+                    label = f"--objective-expr {text[:40]!r} seed={seed}"
+                    failures.append((label, problem))
+                    print(f"MISMATCH {label}: {problem}")
+
+    print(f"{n_runs - (len(failures) - n_expr_bad)}/{n_runs} runs identical to the sequential reference")
+    print(f"{n_expr - n_expr_bad}/{n_expr} expression runs match their formula")
+    sys.exit(1 if failures else 0)
+
+
+if __name__ == "__main__":
+    main()
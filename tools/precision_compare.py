@@ -0,0 +1,106 @@
+#!/usr/bin/env python3
+"""Compare the double and single-precision (PRECISION=float) engines.
+
+Usage:
+  cd code && make && make PRECISION=float && cd ..
+  python3 tools/precision_compare.py --bin-dir code --seeds 5 --sizes 100,20000 --iters 500
+
+For every built-in objective, population size, ISA variant (--isa) and
+precision, the sequential program is run over several seeds. The script
+reads the BENCH lines and prints, per configuration:
+
+- time_s        : mean run time
+- ns/eval       : time per objective evaluation (evals= field)
+- bytes/bat     : size of one population record (from a --final-pop file)
+- speedup       : double time / float time for the same configuration
+- err_median    : median of (optimum - best_f) over the seeds
+- succ          : fraction of seeds with optimum - best_f <= --tol
+
+Large populations show the bandwidth gain of the smaller records; the
+generic vs avx2/avx512 rows show what the wider vectors bring to each
+precision. Quality is compared on the same seeds, so the error columns
+show the cost of storing positions in float.
+"""
+
+from __future__ import annotations
+
+import argparse
+import os
+import statistics
+import struct
+import subprocess
+import sys
+import tempfile
+from typing import Dict, List, Tuple
+
+sys.path.insert(0, os.path.dirname(os.path.abspath(__file__)))
+from adapt_compare import OBJECTIVES  # noqa: E402
+from bench_analyze import parse_lines  # noqa: E402
+
+PRECISIONS = [("double", ""), ("float", "_f32")]
+
+
+def record_size(exe: str) -> int:
+    """sizeof(Bat) of a binary, read from the header of a population file."""
+    with tempfile.TemporaryDirectory() as tmp:
+        path = os.path.join(tmp, "pop.bin")
+        subprocess.run([exe, "--n-bats", "2", "--iters", "1", "--quiet", "--no-snapshot", "--final-pop", path],
+                       check=True, capture_output=True)
+        with open(path, "rb") as f:
+            return struct.unpack_from("<8s8I", f.read(40))[3]
+
+
+def run_one(exe: str, objective: str, isa: str, n_bats: int, seed: int, iters: int) -> Dict[str, str]:
+    cmd = [exe, "--objective", objective, "--isa", isa, "--n-bats", str(n_bats), "--iters", str(iters),
+           "--seed", str(seed), "--quiet", "--no-snapshot"]
+    res = subprocess.run(cmd, capture_output=True, text=True)
+    if res.returncode != 0:
+        raise SystemExit(f"Command failed: {' '.join(cmd)}\n{res.stderr}")
+    rows = parse_lines(res.stdout.splitlines())
+    if not rows:
+        raise SystemExit(f"No BENCH line from: {' '.join(cmd)}")
+    extra = dict(rows[-1].extra)
+    extra["time_s"] = str(rows[-1].time_s)
+    return extra
+
+
+def main() -> None:
+    ap = argparse.ArgumentParser()
+    ap.add_argument("--bin-dir", default="code", help="Directory with sequential and sequential_f32")
+    ap.add_argument("--seeds", type=int, default=5)
+    ap.add_argument("--sizes", default="100,20000", help="Population sizes (comma-separated)")
+    ap.add_argument("--iters", type=int, default=500)
+    ap.add_argument("--isas", default="generic,auto", help="--isa values to compare")
+    ap.add_argument("--tol", type=float, default=1e-4, help="Success if optimum - best_f <= tol")
+    args = ap.parse_args()
+
+    sizes = [int(s) for s in args.sizes.split(",") if s]
+    isas = [s for s in args.isas.split(",") if s]
+    exes = {prec: os.path.join(args.bin_dir, "sequential" + sfx) for prec, sfx in PRECISIONS}
+    for prec, exe in exes.items():
+        if not os.path.exists(exe):
+            raise SystemExit(f"Missing {exe} (build it with `make PRECISION={prec}`)")
+    sizes_bytes = {prec: record_size(exe) for prec, exe in exes.items()}
+
+    print(f"{'objective':<11} {'n_bats':>7} {'isa':<8} {'prec':<7} {'isa_used':<8} {'bytes/bat':>9} "
+          f"{'time_s':>9} {'ns/eval':>8} {'speedup':>8} {'err_median':>11} {'succ':>5}")
+    for objective, f_opt in OBJECTIVES.items():
+        for n_bats in sizes:
+            for isa in isas:
+                times: Dict[str, float] = {}
+                for prec, exe in exes.items():
+                    runs = [run_one(exe, objective, isa, n_bats, seed, args.iters)
+                            for seed in range(1, args.seeds + 1)]
+                    t = statistics.mean(float(r["time_s"]) for r in runs)
+                    evals = statistics.mean(int(r["evals"]) for r in runs)
+                    errs = [f_opt - float(r["best_f"]) for r in runs]
+                    succ = sum(e <= args.tol for e in errs) / len(errs)
+                    times[prec] = t
+                    speedup = times["double"] / t if prec != "double" and t > 0 else 1.0
+                    print(f"{objective:<11} {n_bats:>7} {isa:<8} {prec:<7} {runs[0]['isa']:<8} "
+                          f"{sizes_bytes[prec]:>9} {t:>9.4f} {t * 1e9 / evals:>8.1f} {speedup:>8.2f} "
+                          f"{statistics.median(errs):>11.3e} {succ:>5.2f}")
+
+
+if __name__ == "__main__":
+    main()